@@ -36,7 +36,10 @@ class DFALayer {
 public:
   DFALayer(const std::size_t, const std::size_t, const std::size_t);
   laplus::Matrixf operator()(laplus::Matrixf);
+  laplus::Matrixf operator()(const laplus::SparseMatrixf&);
   void update(laplus::Matrixf, laplus::Matrixf, laplus::Matrixf, float);
+  void update(laplus::Matrixf, const laplus::SparseMatrixf&,
+              laplus::Matrixf, float);
   laplus::Matrixf W;
   laplus::Matrixf B;
 };
@@ -44,9 +44,18 @@ DFALayer::DFALayer(const std::size_t n_input,
 lp::Matrixf DFALayer::operator()(lp::Matrixf x)
 { return x.dot(W).apply(lp::sigmoid); }
 
+lp::Matrixf DFALayer::operator()(const lp::SparseMatrixf& x)
+{ return x.dot(W).apply(lp::sigmoid); }
+
 void DFALayer::update(lp::Matrixf e, lp::Matrixf x, lp::Matrixf y, float lr)
 {
   lp::Matrixf d_x = e.dot(B) * y.apply(lp::dsigmoid);
-  lp::Matrixf d_W = -x.transpose().dot(d_x);
-  W += d_W * lr;
+  W.gemm(-lr, x.transpose(), d_x, 1.0);
+}
+
+void DFALayer::update(lp::Matrixf e, const lp::SparseMatrixf& x,
+                      lp::Matrixf y, float lr)
+{
+  lp::Matrixf d_x = e.dot(B) * y.apply(lp::dsigmoid);
+  x.transpose().spmm(CblasLeft, -lr, d_x, 1.0, W);
 }
@@ -39,7 +39,4 @@ lp::Matrixf Layer::operator()(lp::Matrixf x)
 { return x.dot(W).apply(lp::sigmoid); }
 
 void Layer::update(lp::Matrixf e, lp::Matrixf x, float lr)
-{
-  lp::Matrixf d_W = -x.transpose().dot(e);
-  W += d_W * lr;
-}
+{ W.gemm(-lr, x.transpose(), e, 1.0); }
@@ -29,7 +29,6 @@
 #include <iostream>
 #include <iomanip>
 #include <vector>
-#include "mnist/mnist_reader.hpp"
 #include "layer.hpp"
 #include "dfa_layer.hpp"
 #include "laplus.hpp"
@@ -54,107 +53,73 @@ float accuracy(lp::Matrixf y, lp::Matrixf t) {
 }
 
 int main() {
-  auto mnist = mnist::read_dataset<std::vector, std::vector, unsigned char, unsigned char>();
+  lp::Records train_images = lp::Records::IDX("mnist/train-images-idx3-ubyte");
+  lp::Records train_labels = lp::Records::IDX("mnist/train-labels-idx1-ubyte");
 
-  std::vector<std::vector<unsigned char> > train_images = mnist.training_images;
-  std::vector<unsigned char> train_labels = mnist.training_labels;
+  lp::Records test_images = lp::Records::IDX("mnist/t10k-images-idx3-ubyte");
+  lp::Records test_labels = lp::Records::IDX("mnist/t10k-labels-idx1-ubyte");
 
-  std::vector<std::vector<unsigned char> > test_images = mnist.test_images;
-  std::vector<unsigned char> test_labels = mnist.test_labels;
+  if(!train_images.is_open() || !train_labels.is_open() ||
+     !test_images.is_open() || !test_labels.is_open()) {
+    std::cerr << "Could not open the MNIST dataset" << std::endl;
+    return 1;
+  }
 
-  std::size_t N_train = train_images.size();
   std::size_t N_test = test_images.size();
-  std::size_t x_shape = train_images[0].size();
   std::size_t y_shape = 10;
   std::size_t n_epoch = 20;
-
-  lp::Matrixf x_train(N_train, x_shape);
-  lp::Matrixf y_train(N_train, y_shape);
-
-  lp::Matrixf x_test(N_test, x_shape);
-  lp::Matrixf y_test(N_test, y_shape);
-
-  for(std::size_t i = 0; i < N_train; ++i) {
-    for(std::size_t j = 0; j < x_shape; ++j) {
-      x_train(i, j) = static_cast<float>(train_images[i][j]) / 255.0;
-    }
-    for(std::size_t j = 0; j < y_shape; ++j) {
-      y_train(i, j) = train_labels[i] == j ? 1.0f : 0.0f;
-    }
-    if(i < N_test) {
-      for(std::size_t j = 0; j < x_shape; ++j) {
-        x_test(i, j) = static_cast<float>(test_images[i][j]) / 255.0;
-      }
-      for(std::size_t j = 0; j < y_shape; ++j) {
-        y_test(i, j) = test_labels[i] == j ? 1.0f : 0.0f;
-      }
-    }
-  }
-
-  std::vector<std::size_t> perm;
-  for(std::size_t i = 0; i < N_train; ++i) {
-    perm.push_back(i);
-  }
-
   std::size_t batchsize = 100;
 
+  lp::DataLoader train(train_images, train_labels,
+                       {batchsize, y_shape, 1.0f / 255.0f, 0.0f, true, true, 0, 4, 2});
+  lp::DataLoader test(test_images, test_labels,
+                      {batchsize, y_shape, 1.0f / 255.0f, 0.0f, false, false, 0, 4, 1});
+
   DFALayer layer0(28 * 28, 1000, 10);
   Layer layer1(1000, 10);  
 
+  lp::Matrixf x(1, 1);
+  lp::Matrixf t(1, 1);
+
   for(std::size_t epoch = 0; epoch < n_epoch; ++epoch) {
     std::cerr << "Epoch: " << epoch + 1 << std::endl;
-    std::random_shuffle(perm.begin(), perm.end());
 
     { /* Training */
       float acc = 0.0f;
       float loss = 0.0f;
 
-      for(std::size_t i = 0; i < N_train; i += batchsize) {
-        std::vector<std::size_t> indices(perm.begin() + i, perm.begin() + i + batchsize);
-
-        lp::Matrixf x(batchsize, x_shape);
-        lp::Matrixf t(batchsize, y_shape);
-
-        for(std::size_t i = 0; i < batchsize; ++i) {
-          x.set_row(i, x_train.row(indices[i]));
-          t.set_row(i, y_train.row(indices[i]));
-        }
-
-        lp::Matrixf h = layer0(x);
+      while(train.next(x, t)) {
+        // MNIST images are mostly background, so the first layer reads
+        // them as a sparse matrix and accumulates a sparse gradient.
+        lp::SparseMatrixf s(x, lp::CSR);
+        lp::Matrixf h = layer0(s);
         lp::Matrixf y = layer1(h);
         lp::Matrixf e = y - t;
 
-        layer0.update(e, x, h, 0.1);
+        layer0.update(e, s, h, 0.1);
         layer1.update(e, h, 0.1);
 
-        loss += cross_entropy(y, t) * batchsize;
-        acc += accuracy(y, t) * batchsize;
+        loss += cross_entropy(y, t) * x.rows();
+        acc += accuracy(y, t) * x.rows();
       }
 
+      std::size_t N = train.batches() * batchsize;
       std::cerr
-        << "Train Loss: " << std::setprecision(7) << std::setw(8) << loss / N_train
-        << "\tAccuracy: "  << std::setprecision(4) << std::setw(5) << acc / N_train * 100
+        << "Train Loss: " << std::setprecision(7) << std::setw(8) << loss / N
+        << "\tAccuracy: "  << std::setprecision(4) << std::setw(5) << acc / N * 100
         << "%" << std::endl;
     }
 
-    { /* Training */
+    { /* Test */
       float acc = 0.0f;
       float loss = 0.0f;
 
-      for(std::size_t i = 0; i < N_test; i += batchsize) {
-        lp::Matrixf x(batchsize, x_shape);
-        lp::Matrixf t(batchsize, y_shape);
-
-        for(std::size_t i = 0; i < batchsize; ++i) {
-          x.set_row(i, x_test.row(i));
-          t.set_row(i, y_test.row(i));
-        }
-
-        lp::Matrixf h = layer0(x);
+      while(test.next(x, t)) {
+        lp::Matrixf h = layer0(lp::SparseMatrixf(x, lp::CSR));
         lp::Matrixf y = layer1(h);
 
-        loss += cross_entropy(y, t) * batchsize;
-        acc += accuracy(y, t) * batchsize;
+        loss += cross_entropy(y, t) * x.rows();
+        acc += accuracy(y, t) * x.rows();
       }
 
       std::cerr
@@ -30,7 +30,31 @@
 #define __LAPLUS__
 
 #include "laplus/math.hpp"
+#include "laplus/random.hpp"
+#include "laplus/archive.hpp"
+#include "laplus/npy.hpp"
+#include "laplus/convert.hpp"
+#include "laplus/data_loader.hpp"
+#include "laplus/vector.hpp"
+#include "laplus/matrix.hpp"
 #include "laplus/vectorf.hpp"
 #include "laplus/matrixf.hpp"
+#include "laplus/linalg.hpp"
+#include "laplus/sparse_matrixf.hpp"
+#include "laplus/half.hpp"
+#include "laplus/half_matrix.hpp"
+#include "laplus/quantized_matrix.hpp"
+#include "laplus/tensor.hpp"
+#include "laplus/conv.hpp"
+#include "laplus/nn.hpp"
+#include "laplus/optimizer.hpp"
+#include "laplus/autodiff.hpp"
+#include "laplus/graph.hpp"
+#include "laplus/jit.hpp"
+#include "laplus/trainer.hpp"
+#include "laplus/communicator.hpp"
+#include "laplus/transport.hpp"
+#include "laplus/process_grid.hpp"
+#include "laplus/strassen.hpp"
 
 #endif  // __LAPLUS__
@@ -0,0 +1,128 @@
+/******************************************************************************
+ *
+ * laplus/archive.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_ARCHIVE_HPP__
+#define __LAPLUS_ARCHIVE_HPP__
+
+#include "laplus/vector.hpp"
+#include "laplus/matrix.hpp"
+#include "laplus/typedef.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace laplus {
+
+// Binary container of named arrays. A 64 byte file header is followed by
+// one record per array: a fixed size entry holding the dtype, shape and
+// storage order, the name, and the payload. Records and payloads start on
+// 64 byte boundaries so that payloads can be used in place from a memory
+// mapping. All fields are little-endian.
+class ArchiveWriter {
+public:
+  // Constructors and Destructor
+  ArchiveWriter()=delete;
+  explicit ArchiveWriter(const std::string&);
+  ArchiveWriter(const ArchiveWriter&)=delete;
+  virtual ~ArchiveWriter();
+
+  // Assignment Operators
+  ArchiveWriter& operator=(const ArchiveWriter&)=delete;
+
+  // Utilities
+  template<typename T>
+  void write(const std::string&, const Vector<T>&);
+  template<typename T>
+  void write(const std::string&, const Matrix<T>&);
+  void close();
+
+  // Accessors
+  const bool is_open() const;
+private:
+  void record(const std::string&, const DType, const std::size_t,
+              const std::size_t, const std::size_t, const bool,
+              const void* const, const std::size_t);
+  void pad();
+
+  std::ofstream stream;
+  std::uint64_t position;
+};
+
+// Read-only view of an archive file. The file is mapped privately and
+// arrays are returned as views of the mapping, which stays alive for as
+// long as the archive or any array taken from it does. Writes to these
+// arrays are copy-on-write and never reach the file.
+class Archive {
+public:
+  // Constructors and Destructor
+  Archive()=delete;
+  explicit Archive(const std::string&);
+  Archive(const Archive&);
+  Archive(Archive&&) noexcept;
+  virtual ~Archive();
+
+  // Assignment Operators
+  Archive& operator=(const Archive&);
+  Archive& operator=(Archive&&) noexcept;
+
+  // Utilities
+  friend void swap(Archive&, Archive&);
+  template<typename T>
+  Vector<T> vector(const std::string&) const;
+  template<typename T>
+  Matrix<T> matrix(const std::string&) const;
+
+  // Accessors
+  const bool is_open() const;
+  const bool contains(const std::string&) const;
+  const std::vector<std::string> names() const;
+  const DType dtype(const std::string&) const;
+  const shape_t shape(const std::string&) const;
+private:
+  struct Entry {
+    DType dtype;
+    shape_t shape;
+    bool trans;
+    std::size_t offset;
+  };
+
+  template<typename T>
+  std::shared_ptr<T> payload(const Entry&) const;
+
+  std::shared_ptr<char> mapping;
+  std::map<std::string, Entry> entries;
+};
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_ARCHIVE_HPP__
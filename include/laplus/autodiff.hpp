@@ -0,0 +1,139 @@
+/******************************************************************************
+ *
+ * laplus/autodiff.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_AUTODIFF_HPP__
+#define __LAPLUS_AUTODIFF_HPP__
+
+#include "laplus/matrixf.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace laplus {
+
+class Tape;
+
+// A node recorded on a Tape.
+struct Var {
+  Tape* tape;
+  std::size_t index;
+};
+
+Var operator+(const Var&, const Var&);
+Var operator-(const Var&, const Var&);
+Var operator*(const Var&, const Var&);
+Var operator*(const Var&, const float);
+Var operator*(const float, const Var&);
+
+// Reverse-mode automatic differentiation
+// Operations are recorded as compact nodes (an opcode, two operand
+// indices and a scalar) and evaluated eagerly. Values and gradients live
+// in buffers drawn from a pool: backward() returns the gradient buffer of
+// every intermediate node once it has been propagated, and clear() returns
+// all of them, so a training loop that records the same graph each step
+// stops allocating after the first one. Each backward rule is one fused
+// pass that writes the first contribution to a gradient and accumulates
+// the rest, so gradients are never zero-filled or built from temporaries.
+//
+// Computed values are row-major. Leaves in another layout are copied on
+// entry. Vars, values and gradients are invalidated by clear().
+class Tape {
+public:
+  // Constructors and Destructor
+  Tape();
+
+  // Leaves
+  Var variable(const Matrixf&);
+  Var constant(const Matrixf&);
+
+  // Operations
+  Var dot(const Var&, const Var&);
+  Var add(const Var&, const Var&);  // b may also be a single row
+  Var sub(const Var&, const Var&);
+  Var mul(const Var&, const Var&);
+  Var scale(const Var&, const float);
+  Var sigmoid(const Var&);
+  Var tanh(const Var&);
+  Var relu(const Var&);
+  Var sum(const Var&);
+  Var mean(const Var&);
+  Var mse(const Var&, const Var&);
+  Var softmax_cross_entropy(const Var&, const Var&);
+
+  // Differentiation
+  void backward(const Var&);
+  void clear();
+
+  // Accessors
+  const Matrixf& value(const Var&) const;
+  Matrixf grad(const Var&) const;
+  const std::size_t size() const;
+  const std::size_t buffers() const;
+private:
+  enum Op : std::uint8_t {
+    Leaf, Dot, Add, Sub, Mul, Scale, Sigmoid, Tanh, Relu, Sum, Mean, MSE,
+    SoftmaxCrossEntropy
+  };
+
+  struct Node {
+    Op op;
+    bool needs;
+    bool leaf;
+    float s;
+    std::size_t a;
+    std::size_t b;
+    std::size_t value;
+    std::size_t grad;
+    std::size_t aux;
+  };
+
+  struct Buffer {
+    std::vector<float> data;
+    bool used;
+  };
+
+  Var record(const Op, const std::size_t, const std::size_t, const float,
+             const std::size_t, const std::size_t);
+  float* gradient(const std::size_t, bool&);
+  void propagate(const std::size_t);
+
+  const std::size_t acquire(const std::size_t);
+  void release(const std::size_t);
+  Matrixf view(const std::size_t, const std::size_t,
+               const std::size_t) const;
+
+  std::vector<Node> nodes;
+  std::vector<Matrixf> values;
+  std::vector<Buffer> pool;
+};
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_AUTODIFF_HPP__
@@ -0,0 +1,97 @@
+/******************************************************************************
+ *
+ * laplus/communicator.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_COMMUNICATOR_HPP__
+#define __LAPLUS_COMMUNICATOR_HPP__
+
+#include "laplus/matrixf.hpp"
+
+#include <cstddef>
+#include <string>
+
+namespace laplus {
+
+// Collectives between the processes of one machine
+// The ranks of a group map the same named POSIX shared memory segment,
+// which rank 0 creates (replacing any stale one) and removes again on
+// destruction. Each rank owns a staging slot of capacity floats in each
+// of two banks. Buffers pass through the slots in chunks, and consecutive
+// chunks alternate banks, so a rank can post its next chunk while slower
+// ranks still read the last one. Allreduce is a reduce-scatter, where
+// rank r sums range r of every slot in place, followed by an allgather
+// straight out of the segment. Ranks block on futexes in the segment.
+// Every rank must issue the same collectives with the same sizes. Ranks
+// that start before rank 0 may join a segment left by a crashed run, so
+// names should be unique per run.
+class Communicator {
+public:
+  // Constructors and Destructor
+  Communicator()=delete;
+  Communicator(const std::string&, const std::size_t, const std::size_t);
+  Communicator(const std::string&, const std::size_t, const std::size_t,
+               const std::size_t);
+  Communicator(const Communicator&)=delete;
+  virtual ~Communicator();
+
+  // Assignment Operators
+  Communicator& operator=(const Communicator&)=delete;
+
+  // Collectives
+  // Sums the buffers of all ranks into each of them.
+  void allreduce(Matrixf&);
+  // Copies the buffer of the given root rank into everyone else's.
+  void broadcast(Matrixf&, const std::size_t);
+  // Stacks the row-major buffers of all ranks, in rank order, into the
+  // second argument.
+  void allgather(const Matrixf&, Matrixf&);
+  void barrier();
+
+  // Accessors
+  const bool is_open() const;
+  const std::size_t rank() const;
+  const std::size_t size() const;
+  const std::size_t capacity() const;
+private:
+  struct Header;
+
+  float* const slot(const std::size_t, const std::size_t) const;
+
+  std::string name;
+  std::size_t me;
+  std::size_t ranks;
+  std::size_t chunk;
+  std::size_t length;
+  void* memory;
+  Header* header;
+  std::size_t round;
+};
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_COMMUNICATOR_HPP__
@@ -0,0 +1,66 @@
+/******************************************************************************
+ *
+ * laplus/conv.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_CONV_HPP__
+#define __LAPLUS_CONV_HPP__
+
+#include "laplus/tensor.hpp"
+#include "laplus/typedef.hpp"
+
+namespace laplus {
+
+// Images are N x C x H x W (NCHW) or N x H x W x C (NHWC) and filters are
+// O x C x KH x KW or O x KH x KW x C to match.
+enum ConvLayout { NCHW, NHWC };
+
+// ConvAuto picks Winograd F(2x2, 3x3) for 3x3 stride-1 filters with enough
+// channels to amortize the transforms and im2col + GEMM otherwise.
+enum ConvAlgorithm { ConvAuto, ConvIm2col, ConvWinograd };
+
+struct ConvParams {
+  ConvLayout layout;
+  std::size_t stride_h;
+  std::size_t stride_w;
+  std::size_t pad_h;
+  std::size_t pad_w;
+  ConvAlgorithm algorithm;
+};
+
+// y = conv2d(x, w) and its gradients with respect to x and w given dy.
+// The shape of the missing operand is passed to the backward passes.
+// Scratch buffers are kept per thread and reused across calls.
+Tensorf conv2d(const Tensorf&, const Tensorf&, const ConvParams&);
+Tensorf conv2d_backward_data(const Tensorf&, const Tensorf&, const dims_t&,
+                             const ConvParams&);
+Tensorf conv2d_backward_weight(const Tensorf&, const Tensorf&, const dims_t&,
+                               const ConvParams&);
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_CONV_HPP__
@@ -0,0 +1,78 @@
+/******************************************************************************
+ *
+ * laplus/convert.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_CONVERT_HPP__
+#define __LAPLUS_CONVERT_HPP__
+
+#include "laplus/matrixf.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace laplus {
+
+// Bulk conversions computing y = x * scale + bias. Conversions to integers
+// round to nearest even and saturate; NaN converts to the lowest value.
+// Large inputs are split across threads.
+void convert(const std::uint8_t*, float*, const std::size_t,
+             const float, const float);
+void convert(const std::int16_t*, float*, const std::size_t,
+             const float, const float);
+void convert(const std::int32_t*, float*, const std::size_t,
+             const float, const float);
+void convert(const double*, float*, const std::size_t,
+             const float, const float);
+
+void convert(const float*, std::uint8_t*, const std::size_t,
+             const float, const float);
+void convert(const float*, std::int16_t*, const std::size_t,
+             const float, const float);
+void convert(const float*, std::int32_t*, const std::size_t,
+             const float, const float);
+void convert(const float*, double*, const std::size_t,
+             const float, const float);
+
+// Row-major rows x cols arrays to and from matrices.
+Matrixf from_u8(const std::uint8_t*, const std::size_t, const std::size_t,
+                const float, const float);
+Matrixf from_i16(const std::int16_t*, const std::size_t, const std::size_t,
+                 const float, const float);
+Matrixf from_i32(const std::int32_t*, const std::size_t, const std::size_t,
+                 const float, const float);
+Matrixf from_f64(const double*, const std::size_t, const std::size_t,
+                 const float, const float);
+
+void to_u8(const Matrixf&, std::uint8_t*, const float, const float);
+void to_i16(const Matrixf&, std::int16_t*, const float, const float);
+void to_i32(const Matrixf&, std::int32_t*, const float, const float);
+void to_f64(const Matrixf&, double*, const float, const float);
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_CONVERT_HPP__
@@ -0,0 +1,154 @@
+/******************************************************************************
+ *
+ * laplus/data_loader.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_DATA_LOADER_HPP__
+#define __LAPLUS_DATA_LOADER_HPP__
+
+#include "laplus/matrixf.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace laplus {
+
+// Fixed size byte records stored back to back after a header, such as the
+// unsigned byte IDX files of MNIST. Records are read in place from a
+// mapping of the file.
+class Records {
+public:
+  // Generators
+  static Records IDX(const std::string&);
+
+  // Constructors and Destructor
+  Records()=delete;
+  Records(const std::string&, const std::size_t, const std::size_t);
+  Records(const Records&);
+  Records(Records&&) noexcept;
+  virtual ~Records();
+
+  // Assignment Operators
+  Records& operator=(const Records&);
+  Records& operator=(Records&&) noexcept;
+
+  // Miscellaneous Operators
+  const std::uint8_t* operator[](const std::size_t) const;
+
+  // Utilities
+  friend void swap(Records&, Records&);
+
+  // Accessors
+  const bool is_open() const;
+  const std::size_t size() const;
+  const std::size_t record_size() const;
+private:
+  std::shared_ptr<char> mapping;
+  const std::uint8_t* first;
+  std::size_t count;
+  std::size_t length;
+};
+
+// Features are stored as x * scale + bias. Labels are one-hot encoded
+// into the given number of classes from the first byte of each label
+// record, or copied as raw values when classes is zero. Batches are
+// prepared by the given number of background threads into a ring of depth
+// preallocated buffers.
+struct LoaderParams {
+  std::size_t batch_size;
+  std::size_t classes;
+  float scale;
+  float bias;
+  bool shuffle;
+  bool drop_last;
+  std::uint64_t seed;
+  std::size_t depth;
+  std::size_t workers;
+};
+
+// Streams shuffled (x, t) batches of a pair of record files. Workers run
+// ahead of the consumer across epoch boundaries; each epoch is shuffled
+// by a Philox stream of the seed so the order does not depend on the
+// number of workers. Batches returned by next() are views of the ring and
+// stay valid until the following call.
+class DataLoader {
+public:
+  // Constructors and Destructor
+  DataLoader()=delete;
+  DataLoader(const Records&, const Records&, const LoaderParams&);
+  DataLoader(const DataLoader&)=delete;
+  virtual ~DataLoader();
+
+  // Assignment Operators
+  DataLoader& operator=(const DataLoader&)=delete;
+
+  // Utilities
+  const bool next(Matrixf&, Matrixf&);
+
+  // Accessors
+  const std::size_t batches() const;
+  const std::size_t epoch() const;
+private:
+  struct Slot {
+    Matrixf x;
+    Matrixf t;
+    std::size_t free;
+    std::size_t ready;
+  };
+
+  void work();
+  void fill(const std::size_t, Slot&);
+  std::shared_ptr<const std::vector<std::size_t>> order(const std::size_t);
+
+  Records features;
+  Records labels;
+  LoaderParams params;
+  std::size_t count;
+
+  std::vector<Slot> slots;
+  std::map<std::size_t, std::shared_ptr<const std::vector<std::size_t>>>
+      orders;
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable produced;
+  std::condition_variable consumed;
+  std::size_t issued;
+  std::size_t current;
+  std::size_t released;
+  std::size_t position;
+  bool stop;
+};
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_DATA_LOADER_HPP__
@@ -0,0 +1,159 @@
+/******************************************************************************
+ *
+ * laplus/graph.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_GRAPH_HPP__
+#define __LAPLUS_GRAPH_HPP__
+
+#include "laplus/matrixf.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace laplus {
+
+// Computation graphs
+// A Graph captures a fixed-shape sequence of Matrixf operations once and
+// compiles it into a plan that replays without allocating:
+//
+//  * Single-use elementwise nodes are fused into their consumer, so a
+//    chain such as (a - b) * dsigmoid(y) runs as one kernel that keeps its
+//    intermediates in cache-sized chunks.
+//  * Every materialized value gets a lifetime from its definition to its
+//    last use, and values whose lifetimes do not overlap share space in
+//    one arena.
+//  * A kernel whose same-shaped operand dies at that step writes its
+//    result over the operand.
+//
+// Inputs are bound before each run and parameters are read, and updated,
+// in place. Both must be row-major or vector-shaped. Operations run in
+// capture order, and nothing is fused across an update.
+class Graph {
+public:
+  // Constructors and Destructor
+  Graph();
+
+  // Leaves
+  const std::size_t input(const std::size_t, const std::size_t);
+  const std::size_t parameter(const Matrixf&);
+
+  // Operations
+  const std::size_t dot(const std::size_t, const std::size_t,
+                        const CBLAS_TRANSPOSE=CblasNoTrans,
+                        const CBLAS_TRANSPOSE=CblasNoTrans);
+  const std::size_t add(const std::size_t, const std::size_t);
+  const std::size_t sub(const std::size_t, const std::size_t);
+  const std::size_t mul(const std::size_t, const std::size_t);
+  const std::size_t scale(const std::size_t, const float);
+  const std::size_t sigmoid(const std::size_t);
+  const std::size_t dsigmoid(const std::size_t);
+  const std::size_t tanh(const std::size_t);
+  const std::size_t relu(const std::size_t);
+
+  // Adds alpha * op(a) * op(b) to a parameter.
+  void update(const std::size_t, const float,
+              const std::size_t, const std::size_t,
+              const CBLAS_TRANSPOSE=CblasNoTrans,
+              const CBLAS_TRANSPOSE=CblasNoTrans);
+
+  // Keeps a value readable after run().
+  void output(const std::size_t);
+
+  // Compilation and Execution
+  void compile();
+  void bind(const std::size_t, const Matrixf&);
+  void run();
+
+  // Accessors
+  const Matrixf& value(const std::size_t) const;
+  const std::size_t kernels() const;
+  const std::size_t arena() const;
+private:
+  enum Op : std::uint8_t {
+    Input, Parameter, Dot, Add, Sub, Mul, Scale, Sigmoid, DSigmoid, Tanh,
+    Relu, Update, Load, Kernel
+  };
+
+  struct Node {
+    Op op;
+    CBLAS_TRANSPOSE ta;
+    CBLAS_TRANSPOSE tb;
+    float s;
+    std::size_t a;
+    std::size_t b;
+    std::size_t c;
+    std::size_t rows;
+    std::size_t cols;
+    std::size_t epoch;
+    bool output;
+  };
+
+  // One register operation of a fused kernel. Operands are registers,
+  // and loads read a value, repeating it down the rows when broadcast.
+  struct Instr {
+    Op op;
+    bool broadcast;
+    std::uint8_t a;
+    std::uint8_t b;
+    float s;
+    std::size_t value;
+  };
+
+  // A GEMM, an update or a kernel running program[first, last) in tasks
+  // of span elements.
+  struct Step {
+    Op op;
+    std::size_t node;
+    std::size_t first;
+    std::size_t last;
+    std::size_t tasks;
+    std::size_t span;
+  };
+
+  const std::size_t record(const Op, const std::size_t, const std::size_t,
+                           const float, const std::size_t,
+                           const std::size_t);
+  const std::size_t binary(const Op, const std::size_t, const std::size_t);
+  const std::size_t unary(const Op, const std::size_t, const float);
+  const std::uint8_t emit(const std::size_t, const std::size_t,
+                          const std::vector<bool>&);
+  void execute(const Step&, const std::size_t, const std::size_t) const;
+
+  std::vector<Node> nodes;
+  std::vector<Matrixf> values;
+  std::vector<Instr> program;
+  std::vector<Step> steps;
+  std::vector<float> memory;
+  std::size_t epoch;
+  bool compiled;
+};
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_GRAPH_HPP__
@@ -0,0 +1,69 @@
+/******************************************************************************
+ *
+ * laplus/half.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_HALF_HPP__
+#define __LAPLUS_HALF_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace laplus {
+
+// IEEE 754 binary16 storage. Arithmetic is done after widening to float.
+struct half {
+  half() : bits(0) {}
+  explicit half(const float);
+  operator float() const;
+
+  std::uint16_t bits;
+};
+
+// The upper 16 bits of an IEEE 754 binary32 value.
+struct bfloat16 {
+  bfloat16() : bits(0) {}
+  explicit bfloat16(const float);
+  operator float() const;
+
+  std::uint16_t bits;
+};
+
+std::ostream& operator<<(std::ostream&, const half&);
+std::ostream& operator<<(std::ostream&, const bfloat16&);
+
+// Bulk conversions, rounding to nearest even. These pick F16C and
+// AVX-512 BF16 kernels at run time when the CPU supports them.
+void convert(const half*, float*, const std::size_t);
+void convert(const float*, half*, const std::size_t);
+void convert(const bfloat16*, float*, const std::size_t);
+void convert(const float*, bfloat16*, const std::size_t);
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_HALF_HPP__
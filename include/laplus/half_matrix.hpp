@@ -0,0 +1,154 @@
+/******************************************************************************
+ *
+ * laplus/half_matrix.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_HALF_MATRIX_HPP__
+#define __LAPLUS_HALF_MATRIX_HPP__
+
+#include "laplus/internal/shared_array.hpp"
+#include "laplus/half.hpp"
+#include "laplus/matrixf.hpp"
+
+#include <functional>
+#include <ostream>
+#include <utility>
+#include "cblas.h"
+
+namespace laplus {
+
+// Matrix stored in 16-bit floating point. Every operation widens the
+// elements to float, computes in float and narrows the result back.
+template<typename H>
+class HalfMatrix : public internal::SharedArray<H> {
+public:
+  // Constructors and Destructor
+  HalfMatrix()=delete;
+  HalfMatrix(const std::size_t, const std::size_t);
+  explicit HalfMatrix(const Matrixf&);
+  HalfMatrix(const HalfMatrix&);
+  HalfMatrix(HalfMatrix&&) noexcept;
+  virtual ~HalfMatrix();
+
+  // Assignment Operators
+  HalfMatrix& operator=(const HalfMatrix&);
+  HalfMatrix& operator=(HalfMatrix&&) noexcept;
+
+  HalfMatrix& operator+=(const HalfMatrix&);
+  HalfMatrix& operator-=(const HalfMatrix&);
+  HalfMatrix& operator*=(const HalfMatrix&);
+  HalfMatrix& operator/=(const HalfMatrix&);
+
+  HalfMatrix& operator+=(const float);
+  HalfMatrix& operator*=(const float);
+
+  // Arithmetic Operators
+  HalfMatrix operator+(const HalfMatrix&) const;
+  HalfMatrix operator-(const HalfMatrix&) const;
+  HalfMatrix operator*(const HalfMatrix&) const;
+  HalfMatrix operator/(const HalfMatrix&) const;
+
+  HalfMatrix operator+(const float) const;
+  HalfMatrix operator*(const float) const;
+
+  // Miscellaneous Operators
+  const float operator()(const std::size_t, const std::size_t) const;
+
+  // Utilities
+  template<typename U>
+  friend void swap(HalfMatrix<U>&, HalfMatrix<U>&);
+  HalfMatrix clone() const;
+  HalfMatrix transpose() const;
+  Matrixf widen() const;
+  void set(const std::size_t, const std::size_t, const float);
+
+  // Accessors
+  const std::size_t rows() const;
+  const std::size_t cols() const;
+  const std::size_t ldim() const;
+  const CBLAS_ORDER layout() const;
+  H* const data() const;
+
+  // Arithmetic Functions
+  void axpy(const float, const HalfMatrix&);
+  void scal(const float);
+
+  void add_inplace(const HalfMatrix&);
+  void sub_inplace(const HalfMatrix&);
+  void mul_inplace(const HalfMatrix&);
+  void div_inplace(const HalfMatrix&);
+
+  void add_inplace(const float);
+  void mul_inplace(const float);
+
+  void apply_inplace(const std::function<float(float)>&);
+  HalfMatrix apply(const std::function<float(float)>&) const;
+private:
+  template<typename F>
+  void binary_inplace(const HalfMatrix&, const F&);
+  template<typename F>
+  void unary_inplace(const F&);
+
+  std::pair<std::size_t, std::size_t> shape;
+  CBLAS_TRANSPOSE trans;
+};
+
+using Matrixh = HalfMatrix<half>;
+using Matrixbf = HalfMatrix<bfloat16>;
+
+template<typename H>
+std::ostream& operator<<(std::ostream&, const HalfMatrix<H>&);
+
+// Mixed Precision BLAS
+// C = alpha * A * B + beta * C where either operand may be stored in half
+// precision. Panels are widened to float while packing and the products
+// are accumulated in float.
+void gemm(const float, const Matrixh&, const Matrixh&, const float,
+          const Matrixf&);
+void gemm(const float, const Matrixf&, const Matrixh&, const float,
+          const Matrixf&);
+void gemm(const float, const Matrixh&, const Matrixf&, const float,
+          const Matrixf&);
+
+void gemm(const float, const Matrixbf&, const Matrixbf&, const float,
+          const Matrixf&);
+void gemm(const float, const Matrixf&, const Matrixbf&, const float,
+          const Matrixf&);
+void gemm(const float, const Matrixbf&, const Matrixf&, const float,
+          const Matrixf&);
+
+Matrixf dot(const Matrixh&, const Matrixh&);
+Matrixf dot(const Matrixf&, const Matrixh&);
+Matrixf dot(const Matrixh&, const Matrixf&);
+
+Matrixf dot(const Matrixbf&, const Matrixbf&);
+Matrixf dot(const Matrixf&, const Matrixbf&);
+Matrixf dot(const Matrixbf&, const Matrixf&);
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_HALF_MATRIX_HPP__
@@ -31,6 +31,9 @@
 
 #include "laplus/internal/array.hpp"
 #include "laplus/internal/shared_array.hpp"
+#include "laplus/internal/blas.hpp"
+#include "laplus/internal/simd.hpp"
+#include "laplus/internal/parallel.hpp"
 
 #endif
 
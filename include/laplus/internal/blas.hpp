@@ -0,0 +1,280 @@
+/******************************************************************************
+ *
+ * laplus/internal/blas.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_INTERNAL_BLAS_HPP__
+#define __LAPLUS_INTERNAL_BLAS_HPP__
+
+#include <cstddef>
+#include "cblas.h"
+
+namespace laplus {
+namespace internal {
+
+// Maps an element type onto the matching family of CBLAS routines.
+template<typename T>
+struct blas;
+
+template<>
+struct blas<float> {
+  // Level 1 BLAS
+  static void swap(const int n, float* x, const int incx,
+                   float* y, const int incy)
+  { cblas_sswap(n, x, incx, y, incy); }
+
+  static void scal(const int n, const float alpha, float* x, const int incx)
+  { cblas_sscal(n, alpha, x, incx); }
+
+  static void copy(const int n, const float* x, const int incx,
+                   float* y, const int incy)
+  { cblas_scopy(n, x, incx, y, incy); }
+
+  static void axpy(const int n, const float alpha,
+                   const float* x, const int incx, float* y, const int incy)
+  { cblas_saxpy(n, alpha, x, incx, y, incy); }
+
+  static float dot(const int n, const float* x, const int incx,
+                   const float* y, const int incy)
+  { return cblas_sdot(n, x, incx, y, incy); }
+
+  static float nrm2(const int n, const float* x, const int incx)
+  { return cblas_snrm2(n, x, incx); }
+
+  static float asum(const int n, const float* x, const int incx)
+  { return cblas_sasum(n, x, incx); }
+
+  static std::size_t iamax(const int n, const float* x, const int incx)
+  { return cblas_isamax(n, x, incx); }
+
+  // Level 2 BLAS
+  static void gemv(const CBLAS_ORDER order, const CBLAS_TRANSPOSE trans,
+                   const int m, const int n, const float alpha,
+                   const float* a, const int lda, const float* x,
+                   const int incx, const float beta, float* y, const int incy)
+  { cblas_sgemv(order, trans, m, n, alpha, a, lda, x, incx, beta, y, incy); }
+
+  static void symv(const CBLAS_ORDER order, const CBLAS_UPLO uplo,
+                   const int n, const float alpha,
+                   const float* a, const int lda, const float* x,
+                   const int incx, const float beta, float* y, const int incy)
+  { cblas_ssymv(order, uplo, n, alpha, a, lda, x, incx, beta, y, incy); }
+
+  static void trmv(const CBLAS_ORDER order, const CBLAS_UPLO uplo,
+                   const CBLAS_TRANSPOSE trans, const CBLAS_DIAG diag,
+                   const int n, const float* a, const int lda,
+                   float* x, const int incx)
+  { cblas_strmv(order, uplo, trans, diag, n, a, lda, x, incx); }
+
+  static void trsv(const CBLAS_ORDER order, const CBLAS_UPLO uplo,
+                   const CBLAS_TRANSPOSE trans, const CBLAS_DIAG diag,
+                   const int n, const float* a, const int lda,
+                   float* x, const int incx)
+  { cblas_strsv(order, uplo, trans, diag, n, a, lda, x, incx); }
+
+  static void ger(const CBLAS_ORDER order, const int m, const int n,
+                  const float alpha, const float* x, const int incx,
+                  const float* y, const int incy, float* a, const int lda)
+  { cblas_sger(order, m, n, alpha, x, incx, y, incy, a, lda); }
+
+  static void syr(const CBLAS_ORDER order, const CBLAS_UPLO uplo,
+                  const int n, const float alpha, const float* x,
+                  const int incx, float* a, const int lda)
+  { cblas_ssyr(order, uplo, n, alpha, x, incx, a, lda); }
+
+  static void syr2(const CBLAS_ORDER order, const CBLAS_UPLO uplo,
+                   const int n, const float alpha, const float* x,
+                   const int incx, const float* y, const int incy,
+                   float* a, const int lda)
+  { cblas_ssyr2(order, uplo, n, alpha, x, incx, y, incy, a, lda); }
+
+  // Level 3 BLAS
+  static void gemm(const CBLAS_ORDER order, const CBLAS_TRANSPOSE transa,
+                   const CBLAS_TRANSPOSE transb,
+                   const int m, const int n, const int k, const float alpha,
+                   const float* a, const int lda, const float* b,
+                   const int ldb, const float beta, float* c, const int ldc)
+  { cblas_sgemm(order, transa, transb, m, n, k,
+                alpha, a, lda, b, ldb, beta, c, ldc); }
+
+  static void symm(const CBLAS_ORDER order, const CBLAS_SIDE side,
+                   const CBLAS_UPLO uplo, const int m, const int n,
+                   const float alpha, const float* a, const int lda,
+                   const float* b, const int ldb,
+                   const float beta, float* c, const int ldc)
+  { cblas_ssymm(order, side, uplo, m, n, alpha, a, lda, b, ldb, beta, c, ldc); }
+
+  static void syrk(const CBLAS_ORDER order, const CBLAS_UPLO uplo,
+                   const CBLAS_TRANSPOSE trans, const int n, const int k,
+                   const float alpha, const float* a, const int lda,
+                   const float beta, float* c, const int ldc)
+  { cblas_ssyrk(order, uplo, trans, n, k, alpha, a, lda, beta, c, ldc); }
+
+  static void syr2k(const CBLAS_ORDER order, const CBLAS_UPLO uplo,
+                    const CBLAS_TRANSPOSE trans, const int n, const int k,
+                    const float alpha, const float* a, const int lda,
+                    const float* b, const int ldb,
+                    const float beta, float* c, const int ldc)
+  { cblas_ssyr2k(order, uplo, trans, n, k,
+                 alpha, a, lda, b, ldb, beta, c, ldc); }
+
+  static void trmm(const CBLAS_ORDER order, const CBLAS_SIDE side,
+                   const CBLAS_UPLO uplo, const CBLAS_TRANSPOSE trans,
+                   const CBLAS_DIAG diag, const int m, const int n,
+                   const float alpha, const float* a, const int lda,
+                   float* b, const int ldb)
+  { cblas_strmm(order, side, uplo, trans, diag, m, n, alpha, a, lda, b, ldb); }
+
+  static void trsm(const CBLAS_ORDER order, const CBLAS_SIDE side,
+                   const CBLAS_UPLO uplo, const CBLAS_TRANSPOSE trans,
+                   const CBLAS_DIAG diag, const int m, const int n,
+                   const float alpha, const float* a, const int lda,
+                   float* b, const int ldb)
+  { cblas_strsm(order, side, uplo, trans, diag, m, n, alpha, a, lda, b, ldb); }
+};
+
+template<>
+struct blas<double> {
+  // Level 1 BLAS
+  static void swap(const int n, double* x, const int incx,
+                   double* y, const int incy)
+  { cblas_dswap(n, x, incx, y, incy); }
+
+  static void scal(const int n, const double alpha, double* x, const int incx)
+  { cblas_dscal(n, alpha, x, incx); }
+
+  static void copy(const int n, const double* x, const int incx,
+                   double* y, const int incy)
+  { cblas_dcopy(n, x, incx, y, incy); }
+
+  static void axpy(const int n, const double alpha,
+                   const double* x, const int incx, double* y, const int incy)
+  { cblas_daxpy(n, alpha, x, incx, y, incy); }
+
+  static double dot(const int n, const double* x, const int incx,
+                    const double* y, const int incy)
+  { return cblas_ddot(n, x, incx, y, incy); }
+
+  static double nrm2(const int n, const double* x, const int incx)
+  { return cblas_dnrm2(n, x, incx); }
+
+  static double asum(const int n, const double* x, const int incx)
+  { return cblas_dasum(n, x, incx); }
+
+  static std::size_t iamax(const int n, const double* x, const int incx)
+  { return cblas_idamax(n, x, incx); }
+
+  // Level 2 BLAS
+  static void gemv(const CBLAS_ORDER order, const CBLAS_TRANSPOSE trans,
+                   const int m, const int n, const double alpha,
+                   const double* a, const int lda, const double* x,
+                   const int incx, const double beta, double* y, const int incy)
+  { cblas_dgemv(order, trans, m, n, alpha, a, lda, x, incx, beta, y, incy); }
+
+  static void symv(const CBLAS_ORDER order, const CBLAS_UPLO uplo,
+                   const int n, const double alpha,
+                   const double* a, const int lda, const double* x,
+                   const int incx, const double beta, double* y, const int incy)
+  { cblas_dsymv(order, uplo, n, alpha, a, lda, x, incx, beta, y, incy); }
+
+  static void trmv(const CBLAS_ORDER order, const CBLAS_UPLO uplo,
+                   const CBLAS_TRANSPOSE trans, const CBLAS_DIAG diag,
+                   const int n, const double* a, const int lda,
+                   double* x, const int incx)
+  { cblas_dtrmv(order, uplo, trans, diag, n, a, lda, x, incx); }
+
+  static void trsv(const CBLAS_ORDER order, const CBLAS_UPLO uplo,
+                   const CBLAS_TRANSPOSE trans, const CBLAS_DIAG diag,
+                   const int n, const double* a, const int lda,
+                   double* x, const int incx)
+  { cblas_dtrsv(order, uplo, trans, diag, n, a, lda, x, incx); }
+
+  static void ger(const CBLAS_ORDER order, const int m, const int n,
+                  const double alpha, const double* x, const int incx,
+                  const double* y, const int incy, double* a, const int lda)
+  { cblas_dger(order, m, n, alpha, x, incx, y, incy, a, lda); }
+
+  static void syr(const CBLAS_ORDER order, const CBLAS_UPLO uplo,
+                  const int n, const double alpha, const double* x,
+                  const int incx, double* a, const int lda)
+  { cblas_dsyr(order, uplo, n, alpha, x, incx, a, lda); }
+
+  static void syr2(const CBLAS_ORDER order, const CBLAS_UPLO uplo,
+                   const int n, const double alpha, const double* x,
+                   const int incx, const double* y, const int incy,
+                   double* a, const int lda)
+  { cblas_dsyr2(order, uplo, n, alpha, x, incx, y, incy, a, lda); }
+
+  // Level 3 BLAS
+  static void gemm(const CBLAS_ORDER order, const CBLAS_TRANSPOSE transa,
+                   const CBLAS_TRANSPOSE transb,
+                   const int m, const int n, const int k, const double alpha,
+                   const double* a, const int lda, const double* b,
+                   const int ldb, const double beta, double* c, const int ldc)
+  { cblas_dgemm(order, transa, transb, m, n, k,
+                alpha, a, lda, b, ldb, beta, c, ldc); }
+
+  static void symm(const CBLAS_ORDER order, const CBLAS_SIDE side,
+                   const CBLAS_UPLO uplo, const int m, const int n,
+                   const double alpha, const double* a, const int lda,
+                   const double* b, const int ldb,
+                   const double beta, double* c, const int ldc)
+  { cblas_dsymm(order, side, uplo, m, n, alpha, a, lda, b, ldb, beta, c, ldc); }
+
+  static void syrk(const CBLAS_ORDER order, const CBLAS_UPLO uplo,
+                   const CBLAS_TRANSPOSE trans, const int n, const int k,
+                   const double alpha, const double* a, const int lda,
+                   const double beta, double* c, const int ldc)
+  { cblas_dsyrk(order, uplo, trans, n, k, alpha, a, lda, beta, c, ldc); }
+
+  static void syr2k(const CBLAS_ORDER order, const CBLAS_UPLO uplo,
+                    const CBLAS_TRANSPOSE trans, const int n, const int k,
+                    const double alpha, const double* a, const int lda,
+                    const double* b, const int ldb,
+                    const double beta, double* c, const int ldc)
+  { cblas_dsyr2k(order, uplo, trans, n, k,
+                 alpha, a, lda, b, ldb, beta, c, ldc); }
+
+  static void trmm(const CBLAS_ORDER order, const CBLAS_SIDE side,
+                   const CBLAS_UPLO uplo, const CBLAS_TRANSPOSE trans,
+                   const CBLAS_DIAG diag, const int m, const int n,
+                   const double alpha, const double* a, const int lda,
+                   double* b, const int ldb)
+  { cblas_dtrmm(order, side, uplo, trans, diag, m, n, alpha, a, lda, b, ldb); }
+
+  static void trsm(const CBLAS_ORDER order, const CBLAS_SIDE side,
+                   const CBLAS_UPLO uplo, const CBLAS_TRANSPOSE trans,
+                   const CBLAS_DIAG diag, const int m, const int n,
+                   const double alpha, const double* a, const int lda,
+                   double* b, const int ldb)
+  { cblas_dtrsm(order, side, uplo, trans, diag, m, n, alpha, a, lda, b, ldb); }
+};
+
+}  // namespace internal
+}  // namespace laplus
+
+#endif  // __LAPLUS_INTERNAL_BLAS_HPP__
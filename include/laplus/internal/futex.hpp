@@ -0,0 +1,52 @@
+/******************************************************************************
+ *
+ * laplus/internal/futex.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_INTERNAL_FUTEX_HPP__
+#define __LAPLUS_INTERNAL_FUTEX_HPP__
+
+#include <atomic>
+#include <cstdint>
+
+namespace laplus {
+namespace internal {
+
+// Waiting on 32-bit words that may live in memory shared between
+// processes. On Linux the waiters sleep on a futex; elsewhere they yield.
+
+// Returns once word no longer holds value, spinning briefly before going to
+// sleep.
+void wait_while(const std::atomic<std::uint32_t>&, const std::uint32_t);
+
+// Wakes every thread waiting on word.
+void wake_all(std::atomic<std::uint32_t>&);
+
+}  // namespace internal
+}  // namespace laplus
+
+#endif  // __LAPLUS_INTERNAL_FUTEX_HPP__
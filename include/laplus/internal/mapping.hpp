@@ -0,0 +1,56 @@
+/******************************************************************************
+ *
+ * laplus/internal/mapping.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_INTERNAL_MAPPING_HPP__
+#define __LAPLUS_INTERNAL_MAPPING_HPP__
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace laplus {
+namespace internal {
+
+// Maps a whole file privately, so that writes through the mapping stay in
+// this process. Returns nullptr when the file cannot be opened, is empty
+// or cannot be mapped; otherwise stores the file size in the second
+// argument. The mapping is released together with the last reference.
+std::shared_ptr<char> map_file(const std::string&, std::size_t&);
+
+// Maps a named POSIX shared memory object of the given length so that
+// writes are seen by every process mapping it. The creating process
+// replaces any object of that name with a zero filled one; the others wait
+// until it exists with at least that length. Returns nullptr on failure.
+// Release the mapping with munmap() and the name with shm_unlink().
+void* map_shared(const std::string&, const std::size_t, const bool);
+
+}  // namespace internal
+}  // namespace laplus
+
+#endif  // __LAPLUS_INTERNAL_MAPPING_HPP__
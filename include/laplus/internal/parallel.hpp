@@ -0,0 +1,68 @@
+/******************************************************************************
+ *
+ * laplus/internal/parallel.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_INTERNAL_PARALLEL_HPP__
+#define __LAPLUS_INTERNAL_PARALLEL_HPP__
+
+#include <cstddef>
+#include <functional>
+
+namespace laplus {
+namespace internal {
+
+// Elements per task of the elementwise kernels, large enough that the cost
+// of handing a chunk to a worker stays small next to the work in it.
+const std::size_t grain = 1 << 14;
+
+// Number of threads taking part in parallel regions, including the caller.
+// Defaults to std::thread::hardware_concurrency() and can be overridden with
+// the LAPLUS_NUM_THREADS environment variable.
+const std::size_t concurrency();
+
+// Replaces the worker pool with one of the given number of threads, or the
+// default when zero. Must not be called while parallel regions are running.
+void set_concurrency(const std::size_t);
+
+// Runs task(i) for every i in [0, tasks) on the shared worker pool and
+// returns once all of them have finished. Calls made from inside a running
+// task are executed serially on the calling thread.
+void parallel_run(const std::size_t tasks,
+                  const std::function<void(const std::size_t)>& task);
+
+// Splits [begin, end) into contiguous chunks of at least grain elements and
+// runs body(chunk_begin, chunk_end) for each of them in parallel.
+void parallel_for(const std::size_t begin, const std::size_t end,
+                  const std::size_t grain,
+                  const std::function<void(const std::size_t,
+                                           const std::size_t)>& body);
+
+}  // namespace internal
+}  // namespace laplus
+
+#endif  // __LAPLUS_INTERNAL_PARALLEL_HPP__
@@ -45,6 +45,8 @@ class SharedArray : public Array<T> {
 public:
   SharedArray(const std::size_t);
   SharedArray(const std::vector<T>&);
+  SharedArray(std::vector<T>&&);
+  SharedArray(const std::shared_ptr<T>&, const std::size_t);
   SharedArray(const SharedArray&);
   SharedArray(SharedArray&&) noexcept;
   virtual ~SharedArray();
@@ -58,6 +58,24 @@ SharedArray<T>::SharedArray(const std::vector<T>& values)
   std::copy(values.begin(), values.end(), this->get());
 }
 
+// Takes over the buffer of the vector without copying it.
+template<typename T>
+SharedArray<T>::SharedArray(std::vector<T>&& values)
+  : shared(nullptr), Array<T>()
+{
+  const std::shared_ptr<std::vector<T>> owner =
+      std::make_shared<std::vector<T>>(std::move(values));
+  shared = std::shared_ptr<T>(owner, owner->data());
+  Array<T>::set(shared.get(), owner->size());
+}
+
+// Shares ownership of externally managed storage.
+template<typename T>
+SharedArray<T>::SharedArray(const std::shared_ptr<T>& storage,
+                            const std::size_t size)
+  : shared(storage), Array<T>(storage.get(), size)
+{}
+
 template<typename T>
 SharedArray<T>::SharedArray(const SharedArray<T>& other)
   : shared(other.shared), Array<T>(other)
@@ -0,0 +1,89 @@
+/******************************************************************************
+ *
+ * laplus/internal/simd.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_INTERNAL_SIMD_HPP__
+#define __LAPLUS_INTERNAL_SIMD_HPP__
+
+#include <cstddef>
+
+#include <immintrin.h>
+
+namespace laplus {
+namespace internal {
+
+// Thin wrappers around the 256-bit AVX registers for each element type.
+template<typename T>
+struct simd;
+
+template<>
+struct simd<float> {
+  using type = __m256;
+  static const std::size_t width = 8;
+
+  static type load(const float* p) { return _mm256_loadu_ps(p); }
+  static void store(float* p, const type v) { _mm256_storeu_ps(p, v); }
+  static type set1(const float x) { return _mm256_set1_ps(x); }
+  static type add(const type a, const type b) { return _mm256_add_ps(a, b); }
+  static type sub(const type a, const type b) { return _mm256_sub_ps(a, b); }
+  static type mul(const type a, const type b) { return _mm256_mul_ps(a, b); }
+  static type div(const type a, const type b) { return _mm256_div_ps(a, b); }
+  static type max(const type a, const type b) { return _mm256_max_ps(a, b); }
+  static type sqrt(const type a) { return _mm256_sqrt_ps(a); }
+};
+
+template<>
+struct simd<double> {
+  using type = __m256d;
+  static const std::size_t width = 4;
+
+  static type load(const double* p) { return _mm256_loadu_pd(p); }
+  static void store(double* p, const type v) { _mm256_storeu_pd(p, v); }
+  static type set1(const double x) { return _mm256_set1_pd(x); }
+  static type add(const type a, const type b) { return _mm256_add_pd(a, b); }
+  static type sub(const type a, const type b) { return _mm256_sub_pd(a, b); }
+  static type mul(const type a, const type b) { return _mm256_mul_pd(a, b); }
+  static type div(const type a, const type b) { return _mm256_div_pd(a, b); }
+  static type max(const type a, const type b) { return _mm256_max_pd(a, b); }
+  static type sqrt(const type a) { return _mm256_sqrt_pd(a); }
+};
+
+// Whether the processor runs the AVX2 and FMA kernels. These are compiled
+// per function with __attribute__((target("avx2,fma"))) under LAPLUS_AVX2
+// and guarded by this check, so the library still runs on AVX-only hosts.
+inline const bool has_avx2()
+{
+  static const bool supported = __builtin_cpu_supports("avx2")
+                                && __builtin_cpu_supports("fma");
+  return supported;
+}
+
+}  // namespace internal
+}  // namespace laplus
+
+#endif  // __LAPLUS_INTERNAL_SIMD_HPP__
@@ -0,0 +1,75 @@
+/******************************************************************************
+ *
+ * laplus/internal/transpose.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_INTERNAL_TRANSPOSE_HPP__
+#define __LAPLUS_INTERNAL_TRANSPOSE_HPP__
+
+#include <cstddef>
+
+namespace laplus {
+namespace internal {
+
+// Writes the transpose of the rows x cols row-major array at src with
+// leading dimension lds to dst with leading dimension ldd. The arrays are
+// walked in cache sized tiles, split across threads, and each tile is
+// transposed in 8x8 (float) or 4x4 (double) register blocks.
+template<typename T>
+void transpose(const T* const, const std::size_t, T* const,
+               const std::size_t, const std::size_t, const std::size_t);
+
+// Transposes the n x n array at a with leading dimension lda in place by
+// swapping mirrored tiles.
+template<typename T>
+void transpose(T* const, const std::size_t, const std::size_t);
+
+// Update the rows x cols array at a with leading dimension lda elementwise
+// against the transpose of the cols x rows array at b with leading
+// dimension ldb: a(i, j) += alpha * b(j, i), a(i, j) *= b(j, i), and so on.
+// Blocks of b are transposed in registers so neither operand is copied.
+template<typename T>
+void transpose_axpy(const T, const T* const, const std::size_t,
+                    T* const, const std::size_t,
+                    const std::size_t, const std::size_t);
+template<typename T>
+void transpose_mul(const T* const, const std::size_t,
+                   T* const, const std::size_t,
+                   const std::size_t, const std::size_t);
+template<typename T>
+void transpose_div(const T* const, const std::size_t,
+                   T* const, const std::size_t,
+                   const std::size_t, const std::size_t);
+template<typename T>
+void transpose_pow(const T* const, const std::size_t,
+                   T* const, const std::size_t,
+                   const std::size_t, const std::size_t);
+
+}  // namespace internal
+}  // namespace laplus
+
+#endif  // __LAPLUS_INTERNAL_TRANSPOSE_HPP__
@@ -0,0 +1,141 @@
+/******************************************************************************
+ *
+ * laplus/jit.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_JIT_HPP__
+#define __LAPLUS_JIT_HPP__
+
+#include "laplus/matrixf.hpp"
+#include "laplus/vectorf.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace laplus {
+
+namespace internal {
+
+// A node of an expression tree. Leaves read an input or hold a constant;
+// the remaining operations take one (a) or two (a, b) operands.
+struct ExprNode {
+  enum Op : std::uint8_t {
+    Leaf, Constant, Add, Sub, Mul, Div, Min, Max, Neg, Abs, Sqrt, Exp
+  };
+
+  Op op;
+  std::size_t index;
+  float value;
+  std::shared_ptr<const ExprNode> a;
+  std::shared_ptr<const ExprNode> b;
+};
+
+}  // namespace internal
+
+// Runtime elementwise expressions
+// An Expr is a tree over numbered inputs and float constants, built with
+// the operators below or parsed from text such as
+// "max(x0, 0) * x1 + 0.5" or "sigmoid(x0 * 2)". Sigmoid and tanh expand
+// to exp, so every tree reduces to add, sub, mul, div, min, max, neg,
+// abs, sqrt and exp.
+class Expr {
+public:
+  // Generators
+  static Expr Input(const std::size_t);
+  static const bool Parse(const std::string&, Expr&);
+
+  // Constructors and Destructor
+  Expr(const float);
+
+  // Arithmetic Operators
+  Expr operator-() const;
+  friend Expr operator+(const Expr&, const Expr&);
+  friend Expr operator-(const Expr&, const Expr&);
+  friend Expr operator*(const Expr&, const Expr&);
+  friend Expr operator/(const Expr&, const Expr&);
+
+  // Arithmetic Functions
+  Expr min(const Expr&) const;
+  Expr max(const Expr&) const;
+  Expr abs() const;
+  Expr sqrt() const;
+  Expr exp() const;
+  Expr sigmoid() const;
+  Expr tanh() const;
+
+  // Accessors
+  const std::size_t arity() const;
+  const std::string key() const;
+private:
+  friend class JitKernel;
+
+  using Node = internal::ExprNode;
+
+  Expr(const std::shared_ptr<const Node>&);
+  static Expr make(const Node::Op, const Expr&, const Expr&);
+
+  std::shared_ptr<const Node> node;
+};
+
+// A compiled expression. On x86-64 processors with AVX2 the tree is
+// translated to a fused machine code loop, cached process-wide by the
+// structure of the tree so that expressions differing only in their
+// constants share code. Elsewhere, for trees too deep for the registers
+// or for more than 32 inputs, the tree is interpreted.
+class JitKernel {
+public:
+  // Constructors and Destructor
+  JitKernel(const Expr&);
+
+  // Applies the kernel to n elements of each input.
+  void operator()(const float* const* const, float* const,
+                  const std::size_t) const;
+  Vectorf operator()(const std::vector<Vectorf>&) const;
+  Matrixf operator()(const std::vector<Matrixf>&) const;
+
+  // Accessors
+  const std::size_t arity() const;
+  const bool native() const;
+  const void* const entry() const;
+private:
+  struct Code;
+
+  void interpret(const float* const* const, float* const,
+                 const std::size_t) const;
+
+  Expr expr;
+  std::size_t inputs;
+  std::shared_ptr<const Code> code;
+  std::vector<float> constants;
+};
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_JIT_HPP__
@@ -0,0 +1,151 @@
+/******************************************************************************
+ *
+ * laplus/linalg.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_LINALG_HPP__
+#define __LAPLUS_LINALG_HPP__
+
+#include "laplus/vectorf.hpp"
+#include "laplus/matrixf.hpp"
+
+#include <vector>
+#include "cblas.h"
+#include "lapacke.h"
+
+namespace laplus {
+
+// Factorizations overwrite the storage of the given matrix and keep a
+// reference to it, so pass a clone() when the original is still needed.
+// solve_inplace() returns the LAPACK info of the solve, and the solvers
+// that return their result assert that it is zero.
+
+class LU {
+public:
+  LU(const Matrixf&);
+
+  // Accessors
+  const Matrixf& factors() const;
+  const std::vector<lapack_int>& pivots() const;
+  const lapack_int info() const;
+  Matrixf L() const;
+  Matrixf U() const;
+
+  // Solvers
+  const lapack_int solve_inplace(const Matrixf&) const;
+  Matrixf solve(const Matrixf&) const;
+  Vectorf solve(const Vectorf&) const;
+private:
+  Matrixf lu;
+  std::vector<lapack_int> ipiv;
+  lapack_int status;
+};
+
+class Cholesky {
+public:
+  Cholesky(const Matrixf&, const CBLAS_UPLO);
+
+  // Accessors
+  const Matrixf& factors() const;
+  const lapack_int info() const;
+  Matrixf L() const;
+  Matrixf U() const;
+
+  // Solvers
+  const lapack_int solve_inplace(const Matrixf&) const;
+  Matrixf solve(const Matrixf&) const;
+  Vectorf solve(const Vectorf&) const;
+private:
+  Matrixf llt;
+  CBLAS_UPLO uplo;
+  lapack_int status;
+};
+
+class QR {
+public:
+  QR(const Matrixf&);
+
+  // Accessors
+  const Matrixf& factors() const;
+  const Vectorf& reflectors() const;
+  const lapack_int info() const;
+  Matrixf Q() const;
+  Matrixf R() const;
+
+  // Solvers
+  Matrixf solve(const Matrixf&) const;
+  Vectorf solve(const Vectorf&) const;
+private:
+  Matrixf qr;
+  Vectorf tau;
+  lapack_int status;
+};
+
+class SVD {
+public:
+  SVD(const Matrixf&);
+
+  // Accessors
+  const Matrixf& U() const;
+  const Vectorf& S() const;
+  const Matrixf& Vt() const;
+  const lapack_int info() const;
+private:
+  Matrixf u;
+  Vectorf s;
+  Matrixf vt;
+  lapack_int status;
+};
+
+class Eigh {
+public:
+  Eigh(const Matrixf&, const CBLAS_UPLO);
+
+  // Accessors
+  const Vectorf& values() const;
+  const Matrixf& vectors() const;
+  const lapack_int info() const;
+private:
+  Vectorf w;
+  Matrixf v;
+  lapack_int status;
+};
+
+// Decompositions
+LU lu(const Matrixf&);
+Cholesky cholesky(const Matrixf&, const CBLAS_UPLO);
+QR qr(const Matrixf&);
+SVD svd(const Matrixf&);
+Eigh eigh(const Matrixf&, const CBLAS_UPLO);
+
+// Solvers
+Matrixf solve(const Matrixf&, const Matrixf&);
+Matrixf lstsq(const Matrixf&, const Matrixf&);
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_LINALG_HPP__
@@ -0,0 +1,240 @@
+/******************************************************************************
+ *
+ * laplus/matrix.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifndef __LAPLUS_MATRIX_HPP__
+#define __LAPLUS_MATRIX_HPP__
+
+#include "laplus/vector.hpp"
+
+#include <cmath>
+#include <vector>
+#include <ostream>
+#include <functional>
+#include <utility>
+#include "cblas.h"
+
+namespace laplus {
+
+template<typename T>
+class Matrix : public Vector<T> {
+  friend class Vector<T>;
+public:
+  // Generators
+  static Matrix Uniform(const std::size_t, const std::size_t);
+  static Matrix Uniform(const std::size_t, const std::size_t, const T);
+  static Matrix Uniform(const std::size_t, const std::size_t,
+                         const T, const T);
+
+  static Matrix Normal(const std::size_t, const std::size_t);
+  static Matrix Normal(const std::size_t, const std::size_t,
+                        const T, const T);
+
+  static Matrix Identity(const std::size_t);
+
+  // Constructors and Destructor
+  Matrix()=delete;
+  Matrix(const std::size_t, const std::size_t);
+  Matrix(const std::pair<std::size_t, std::size_t>);
+  Matrix(const std::vector<T>&, const std::size_t, const std::size_t);
+  Matrix(std::vector<T>&&, const std::size_t, const std::size_t);
+  Matrix(T* const, const std::size_t, const std::size_t,
+         const std::function<void(T*)>&);
+  Matrix(const std::vector<std::vector<T>>&);
+  Matrix(const Matrix&);
+  Matrix(Matrix&&) noexcept;
+  explicit Matrix(const Vector<T>&);
+  virtual ~Matrix();
+
+  // Assignment Operators
+  Matrix& operator=(const Matrix&);
+  Matrix& operator=(Matrix&&) noexcept;
+
+  Matrix& operator+=(const Matrix&);
+  Matrix& operator-=(const Matrix&);
+  Matrix& operator*=(const Matrix&);
+  Matrix& operator/=(const Matrix&);
+  Matrix& operator^=(const Matrix&);
+
+  Matrix& operator+=(const T);
+  Matrix& operator-=(const T);
+  Matrix& operator*=(const T);
+  Matrix& operator/=(const T);
+  Matrix& operator^=(const T);
+
+  // Arithmetic Operators
+  Matrix operator+() const;
+  Matrix operator-() const;
+
+  Matrix operator+(const Matrix&) const;
+  Matrix operator-(const Matrix&) const;
+  Matrix operator*(const Matrix&) const;
+  Matrix operator/(const Matrix&) const;
+  Matrix operator^(const Matrix&) const;
+
+  Matrix operator+(const T) const;
+  Matrix operator-(const T) const;
+  Matrix operator*(const T) const;
+  Matrix operator/(const T) const;
+  Matrix operator^(const T) const;
+
+  // Miscellaneous Operators
+  const Vector<T> operator[](const std::size_t) const;
+  T& operator()(const std::size_t, const std::size_t) const;
+
+  // Utilities
+  template<typename U>
+  friend void swap(Matrix<U>&, Matrix<U>&);
+  Matrix clone() const;
+  Matrix transpose() const;
+  Matrix transpose_copy() const;
+  Matrix materialize() const;
+  Matrix row_major() const;
+  void transpose_inplace();
+  Matrix reshape(const std::size_t, const std::size_t) const;
+
+  // Accessors
+  const std::size_t rows() const;
+  const std::size_t cols() const;
+  const std::size_t ldim() const;
+  const CBLAS_ORDER layout() const;
+  const Vector<T> row(const std::size_t) const;
+  const Vector<T> col(const std::size_t) const;
+
+  void set_row(const std::size_t, const Vector<T>&);
+  void set_col(const std::size_t, const Vector<T>&);
+
+  // Level 1 BLAS
+  using Vector<T>::axpy;
+  void axpy(const T, const Matrix&);
+
+  // Level 2 BLAS
+  void ger(const T, const Vector<T>&, const Vector<T>&);
+  void syr(const CBLAS_UPLO, const T, const Vector<T>&);
+  void syr2(const CBLAS_UPLO, const T, const Vector<T>&, const Vector<T>&);
+
+  // Level 3 BLAS
+  void gemm(const T, const Matrix&, const Matrix&, const T);
+  void symm(const CBLAS_SIDE, const CBLAS_UPLO,
+            const T, const Matrix&, const Matrix&, const T);
+  void syrk(const CBLAS_UPLO, const T, const Matrix&, const T);
+  void syr2k(const CBLAS_UPLO, const T,
+             const Matrix&, const Matrix&, const T);
+  void trmm(const CBLAS_SIDE, const CBLAS_UPLO, const CBLAS_DIAG,
+            const T, const Matrix&);
+  void trsm(const CBLAS_SIDE, const CBLAS_UPLO, const CBLAS_DIAG,
+            const T, const Matrix&);
+
+  // Arithmetic Functions
+  using Vector<T>::mul_inplace;
+  using Vector<T>::div_inplace;
+  using Vector<T>::pow_inplace;
+  void mul_inplace(const Matrix&);
+  void div_inplace(const Matrix&);
+  void pow_inplace(const Matrix&);
+
+  Matrix mul(const Matrix&) const;
+  Matrix div(const Matrix&) const;
+  Matrix pow(const Matrix&) const;
+
+  Matrix add(const T) const;
+  Matrix sub(const T) const;
+  Matrix mul(const T) const;
+  Matrix div(const T) const;
+  Matrix pow(const T) const;
+
+  Matrix log() const;
+
+  Matrix apply(const std::function<T(T)>&);
+
+  // Extensions
+  const T maxCoeff() const;
+  const T minCoeff() const;
+
+  const T maxCoeff(std::size_t&, std::size_t&) const;
+  const T minCoeff(std::size_t&, std::size_t&) const;
+
+  // Linear Algebra
+  Matrix dot(const Matrix&) const;
+  Vector<T> dot(const Vector<T>&) const;
+  void dot(const Matrix&, const Matrix&);
+private:
+  // Layout Helpers
+  const bool mixed(const Matrix&) const;
+  const CBLAS_TRANSPOSE relative(const Matrix&) const;
+  const CBLAS_UPLO relative(const Matrix&, const CBLAS_UPLO) const;
+  Matrix aligned(const Matrix&) const;
+  const Vector<T> view(const std::size_t, const std::size_t,
+                       const std::size_t) const;
+
+  std::pair<std::size_t, std::size_t> shape;
+  CBLAS_TRANSPOSE trans;
+};
+
+// Non-member functions
+template<typename T>
+Matrix<T> operator+(const typename Matrix<T>::value_type&, const Matrix<T>&);
+template<typename T>
+Matrix<T> operator-(const typename Matrix<T>::value_type&, const Matrix<T>&);
+template<typename T>
+Matrix<T> operator*(const typename Matrix<T>::value_type&, const Matrix<T>&);
+template<typename T>
+Matrix<T> operator/(const typename Matrix<T>::value_type&, const Matrix<T>&);
+template<typename T>
+Matrix<T> operator^(const typename Matrix<T>::value_type&, const Matrix<T>&);
+
+template<typename T>
+std::ostream& operator<<(std::ostream&, const Matrix<T>&);
+
+template<typename T>
+const bool operator==(const Matrix<T>&, const Matrix<T>&);
+template<typename T>
+const bool operator!=(const Matrix<T>&, const Matrix<T>&);
+
+template<typename T>
+const bool operator==(const Matrix<T>&, const std::vector<T>&);
+template<typename T>
+const bool operator!=(const Matrix<T>&, const std::vector<T>&);
+
+template<typename T>
+const bool operator==(const std::vector<T>&, const Matrix<T>&);
+template<typename T>
+const bool operator!=(const std::vector<T>&, const Matrix<T>&);
+
+template<typename T>
+const bool operator==(const Matrix<T>&, const std::vector<std::vector<T>>&);
+template<typename T>
+const bool operator!=(const Matrix<T>&, const std::vector<std::vector<T>>&);
+
+template<typename T>
+const bool operator==(const std::vector<std::vector<T>>&, const Matrix<T>&);
+template<typename T>
+const bool operator!=(const std::vector<std::vector<T>>&, const Matrix<T>&);
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_MATRIX_HPP__
@@ -0,0 +1,100 @@
+/******************************************************************************
+ *
+ * laplus/nn.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_NN_HPP__
+#define __LAPLUS_NN_HPP__
+
+#include "laplus/conv.hpp"
+#include "laplus/matrixf.hpp"
+#include "laplus/tensor.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace laplus {
+
+// Pooling
+// Windows are clipped to the image, so padded taps are ignored by max
+// pooling and excluded from the average of average pooling.
+struct PoolParams {
+  ConvLayout layout;
+  std::size_t kernel_h;
+  std::size_t kernel_w;
+  std::size_t stride_h;
+  std::size_t stride_w;
+  std::size_t pad_h;
+  std::size_t pad_w;
+};
+
+Tensorf max_pool2d(const Tensorf&, const PoolParams&);
+Tensorf max_pool2d_backward(const Tensorf&, const Tensorf&,
+                            const PoolParams&);
+Tensorf avg_pool2d(const Tensorf&, const PoolParams&);
+Tensorf avg_pool2d_backward(const Tensorf&, const dims_t&, const PoolParams&);
+
+// Normalization
+// batch_norm normalizes every column over the rows of a batch and
+// layer_norm every row over its columns; both then scale and shift each
+// column by gamma and beta. The mean and reciprocal standard deviation of
+// each group are computed in a single pass and saved for the backward
+// pass; batch_norm can also be applied with given statistics for
+// inference.
+struct NormStats {
+  std::vector<float> mean;
+  std::vector<float> rstd;
+};
+
+struct NormGrads {
+  Matrixf dx;
+  Vectorf dgamma;
+  Vectorf dbeta;
+};
+
+Matrixf batch_norm(const Matrixf&, const Vectorf&, const Vectorf&,
+                   const float, NormStats&);
+Matrixf batch_norm(const Matrixf&, const Vectorf&, const Vectorf&,
+                   const NormStats&);
+NormGrads batch_norm_backward(const Matrixf&, const Matrixf&, const Vectorf&,
+                              const NormStats&);
+
+Matrixf layer_norm(const Matrixf&, const Vectorf&, const Vectorf&,
+                   const float, NormStats&);
+NormGrads layer_norm_backward(const Matrixf&, const Matrixf&, const Vectorf&,
+                              const NormStats&);
+
+// Dropout
+// Zeroes each element with probability rate and scales the rest by
+// 1 / (1 - rate). The mask is a hash of the seed and the element index, so
+// the backward pass regenerates it instead of storing it.
+Matrixf dropout(const Matrixf&, const float, const std::uint64_t);
+Matrixf dropout_backward(const Matrixf&, const float, const std::uint64_t);
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_NN_HPP__
@@ -0,0 +1,65 @@
+/******************************************************************************
+ *
+ * laplus/npy.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_NPY_HPP__
+#define __LAPLUS_NPY_HPP__
+
+#include "laplus/vector.hpp"
+#include "laplus/matrix.hpp"
+
+#include <map>
+#include <string>
+
+namespace laplus {
+
+// NumPy .npy files and uncompressed .npz archives of arrays with at most
+// two dimensions. One dimensional arrays load as a single row. C and
+// Fortran order map to row-major and transposed matrices.
+//
+// Loading maps the file privately. Arrays stored as little-endian T at a
+// suitably aligned offset are returned as views of the mapping; boolean,
+// integer, half and other floating point arrays are converted. Loaders
+// return false and leave the output untouched when the file cannot be
+// read or holds an unsupported array.
+template<typename T>
+const bool load_npy(const std::string&, Matrix<T>&);
+template<typename T>
+const bool load_npz(const std::string&, std::map<std::string, Matrix<T>>&);
+
+template<typename T>
+const bool save_npy(const std::string&, const Vector<T>&);
+template<typename T>
+const bool save_npy(const std::string&, const Matrix<T>&);
+template<typename T>
+const bool save_npz(const std::string&,
+                    const std::map<std::string, Matrix<T>>&);
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_NPY_HPP__
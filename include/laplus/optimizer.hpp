@@ -0,0 +1,102 @@
+/******************************************************************************
+ *
+ * laplus/optimizer.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_OPTIMIZER_HPP__
+#define __LAPLUS_OPTIMIZER_HPP__
+
+#include "laplus/matrixf.hpp"
+#include "laplus/vectorf.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace laplus {
+
+// Optimizers
+// Every step updates a parameter and its moment buffers in one fused
+// read-modify-write pass. Weight decay is added to the gradient, except
+// for AdamW which decays the weights directly. RMSProp uses beta2 as its
+// smoothing constant and momentum for its optional velocity buffer.
+enum OptimizerAlgorithm {
+  OptimizerSGD,
+  OptimizerAdam,
+  OptimizerAdamW,
+  OptimizerRMSProp
+};
+
+struct OptimizerParams {
+  OptimizerAlgorithm algorithm;
+  float lr;
+  float momentum;
+  float beta1;
+  float beta2;
+  float eps;
+  float weight_decay;
+  bool nesterov;
+};
+
+class Optimizer {
+public:
+  // Constructors and Destructor
+  Optimizer(const OptimizerParams&);
+
+  // Registers a parameter of the given size and returns the slot that
+  // identifies its buffers in step().
+  const std::size_t add(const Vectorf&);
+
+  // Applies the gradient to the parameter of a slot.
+  void step(const std::size_t, Vectorf&, const Vectorf&);
+  void step(const std::size_t, Matrixf&, const Matrixf&);
+
+  // Applies the gradient a.dot(b) without a temporary of its own. Plain
+  // SGD folds the update into the GEMM through beta, momentum SGD
+  // accumulates into its velocity, and the rest reuse a scratch buffer.
+  void step(const std::size_t, Matrixf&, const Matrixf&, const Matrixf&);
+
+  // Accessors
+  const OptimizerParams& params() const;
+  void set_lr(const float);
+  const std::size_t steps(const std::size_t) const;
+private:
+  struct Slot {
+    std::vector<float> m;
+    std::vector<float> v;
+    std::vector<float> g;
+    std::size_t t;
+  };
+
+  void update(Slot&, float* const, const float* const, const std::size_t);
+
+  OptimizerParams p;
+  std::vector<Slot> slots;
+};
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_OPTIMIZER_HPP__
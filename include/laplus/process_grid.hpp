@@ -0,0 +1,86 @@
+/******************************************************************************
+ *
+ * laplus/process_grid.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_PROCESS_GRID_HPP__
+#define __LAPLUS_PROCESS_GRID_HPP__
+
+#include "laplus/matrixf.hpp"
+#include "laplus/transport.hpp"
+
+#include <cstddef>
+
+namespace laplus {
+
+// A rows x cols grid over the ranks of a transport, numbered row-major.
+// Matrices are distributed in blocks: the rank at (i, j) holds rows
+// [split(m, rows, i), split(m, rows, i + 1)) and columns
+// [split(n, cols, j), split(n, cols, j + 1)) of an m x n matrix.
+class ProcessGrid {
+public:
+  // Constructors and Destructor
+  ProcessGrid()=delete;
+  ProcessGrid(Transport&, const std::size_t, const std::size_t);
+
+  // Start of part p of n split into parts near-equal parts.
+  static const std::size_t split(const std::size_t, const std::size_t,
+                                 const std::size_t);
+
+  // Distribution
+  // The local block of a matrix every rank holds in full.
+  Matrixf block(const Matrixf&) const;
+  // The full m x n matrix assembled from the local blocks, on every rank.
+  Matrixf gather(const Matrixf&, const std::size_t, const std::size_t) const;
+
+  // SUMMA: c = alpha * a.dot(b) + beta * c over local blocks of an m x k
+  // a, k x n b and m x n c, given k. The shared dimension is walked in
+  // panels of at most the given width (256 by default). Each panel of a
+  // is broadcast along grid rows and each panel of b along grid columns
+  // by a communication thread that fetches the next panel while the
+  // current one is multiplied.
+  void gemm(const float, const Matrixf&, const Matrixf&, const float,
+            Matrixf&, const std::size_t) const;
+  void gemm(const float, const Matrixf&, const Matrixf&, const float,
+            Matrixf&, const std::size_t, const std::size_t) const;
+
+  // Accessors
+  Transport& transport() const;
+  const std::size_t rows() const;
+  const std::size_t cols() const;
+  const std::size_t row() const;
+  const std::size_t col() const;
+  const std::size_t rank(const std::size_t, const std::size_t) const;
+private:
+  Transport& comm;
+  std::size_t nrows;
+  std::size_t ncols;
+};
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_PROCESS_GRID_HPP__
@@ -0,0 +1,127 @@
+/******************************************************************************
+ *
+ * laplus/quantized_matrix.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_QUANTIZED_MATRIX_HPP__
+#define __LAPLUS_QUANTIZED_MATRIX_HPP__
+
+#include "laplus/internal/shared_array.hpp"
+#include "laplus/matrixf.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "cblas.h"
+
+namespace laplus {
+
+enum QuantType { Int8, UInt8 };
+enum QuantAxis { PerTensor, PerRow, PerCol };
+
+// Affine quantization, real = scale * (q - zero_point), with one scale and
+// zero point per tensor, row or column.
+struct QuantParams {
+  QuantType type;
+  QuantAxis axis;
+  std::vector<float> scales;
+  std::vector<std::int32_t> zero_points;
+};
+
+// Tracks the running range of the data it observes and derives
+// quantization parameters covering it.
+class Calibrator {
+public:
+  Calibrator(const QuantAxis);
+
+  void observe(const Matrixf&);
+  QuantParams params(const QuantType, const bool symmetric=false) const;
+private:
+  QuantAxis axis;
+  std::vector<float> lower;
+  std::vector<float> upper;
+};
+
+class QuantizedMatrix {
+public:
+  // Constructors and Destructor
+  QuantizedMatrix()=delete;
+  QuantizedMatrix(const Matrixf&, const QuantParams&);
+  QuantizedMatrix(const Matrixf&, const QuantParams&, const CBLAS_ORDER);
+  QuantizedMatrix(const Matrixf&, const QuantAxis, const QuantType);
+  QuantizedMatrix(const QuantizedMatrix&);
+  QuantizedMatrix(QuantizedMatrix&&) noexcept;
+  virtual ~QuantizedMatrix();
+
+  // Assignment Operators
+  QuantizedMatrix& operator=(const QuantizedMatrix&);
+  QuantizedMatrix& operator=(QuantizedMatrix&&) noexcept;
+
+  // Miscellaneous Operators
+  const float operator()(const std::size_t, const std::size_t) const;
+
+  // Utilities
+  friend void swap(QuantizedMatrix&, QuantizedMatrix&);
+  friend QuantizedMatrix dot(const QuantizedMatrix&, const QuantizedMatrix&,
+                             const QuantParams&);
+  QuantizedMatrix transpose() const;
+  QuantizedMatrix pack(const CBLAS_ORDER) const;
+  Matrixf dequantize() const;
+
+  // Accessors
+  const std::size_t rows() const;
+  const std::size_t cols() const;
+  const std::size_t ldim() const;
+  const CBLAS_ORDER layout() const;
+  const QuantParams& params() const;
+  const std::int32_t value(const std::size_t, const std::size_t) const;
+  std::uint8_t* const data() const;
+private:
+  QuantizedMatrix(const std::size_t, const std::size_t,
+                  const QuantParams&, const CBLAS_TRANSPOSE);
+
+  const std::size_t index(const std::size_t, const std::size_t) const;
+
+  std::pair<std::size_t, std::size_t> shape;
+  CBLAS_TRANSPOSE trans;
+  QuantParams quant;
+  internal::SharedArray<std::uint8_t> storage;
+};
+
+// Quantized BLAS
+// A holds UInt8 values quantized per tensor or per row and B holds Int8
+// values quantized per tensor or per column. gemm() writes the row-major
+// int32 accumulators sum_k (a_ik - za_i) * (b_kj - zb_j); dot() rescales
+// them to float or requantizes them with the given parameters.
+void gemm(const QuantizedMatrix&, const QuantizedMatrix&, std::int32_t* const);
+Matrixf dot(const QuantizedMatrix&, const QuantizedMatrix&);
+QuantizedMatrix dot(const QuantizedMatrix&, const QuantizedMatrix&,
+                    const QuantParams&);
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_QUANTIZED_MATRIX_HPP__
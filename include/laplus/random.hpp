@@ -0,0 +1,74 @@
+/******************************************************************************
+ *
+ * laplus/random.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_RANDOM_HPP__
+#define __LAPLUS_RANDOM_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace laplus {
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel Random
+// Numbers: As Easy as 1, 2, 3", SC'11). Block i of a stream is a keyed
+// bijection of the counter (i, stream), so any part of a stream can be
+// generated without the rest. Fills split the work across threads and
+// produce the same values for any number of threads.
+class Philox {
+public:
+  // Generators
+  static Philox next();
+
+  // Constructors and Destructor
+  Philox(const std::uint64_t, const std::uint64_t);
+
+  // Utilities
+  void block(const std::uint64_t, std::uint32_t* const) const;
+
+  void uniform(float* const, const std::size_t,
+               const float, const float) const;
+  void uniform(double* const, const std::size_t,
+               const double, const double) const;
+  void normal(float* const, const std::size_t,
+              const float, const float) const;
+  void normal(double* const, const std::size_t,
+              const double, const double) const;
+private:
+  std::uint64_t key;
+  std::uint64_t stream;
+};
+
+// Seeds the streams handed out by Philox::next(), which back the Uniform
+// and Normal generators of Vector and Matrix. Each generator call takes a
+// new stream, so its values depend only on the seed and the call order.
+void seed(const std::uint64_t);
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_RANDOM_HPP__
@@ -0,0 +1,114 @@
+/******************************************************************************
+ *
+ * laplus/sparse_matrixf.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_SPARSE_MATRIXF_HPP__
+#define __LAPLUS_SPARSE_MATRIXF_HPP__
+
+#include "laplus/internal/shared_array.hpp"
+#include "laplus/vectorf.hpp"
+#include "laplus/matrixf.hpp"
+
+#include <cstdint>
+#include <vector>
+#include <ostream>
+#include "cblas.h"
+
+namespace laplus {
+
+enum SparseFormat { CSR, CSC };
+
+struct Triplet {
+  std::size_t row;
+  std::size_t col;
+  float value;
+};
+
+class SparseMatrixf {
+public:
+  // Constructors and Destructor
+  SparseMatrixf()=delete;
+  SparseMatrixf(const std::size_t, const std::size_t, const SparseFormat);
+  SparseMatrixf(const std::size_t, const std::size_t,
+                const std::vector<Triplet>&, const SparseFormat);
+  SparseMatrixf(const Matrixf&, const SparseFormat);
+  SparseMatrixf(const SparseMatrixf&);
+  SparseMatrixf(SparseMatrixf&&) noexcept;
+  virtual ~SparseMatrixf();
+
+  // Assignment Operators
+  SparseMatrixf& operator=(const SparseMatrixf&);
+  SparseMatrixf& operator=(SparseMatrixf&&) noexcept;
+
+  // Miscellaneous Operators
+  const float operator()(const std::size_t, const std::size_t) const;
+  friend std::ostream& operator<<(std::ostream&, const SparseMatrixf&);
+
+  // Utilities
+  friend void swap(SparseMatrixf&, SparseMatrixf&);
+  SparseMatrixf clone() const;
+  SparseMatrixf transpose() const;
+  SparseMatrixf convert(const SparseFormat) const;
+  Matrixf dense() const;
+
+  // Accessors
+  const std::size_t rows() const;
+  const std::size_t cols() const;
+  const std::size_t nnz() const;
+  const SparseFormat format() const;
+  const std::size_t* const indptr() const;
+  const std::int32_t* const indices() const;
+  float* const values() const;
+
+  // Sparse BLAS
+  void spmv(const float, const Vectorf&, const float, const Vectorf&) const;
+  void spmm(const CBLAS_SIDE, const float, const Matrixf&,
+            const float, const Matrixf&) const;
+
+  // Linear Algebra
+  Vectorf dot(const Vectorf&) const;
+  Matrixf dot(const Matrixf&) const;
+private:
+  SparseMatrixf(const std::size_t, const std::size_t, const SparseFormat,
+                const std::size_t);
+
+  const std::size_t major() const;
+  const std::size_t minor() const;
+
+  std::pair<std::size_t, std::size_t> shape;
+  SparseFormat storage;
+  internal::SharedArray<std::size_t> offsets;
+  internal::SharedArray<std::int32_t> positions;
+  internal::SharedArray<float> entries;
+};
+
+Matrixf dot(const Matrixf&, const SparseMatrixf&);
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_SPARSE_MATRIXF_HPP__
@@ -0,0 +1,84 @@
+/******************************************************************************
+ *
+ * laplus/strassen.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_STRASSEN_HPP__
+#define __LAPLUS_STRASSEN_HPP__
+
+#include "laplus/matrixf.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace laplus {
+
+// Strassen-Winograd multiplication
+// Each level of recursion replaces eight half-size products with seven
+// plus fifteen block additions, down to blocks whose smallest dimension is
+// at most the cutoff, which go to cblas_sgemm. Odd dimensions are peeled
+// off and fixed up with rank-one updates and matrix-vector products.
+// With parallel set and more than one thread in the pool, the seven
+// products of the top level run concurrently.
+//
+// The error is bounded normwise rather than per element. With u the unit
+// roundoff, n0 the leaf size and n a power-of-two multiple of it (Higham,
+// Accuracy and Stability of Numerical Algorithms, Theorem 23.4),
+//   max|C - fl(C)| <= ((n / n0)^log2(18) (n0^2 + 6 n0) - 6 n) u
+//                     max|A| max|B| + O(u^2),
+// against n u (|A||B|)_ij per element for the conventional product. Each
+// level roughly multiplies the bound by 4.5. The error is therefore small
+// relative to max|A| max|B|, but small entries of C that result from
+// cancellation may lose relative accuracy compared to dot().
+//
+// The workspace is pooled in the object: it grows to the largest product
+// seen and is reused by later calls until release().
+class Strassen {
+public:
+  // Constructors and Destructor
+  Strassen();
+  Strassen(const std::size_t, const bool);
+
+  // c = alpha * a.dot(b) + beta * c for a row-major c.
+  void gemm(const float, const Matrixf&, const Matrixf&, const float,
+            Matrixf&);
+  Matrixf dot(const Matrixf&, const Matrixf&);
+
+  // Accessors
+  const std::size_t cutoff() const;
+  void set_cutoff(const std::size_t);
+  const std::size_t workspace() const;
+  void release();
+private:
+  std::size_t leaf;
+  bool parallel;
+  std::vector<float> pool;
+};
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_STRASSEN_HPP__
@@ -0,0 +1,166 @@
+/******************************************************************************
+ *
+ * laplus/tensor.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_TENSOR_HPP__
+#define __LAPLUS_TENSOR_HPP__
+
+#include "laplus/internal/shared_array.hpp"
+#include "laplus/matrix.hpp"
+#include "laplus/typedef.hpp"
+
+#include <functional>
+#include <ostream>
+#include <vector>
+
+namespace laplus {
+
+// N-dimensional array over shared storage. Every element (i0, ..., ik)
+// lives at data()[i0 * strides()[0] + ... + ik * strides()[k]], so views
+// produced by slice, select, permute, broadcast_to and most reshapes share
+// the buffer with their source. A stride of zero repeats an element along
+// a broadcast axis.
+template<typename T>
+class Tensor : public internal::SharedArray<T> {
+public:
+  // Constructors and Destructor
+  Tensor()=delete;
+  explicit Tensor(const dims_t&);
+  Tensor(const std::vector<T>&, const dims_t&);
+  explicit Tensor(const Matrix<T>&);
+  Tensor(const Tensor&);
+  Tensor(Tensor&&) noexcept;
+  virtual ~Tensor();
+
+  // Assignment Operators
+  Tensor& operator=(const Tensor&);
+  Tensor& operator=(Tensor&&) noexcept;
+
+  Tensor& operator+=(const Tensor&);
+  Tensor& operator-=(const Tensor&);
+  Tensor& operator*=(const Tensor&);
+  Tensor& operator/=(const Tensor&);
+
+  Tensor& operator+=(const T);
+  Tensor& operator-=(const T);
+  Tensor& operator*=(const T);
+  Tensor& operator/=(const T);
+
+  // Arithmetic Operators
+  Tensor operator+() const;
+  Tensor operator-() const;
+
+  Tensor operator+(const Tensor&) const;
+  Tensor operator-(const Tensor&) const;
+  Tensor operator*(const Tensor&) const;
+  Tensor operator/(const Tensor&) const;
+
+  Tensor operator+(const T) const;
+  Tensor operator-(const T) const;
+  Tensor operator*(const T) const;
+  Tensor operator/(const T) const;
+
+  // Miscellaneous Operators
+  const Tensor operator[](const std::size_t) const;
+  T& operator()(const dims_t&) const;
+
+  // Utilities
+  template<typename U>
+  friend void swap(Tensor<U>&, Tensor<U>&);
+  Tensor clone() const;
+  Tensor materialize() const;
+  Tensor reshape(const dims_t&) const;
+  Tensor permute(const dims_t&) const;
+  Tensor transpose() const;
+  Tensor slice(const std::size_t, const std::size_t, const std::size_t,
+               const std::size_t=1) const;
+  Tensor select(const std::size_t, const std::size_t) const;
+  Tensor squeeze(const std::size_t) const;
+  Tensor unsqueeze(const std::size_t) const;
+  Tensor broadcast_to(const dims_t&) const;
+  Matrix<T> matrix() const;
+  Matrix<T> matrix(const std::size_t) const;
+  void copy(const Tensor&);
+
+  // Accessors
+  const std::size_t rank() const;
+  const std::size_t size() const;
+  const std::size_t dim(const std::size_t) const;
+  const dims_t& dims() const;
+  const dims_t& strides() const;
+  const bool contiguous() const;
+  T* const data() const;
+
+  // Arithmetic Functions
+  void add_inplace(const Tensor&);
+  void sub_inplace(const Tensor&);
+  void mul_inplace(const Tensor&);
+  void div_inplace(const Tensor&);
+
+  void add_inplace(const T);
+  void sub_inplace(const T);
+  void mul_inplace(const T);
+  void div_inplace(const T);
+
+  void apply_inplace(const std::function<T(T)>&);
+  Tensor apply(const std::function<T(T)>&) const;
+private:
+  Tensor(const internal::SharedArray<T>&, const std::size_t,
+         const dims_t&, const dims_t&);
+
+  template<typename F>
+  void binary_inplace(const Tensor&, const F&);
+
+  std::size_t offset;
+  dims_t shape;
+  dims_t steps;
+};
+
+using Tensorf = Tensor<float>;
+using Tensord = Tensor<double>;
+
+// Shape of the result of a broadcasting operation between two shapes,
+// aligned at their trailing axes.
+dims_t broadcast(const dims_t&, const dims_t&);
+
+template<typename T>
+std::ostream& operator<<(std::ostream&, const Tensor<T>&);
+
+template<typename T>
+const bool operator==(const Tensor<T>&, const Tensor<T>&);
+template<typename T>
+const bool operator!=(const Tensor<T>&, const Tensor<T>&);
+
+template<typename T>
+const bool operator==(const Tensor<T>&, const std::vector<T>&);
+template<typename T>
+const bool operator!=(const Tensor<T>&, const std::vector<T>&);
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_TENSOR_HPP__
@@ -0,0 +1,103 @@
+/******************************************************************************
+ *
+ * laplus/trainer.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_TRAINER_HPP__
+#define __LAPLUS_TRAINER_HPP__
+
+#include "laplus/matrixf.hpp"
+#include "laplus/optimizer.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace laplus {
+
+// Data-parallel training
+// Each minibatch is split row-wise into one shard per worker. A worker
+// runs the gradient function on its shard against the shared weights and
+// writes into gradient buffers of its own. TrainerSynchronous then sums
+// the buffers range by range, each range owned by a single task so the
+// reduction needs neither locks nor atomics, and steps the optimizer once
+// per weight. TrainerHogwild skips the reduction: every worker walks its
+// own minibatches of an epoch and applies SGD to the shared weights as
+// soon as its gradient is ready, racing with the other workers.
+enum TrainerMode {
+  TrainerSynchronous,
+  TrainerHogwild
+};
+
+// Zero workers uses one per thread of the pool.
+struct TrainerParams {
+  TrainerMode mode;
+  std::size_t workers;
+};
+
+class Trainer {
+public:
+  // Called as gradient(worker, x, t, weights, grads) for the shard (x, t).
+  // Writes the gradient of the loss summed over the shard rows into grads,
+  // shaped like the weights, and returns that summed loss.
+  using Gradient = std::function<const float(const std::size_t,
+                                             const Matrixf&,
+                                             const Matrixf&,
+                                             const std::vector<Matrixf>&,
+                                             std::vector<Matrixf>&)>;
+
+  // Constructors and Destructor
+  Trainer(const std::vector<Matrixf>&, const Gradient&,
+          const OptimizerParams&, const TrainerParams&);
+
+  // Trains on one minibatch and returns its summed loss. Always
+  // synchronous.
+  const float step(const Matrixf&, const Matrixf&);
+
+  // Trains on every minibatch of the given size in order and returns the
+  // summed loss.
+  const float epoch(const Matrixf&, const Matrixf&, const std::size_t);
+
+  // Accessors
+  const std::vector<Matrixf>& weights() const;
+  const std::size_t workers() const;
+  const Optimizer& optimizer() const;
+private:
+  const float hogwild(const Matrixf&, const Matrixf&, const std::size_t);
+  void reduce(const std::size_t, const std::size_t);
+
+  std::vector<Matrixf> w;
+  Gradient gradient;
+  Optimizer opt;
+  TrainerParams p;
+  std::vector<std::vector<Matrixf>> grads;
+  std::vector<float> losses;
+};
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_TRAINER_HPP__
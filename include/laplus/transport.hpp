@@ -0,0 +1,138 @@
+/******************************************************************************
+ *
+ * laplus/transport.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_TRANSPORT_HPP__
+#define __LAPLUS_TRANSPORT_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace laplus {
+
+// Point-to-point byte streams between the ranks of a group. Messages
+// between a pair of ranks arrive in the order they were sent, and send()
+// may block until the receiver has drained part of the stream. One thread
+// may send while another receives. A transport that loses a peer closes,
+// after which is_open() is false and transfers return immediately.
+class Transport {
+public:
+  // Constructors and Destructor
+  virtual ~Transport();
+
+  // Transfers
+  virtual void send(const std::size_t, const void*, const std::size_t)=0;
+  virtual void recv(const std::size_t, void*, const std::size_t)=0;
+
+  // Accessors
+  virtual const bool is_open() const=0;
+  virtual const std::size_t rank() const=0;
+  virtual const std::size_t size() const=0;
+};
+
+enum SocketFamily {
+  SocketUnix,
+  SocketTCP
+};
+
+// Fully connected stream sockets. For Unix sockets rank r listens on the
+// path address.r; for TCP the address is an IPv4 "host:port" and rank r
+// listens on port + r. Every rank connects to the ranks below it and
+// accepts the ones above, so ranks may start in any order.
+class SocketTransport : public Transport {
+public:
+  // Constructors and Destructor
+  SocketTransport()=delete;
+  SocketTransport(const SocketFamily, const std::string&, const std::size_t,
+                  const std::size_t);
+  SocketTransport(const SocketTransport&)=delete;
+  virtual ~SocketTransport();
+
+  // Assignment Operators
+  SocketTransport& operator=(const SocketTransport&)=delete;
+
+  // Transfers
+  void send(const std::size_t, const void*, const std::size_t) override;
+  void recv(const std::size_t, void*, const std::size_t) override;
+
+  // Accessors
+  const bool is_open() const override;
+  const std::size_t rank() const override;
+  const std::size_t size() const override;
+private:
+  std::size_t me;
+  std::size_t ranks;
+  std::vector<int> sockets;
+  // Cleared by whichever of a concurrent send() and recv() fails first.
+  std::atomic<bool> open;
+};
+
+// Single-producer single-consumer byte rings, one for every ordered pair
+// of ranks, in one named POSIX shared memory segment. Capacity is rounded
+// up to a power of two. Rank 0 creates the segment and unlinks its name
+// as soon as every rank has joined.
+class SharedTransport : public Transport {
+public:
+  // Constructors and Destructor
+  SharedTransport()=delete;
+  SharedTransport(const std::string&, const std::size_t, const std::size_t);
+  SharedTransport(const std::string&, const std::size_t, const std::size_t,
+                  const std::size_t);
+  SharedTransport(const SharedTransport&)=delete;
+  virtual ~SharedTransport();
+
+  // Assignment Operators
+  SharedTransport& operator=(const SharedTransport&)=delete;
+
+  // Transfers
+  void send(const std::size_t, const void*, const std::size_t) override;
+  void recv(const std::size_t, void*, const std::size_t) override;
+
+  // Accessors
+  const bool is_open() const override;
+  const std::size_t rank() const override;
+  const std::size_t size() const override;
+  const std::size_t capacity() const;
+private:
+  struct Ring;
+
+  Ring& ring(const std::size_t, const std::size_t) const;
+
+  std::size_t me;
+  std::size_t ranks;
+  std::size_t bytes;
+  std::size_t length;
+  void* memory;
+};
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_TRANSPORT_HPP__
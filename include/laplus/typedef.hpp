@@ -34,7 +34,10 @@
 
 namespace laplus {
 
+enum DType { Float32, Float64 };
+
 using shape_t = std::pair<std::size_t, std::size_t>;
+using dims_t = std::vector<std::size_t>;
 
 template<typename T>
 using vector1d = std::vector<T>;
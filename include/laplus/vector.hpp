@@ -0,0 +1,218 @@
+/******************************************************************************
+ *
+ * laplus/vector.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifndef __LAPLUS_VECTOR_HPP__
+#define __LAPLUS_VECTOR_HPP__
+
+#include "laplus/internal/shared_array.hpp"
+
+#include <cmath>
+#include <vector>
+#include <ostream>
+#include <functional>
+#include <memory>
+#include "cblas.h"
+
+namespace laplus {
+
+template<typename T>
+class Matrix;
+
+template<typename T>
+class Vector : public internal::SharedArray<T> {
+  friend class Matrix<T>;
+public:
+  using value_type = T;
+
+  // Generators
+  static Vector Uniform(const std::size_t);
+  static Vector Uniform(const std::size_t, const T);
+  static Vector Uniform(const std::size_t, const T, const T);
+
+  static Vector Normal(const std::size_t);
+  static Vector Normal(const std::size_t, const T, const T);
+
+  // Constructors and Destructor
+  Vector()=delete;
+  Vector(const std::size_t);
+  Vector(const std::vector<T>&);
+  Vector(std::vector<T>&&);
+  Vector(T* const, const std::size_t, const std::function<void(T*)>&);
+  Vector(const Vector&);
+  Vector(Vector&&) noexcept;
+  Vector(const internal::SharedArray<T>&,
+         std::size_t, std::size_t, std::size_t);
+  virtual ~Vector();
+
+  // Assignment Operators
+  Vector& operator=(const Vector&);
+  Vector& operator=(Vector&&) noexcept;
+
+  Vector& operator+=(const Vector&);
+  Vector& operator-=(const Vector&);
+  Vector& operator*=(const Vector&);
+  Vector& operator/=(const Vector&);
+  Vector& operator^=(const Vector&);
+
+  Vector& operator+=(const T);
+  Vector& operator-=(const T);
+  Vector& operator*=(const T);
+  Vector& operator/=(const T);
+  Vector& operator^=(const T);
+
+  // Arithmetic Operators
+  Vector operator+() const;
+  Vector operator-() const;
+
+  Vector operator+(const Vector&) const;
+  Vector operator-(const Vector&) const;
+  Vector operator*(const Vector&) const;
+  Vector operator/(const Vector&) const;
+  Vector operator^(const Vector&) const;
+
+  Vector operator+(const T) const;
+  Vector operator-(const T) const;
+  Vector operator*(const T) const;
+  Vector operator/(const T) const;
+  Vector operator^(const T) const;
+
+  // Miscellaneous Operators
+  T& operator[](const std::size_t) const;
+  T& operator()(const std::size_t) const;
+
+  // Utilities
+  template<typename U>
+  friend void swap(Vector<U>&, Vector<U>&);
+  Vector clone() const;
+
+  // Accessors
+  const std::size_t size() const;
+  const std::size_t aligned_size() const;
+  T* const data() const;
+  const std::size_t inc() const;
+
+  // Level 1 BLAS
+  void swap(Vector&);
+  void scal(const T);
+  void copy(const Vector&);
+  void axpy(const T, const Vector&);
+  const T dot(const Vector&) const;
+  const T nrm2() const;
+  const T asum() const;
+  const std::size_t iamax() const;
+
+  // Level 2 BLAS
+  void gemv(const T, const Matrix<T>&, const Vector&, const T);
+  void symv(const CBLAS_UPLO, const T,
+            const Matrix<T>&, const Vector&, const T);
+  void trmv(const CBLAS_UPLO, const CBLAS_DIAG, const Matrix<T>&);
+  void trsv(const CBLAS_UPLO, const CBLAS_DIAG, const Matrix<T>&);
+
+  // Arithmetic Functions
+  void mul_inplace(const Vector&);
+  void div_inplace(const Vector&);
+  void pow_inplace(const Vector&);
+
+  void contiguous_mul_inplace(const Vector&);
+  void contiguous_div_inplace(const Vector&);
+
+  void add_inplace(const T);
+  void sub_inplace(const T);
+  void mul_inplace(const T);
+  void div_inplace(const T);
+  void pow_inplace(const T);
+
+  void log_inplace();
+
+  void apply_inplace(const std::function<T(T)>&);
+
+  Vector mul(const Vector&) const;
+  Vector div(const Vector&) const;
+  Vector pow(const Vector&) const;
+
+  Vector add(const T) const;
+  Vector sub(const T) const;
+  Vector mul(const T) const;
+  Vector div(const T) const;
+  Vector pow(const T) const;
+
+  Vector log() const;
+
+  Vector apply(const std::function<T(T)>&);
+
+  // Extensions
+  const T sum() const;
+
+  const T maxCoeff() const;
+  const T minCoeff() const;
+
+  const T maxCoeff(std::size_t&) const;
+  const T minCoeff(std::size_t&) const;
+
+  // Linear Algebra
+  T inner(const Vector&) const;
+  Vector dot(const Matrix<T>&) const;
+private:
+  std::size_t offset;
+  std::size_t stride;
+  std::size_t length;
+};
+
+// Non-member functions
+template<typename T>
+Vector<T> operator+(const typename Vector<T>::value_type&, const Vector<T>&);
+template<typename T>
+Vector<T> operator-(const typename Vector<T>::value_type&, const Vector<T>&);
+template<typename T>
+Vector<T> operator*(const typename Vector<T>::value_type&, const Vector<T>&);
+template<typename T>
+Vector<T> operator/(const typename Vector<T>::value_type&, const Vector<T>&);
+template<typename T>
+Vector<T> operator^(const typename Vector<T>::value_type&, const Vector<T>&);
+
+template<typename T>
+std::ostream& operator<<(std::ostream&, const Vector<T>&);
+
+template<typename T>
+const bool operator==(const Vector<T>& a, const Vector<T>& b);
+template<typename T>
+const bool operator!=(const Vector<T>& a, const Vector<T>& b);
+
+template<typename T>
+const bool operator==(const Vector<T>& a, const std::vector<T>& b);
+template<typename T>
+const bool operator!=(const Vector<T>& a, const std::vector<T>& b);
+
+template<typename T>
+const bool operator==(const std::vector<T>& a, const Vector<T>& b);
+template<typename T>
+const bool operator!=(const std::vector<T>& a, const Vector<T>& b);
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_VECTOR_HPP__
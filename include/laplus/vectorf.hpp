@@ -26,165 +26,16 @@
  *
  *****************************************************************************/
 
+
 #ifndef __LAPLUS_VECTORF_HPP__
 #define __LAPLUS_VECTORF_HPP__
 
-#include "laplus/internal/shared_array.hpp"
-
-#include <cmath>
-#include <vector>
-#include <ostream>
-#include <functional>
-#include <memory>
-#include "cblas.h"
+#include "laplus/vector.hpp"
 
 namespace laplus {
 
-class Matrixf;
-
-class Vectorf : public internal::SharedArray<float> {
-  friend class Matrixf;
-public:
-  // Generators
-  static Vectorf Uniform(const std::size_t);
-  static Vectorf Uniform(const std::size_t, const float);
-  static Vectorf Uniform(const std::size_t, const float, const float);
-
-  static Vectorf Normal(const std::size_t);
-  static Vectorf Normal(const std::size_t, const float, const float);
-
-  // Constructors and Destructor
-  Vectorf()=delete;
-  Vectorf(const std::size_t);
-  Vectorf(const std::vector<float>&);
-  Vectorf(const Vectorf&);
-  Vectorf(Vectorf&&) noexcept;
-  Vectorf(const Vectorf&, std::size_t, std::size_t, std::size_t);
-  virtual ~Vectorf();
-
-  // Assignment Operators
-  Vectorf& operator=(const Vectorf&);
-  Vectorf& operator=(Vectorf&&) noexcept;
-
-  Vectorf& operator+=(const Vectorf&);
-  Vectorf& operator-=(const Vectorf&);
-  Vectorf& operator*=(const Vectorf&);
-  Vectorf& operator/=(const Vectorf&);
-  Vectorf& operator^=(const Vectorf&);
-
-  Vectorf& operator+=(const float);
-  Vectorf& operator-=(const float);
-  Vectorf& operator*=(const float);
-  Vectorf& operator/=(const float);
-  Vectorf& operator^=(const float);
-
-  // Arithmetic Operators
-  Vectorf operator+() const;
-  Vectorf operator-() const;
-
-  Vectorf operator+(const Vectorf&) const;
-  Vectorf operator-(const Vectorf&) const;
-  Vectorf operator*(const Vectorf&) const;
-  Vectorf operator/(const Vectorf&) const;
-  Vectorf operator^(const Vectorf&) const;
-
-  Vectorf operator+(const float) const;
-  Vectorf operator-(const float) const;
-  Vectorf operator*(const float) const;
-  Vectorf operator/(const float) const;
-  Vectorf operator^(const float) const;
-
-  friend Vectorf operator+(const float&, const Vectorf&);
-  friend Vectorf operator-(const float&, const Vectorf&);
-  friend Vectorf operator*(const float&, const Vectorf&);
-  friend Vectorf operator/(const float&, const Vectorf&);
-  friend Vectorf operator^(const float&, const Vectorf&);
-
-  // Miscellaneous Operators
-  float& operator[](const std::size_t) const;
-  float& operator()(const std::size_t) const;
-  friend std::ostream& operator<<(std::ostream&, const Vectorf&);
-
-  // Utilities
-  friend void swap(Vectorf&, Vectorf&);
-  Vectorf clone() const;
-
-  // Accessors
-  const std::size_t size() const;
-  const std::size_t aligned_size() const;
-
-  // Level 1 BLAS
-  void swap(Vectorf&);
-  void scal(const float);
-  void copy(const Vectorf&);
-  void axpy(const float, const Vectorf&);
-  const float dot(const Vectorf&) const;
-  const float nrm2() const;
-  const float asum() const;
-  const std::size_t iamax() const;
-
-  // Level 2 BLAS
-  void gemv(const float, const Matrixf&, const Vectorf&, const float);
-
-  // Arithmetic Functions
-  void mul_inplace(const Vectorf&);
-  void div_inplace(const Vectorf&);
-  void pow_inplace(const Vectorf&);
-
-  void contiguous_mul_inplace(const Vectorf&);
-  void contiguous_div_inplace(const Vectorf&);
-
-  void add_inplace(const float);
-  void sub_inplace(const float);
-  void mul_inplace(const float);
-  void div_inplace(const float);
-  void pow_inplace(const float);
-
-  void log_inplace();
-
-  void apply_inplace(const std::function<float(float)>&);
-
-  Vectorf mul(const Vectorf&) const;
-  Vectorf div(const Vectorf&) const;
-  Vectorf pow(const Vectorf&) const;
-
-  Vectorf add(const float) const;
-  Vectorf sub(const float) const;
-  Vectorf mul(const float) const;
-  Vectorf div(const float) const;
-  Vectorf pow(const float) const;
-
-  Vectorf log() const;
-
-  Vectorf apply(const std::function<float(float)>&);
-
-  // Extensions
-  const float sum() const;
-
-  const float maxCoeff() const;
-  const float minCoeff() const;
-
-  const float maxCoeff(std::size_t&) const;
-  const float minCoeff(std::size_t&) const;
-
-  // Linear Algebra
-  float inner(const Vectorf&) const;
-  Vectorf dot(const Matrixf&) const;
-private:
-  std::size_t offset;
-  std::size_t stride;
-  std::size_t length;
-};
-
-// Non-member functions
-const bool operator==(const Vectorf& a, const Vectorf& b);
-const bool operator!=(const Vectorf& a, const Vectorf& b);
-
-const bool operator==(const Vectorf& a, const std::vector<float>& b);
-const bool operator!=(const Vectorf& a, const std::vector<float>& b);
-
-const bool operator==(const std::vector<float>& a, const Vectorf& b);
-const bool operator!=(const std::vector<float>& a, const Vectorf& b);
+using Vectorf = Vector<float>;
+using Vectord = Vector<double>;
 
 }  // namespace laplus
 
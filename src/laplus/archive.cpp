@@ -0,0 +1,325 @@
+/******************************************************************************
+ *
+ * laplus/archive.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/archive.hpp"
+#include "laplus/internal/mapping.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+namespace laplus {
+
+namespace {
+
+const char magic[8] = {'L', 'A', 'P', 'L', 'U', 'S', 'A', 'R'};
+const std::uint32_t version = 1;
+const std::uint64_t alignment = 64;
+
+struct Header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t alignment;
+  char reserved[48];
+};
+
+struct Record {
+  std::uint32_t dtype;
+  std::uint32_t rank;
+  std::uint32_t trans;
+  std::uint32_t reserved;
+  std::uint64_t rows;
+  std::uint64_t cols;
+  std::uint64_t name_size;
+  std::uint64_t payload_size;
+};
+
+static_assert(sizeof(Header) == 64, "archive header must be 64 bytes");
+static_assert(sizeof(Record) == 48, "archive record must be 48 bytes");
+
+const std::uint64_t align(const std::uint64_t position)
+{ return (position + alignment - 1) / alignment * alignment; }
+
+const std::size_t itemsize(const DType dtype)
+{ return (dtype == Float64) ? sizeof(double) : sizeof(float); }
+
+// Whether rows * cols * size equals bytes, rejecting products that would
+// overflow.
+const bool fits(const std::uint64_t rows, const std::uint64_t cols,
+                const std::uint64_t size, const std::uint64_t bytes)
+{
+  const std::uint64_t max = std::numeric_limits<std::uint64_t>::max();
+  if(rows == 0 || cols == 0) return bytes == 0;
+  if(cols > max / rows || size > max / (rows * cols)) return false;
+  return rows * cols * size == bytes;
+}
+
+template<typename T>
+const DType dtype_of();
+
+template<>
+const DType dtype_of<float>()
+{ return Float32; }
+
+template<>
+const DType dtype_of<double>()
+{ return Float64; }
+
+}  // unnamed namespace
+
+// Constructors and Destructor
+ArchiveWriter::ArchiveWriter(const std::string& path)
+  : stream(path, std::ios::binary | std::ios::trunc), position(0)
+{
+  Header header;
+  std::memset(&header, 0, sizeof(Header));
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.alignment = alignment;
+  stream.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+  position = sizeof(Header);
+}
+
+ArchiveWriter::~ArchiveWriter()
+{ close(); }
+
+// Utilities
+template<typename T>
+void ArchiveWriter::write(const std::string& name, const Vector<T>& vector)
+{
+  if(vector.inc() == 1) {
+    record(name, dtype_of<T>(), 1, 1, vector.size(), false,
+           vector.data(), vector.size() * sizeof(T));
+    return;
+  }
+  std::vector<T> values(vector.size());
+  for(std::size_t i = 0; i < vector.size(); ++i) values[i] = vector[i];
+  record(name, dtype_of<T>(), 1, 1, vector.size(), false,
+         values.data(), values.size() * sizeof(T));
+}
+
+template<typename T>
+void ArchiveWriter::write(const std::string& name, const Matrix<T>& matrix)
+{
+  record(name, dtype_of<T>(), 2, matrix.rows(), matrix.cols(),
+         matrix.layout() == CblasColMajor,
+         matrix.data(), matrix.rows() * matrix.cols() * sizeof(T));
+}
+
+void ArchiveWriter::close()
+{
+  if(stream.is_open()) stream.close();
+}
+
+// Accessors
+const bool ArchiveWriter::is_open() const
+{ return stream.is_open() && stream.good(); }
+
+void ArchiveWriter::record(const std::string& name, const DType dtype,
+                           const std::size_t rank,
+                           const std::size_t rows, const std::size_t cols,
+                           const bool trans, const void* const data,
+                           const std::size_t bytes)
+{
+  assert(stream.is_open());
+
+  Record entry;
+  std::memset(&entry, 0, sizeof(Record));
+  entry.dtype = dtype;
+  entry.rank = rank;
+  entry.trans = trans;
+  entry.rows = rows;
+  entry.cols = cols;
+  entry.name_size = name.size();
+  entry.payload_size = bytes;
+
+  stream.write(reinterpret_cast<const char*>(&entry), sizeof(Record));
+  stream.write(name.data(), name.size());
+  position += sizeof(Record) + name.size();
+  pad();
+  stream.write(static_cast<const char*>(data), bytes);
+  position += bytes;
+  pad();
+}
+
+void ArchiveWriter::pad()
+{
+  const char zeros[alignment] = {};
+  const std::uint64_t next = align(position);
+  stream.write(zeros, next - position);
+  position = next;
+}
+
+// Constructors and Destructor
+Archive::Archive(const std::string& path)
+  : mapping(nullptr), entries()
+{
+  std::size_t size = 0;
+  mapping = internal::map_file(path, size);
+  if(!mapping) return;
+  if(size < sizeof(Header)) {
+    mapping = nullptr;
+    return;
+  }
+
+  Header header;
+  std::memcpy(&header, mapping.get(), sizeof(Header));
+  if(std::memcmp(header.magic, magic, sizeof(magic)) != 0
+     || header.version != version || header.alignment != alignment) {
+    mapping = nullptr;
+    return;
+  }
+
+  std::uint64_t position = sizeof(Header);
+  while(position + sizeof(Record) <= size) {
+    Record record;
+    std::memcpy(&record, mapping.get() + position, sizeof(Record));
+    const std::uint64_t name = position + sizeof(Record);
+    const std::uint64_t offset = align(name + record.name_size);
+    const bool valid = (record.dtype <= Float64)
+                    && fits(record.rows, record.cols,
+                            itemsize(DType(record.dtype)),
+                            record.payload_size)
+                    && (record.name_size <= size - name)
+                    && (offset <= size)
+                    && (record.payload_size <= size - offset);
+    if(!valid) {
+      mapping = nullptr;
+      entries.clear();
+      return;
+    }
+
+    Entry entry;
+    entry.dtype = DType(record.dtype);
+    entry.shape = shape_t(record.rows, record.cols);
+    entry.trans = record.trans;
+    entry.offset = offset;
+    entries[std::string(mapping.get() + name, record.name_size)] = entry;
+    position = align(offset + record.payload_size);
+  }
+}
+
+Archive::Archive(const Archive& other)
+  : mapping(other.mapping), entries(other.entries)
+{}
+
+Archive::Archive(Archive&& other) noexcept
+  : mapping(std::move(other.mapping)), entries(std::move(other.entries))
+{}
+
+Archive::~Archive() {}
+
+// Assignment Operators
+Archive& Archive::operator=(const Archive& other)
+{
+  Archive another(other);
+  *this = std::move(another);
+  return *this;
+}
+
+Archive& Archive::operator=(Archive&& other) noexcept
+{
+  swap(*this, other);
+  return *this;
+}
+
+// Utilities
+void swap(Archive& a, Archive& b)
+{
+  using std::swap;
+  swap(a.mapping, b.mapping);
+  swap(a.entries, b.entries);
+}
+
+template<typename T>
+Vector<T> Archive::vector(const std::string& name) const
+{
+  assert(contains(name));
+  const Entry& entry = entries.at(name);
+  assert(entry.dtype == dtype_of<T>());
+  const std::size_t size = entry.shape.first * entry.shape.second;
+  return Vector<T>(internal::SharedArray<T>(payload<T>(entry), size),
+                   0, 1, size);
+}
+
+template<typename T>
+Matrix<T> Archive::matrix(const std::string& name) const
+{
+  const Entry& entry = entries.at(name);
+  const Matrix<T> flat(vector<T>(name));
+  if(entry.trans) {
+    return flat.reshape(entry.shape.second, entry.shape.first).transpose();
+  }
+  return flat.reshape(entry.shape.first, entry.shape.second);
+}
+
+template<typename T>
+std::shared_ptr<T> Archive::payload(const Entry& entry) const
+{
+  return std::shared_ptr<T>(mapping,
+                            reinterpret_cast<T*>(mapping.get() + entry.offset));
+}
+
+// Accessors
+const bool Archive::is_open() const
+{ return mapping != nullptr; }
+
+const bool Archive::contains(const std::string& name) const
+{ return entries.find(name) != entries.end(); }
+
+const std::vector<std::string> Archive::names() const
+{
+  std::vector<std::string> result;
+  for(const auto& entry: entries) result.push_back(entry.first);
+  return result;
+}
+
+const DType Archive::dtype(const std::string& name) const
+{
+  assert(contains(name));
+  return entries.at(name).dtype;
+}
+
+const shape_t Archive::shape(const std::string& name) const
+{
+  assert(contains(name));
+  return entries.at(name).shape;
+}
+
+template void ArchiveWriter::write(const std::string&, const Vector<float>&);
+template void ArchiveWriter::write(const std::string&, const Vector<double>&);
+template void ArchiveWriter::write(const std::string&, const Matrix<float>&);
+template void ArchiveWriter::write(const std::string&, const Matrix<double>&);
+
+template Vector<float> Archive::vector(const std::string&) const;
+template Vector<double> Archive::vector(const std::string&) const;
+template Matrix<float> Archive::matrix(const std::string&) const;
+template Matrix<double> Archive::matrix(const std::string&) const;
+
+}  // namespace laplus
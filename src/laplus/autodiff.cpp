@@ -0,0 +1,512 @@
+/******************************************************************************
+ *
+ * laplus/autodiff.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/autodiff.hpp"
+#include "laplus/math.hpp"
+#include "laplus/internal/parallel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace laplus {
+
+namespace {
+
+const std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+template<typename F>
+void each(const std::size_t n, const F& f)
+{
+  internal::parallel_for(0, n, internal::grain, [&](
+      const std::size_t first, const std::size_t last) {
+    for(std::size_t i = first; i < last; ++i) f(i);
+  });
+}
+
+// Writes g = f(i) for a fresh gradient and g += f(i) otherwise.
+template<typename F>
+void accumulate(float* const g, const bool fresh, const std::size_t n,
+                const F& f)
+{
+  if(fresh) each(n, [&](const std::size_t i) { g[i] = f(i); });
+  else each(n, [&](const std::size_t i) { g[i] += f(i); });
+}
+
+const float total(const float* const x, const std::size_t n)
+{
+  double s = 0.0;
+  for(std::size_t i = 0; i < n; ++i) s += x[i];
+  return s;
+}
+
+}  // unnamed namespace
+
+Var operator+(const Var& a, const Var& b)
+{ return a.tape->add(a, b); }
+
+Var operator-(const Var& a, const Var& b)
+{ return a.tape->sub(a, b); }
+
+Var operator*(const Var& a, const Var& b)
+{ return a.tape->mul(a, b); }
+
+Var operator*(const Var& a, const float s)
+{ return a.tape->scale(a, s); }
+
+Var operator*(const float s, const Var& a)
+{ return a.tape->scale(a, s); }
+
+// Constructors and Destructor
+Tape::Tape() {}
+
+// Leaves
+Var Tape::variable(const Matrixf& x)
+{
+  assert(x.inc() == 1);
+  const bool mixed = (x.layout() != CblasRowMajor)
+                     && x.rows() > 1 && x.cols() > 1;
+  nodes.push_back({Leaf, true, true, 0.0f, npos, npos, npos, npos, npos});
+  values.push_back(mixed ? x.materialize() : x);
+  return {this, nodes.size() - 1};
+}
+
+Var Tape::constant(const Matrixf& x)
+{
+  const Var v = variable(x);
+  nodes.back().needs = false;
+  return v;
+}
+
+// Operations
+Var Tape::dot(const Var& a, const Var& b)
+{
+  assert(values[a.index].cols() == values[b.index].rows());
+  const Var y = record(Dot, a.index, b.index, 0.0f, values[a.index].rows(),
+                       values[b.index].cols());
+  values[y.index].gemm(1.0, values[a.index], values[b.index], 0.0);
+  return y;
+}
+
+Var Tape::add(const Var& a, const Var& b)
+{
+  const std::size_t rows = values[a.index].rows();
+  const std::size_t cols = values[a.index].cols();
+  assert(values[b.index].cols() == cols);
+  assert(values[b.index].rows() == rows || values[b.index].rows() == 1);
+  const Var y = record(Add, a.index, b.index, 0.0f, rows, cols);
+  const float* const x0 = values[a.index].data();
+  const float* const x1 = values[b.index].data();
+  float* const z = values[y.index].data();
+  if(values[b.index].rows() == rows) {
+    each(rows * cols, [&](const std::size_t i) { z[i] = x0[i] + x1[i]; });
+  } else {
+    each(rows * cols, [&](const std::size_t i) {
+      z[i] = x0[i] + x1[i % cols];
+    });
+  }
+  return y;
+}
+
+Var Tape::sub(const Var& a, const Var& b)
+{
+  assert(values[a.index].rows() == values[b.index].rows());
+  assert(values[a.index].cols() == values[b.index].cols());
+  const Var y = record(Sub, a.index, b.index, 0.0f, values[a.index].rows(),
+                       values[a.index].cols());
+  const float* const x0 = values[a.index].data();
+  const float* const x1 = values[b.index].data();
+  float* const z = values[y.index].data();
+  each(values[y.index].size(), [&](const std::size_t i) {
+    z[i] = x0[i] - x1[i];
+  });
+  return y;
+}
+
+Var Tape::mul(const Var& a, const Var& b)
+{
+  assert(values[a.index].rows() == values[b.index].rows());
+  assert(values[a.index].cols() == values[b.index].cols());
+  const Var y = record(Mul, a.index, b.index, 0.0f, values[a.index].rows(),
+                       values[a.index].cols());
+  const float* const x0 = values[a.index].data();
+  const float* const x1 = values[b.index].data();
+  float* const z = values[y.index].data();
+  each(values[y.index].size(), [&](const std::size_t i) {
+    z[i] = x0[i] * x1[i];
+  });
+  return y;
+}
+
+Var Tape::scale(const Var& a, const float s)
+{
+  const Var y = record(Scale, a.index, npos, s, values[a.index].rows(),
+                       values[a.index].cols());
+  const float* const x = values[a.index].data();
+  float* const z = values[y.index].data();
+  each(values[y.index].size(), [&](const std::size_t i) { z[i] = s * x[i]; });
+  return y;
+}
+
+Var Tape::sigmoid(const Var& a)
+{
+  const Var y = record(Sigmoid, a.index, npos, 0.0f, values[a.index].rows(),
+                       values[a.index].cols());
+  const float* const x = values[a.index].data();
+  float* const z = values[y.index].data();
+  each(values[y.index].size(), [&](const std::size_t i) {
+    z[i] = laplus::sigmoid(x[i]);
+  });
+  return y;
+}
+
+Var Tape::tanh(const Var& a)
+{
+  const Var y = record(Tanh, a.index, npos, 0.0f, values[a.index].rows(),
+                       values[a.index].cols());
+  const float* const x = values[a.index].data();
+  float* const z = values[y.index].data();
+  each(values[y.index].size(), [&](const std::size_t i) {
+    z[i] = std::tanh(x[i]);
+  });
+  return y;
+}
+
+Var Tape::relu(const Var& a)
+{
+  const Var y = record(Relu, a.index, npos, 0.0f, values[a.index].rows(),
+                       values[a.index].cols());
+  const float* const x = values[a.index].data();
+  float* const z = values[y.index].data();
+  each(values[y.index].size(), [&](const std::size_t i) {
+    z[i] = std::max(0.0f, x[i]);
+  });
+  return y;
+}
+
+Var Tape::sum(const Var& a)
+{
+  const Var y = record(Sum, a.index, npos, 0.0f, 1, 1);
+  values[y.index].data()[0] = total(values[a.index].data(),
+                                    values[a.index].size());
+  return y;
+}
+
+Var Tape::mean(const Var& a)
+{
+  const std::size_t n = values[a.index].size();
+  const Var y = record(Mean, a.index, npos, 1.0f / n, 1, 1);
+  values[y.index].data()[0] = total(values[a.index].data(), n) / n;
+  return y;
+}
+
+Var Tape::mse(const Var& a, const Var& t)
+{
+  assert(values[a.index].rows() == values[t.index].rows());
+  assert(values[a.index].cols() == values[t.index].cols());
+  const std::size_t n = values[a.index].size();
+  const Var y = record(MSE, a.index, t.index, 1.0f / n, 1, 1);
+  const float* const x0 = values[a.index].data();
+  const float* const x1 = values[t.index].data();
+  double s = 0.0;
+  for(std::size_t i = 0; i < n; ++i) s += (x0[i] - x1[i]) * (x0[i] - x1[i]);
+  values[y.index].data()[0] = s / n;
+  return y;
+}
+
+Var Tape::softmax_cross_entropy(const Var& a, const Var& t)
+{
+  const std::size_t rows = values[a.index].rows();
+  const std::size_t cols = values[a.index].cols();
+  assert(values[t.index].rows() == rows && values[t.index].cols() == cols);
+  const Var y = record(SoftmaxCrossEntropy, a.index, t.index, 1.0f / rows,
+                       1, 1);
+  Node& node = nodes[y.index];
+  node.aux = acquire(rows * cols);
+
+  // Keeps the softmax for the backward pass and each row's loss.
+  const float* const x = values[a.index].data();
+  const float* const p = values[t.index].data();
+  float* const q = pool[node.aux].data.data();
+  std::vector<float> loss(rows);
+  internal::parallel_for(0, rows, 64, [&](const std::size_t first,
+                                          const std::size_t last) {
+    for(std::size_t i = first; i < last; ++i) {
+      const float* const xi = x + i * cols;
+      float* const qi = q + i * cols;
+      const float top = *std::max_element(xi, xi + cols);
+      float s = 0.0f;
+      for(std::size_t j = 0; j < cols; ++j) s += qi[j] = std::exp(xi[j] - top);
+      const float lse = std::log(s);
+      float l = 0.0f;
+      for(std::size_t j = 0; j < cols; ++j) {
+        l -= p[i * cols + j] * (xi[j] - top - lse);
+        qi[j] /= s;
+      }
+      loss[i] = l;
+    }
+  });
+  values[y.index].data()[0] = total(loss.data(), rows) / rows;
+  return y;
+}
+
+// Differentiation
+void Tape::backward(const Var& y)
+{
+  bool fresh = false;
+  float* const g = gradient(y.index, fresh);
+  const std::size_t n = values[y.index].size();
+  accumulate(g, fresh, n, [](const std::size_t) { return 1.0f; });
+
+  for(std::size_t i = y.index + 1; i-- > 0;) {
+    Node& node = nodes[i];
+    if(!node.needs || node.grad == npos) continue;
+    if(!node.leaf) {
+      propagate(i);
+      release(node.grad);
+      node.grad = npos;
+    }
+  }
+}
+
+void Tape::clear()
+{
+  nodes.clear();
+  values.clear();
+  for(Buffer& buffer: pool) buffer.used = false;
+}
+
+// Accessors
+const Matrixf& Tape::value(const Var& v) const
+{ return values[v.index]; }
+
+Matrixf Tape::grad(const Var& v) const
+{
+  const Matrixf& x = values[v.index];
+  if(nodes[v.index].grad == npos) return Matrixf(x.rows(), x.cols());
+  return view(nodes[v.index].grad, x.rows(), x.cols());
+}
+
+const std::size_t Tape::size() const
+{ return nodes.size(); }
+
+const std::size_t Tape::buffers() const
+{ return pool.size(); }
+
+// Recording
+Var Tape::record(const Op op, const std::size_t a, const std::size_t b,
+                 const float s, const std::size_t rows, const std::size_t cols)
+{
+  const bool needs = nodes[a].needs || (b != npos && nodes[b].needs);
+  const std::size_t value = acquire(rows * cols);
+  nodes.push_back({op, needs, false, s, a, b, value, npos, npos});
+  values.push_back(view(value, rows, cols));
+  return {this, nodes.size() - 1};
+}
+
+float* Tape::gradient(const std::size_t i, bool& fresh)
+{
+  fresh = (nodes[i].grad == npos);
+  if(fresh) nodes[i].grad = acquire(values[i].size());
+  return pool[nodes[i].grad].data.data();
+}
+
+// Applies the backward rule of node i to the gradients of its operands.
+void Tape::propagate(const std::size_t i)
+{
+  const Node node = nodes[i];
+  const std::size_t a = node.a;
+  const std::size_t b = node.b;
+  const bool da = nodes[a].needs;
+  const bool db = (b != npos) && nodes[b].needs;
+  const std::size_t n = values[a].size();
+  const Matrixf gy = view(node.grad, values[i].rows(), values[i].cols());
+  const float* const g = gy.data();
+  const float* const y = values[i].data();
+  const float* const x0 = values[a].data();
+  const float* const x1 = (b != npos) ? values[b].data() : nullptr;
+  bool fresh = false;
+
+  switch(node.op) {
+  case Leaf:
+    break;
+  case Dot:
+    if(da) {
+      gradient(a, fresh);
+      view(nodes[a].grad, values[a].rows(), values[a].cols())
+        .gemm(1.0, gy, values[b].transpose(), fresh ? 0.0 : 1.0);
+    }
+    if(db) {
+      gradient(b, fresh);
+      view(nodes[b].grad, values[b].rows(), values[b].cols())
+        .gemm(1.0, values[a].transpose(), gy, fresh ? 0.0 : 1.0);
+    }
+    break;
+  case Add:
+  case Sub:
+    if(da) {
+      float* const ga = gradient(a, fresh);
+      accumulate(ga, fresh, n, [&](const std::size_t k) { return g[k]; });
+    }
+    if(db) {
+      const float sign = (node.op == Sub) ? -1.0f : 1.0f;
+      float* const gb = gradient(b, fresh);
+      if(values[b].size() == n) {
+        accumulate(gb, fresh, n, [&](const std::size_t k) {
+          return sign * g[k];
+        });
+      } else {
+        const std::size_t rows = values[a].rows();
+        const std::size_t cols = values[a].cols();
+        accumulate(gb, fresh, cols, [&](const std::size_t j) {
+          float s = 0.0f;
+          for(std::size_t r = 0; r < rows; ++r) s += g[r * cols + j];
+          return s;
+        });
+      }
+    }
+    break;
+  case Mul:
+    if(da) {
+      float* const ga = gradient(a, fresh);
+      accumulate(ga, fresh, n, [&](const std::size_t k) {
+        return g[k] * x1[k];
+      });
+    }
+    if(db) {
+      float* const gb = gradient(b, fresh);
+      accumulate(gb, fresh, n, [&](const std::size_t k) {
+        return g[k] * x0[k];
+      });
+    }
+    break;
+  case Scale:
+    if(da) {
+      float* const ga = gradient(a, fresh);
+      accumulate(ga, fresh, n, [&](const std::size_t k) {
+        return node.s * g[k];
+      });
+    }
+    break;
+  case Sigmoid:
+    if(da) {
+      float* const ga = gradient(a, fresh);
+      accumulate(ga, fresh, n, [&](const std::size_t k) {
+        return g[k] * y[k] * (1.0f - y[k]);
+      });
+    }
+    break;
+  case Tanh:
+    if(da) {
+      float* const ga = gradient(a, fresh);
+      accumulate(ga, fresh, n, [&](const std::size_t k) {
+        return g[k] * (1.0f - y[k] * y[k]);
+      });
+    }
+    break;
+  case Relu:
+    if(da) {
+      float* const ga = gradient(a, fresh);
+      accumulate(ga, fresh, n, [&](const std::size_t k) {
+        return (y[k] > 0.0f) ? g[k] : 0.0f;
+      });
+    }
+    break;
+  case Sum:
+  case Mean:
+    if(da) {
+      const float s = (node.op == Mean) ? node.s * g[0] : g[0];
+      float* const ga = gradient(a, fresh);
+      accumulate(ga, fresh, n, [&](const std::size_t) { return s; });
+    }
+    break;
+  case MSE: {
+    const float s = 2.0f * node.s * g[0];
+    if(da) {
+      float* const ga = gradient(a, fresh);
+      accumulate(ga, fresh, n, [&](const std::size_t k) {
+        return s * (x0[k] - x1[k]);
+      });
+    }
+    if(db) {
+      float* const gb = gradient(b, fresh);
+      accumulate(gb, fresh, n, [&](const std::size_t k) {
+        return s * (x1[k] - x0[k]);
+      });
+    }
+    break;
+  }
+  case SoftmaxCrossEntropy: {
+    const float s = node.s * g[0];
+    const float* const q = pool[node.aux].data.data();
+    if(da) {
+      float* const ga = gradient(a, fresh);
+      accumulate(ga, fresh, n, [&](const std::size_t k) {
+        return s * (q[k] - x1[k]);
+      });
+    }
+    if(db) {
+      float* const gb = gradient(b, fresh);
+      accumulate(gb, fresh, n, [&](const std::size_t k) {
+        return -s * std::log(q[k]);
+      });
+    }
+    break;
+  }
+  }
+}
+
+// Memory Planning
+const std::size_t Tape::acquire(const std::size_t n)
+{
+  std::size_t best = npos;
+  for(std::size_t i = 0; i < pool.size(); ++i) {
+    if(pool[i].used || pool[i].data.size() < n) continue;
+    if(best == npos || pool[i].data.size() < pool[best].data.size()) best = i;
+  }
+  if(best == npos) {
+    pool.push_back({std::vector<float>(n), false});
+    best = pool.size() - 1;
+  }
+  pool[best].used = true;
+  return best;
+}
+
+void Tape::release(const std::size_t i)
+{ pool[i].used = false; }
+
+Matrixf Tape::view(const std::size_t i, const std::size_t rows,
+                   const std::size_t cols) const
+{
+  float* const p = const_cast<float*>(pool[i].data.data());
+  return Matrixf(p, rows, cols, [](float*) {});
+}
+
+}  // namespace laplus
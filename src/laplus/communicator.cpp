@@ -0,0 +1,218 @@
+/******************************************************************************
+ *
+ * laplus/communicator.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/communicator.hpp"
+#include "laplus/internal/futex.hpp"
+#include "laplus/internal/mapping.hpp"
+#include "laplus/internal/simd.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#include <sys/mman.h>
+
+namespace laplus {
+
+// The segment starts with the barrier state, followed by the slots of bank
+// 0 and then those of bank 1.
+struct Communicator::Header {
+  std::atomic<std::uint32_t> ready;
+  std::atomic<std::uint32_t> count;
+  std::atomic<std::uint32_t> generation;
+};
+
+namespace {
+
+using simd = internal::simd<float>;
+
+const std::size_t width = simd::width;
+const std::size_t header_size = 64;
+const std::size_t default_capacity = 1 << 18;
+const std::uint32_t magic = 0x4C50434D;
+
+void backoff()
+{ std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+// y += x
+void accumulate(float* const y, const float* const x, const std::size_t n)
+{
+  std::size_t i = 0;
+  for(; i + width <= n; i += width)
+    simd::store(y + i, simd::add(simd::load(y + i), simd::load(x + i)));
+  for(; i < n; ++i) y[i] += x[i];
+}
+
+}  // unnamed namespace
+
+// Constructors and Destructor
+Communicator::Communicator(const std::string& name, const std::size_t rank,
+                           const std::size_t size)
+  : Communicator(name, rank, size, default_capacity)
+{}
+
+Communicator::Communicator(const std::string& name, const std::size_t rank,
+                           const std::size_t size, const std::size_t capacity)
+  : name(name[0] == '/' ? name : "/" + name), me(rank), ranks(size)
+  , chunk(capacity)
+  , length(header_size + 2 * size * capacity * sizeof(float))
+  , memory(nullptr), header(nullptr), round(0)
+{
+  assert(rank < size);
+  assert(capacity > 0);
+  static_assert(sizeof(Header) <= header_size, "header does not fit");
+
+  memory = internal::map_shared(this->name, length, me == 0);
+  if(!memory) return;
+  header = static_cast<Header*>(memory);
+
+  // A fresh segment is zero filled, which is the initial barrier state.
+  if(me == 0) {
+    header->ready.store(magic, std::memory_order_release);
+  } else {
+    while(header->ready.load(std::memory_order_acquire) != magic) backoff();
+  }
+  barrier();
+}
+
+Communicator::~Communicator()
+{
+  if(!memory) return;
+  barrier();
+  if(me == 0) header->ready.store(0, std::memory_order_release);
+  ::munmap(memory, length);
+  if(me == 0) ::shm_unlink(name.c_str());
+}
+
+// Collectives
+void Communicator::allreduce(Matrixf& m)
+{
+  assert(memory);
+  assert(m.inc() == 1);
+  float* const data = m.data();
+  const std::size_t n = m.size();
+  for(std::size_t offset = 0; offset < n; offset += chunk) {
+    const std::size_t count = std::min(chunk, n - offset);
+    const std::size_t bank = round++ % 2;
+    std::memcpy(slot(bank, me), data + offset, count * sizeof(float));
+    barrier();
+
+    // Reduce-scatter into the slot of rank 0.
+    const std::size_t first = count * me / ranks;
+    const std::size_t last = count * (me + 1) / ranks;
+    float* const sum = slot(bank, 0);
+    for(std::size_t k = 1; k < ranks; ++k)
+      accumulate(sum + first, slot(bank, k) + first, last - first);
+    barrier();
+
+    std::memcpy(data + offset, sum, count * sizeof(float));
+  }
+}
+
+void Communicator::broadcast(Matrixf& m, const std::size_t root)
+{
+  assert(memory);
+  assert(root < ranks);
+  assert(m.inc() == 1);
+  float* const data = m.data();
+  const std::size_t n = m.size();
+  for(std::size_t offset = 0; offset < n; offset += chunk) {
+    const std::size_t count = std::min(chunk, n - offset);
+    const std::size_t bank = round++ % 2;
+    float* const source = slot(bank, root);
+    if(me == root) std::memcpy(source, data + offset, count * sizeof(float));
+    barrier();
+    if(me != root) std::memcpy(data + offset, source, count * sizeof(float));
+  }
+}
+
+void Communicator::allgather(const Matrixf& m, Matrixf& result)
+{
+  assert(memory);
+  assert(result.rows() == ranks * m.rows() && result.cols() == m.cols());
+  assert(result.layout() == CblasRowMajor && result.inc() == 1);
+  const bool dense = m.layout() == CblasRowMajor && m.inc() == 1;
+  const Matrixf local = dense ? m : m.materialize();
+  const float* const data = local.data();
+  float* const out = result.data();
+  const std::size_t n = local.size();
+  for(std::size_t offset = 0; offset < n; offset += chunk) {
+    const std::size_t count = std::min(chunk, n - offset);
+    const std::size_t bank = round++ % 2;
+    std::memcpy(slot(bank, me), data + offset, count * sizeof(float));
+    barrier();
+    for(std::size_t k = 0; k < ranks; ++k) {
+      std::memcpy(out + k * n + offset, slot(bank, k),
+                  count * sizeof(float));
+    }
+  }
+}
+
+// Sense-counting barrier: the last rank to arrive resets the count and
+// bumps the generation everyone else waits on.
+void Communicator::barrier()
+{
+  assert(memory);
+  Header& h = *header;
+  const std::uint32_t generation =
+      h.generation.load(std::memory_order_acquire);
+  if(h.count.fetch_add(1, std::memory_order_acq_rel) + 1 == ranks) {
+    h.count.store(0, std::memory_order_relaxed);
+    h.generation.fetch_add(1, std::memory_order_release);
+    internal::wake_all(h.generation);
+    return;
+  }
+  internal::wait_while(h.generation, generation);
+}
+
+// Accessors
+const bool Communicator::is_open() const
+{ return memory != nullptr; }
+
+const std::size_t Communicator::rank() const
+{ return me; }
+
+const std::size_t Communicator::size() const
+{ return ranks; }
+
+const std::size_t Communicator::capacity() const
+{ return chunk; }
+
+float* const Communicator::slot(const std::size_t bank,
+                                const std::size_t rank) const
+{
+  char* const base = static_cast<char*>(memory) + header_size;
+  return reinterpret_cast<float*>(base) + (bank * ranks + rank) * chunk;
+}
+
+}  // namespace laplus
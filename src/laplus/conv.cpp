@@ -0,0 +1,480 @@
+/******************************************************************************
+ *
+ * laplus/conv.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/conv.hpp"
+#include "laplus/internal/parallel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include "cblas.h"
+
+namespace laplus {
+
+namespace {
+
+// Dimensions of one convolution, independent of the memory layout.
+struct Shape {
+  ConvLayout layout;
+  std::size_t n, c, h, w;
+  std::size_t o, kh, kw;
+  std::size_t oh, ow;
+  std::size_t sh, sw, ph, pw;
+
+  const std::size_t taps() const { return c * kh * kw; }
+  const std::size_t pixels() const { return oh * ow; }
+  const std::size_t image() const { return c * h * w; }
+  const std::size_t output() const { return o * oh * ow; }
+};
+
+Shape geometry(const dims_t& x, const dims_t& w, const ConvParams& params)
+{
+  assert(x.size() == 4);
+  assert(w.size() == 4);
+  Shape s;
+  s.layout = params.layout;
+  s.n = x[0];
+  s.o = w[0];
+  if(params.layout == NCHW) {
+    s.c = x[1]; s.h = x[2]; s.w = x[3];
+    s.kh = w[2]; s.kw = w[3];
+    assert(w[1] == s.c);
+  } else {
+    s.h = x[1]; s.w = x[2]; s.c = x[3];
+    s.kh = w[1]; s.kw = w[2];
+    assert(w[3] == s.c);
+  }
+  s.sh = params.stride_h;
+  s.sw = params.stride_w;
+  s.ph = params.pad_h;
+  s.pw = params.pad_w;
+  assert(s.sh > 0 && s.sw > 0);
+  assert(s.h + 2 * s.ph >= s.kh && s.w + 2 * s.pw >= s.kw);
+  s.oh = (s.h + 2 * s.ph - s.kh) / s.sh + 1;
+  s.ow = (s.w + 2 * s.pw - s.kw) / s.sw + 1;
+  return s;
+}
+
+dims_t output_dims(const Shape& s)
+{
+  if(s.layout == NCHW) return dims_t({s.n, s.o, s.oh, s.ow});
+  return dims_t({s.n, s.oh, s.ow, s.o});
+}
+
+// Input coordinate read by output coordinate o through filter tap k, or
+// false if it falls into the padding.
+const bool source(const std::size_t o, const std::size_t k,
+                  const std::size_t stride, const std::size_t pad,
+                  const std::size_t size, std::size_t& i)
+{
+  const std::size_t j = o * stride + k;
+  if(j < pad || j - pad >= size) return false;
+  i = j - pad;
+  return true;
+}
+
+// Output pixels per im2col block, sized to keep the column buffer of a
+// block around 256KB.
+const std::size_t block(const Shape& s)
+{
+  const std::size_t p = std::max<std::size_t>(16, 64 * 1024 / s.taps());
+  return std::min(p, s.pixels());
+}
+
+// Gathers the im2col rows of output pixels [p0, p0 + np) of one image into
+// col, laid out taps x np for NCHW and np x taps for NHWC. With scatter set
+// the columns are instead accumulated back into the image.
+template<bool scatter>
+void im2col(const Shape& s, float* x, const std::size_t p0,
+            const std::size_t np, float* col)
+{
+  std::size_t ih, iw;
+  if(s.layout == NCHW) {
+    for(std::size_t c = 0; c < s.c; ++c) {
+      float* const plane = x + c * s.h * s.w;
+      for(std::size_t i = 0; i < s.kh; ++i) {
+        for(std::size_t j = 0; j < s.kw; ++j) {
+          float* const row = col + ((c * s.kh + i) * s.kw + j) * np;
+          std::size_t oh = p0 / s.ow, ow = p0 % s.ow;
+          for(std::size_t p = 0; p < np; ++p) {
+            const bool inside = source(oh, i, s.sh, s.ph, s.h, ih)
+                             && source(ow, j, s.sw, s.pw, s.w, iw);
+            if(scatter) {
+              if(inside) plane[ih * s.w + iw] += row[p];
+            } else {
+              row[p] = inside ? plane[ih * s.w + iw] : 0.0f;
+            }
+            if(++ow == s.ow) {
+              ow = 0;
+              ++oh;
+            }
+          }
+        }
+      }
+    }
+    return;
+  }
+
+  std::size_t oh = p0 / s.ow, ow = p0 % s.ow;
+  for(std::size_t p = 0; p < np; ++p) {
+    for(std::size_t i = 0; i < s.kh; ++i) {
+      for(std::size_t j = 0; j < s.kw; ++j) {
+        float* const dst = col + p * s.taps() + (i * s.kw + j) * s.c;
+        const bool inside = source(oh, i, s.sh, s.ph, s.h, ih)
+                         && source(ow, j, s.sw, s.pw, s.w, iw);
+        if(!inside) {
+          if(!scatter) std::fill(dst, dst + s.c, 0.0f);
+          continue;
+        }
+        float* const src = x + (ih * s.w + iw) * s.c;
+        if(scatter) {
+          for(std::size_t c = 0; c < s.c; ++c) src[c] += dst[c];
+        } else {
+          std::copy(src, src + s.c, dst);
+        }
+      }
+    }
+    if(++ow == s.ow) {
+      ow = 0;
+      ++oh;
+    }
+  }
+}
+
+void im2col_forward(const Shape& s, const float* x, const float* w, float* y)
+{
+  const std::size_t K = s.taps();
+  const std::size_t P = s.pixels();
+  const std::size_t bp = block(s);
+  const std::size_t blocks = (P + bp - 1) / bp;
+  internal::parallel_run(s.n * blocks, [&](const std::size_t t) {
+    thread_local std::vector<float> col;
+    const std::size_t n = t / blocks;
+    const std::size_t p0 = (t % blocks) * bp;
+    const std::size_t np = std::min(bp, P - p0);
+    col.resize(K * np);
+    im2col<false>(s, const_cast<float*>(x) + n * s.image(), p0, np,
+                  col.data());
+    if(s.layout == NCHW) {
+      cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, s.o, np, K,
+                  1.0, w, K, col.data(), np, 0.0, y + n * s.output() + p0, P);
+    } else {
+      cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasTrans, np, s.o, K,
+                  1.0, col.data(), K, w, K, 0.0,
+                  y + n * s.output() + p0 * s.o, s.o);
+    }
+  });
+}
+
+void im2col_backward_data(const Shape& s, const float* dy, const float* w,
+                          float* dx)
+{
+  const std::size_t K = s.taps();
+  const std::size_t P = s.pixels();
+  const std::size_t bp = block(s);
+  internal::parallel_run(s.n, [&](const std::size_t n) {
+    thread_local std::vector<float> col;
+    col.resize(K * bp);
+    for(std::size_t p0 = 0; p0 < P; p0 += bp) {
+      const std::size_t np = std::min(bp, P - p0);
+      if(s.layout == NCHW) {
+        cblas_sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, K, np, s.o,
+                    1.0, w, K, dy + n * s.output() + p0, P,
+                    0.0, col.data(), np);
+      } else {
+        cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, np, K, s.o,
+                    1.0, dy + n * s.output() + p0 * s.o, s.o, w, K,
+                    0.0, col.data(), K);
+      }
+      im2col<true>(s, dx + n * s.image(), p0, np, col.data());
+    }
+  });
+}
+
+void im2col_backward_weight(const Shape& s, const float* x, const float* dy,
+                            float* dw)
+{
+  const std::size_t K = s.taps();
+  const std::size_t P = s.pixels();
+  const std::size_t bp = block(s);
+  const std::size_t tasks = std::min(s.n, internal::concurrency());
+  std::vector<float> partial(tasks * s.o * K, 0.0f);
+  internal::parallel_run(tasks, [&](const std::size_t t) {
+    thread_local std::vector<float> col;
+    float* const acc = partial.data() + t * s.o * K;
+    col.resize(K * bp);
+    for(std::size_t n = t; n < s.n; n += tasks) {
+      for(std::size_t p0 = 0; p0 < P; p0 += bp) {
+        const std::size_t np = std::min(bp, P - p0);
+        im2col<false>(s, const_cast<float*>(x) + n * s.image(), p0, np,
+                      col.data());
+        if(s.layout == NCHW) {
+          cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasTrans, s.o, K, np,
+                      1.0, dy + n * s.output() + p0, P, col.data(), np,
+                      1.0, acc, K);
+        } else {
+          cblas_sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, s.o, K, np,
+                      1.0, dy + n * s.output() + p0 * s.o, s.o,
+                      col.data(), K, 1.0, acc, K);
+        }
+      }
+    }
+  });
+  std::fill(dw, dw + s.o * K, 0.0f);
+  for(std::size_t t = 0; t < tasks; ++t) {
+    const float* const acc = partial.data() + t * s.o * K;
+    for(std::size_t i = 0; i < s.o * K; ++i) dw[i] += acc[i];
+  }
+}
+
+// Winograd F(2x2, 3x3) transforms. Each applies its 1-D transform to the
+// rows of the tile and then to the columns of the result.
+void filter_transform(const float g[3][3], float u[4][4])
+{
+  float t[4][3];
+  for(std::size_t j = 0; j < 3; ++j) {
+    t[0][j] = g[0][j];
+    t[1][j] = 0.5f * (g[0][j] + g[1][j] + g[2][j]);
+    t[2][j] = 0.5f * (g[0][j] - g[1][j] + g[2][j]);
+    t[3][j] = g[2][j];
+  }
+  for(std::size_t i = 0; i < 4; ++i) {
+    u[i][0] = t[i][0];
+    u[i][1] = 0.5f * (t[i][0] + t[i][1] + t[i][2]);
+    u[i][2] = 0.5f * (t[i][0] - t[i][1] + t[i][2]);
+    u[i][3] = t[i][2];
+  }
+}
+
+void input_transform(const float d[4][4], float v[4][4])
+{
+  float t[4][4];
+  for(std::size_t j = 0; j < 4; ++j) {
+    t[0][j] = d[0][j] - d[2][j];
+    t[1][j] = d[1][j] + d[2][j];
+    t[2][j] = d[2][j] - d[1][j];
+    t[3][j] = d[1][j] - d[3][j];
+  }
+  for(std::size_t i = 0; i < 4; ++i) {
+    v[i][0] = t[i][0] - t[i][2];
+    v[i][1] = t[i][1] + t[i][2];
+    v[i][2] = t[i][2] - t[i][1];
+    v[i][3] = t[i][1] - t[i][3];
+  }
+}
+
+void output_transform(const float m[4][4], float y[2][2])
+{
+  float t[2][4];
+  for(std::size_t j = 0; j < 4; ++j) {
+    t[0][j] = m[0][j] + m[1][j] + m[2][j];
+    t[1][j] = m[1][j] - m[2][j] - m[3][j];
+  }
+  for(std::size_t i = 0; i < 2; ++i) {
+    y[i][0] = t[i][0] + t[i][1] + t[i][2];
+    y[i][1] = t[i][1] - t[i][2] - t[i][3];
+  }
+}
+
+// Computes 2x2 output tiles as 16 independent O x C by C x tiles GEMMs in
+// the transformed domain, which takes 2.25x fewer multiplications than
+// the direct 3x3 convolution.
+void winograd_forward(const Shape& s, const float* x, const float* w,
+                      float* y)
+{
+  const bool planar = (s.layout == NCHW);
+  const std::size_t xc = planar ? s.h * s.w : 1;
+  const std::size_t xr = planar ? s.w : s.w * s.c;
+  const std::size_t xq = planar ? 1 : s.c;
+  const std::size_t yo = planar ? s.oh * s.ow : 1;
+  const std::size_t yr = planar ? s.ow : s.ow * s.o;
+  const std::size_t yq = planar ? 1 : s.o;
+
+  // Workers reach the caller's thread_local through this pointer, not by
+  // name, which would resolve to their own instance.
+  thread_local std::vector<float> filters;
+  filters.resize(16 * s.o * s.c);
+  float* const u = filters.data();
+  internal::parallel_for(0, s.o * s.c, 256, [&](const std::size_t first,
+                                                const std::size_t last) {
+    for(std::size_t k = first; k < last; ++k) {
+      const std::size_t o = k / s.c;
+      const std::size_t c = k % s.c;
+      float g[3][3];
+      float t[4][4];
+      for(std::size_t i = 0; i < 3; ++i) {
+        for(std::size_t j = 0; j < 3; ++j) {
+          g[i][j] = planar ? w[((o * s.c + c) * 3 + i) * 3 + j]
+                           : w[((o * 3 + i) * 3 + j) * s.c + c];
+        }
+      }
+      filter_transform(g, t);
+      for(std::size_t xi = 0; xi < 16; ++xi) {
+        u[(xi * s.o + o) * s.c + c] = t[xi / 4][xi % 4];
+      }
+    }
+  });
+
+  const std::size_t th = (s.oh + 1) / 2;
+  const std::size_t tw = (s.ow + 1) / 2;
+  const std::size_t tiles = th * tw;
+  const std::size_t tb = std::min(tiles,
+                                  std::max<std::size_t>(16, 16384 / s.c));
+  const std::size_t blocks = (tiles + tb - 1) / tb;
+  internal::parallel_run(s.n * blocks, [&](const std::size_t task) {
+    thread_local std::vector<float> v;
+    thread_local std::vector<float> m;
+    const std::size_t n = task / blocks;
+    const std::size_t t0 = (task % blocks) * tb;
+    const std::size_t nt = std::min(tb, tiles - t0);
+    const float* const image = x + n * s.image();
+    float* const out = y + n * s.output();
+    v.resize(16 * s.c * nt);
+    m.resize(16 * s.o * nt);
+
+    for(std::size_t c = 0; c < s.c; ++c) {
+      for(std::size_t t = 0; t < nt; ++t) {
+        const std::size_t r0 = 2 * ((t0 + t) / tw);
+        const std::size_t q0 = 2 * ((t0 + t) % tw);
+        float d[4][4];
+        float e[4][4];
+        std::size_t ih, iw;
+        for(std::size_t i = 0; i < 4; ++i) {
+          const bool row = source(r0, i, 1, s.ph, s.h, ih);
+          for(std::size_t j = 0; j < 4; ++j) {
+            d[i][j] = (row && source(q0, j, 1, s.pw, s.w, iw))
+                    ? image[c * xc + ih * xr + iw * xq] : 0.0f;
+          }
+        }
+        input_transform(d, e);
+        for(std::size_t xi = 0; xi < 16; ++xi) {
+          v[(xi * s.c + c) * nt + t] = e[xi / 4][xi % 4];
+        }
+      }
+    }
+
+    for(std::size_t xi = 0; xi < 16; ++xi) {
+      cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, s.o, nt, s.c,
+                  1.0, u + xi * s.o * s.c, s.c,
+                  v.data() + xi * s.c * nt, nt,
+                  0.0, m.data() + xi * s.o * nt, nt);
+    }
+
+    for(std::size_t o = 0; o < s.o; ++o) {
+      for(std::size_t t = 0; t < nt; ++t) {
+        const std::size_t r0 = 2 * ((t0 + t) / tw);
+        const std::size_t q0 = 2 * ((t0 + t) % tw);
+        float a[4][4];
+        float b[2][2];
+        for(std::size_t xi = 0; xi < 16; ++xi) {
+          a[xi / 4][xi % 4] = m[(xi * s.o + o) * nt + t];
+        }
+        output_transform(a, b);
+        for(std::size_t i = 0; i < 2 && r0 + i < s.oh; ++i) {
+          for(std::size_t j = 0; j < 2 && q0 + j < s.ow; ++j) {
+            out[o * yo + (r0 + i) * yr + (q0 + j) * yq] = b[i][j];
+          }
+        }
+      }
+    }
+  });
+}
+
+const bool winograd(const Shape& s, const ConvAlgorithm algorithm)
+{
+  const bool eligible = (s.kh == 3 && s.kw == 3 && s.sh == 1 && s.sw == 1);
+  if(algorithm == ConvWinograd) assert(eligible);
+  if(algorithm == ConvAuto) return eligible && s.c >= 8 && s.o >= 8;
+  return algorithm == ConvWinograd;
+}
+
+}  // unnamed namespace
+
+Tensorf conv2d(const Tensorf& x, const Tensorf& w, const ConvParams& params)
+{
+  const Shape s = geometry(x.dims(), w.dims(), params);
+  const Tensorf a = x.materialize();
+  const Tensorf b = w.materialize();
+  Tensorf y(output_dims(s));
+  if(winograd(s, params.algorithm)) {
+    winograd_forward(s, a.data(), b.data(), y.data());
+  } else {
+    im2col_forward(s, a.data(), b.data(), y.data());
+  }
+  return y;
+}
+
+Tensorf conv2d_backward_data(const Tensorf& dy, const Tensorf& w,
+                             const dims_t& dims, const ConvParams& params)
+{
+  const Shape s = geometry(dims, w.dims(), params);
+  assert(dy.dims() == output_dims(s));
+  const Tensorf a = dy.materialize();
+  Tensorf dx(dims);
+
+  // With stride 1 the data gradient is itself a convolution of dy with the
+  // rotated filters, channels swapped and the padding complemented.
+  if(winograd(s, params.algorithm) && s.ph <= 2 && s.pw <= 2) {
+    const dims_t order = (s.layout == NCHW) ? dims_t({1, 0, 2, 3})
+                                            : dims_t({3, 1, 2, 0});
+    const std::size_t h = (s.layout == NCHW) ? 2 : 1;
+    Tensorf b = w.permute(order).clone();
+    for(std::size_t i = 0; i < 3; ++i) {
+      b.select(h, i).copy(w.permute(order).select(h, 2 - i));
+    }
+    Tensorf f = b.clone();
+    for(std::size_t j = 0; j < 3; ++j) {
+      f.select(h + 1, j).copy(b.select(h + 1, 2 - j));
+    }
+    const ConvParams flipped = {params.layout, 1, 1, 2 - s.ph, 2 - s.pw,
+                                ConvWinograd};
+    const Shape r = geometry(a.dims(), f.dims(), flipped);
+    assert(output_dims(r) == dims);
+    winograd_forward(r, a.data(), f.data(), dx.data());
+    return dx;
+  }
+
+  const Tensorf b = w.materialize();
+  im2col_backward_data(s, a.data(), b.data(), dx.data());
+  return dx;
+}
+
+Tensorf conv2d_backward_weight(const Tensorf& x, const Tensorf& dy,
+                               const dims_t& dims, const ConvParams& params)
+{
+  const Shape s = geometry(x.dims(), dims, params);
+  assert(dy.dims() == output_dims(s));
+  const Tensorf a = x.materialize();
+  const Tensorf b = dy.materialize();
+  Tensorf dw(dims);
+  im2col_backward_weight(s, a.data(), b.data(), dw.data());
+  return dw;
+}
+
+}  // namespace laplus
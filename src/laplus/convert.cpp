@@ -0,0 +1,462 @@
+/******************************************************************************
+ *
+ * laplus/convert.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/convert.hpp"
+#include "laplus/internal/parallel.hpp"
+#include "laplus/internal/simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <immintrin.h>
+
+namespace laplus {
+
+namespace {
+
+template<typename D>
+struct limits;
+
+template<>
+struct limits<std::uint8_t> {
+  static constexpr float lowest = 0.0f;
+  static constexpr float highest = 255.0f;
+};
+
+template<>
+struct limits<std::int16_t> {
+  static constexpr float lowest = -32768.0f;
+  static constexpr float highest = 32767.0f;
+};
+
+// The largest float below 2^31.
+template<>
+struct limits<std::int32_t> {
+  static constexpr float lowest = -2147483648.0f;
+  static constexpr float highest = 2147483520.0f;
+};
+
+template<typename S>
+void widen_tail(const S* const src, float* const dst, const std::size_t n,
+                const float scale, const float bias)
+{
+  for(std::size_t i = 0; i < n; ++i) {
+    dst[i] = std::fma(static_cast<float>(src[i]), scale, bias);
+  }
+}
+
+template<typename D>
+void narrow_tail(const float* const src, D* const dst, const std::size_t n,
+                 const float scale, const float bias)
+{
+  for(std::size_t i = 0; i < n; ++i) {
+    float v = std::fma(src[i], scale, bias);
+    if(!(v >= limits<D>::lowest)) v = limits<D>::lowest;
+    if(v > limits<D>::highest) v = limits<D>::highest;
+    dst[i] = static_cast<D>(std::nearbyint(v));
+  }
+}
+
+void narrow_tail(const float* const src, double* const dst,
+                 const std::size_t n, const float scale, const float bias)
+{
+  for(std::size_t i = 0; i < n; ++i) dst[i] = std::fma(src[i], scale, bias);
+}
+
+#ifdef LAPLUS_AVX2
+__attribute__((target("avx2,fma")))
+inline __m256 affine(const __m256i x, const __m256 s, const __m256 b)
+{ return _mm256_fmadd_ps(_mm256_cvtepi32_ps(x), s, b); }
+
+template<typename D>
+__attribute__((target("avx2,fma")))
+inline __m256i saturate(const __m256 x, const __m256 s, const __m256 b)
+{
+  const __m256 v = _mm256_max_ps(_mm256_fmadd_ps(x, s, b),
+                                 _mm256_set1_ps(limits<D>::lowest));
+  return _mm256_cvtps_epi32(
+      _mm256_min_ps(v, _mm256_set1_ps(limits<D>::highest)));
+}
+
+__attribute__((target("avx2,fma")))
+std::size_t kernel_avx2(const std::uint8_t* const src, float* const dst,
+                        const std::size_t n, const float scale,
+                        const float bias)
+{
+  std::size_t i = 0;
+  const __m256 s = _mm256_set1_ps(scale);
+  const __m256 b = _mm256_set1_ps(bias);
+  for(; i + 32 <= n; i += 32) {
+    const __m256i x = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(src + i));
+    const __m128i lo = _mm256_castsi256_si128(x);
+    const __m128i hi = _mm256_extracti128_si256(x, 1);
+    _mm256_storeu_ps(dst + i, affine(_mm256_cvtepu8_epi32(lo), s, b));
+    _mm256_storeu_ps(dst + i + 8,
+                     affine(_mm256_cvtepu8_epi32(_mm_srli_si128(lo, 8)), s, b));
+    _mm256_storeu_ps(dst + i + 16, affine(_mm256_cvtepu8_epi32(hi), s, b));
+    _mm256_storeu_ps(dst + i + 24,
+                     affine(_mm256_cvtepu8_epi32(_mm_srli_si128(hi, 8)), s, b));
+  }
+  return i;
+}
+
+__attribute__((target("avx2,fma")))
+std::size_t kernel_avx2(const std::int16_t* const src, float* const dst,
+                        const std::size_t n, const float scale,
+                        const float bias)
+{
+  std::size_t i = 0;
+  const __m256 s = _mm256_set1_ps(scale);
+  const __m256 b = _mm256_set1_ps(bias);
+  for(; i + 16 <= n; i += 16) {
+    const __m256i x = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_ps(dst + i, affine(
+        _mm256_cvtepi16_epi32(_mm256_castsi256_si128(x)), s, b));
+    _mm256_storeu_ps(dst + i + 8, affine(
+        _mm256_cvtepi16_epi32(_mm256_extracti128_si256(x, 1)), s, b));
+  }
+  return i;
+}
+
+__attribute__((target("avx2,fma")))
+std::size_t kernel_avx2(const std::int32_t* const src, float* const dst,
+                        const std::size_t n, const float scale,
+                        const float bias)
+{
+  std::size_t i = 0;
+  const __m256 s = _mm256_set1_ps(scale);
+  const __m256 b = _mm256_set1_ps(bias);
+  for(; i + 8 <= n; i += 8) {
+    const __m256i x = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_ps(dst + i, affine(x, s, b));
+  }
+  return i;
+}
+
+__attribute__((target("avx2,fma")))
+std::size_t kernel_avx2(const double* const src, float* const dst,
+                        const std::size_t n, const float scale,
+                        const float bias)
+{
+  std::size_t i = 0;
+  const __m256 s = _mm256_set1_ps(scale);
+  const __m256 b = _mm256_set1_ps(bias);
+  for(; i + 8 <= n; i += 8) {
+    const __m128 lo = _mm256_cvtpd_ps(_mm256_loadu_pd(src + i));
+    const __m128 hi = _mm256_cvtpd_ps(_mm256_loadu_pd(src + i + 4));
+    const __m256 x = _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+    _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(x, s, b));
+  }
+  return i;
+}
+
+__attribute__((target("avx2,fma")))
+std::size_t kernel_avx2(const float* const src, std::uint8_t* const dst,
+                        const std::size_t n, const float scale,
+                        const float bias)
+{
+  std::size_t i = 0;
+  const __m256 s = _mm256_set1_ps(scale);
+  const __m256 b = _mm256_set1_ps(bias);
+  const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  for(; i + 32 <= n; i += 32) {
+    const __m256i x0 = saturate<std::uint8_t>(_mm256_loadu_ps(src + i), s, b);
+    const __m256i x1 = saturate<std::uint8_t>(_mm256_loadu_ps(src + i + 8),
+                                              s, b);
+    const __m256i x2 = saturate<std::uint8_t>(_mm256_loadu_ps(src + i + 16),
+                                              s, b);
+    const __m256i x3 = saturate<std::uint8_t>(_mm256_loadu_ps(src + i + 24),
+                                              s, b);
+    const __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(x0, x1),
+                                               _mm256_packs_epi32(x2, x3));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                        _mm256_permutevar8x32_epi32(packed, order));
+  }
+  return i;
+}
+
+__attribute__((target("avx2,fma")))
+std::size_t kernel_avx2(const float* const src, std::int16_t* const dst,
+                        const std::size_t n, const float scale,
+                        const float bias)
+{
+  std::size_t i = 0;
+  const __m256 s = _mm256_set1_ps(scale);
+  const __m256 b = _mm256_set1_ps(bias);
+  for(; i + 16 <= n; i += 16) {
+    const __m256i x0 = saturate<std::int16_t>(_mm256_loadu_ps(src + i), s, b);
+    const __m256i x1 = saturate<std::int16_t>(_mm256_loadu_ps(src + i + 8),
+                                              s, b);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                        _mm256_permute4x64_epi64(_mm256_packs_epi32(x0, x1),
+                                                 0xD8));
+  }
+  return i;
+}
+
+__attribute__((target("avx2,fma")))
+std::size_t kernel_avx2(const float* const src, std::int32_t* const dst,
+                        const std::size_t n, const float scale,
+                        const float bias)
+{
+  std::size_t i = 0;
+  const __m256 s = _mm256_set1_ps(scale);
+  const __m256 b = _mm256_set1_ps(bias);
+  for(; i + 8 <= n; i += 8) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                        saturate<std::int32_t>(_mm256_loadu_ps(src + i), s, b));
+  }
+  return i;
+}
+
+__attribute__((target("avx2,fma")))
+std::size_t kernel_avx2(const float* const src, double* const dst,
+                        const std::size_t n, const float scale,
+                        const float bias)
+{
+  std::size_t i = 0;
+  const __m256 s = _mm256_set1_ps(scale);
+  const __m256 b = _mm256_set1_ps(bias);
+  for(; i + 8 <= n; i += 8) {
+    const __m256 x = _mm256_fmadd_ps(_mm256_loadu_ps(src + i), s, b);
+    _mm256_storeu_pd(dst + i, _mm256_cvtps_pd(_mm256_castps256_ps128(x)));
+    _mm256_storeu_pd(dst + i + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(x, 1)));
+  }
+  return i;
+}
+#endif
+
+void kernel(const std::uint8_t* const src, float* const dst,
+            const std::size_t n, const float scale, const float bias)
+{
+  std::size_t i = 0;
+#ifdef LAPLUS_AVX2
+  if(internal::has_avx2()) i = kernel_avx2(src, dst, n, scale, bias);
+#endif
+  widen_tail(src + i, dst + i, n - i, scale, bias);
+}
+
+void kernel(const std::int16_t* const src, float* const dst,
+            const std::size_t n, const float scale, const float bias)
+{
+  std::size_t i = 0;
+#ifdef LAPLUS_AVX2
+  if(internal::has_avx2()) i = kernel_avx2(src, dst, n, scale, bias);
+#endif
+  widen_tail(src + i, dst + i, n - i, scale, bias);
+}
+
+void kernel(const std::int32_t* const src, float* const dst,
+            const std::size_t n, const float scale, const float bias)
+{
+  std::size_t i = 0;
+#ifdef LAPLUS_AVX2
+  if(internal::has_avx2()) i = kernel_avx2(src, dst, n, scale, bias);
+#endif
+  widen_tail(src + i, dst + i, n - i, scale, bias);
+}
+
+void kernel(const double* const src, float* const dst,
+            const std::size_t n, const float scale, const float bias)
+{
+  std::size_t i = 0;
+#ifdef LAPLUS_AVX2
+  if(internal::has_avx2()) i = kernel_avx2(src, dst, n, scale, bias);
+#endif
+  widen_tail(src + i, dst + i, n - i, scale, bias);
+}
+
+void kernel(const float* const src, std::uint8_t* const dst,
+            const std::size_t n, const float scale, const float bias)
+{
+  std::size_t i = 0;
+#ifdef LAPLUS_AVX2
+  if(internal::has_avx2()) i = kernel_avx2(src, dst, n, scale, bias);
+#endif
+  narrow_tail(src + i, dst + i, n - i, scale, bias);
+}
+
+void kernel(const float* const src, std::int16_t* const dst,
+            const std::size_t n, const float scale, const float bias)
+{
+  std::size_t i = 0;
+#ifdef LAPLUS_AVX2
+  if(internal::has_avx2()) i = kernel_avx2(src, dst, n, scale, bias);
+#endif
+  narrow_tail(src + i, dst + i, n - i, scale, bias);
+}
+
+void kernel(const float* const src, std::int32_t* const dst,
+            const std::size_t n, const float scale, const float bias)
+{
+  std::size_t i = 0;
+#ifdef LAPLUS_AVX2
+  if(internal::has_avx2()) i = kernel_avx2(src, dst, n, scale, bias);
+#endif
+  narrow_tail(src + i, dst + i, n - i, scale, bias);
+}
+
+void kernel(const float* const src, double* const dst,
+            const std::size_t n, const float scale, const float bias)
+{
+  std::size_t i = 0;
+#ifdef LAPLUS_AVX2
+  if(internal::has_avx2()) i = kernel_avx2(src, dst, n, scale, bias);
+#endif
+  narrow_tail(src + i, dst + i, n - i, scale, bias);
+}
+
+template<typename S, typename D>
+void bulk(const S* const src, D* const dst, const std::size_t n,
+          const float scale, const float bias)
+{
+  internal::parallel_for(0, n, internal::grain, [&](
+      const std::size_t first, const std::size_t last) {
+    kernel(src + first, dst + first, last - first, scale, bias);
+  });
+}
+
+template<typename S>
+Matrixf widen(const S* const src, const std::size_t rows,
+              const std::size_t cols, const float scale, const float bias)
+{
+  Matrixf result(new float[rows * cols], rows, cols,
+                 [](float* p) { delete[] p; });
+  bulk(src, result.data(), rows * cols, scale, bias);
+  return result;
+}
+
+// Transposed matrices are gathered a block of rows at a time.
+template<typename D>
+void narrow(const Matrixf& matrix, D* const dst,
+            const float scale, const float bias)
+{
+  const std::size_t rows = matrix.rows();
+  const std::size_t cols = matrix.cols();
+  if(matrix.layout() == CblasRowMajor) {
+    bulk(matrix.data(), dst, rows * cols, scale, bias);
+    return;
+  }
+  if(cols == 0) return;
+  const std::size_t block = 8;
+  const std::size_t blocks = (rows + block - 1) / block;
+  const std::size_t chunk =
+    std::max<std::size_t>(1, internal::grain / (block * cols));
+  internal::parallel_for(0, blocks, chunk, [&](const std::size_t first,
+                                               const std::size_t last) {
+    std::vector<float> buffer(block * cols);
+    for(std::size_t k = first; k < last; ++k) {
+      const std::size_t top = k * block;
+      const std::size_t height = std::min(block, rows - top);
+      for(std::size_t j = 0; j < cols; ++j) {
+        const float* const column = matrix.data() + j * rows + top;
+        for(std::size_t i = 0; i < height; ++i) {
+          buffer[i * cols + j] = column[i];
+        }
+      }
+      kernel(buffer.data(), dst + top * cols, height * cols, scale, bias);
+    }
+  });
+}
+
+}  // unnamed namespace
+
+void convert(const std::uint8_t* src, float* dst, const std::size_t n,
+             const float scale, const float bias)
+{ bulk(src, dst, n, scale, bias); }
+
+void convert(const std::int16_t* src, float* dst, const std::size_t n,
+             const float scale, const float bias)
+{ bulk(src, dst, n, scale, bias); }
+
+void convert(const std::int32_t* src, float* dst, const std::size_t n,
+             const float scale, const float bias)
+{ bulk(src, dst, n, scale, bias); }
+
+void convert(const double* src, float* dst, const std::size_t n,
+             const float scale, const float bias)
+{ bulk(src, dst, n, scale, bias); }
+
+void convert(const float* src, std::uint8_t* dst, const std::size_t n,
+             const float scale, const float bias)
+{ bulk(src, dst, n, scale, bias); }
+
+void convert(const float* src, std::int16_t* dst, const std::size_t n,
+             const float scale, const float bias)
+{ bulk(src, dst, n, scale, bias); }
+
+void convert(const float* src, std::int32_t* dst, const std::size_t n,
+             const float scale, const float bias)
+{ bulk(src, dst, n, scale, bias); }
+
+void convert(const float* src, double* dst, const std::size_t n,
+             const float scale, const float bias)
+{ bulk(src, dst, n, scale, bias); }
+
+Matrixf from_u8(const std::uint8_t* src,
+                const std::size_t rows, const std::size_t cols,
+                const float scale, const float bias)
+{ return widen(src, rows, cols, scale, bias); }
+
+Matrixf from_i16(const std::int16_t* src,
+                 const std::size_t rows, const std::size_t cols,
+                 const float scale, const float bias)
+{ return widen(src, rows, cols, scale, bias); }
+
+Matrixf from_i32(const std::int32_t* src,
+                 const std::size_t rows, const std::size_t cols,
+                 const float scale, const float bias)
+{ return widen(src, rows, cols, scale, bias); }
+
+Matrixf from_f64(const double* src,
+                 const std::size_t rows, const std::size_t cols,
+                 const float scale, const float bias)
+{ return widen(src, rows, cols, scale, bias); }
+
+void to_u8(const Matrixf& matrix, std::uint8_t* dst,
+           const float scale, const float bias)
+{ narrow(matrix, dst, scale, bias); }
+
+void to_i16(const Matrixf& matrix, std::int16_t* dst,
+            const float scale, const float bias)
+{ narrow(matrix, dst, scale, bias); }
+
+void to_i32(const Matrixf& matrix, std::int32_t* dst,
+            const float scale, const float bias)
+{ narrow(matrix, dst, scale, bias); }
+
+void to_f64(const Matrixf& matrix, double* dst,
+            const float scale, const float bias)
+{ narrow(matrix, dst, scale, bias); }
+
+}  // namespace laplus
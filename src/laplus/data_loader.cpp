@@ -0,0 +1,299 @@
+/******************************************************************************
+ *
+ * laplus/data_loader.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/data_loader.hpp"
+#include "laplus/convert.hpp"
+#include "laplus/random.hpp"
+#include "laplus/internal/mapping.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+namespace laplus {
+
+namespace {
+
+const std::uint32_t big_endian(const char* const p)
+{
+  const unsigned char* const q = reinterpret_cast<const unsigned char*>(p);
+  return (std::uint32_t(q[0]) << 24) | (std::uint32_t(q[1]) << 16)
+       | (std::uint32_t(q[2]) << 8) | std::uint32_t(q[3]);
+}
+
+}  // unnamed namespace
+
+// Generators
+Records Records::IDX(const std::string& path)
+{
+  std::size_t size = 0;
+  const std::shared_ptr<char> mapping = internal::map_file(path, size);
+  if(!mapping || size < 4) return Records("", 0, 1);
+
+  const char* const p = mapping.get();
+  const std::size_t rank = static_cast<unsigned char>(p[3]);
+  const std::size_t header = 4 + 4 * rank;
+  if(p[0] != 0 || p[1] != 0 || p[2] != 0x08 || rank == 0 || size < header) {
+    return Records("", 0, 1);
+  }
+  std::size_t record = 1;
+  for(std::size_t i = 1; i < rank; ++i) record *= big_endian(p + 4 + 4 * i);
+
+  Records result("", 0, 1);
+  result.mapping = mapping;
+  result.first = reinterpret_cast<const std::uint8_t*>(p + header);
+  result.count = std::min<std::size_t>(big_endian(p + 4),
+                                       record ? (size - header) / record : 0);
+  result.length = record;
+  return result;
+}
+
+// Constructors and Destructor
+Records::Records(const std::string& path, const std::size_t header,
+                 const std::size_t record)
+  : mapping(nullptr), first(nullptr), count(0), length(record)
+{
+  assert(record > 0);
+  std::size_t size = 0;
+  mapping = internal::map_file(path, size);
+  if(!mapping || size < header) {
+    mapping = nullptr;
+    return;
+  }
+  first = reinterpret_cast<const std::uint8_t*>(mapping.get() + header);
+  count = (size - header) / record;
+}
+
+Records::Records(const Records& other)
+  : mapping(other.mapping), first(other.first)
+  , count(other.count), length(other.length)
+{}
+
+Records::Records(Records&& other) noexcept
+  : mapping(std::move(other.mapping)), first(other.first)
+  , count(other.count), length(other.length)
+{
+  other.first = nullptr;
+  other.count = 0;
+}
+
+Records::~Records() {}
+
+// Assignment Operators
+Records& Records::operator=(const Records& other)
+{
+  Records another(other);
+  *this = std::move(another);
+  return *this;
+}
+
+Records& Records::operator=(Records&& other) noexcept
+{
+  swap(*this, other);
+  return *this;
+}
+
+// Miscellaneous Operators
+const std::uint8_t* Records::operator[](const std::size_t index) const
+{
+  assert(index < count);
+  return first + index * length;
+}
+
+// Utilities
+void swap(Records& a, Records& b)
+{
+  using std::swap;
+  swap(a.mapping, b.mapping);
+  swap(a.first, b.first);
+  swap(a.count, b.count);
+  swap(a.length, b.length);
+}
+
+// Accessors
+const bool Records::is_open() const
+{ return mapping != nullptr; }
+
+const std::size_t Records::size() const
+{ return count; }
+
+const std::size_t Records::record_size() const
+{ return length; }
+
+// Constructors and Destructor
+DataLoader::DataLoader(const Records& features, const Records& labels,
+                       const LoaderParams& params)
+  : features(features), labels(labels), params(params)
+  , count(std::min(features.size(), labels.size()))
+  , issued(0), current(0), released(0), position(0), stop(false)
+{
+  assert(params.batch_size > 0);
+  assert(params.depth > 0);
+  assert(features.size() == labels.size());
+  assert(params.classes == 0 || labels.record_size() == 1);
+
+  const std::size_t cols = (params.classes > 0)
+                         ? params.classes : labels.record_size();
+  for(std::size_t i = 0; i < params.depth; ++i) {
+    slots.push_back({Matrixf(params.batch_size, features.record_size()),
+                     Matrixf(params.batch_size, cols), i, 0});
+  }
+  if(batches() == 0) return;
+  for(std::size_t i = 0; i < std::max<std::size_t>(params.workers, 1); ++i) {
+    workers.emplace_back(&DataLoader::work, this);
+  }
+}
+
+DataLoader::~DataLoader()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  consumed.notify_all();
+  for(std::thread& worker: workers) worker.join();
+}
+
+// Utilities
+const bool DataLoader::next(Matrixf& x, Matrixf& t)
+{
+  if(batches() == 0) return false;
+
+  std::unique_lock<std::mutex> lock(mutex);
+  if(released < current) {
+    slots[(current - 1) % params.depth].free = current - 1 + params.depth;
+    released = current;
+    consumed.notify_all();
+  }
+  if(position == batches()) {
+    position = 0;
+    return false;
+  }
+
+  Slot& slot = slots[current % params.depth];
+  produced.wait(lock, [&]() { return slot.ready == current + 1; });
+  const std::size_t rows = std::min(params.batch_size,
+                                    count - position * params.batch_size);
+  if(rows == params.batch_size) {
+    x = slot.x;
+    t = slot.t;
+  } else {
+    x = Matrixf(Vectorf(slot.x, 0, 1, rows * slot.x.cols()))
+        .reshape(rows, slot.x.cols());
+    t = Matrixf(Vectorf(slot.t, 0, 1, rows * slot.t.cols()))
+        .reshape(rows, slot.t.cols());
+  }
+  ++current;
+  ++position;
+  return true;
+}
+
+// Accessors
+const std::size_t DataLoader::batches() const
+{
+  if(params.drop_last) return count / params.batch_size;
+  return (count + params.batch_size - 1) / params.batch_size;
+}
+
+const std::size_t DataLoader::epoch() const
+{ return batches() ? (current - position) / batches() : 0; }
+
+void DataLoader::work()
+{
+  for(;;) {
+    std::size_t batch;
+    Slot* slot;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      batch = issued++;
+      slot = &slots[batch % params.depth];
+      consumed.wait(lock, [&]() { return stop || slot->free == batch; });
+      if(stop) return;
+    }
+    fill(batch, *slot);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      slot->ready = batch + 1;
+    }
+    produced.notify_all();
+  }
+}
+
+void DataLoader::fill(const std::size_t batch, Slot& slot)
+{
+  const std::shared_ptr<const std::vector<std::size_t>> indices =
+      order(batch / batches());
+  const std::size_t first = (batch % batches()) * params.batch_size;
+  const std::size_t rows = std::min(params.batch_size, count - first);
+  const std::size_t cols = features.record_size();
+
+  for(std::size_t i = 0; i < rows; ++i) {
+    const std::size_t index = (*indices)[first + i];
+    convert(features[index], slot.x.data() + i * cols, cols,
+            params.scale, params.bias);
+    float* const target = slot.t.data() + i * slot.t.cols();
+    if(params.classes > 0) {
+      std::fill(target, target + params.classes, 0.0f);
+      const std::size_t label = labels[index][0];
+      if(label < params.classes) target[label] = 1.0f;
+    } else {
+      convert(labels[index], target, slot.t.cols(), 1.0f, 0.0f);
+    }
+  }
+}
+
+// Fisher-Yates shuffle drawing from Philox stream epoch of the seed.
+// Orders of epochs the consumer has finished are dropped.
+std::shared_ptr<const std::vector<std::size_t>>
+DataLoader::order(const std::size_t epoch)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  orders.erase(orders.begin(), orders.lower_bound(this->epoch()));
+  auto found = orders.find(epoch);
+  if(found != orders.end()) return found->second;
+
+  std::vector<std::size_t> result(count);
+  std::iota(result.begin(), result.end(), 0);
+  if(params.shuffle) {
+    const Philox philox(params.seed, epoch);
+    std::uint32_t words[4];
+    for(std::size_t k = 0; k + 1 < count; ++k) {
+      if(k % 4 == 0) philox.block(k / 4, words);
+      const std::size_t i = count - 1 - k;
+      const std::size_t j = (std::uint64_t(words[k % 4]) * (i + 1)) >> 32;
+      std::swap(result[i], result[j]);
+    }
+  }
+  const std::shared_ptr<const std::vector<std::size_t>> shared =
+      std::make_shared<const std::vector<std::size_t>>(std::move(result));
+  orders[epoch] = shared;
+  return shared;
+}
+
+}  // namespace laplus
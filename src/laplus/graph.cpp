@@ -0,0 +1,439 @@
+/******************************************************************************
+ *
+ * laplus/graph.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/graph.hpp"
+#include "laplus/internal/parallel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace laplus {
+
+namespace {
+
+const std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+// Elements per register, registers per kernel and arena alignment in
+// floats.
+const std::size_t chunk = 256;
+const std::size_t registers = 16;
+const std::size_t align = 16;
+
+float placeholder = 0.0f;
+
+Matrixf view(float* const p, const std::size_t rows, const std::size_t cols)
+{ return Matrixf(p, rows, cols, [](float*) {}); }
+
+Matrixf op(const Matrixf& x, const CBLAS_TRANSPOSE t)
+{ return (t == CblasTrans) ? x.transpose() : x; }
+
+#ifndef NDEBUG
+const bool dense(const Matrixf& x)
+{
+  return x.inc() == 1
+         && (x.layout() == CblasRowMajor || x.rows() == 1 || x.cols() == 1);
+}
+#endif
+
+// A block of the arena shared by values with disjoint lifetimes.
+struct Slot {
+  std::size_t size;
+  std::size_t begin;
+  std::size_t end;
+  std::size_t offset;
+};
+
+}  // unnamed namespace
+
+// Constructors and Destructor
+Graph::Graph() : epoch(0), compiled(false) {}
+
+// Leaves
+const std::size_t Graph::input(const std::size_t rows,
+                               const std::size_t cols)
+{ return record(Input, npos, npos, 0.0f, rows, cols); }
+
+const std::size_t Graph::parameter(const Matrixf& x)
+{
+  assert(dense(x));
+  const std::size_t id = record(Parameter, npos, npos, 0.0f, x.rows(),
+                                x.cols());
+  values[id] = x;
+  return id;
+}
+
+// Operations
+const std::size_t Graph::dot(const std::size_t a, const std::size_t b,
+                             const CBLAS_TRANSPOSE ta,
+                             const CBLAS_TRANSPOSE tb)
+{
+  const Node& x = nodes[a];
+  const Node& y = nodes[b];
+  const std::size_t m = (ta == CblasTrans) ? x.cols : x.rows;
+  const std::size_t n = (tb == CblasTrans) ? y.rows : y.cols;
+  assert(((ta == CblasTrans) ? x.rows : x.cols)
+         == ((tb == CblasTrans) ? y.cols : y.rows));
+  const std::size_t id = record(Dot, a, b, 0.0f, m, n);
+  nodes[id].ta = ta;
+  nodes[id].tb = tb;
+  return id;
+}
+
+const std::size_t Graph::add(const std::size_t a, const std::size_t b)
+{ return binary(Add, a, b); }
+
+const std::size_t Graph::sub(const std::size_t a, const std::size_t b)
+{ return binary(Sub, a, b); }
+
+const std::size_t Graph::mul(const std::size_t a, const std::size_t b)
+{ return binary(Mul, a, b); }
+
+const std::size_t Graph::scale(const std::size_t a, const float s)
+{ return unary(Scale, a, s); }
+
+const std::size_t Graph::sigmoid(const std::size_t a)
+{ return unary(Sigmoid, a, 0.0f); }
+
+const std::size_t Graph::dsigmoid(const std::size_t a)
+{ return unary(DSigmoid, a, 0.0f); }
+
+const std::size_t Graph::tanh(const std::size_t a)
+{ return unary(Tanh, a, 0.0f); }
+
+const std::size_t Graph::relu(const std::size_t a)
+{ return unary(Relu, a, 0.0f); }
+
+void Graph::update(const std::size_t target, const float alpha,
+                   const std::size_t a, const std::size_t b,
+                   const CBLAS_TRANSPOSE ta, const CBLAS_TRANSPOSE tb)
+{
+  assert(nodes[target].op == Parameter);
+  const std::size_t product = dot(a, b, ta, tb);
+  assert(nodes[product].rows == nodes[target].rows);
+  assert(nodes[product].cols == nodes[target].cols);
+  Node& node = nodes[product];
+  node.op = Update;
+  node.s = alpha;
+  node.c = target;
+  ++epoch;
+}
+
+void Graph::output(const std::size_t id)
+{ nodes[id].output = true; }
+
+// Compilation and Execution
+void Graph::compile()
+{
+  const std::size_t count = nodes.size();
+  const auto elementwise = [&](const std::size_t i) {
+    return nodes[i].op >= Add && nodes[i].op <= Relu;
+  };
+
+  // Fusion: a single-use elementwise node of the same shape and epoch as
+  // its elementwise consumer is evaluated inside the consumer's kernel, as
+  // long as the kernel still has a register for every operand after it.
+  std::vector<std::size_t> uses(count, 0);
+  for(const Node& node: nodes) {
+    if(node.a != npos) ++uses[node.a];
+    if(node.b != npos) ++uses[node.b];
+  }
+  std::vector<bool> inlined(count, false);
+  std::vector<std::size_t> size(count, 1);
+  for(std::size_t i = 0; i < count; ++i) {
+    if(!elementwise(i)) continue;
+    const std::size_t operands[2] = {nodes[i].a, nodes[i].b};
+    for(std::size_t k = 0; k < 2; ++k) {
+      const std::size_t o = operands[k];
+      if(o == npos) continue;
+      const std::size_t pending = (k == 0 && operands[1] != npos) ? 1 : 0;
+      const bool fusible = elementwise(o) && uses[o] == 1
+                           && !nodes[o].output
+                           && nodes[o].epoch == nodes[i].epoch
+                           && nodes[o].rows == nodes[i].rows
+                           && nodes[o].cols == nodes[i].cols;
+      if(fusible && size[i] + size[o] + pending <= registers) {
+        inlined[o] = true;
+        size[i] += size[o];
+      } else {
+        size[i] += 1;
+      }
+    }
+  }
+
+  // Scheduling, with the step at which each value is defined and last read.
+  program.clear();
+  steps.clear();
+  std::vector<std::size_t> begin(count, npos);
+  std::vector<std::size_t> end(count, npos);
+  const auto read = [&](const std::size_t v) { end[v] = steps.size(); };
+  for(std::size_t i = 0; i < count; ++i) {
+    const Node& node = nodes[i];
+    if(node.op == Input || node.op == Parameter || inlined[i]) continue;
+    Step step = {node.op, i, 0, 0, 1, node.rows * node.cols};
+    if(elementwise(i)) {
+      step.op = Kernel;
+      step.first = program.size();
+      emit(i, step.first, inlined);
+      step.last = program.size();
+      for(std::size_t k = step.first; k < step.last; ++k) {
+        if(program[k].op == Load) read(program[k].value);
+      }
+      const std::size_t n = node.rows * node.cols;
+      step.tasks = std::min(internal::concurrency(),
+                            (n + internal::grain - 1) / internal::grain);
+      step.tasks = std::max<std::size_t>(step.tasks, 1);
+      step.span = (n + step.tasks - 1) / step.tasks;
+    } else {
+      read(node.a);
+      read(node.b);
+    }
+    begin[i] = steps.size();
+    steps.push_back(step);
+  }
+
+  // Liveness: outputs stay alive to the end, and a kernel writes over an
+  // operand of its own size that dies with it.
+  std::vector<std::size_t> slot(count, npos);
+  std::vector<Slot> slots;
+  for(const Step& step: steps) {
+    const std::size_t i = step.node;
+    if(step.op == Update) continue;
+    const Node& node = nodes[i];
+    const std::size_t dead = (end[i] == npos) ? begin[i] : end[i];
+    const std::size_t last = node.output ? steps.size() : dead;
+    std::size_t reuse = npos;
+    for(std::size_t k = step.first; k < step.last && reuse == npos; ++k) {
+      const std::size_t v = program[k].value;
+      if(program[k].op != Load || slot[v] == npos || nodes[v].output) continue;
+      if(end[v] == begin[i] && nodes[v].rows * nodes[v].cols
+                               == node.rows * node.cols) {
+        reuse = slot[v];
+      }
+    }
+    if(reuse != npos) {
+      slot[i] = reuse;
+      slots[reuse].end = std::max(slots[reuse].end, last);
+    } else {
+      slot[i] = slots.size();
+      const std::size_t n = node.rows * node.cols;
+      slots.push_back({(n + align - 1) / align * align, begin[i], last, 0});
+    }
+  }
+
+  // Placement: largest first, each at the lowest offset clear of every
+  // placed slot whose lifetime overlaps its own.
+  std::vector<std::size_t> order(slots.size());
+  for(std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&](const std::size_t x,
+                                                   const std::size_t y) {
+    return slots[x].size > slots[y].size;
+  });
+  std::vector<std::size_t> placed;
+  std::size_t total = 0;
+  for(const std::size_t i: order) {
+    Slot& s = slots[i];
+    std::vector<std::size_t> clash;
+    for(const std::size_t j: placed) {
+      if(slots[j].begin <= s.end && s.begin <= slots[j].end) clash.push_back(j);
+    }
+    std::sort(clash.begin(), clash.end(), [&](const std::size_t x,
+                                              const std::size_t y) {
+      return slots[x].offset < slots[y].offset;
+    });
+    s.offset = 0;
+    for(const std::size_t j: clash) {
+      if(s.offset + s.size <= slots[j].offset) break;
+      s.offset = std::max(s.offset, slots[j].offset + slots[j].size);
+    }
+    total = std::max(total, s.offset + s.size);
+    placed.push_back(i);
+  }
+
+  memory.assign(total, 0.0f);
+  for(std::size_t i = 0; i < count; ++i) {
+    if(slot[i] == npos) continue;
+    values[i] = view(memory.data() + slots[slot[i]].offset, nodes[i].rows,
+                     nodes[i].cols);
+  }
+  compiled = true;
+}
+
+void Graph::bind(const std::size_t id, const Matrixf& x)
+{
+  assert(nodes[id].op == Input);
+  assert(x.rows() == nodes[id].rows && x.cols() == nodes[id].cols);
+  assert(dense(x));
+  values[id] = x;
+}
+
+void Graph::run()
+{
+  assert(compiled);
+  for(const Step& step: steps) {
+    const Node& node = nodes[step.node];
+    switch(step.op) {
+    case Dot:
+      values[step.node].gemm(1.0f, op(values[node.a], node.ta),
+                             op(values[node.b], node.tb), 0.0f);
+      break;
+    case Update:
+      values[node.c].gemm(node.s, op(values[node.a], node.ta),
+                          op(values[node.b], node.tb), 1.0f);
+      break;
+    default:
+      internal::parallel_run(step.tasks, [this, &step](const std::size_t t) {
+        const std::size_t n = nodes[step.node].rows * nodes[step.node].cols;
+        const std::size_t first = t * step.span;
+        execute(step, first, std::min(n, first + step.span));
+      });
+      break;
+    }
+  }
+}
+
+// Accessors
+const Matrixf& Graph::value(const std::size_t id) const
+{ return values[id]; }
+
+const std::size_t Graph::kernels() const
+{ return steps.size(); }
+
+const std::size_t Graph::arena() const
+{ return memory.size(); }
+
+// Capture
+const std::size_t Graph::record(const Op op, const std::size_t a,
+                                const std::size_t b, const float s,
+                                const std::size_t rows,
+                                const std::size_t cols)
+{
+  nodes.push_back({op, CblasNoTrans, CblasNoTrans, s, a, b, npos, rows, cols,
+                   epoch, false});
+  values.push_back(view(&placeholder, 1, 1));
+  compiled = false;
+  return nodes.size() - 1;
+}
+
+const std::size_t Graph::binary(const Op op, const std::size_t a,
+                                const std::size_t b)
+{
+  assert(nodes[a].cols == nodes[b].cols);
+  assert(nodes[a].rows == nodes[b].rows || nodes[b].rows == 1);
+  return record(op, a, b, 0.0f, nodes[a].rows, nodes[a].cols);
+}
+
+const std::size_t Graph::unary(const Op op, const std::size_t a,
+                               const float s)
+{ return record(op, a, npos, s, nodes[a].rows, nodes[a].cols); }
+
+// Appends the instructions of node i and its fused operands, and returns
+// the register holding its result.
+const std::uint8_t Graph::emit(const std::size_t i, const std::size_t first,
+                               const std::vector<bool>& inlined)
+{
+  const Node& node = nodes[i];
+  std::uint8_t operand[2] = {0, 0};
+  const std::size_t inputs[2] = {node.a, node.b};
+  for(std::size_t k = 0; k < 2; ++k) {
+    const std::size_t o = inputs[k];
+    if(o == npos) continue;
+    if(inlined[o]) {
+      operand[k] = emit(o, first, inlined);
+    } else {
+      const bool broadcast = nodes[o].rows != node.rows;
+      program.push_back({Load, broadcast, 0, 0, 0.0f, o});
+      operand[k] = program.size() - 1 - first;
+    }
+  }
+  program.push_back({node.op, false, operand[0], operand[1], node.s, npos});
+  return program.size() - 1 - first;
+}
+
+void Graph::execute(const Step& step, const std::size_t first,
+                    const std::size_t last) const
+{
+  assert(step.last - step.first <= registers);
+  float reg[registers][chunk];
+  float* const out = values[step.node].data();
+  const std::size_t cols = nodes[step.node].cols;
+  for(std::size_t base = first; base < last; base += chunk) {
+    const std::size_t n = std::min(chunk, last - base);
+    for(std::size_t k = step.first; k < step.last; ++k) {
+      const Instr& in = program[k];
+      float* const r = reg[k - step.first];
+      const float* const x = reg[in.a];
+      const float* const y = reg[in.b];
+      switch(in.op) {
+      case Load: {
+        const float* const p = values[in.value].data();
+        if(in.broadcast) {
+          for(std::size_t i = 0; i < n; ++i) r[i] = p[(base + i) % cols];
+        } else {
+          for(std::size_t i = 0; i < n; ++i) r[i] = p[base + i];
+        }
+        break;
+      }
+      case Add:
+        for(std::size_t i = 0; i < n; ++i) r[i] = x[i] + y[i];
+        break;
+      case Sub:
+        for(std::size_t i = 0; i < n; ++i) r[i] = x[i] - y[i];
+        break;
+      case Mul:
+        for(std::size_t i = 0; i < n; ++i) r[i] = x[i] * y[i];
+        break;
+      case Scale:
+        for(std::size_t i = 0; i < n; ++i) r[i] = in.s * x[i];
+        break;
+      case Sigmoid:
+        for(std::size_t i = 0; i < n; ++i) {
+          r[i] = std::tanh(x[i] * 0.5f) * 0.5f + 0.5f;
+        }
+        break;
+      case DSigmoid:
+        for(std::size_t i = 0; i < n; ++i) r[i] = x[i] * (1.0f - x[i]);
+        break;
+      case Tanh:
+        for(std::size_t i = 0; i < n; ++i) r[i] = std::tanh(x[i]);
+        break;
+      case Relu:
+        for(std::size_t i = 0; i < n; ++i) r[i] = std::max(0.0f, x[i]);
+        break;
+      default:
+        break;
+      }
+    }
+    const float* const r = reg[step.last - 1 - step.first];
+    std::copy(r, r + n, out + base);
+  }
+}
+
+}  // namespace laplus
@@ -0,0 +1,255 @@
+/******************************************************************************
+ *
+ * laplus/half.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/half.hpp"
+#include "laplus/internal/simd.hpp"
+
+#include <cstring>
+
+#include <immintrin.h>
+
+namespace laplus {
+
+namespace {
+
+std::uint32_t bits_of(const float value)
+{
+  std::uint32_t x;
+  std::memcpy(&x, &value, sizeof(x));
+  return x;
+}
+
+float float_of(const std::uint32_t x)
+{
+  float value;
+  std::memcpy(&value, &x, sizeof(value));
+  return value;
+}
+
+std::uint16_t narrow_half(const float value)
+{
+  std::uint32_t x = bits_of(value);
+  const std::uint32_t sign = (x >> 16) & 0x8000;
+  x &= 0x7fffffff;
+
+  // Infinity and NaN, keeping NaNs quiet.
+  if(x >= 0x7f800000) {
+    if(x == 0x7f800000) return sign | 0x7c00;
+    return sign | 0x7e00 | ((x >> 13) & 0x3ff);
+  }
+  if(x >= 0x47800000) return sign | 0x7c00;
+
+  // Subnormal results.
+  if(x < 0x38800000) {
+    if(x < 0x33000000) return sign;
+    const std::uint32_t shift = 126 - (x >> 23);
+    const std::uint32_t m = (x & 0x7fffff) | 0x800000;
+    const std::uint32_t rem = m & ((1u << shift) - 1);
+    const std::uint32_t tie = 1u << (shift - 1);
+    std::uint32_t h = m >> shift;
+    if(rem > tie || (rem == tie && (h & 1))) ++h;
+    return sign | h;
+  }
+
+  std::uint32_t h = (x - 0x38000000) >> 13;
+  const std::uint32_t rem = x & 0x1fff;
+  if(rem > 0x1000 || (rem == 0x1000 && (h & 1))) ++h;
+  return sign | h;
+}
+
+float widen_half(const std::uint16_t h)
+{
+  const std::uint32_t sign = static_cast<std::uint32_t>(h & 0x8000) << 16;
+  std::uint32_t e = (h >> 10) & 0x1f;
+  std::uint32_t m = h & 0x3ff;
+  if(e == 0x1f) return float_of(sign | 0x7f800000 | (m << 13));
+  if(e != 0) return float_of(sign | ((e + 112) << 23) | (m << 13));
+  if(m == 0) return float_of(sign);
+  for(e = 113; !(m & 0x400); --e) m <<= 1;
+  return float_of(sign | (e << 23) | ((m & 0x3ff) << 13));
+}
+
+std::uint16_t narrow_bfloat16(const float value)
+{
+  const std::uint32_t x = bits_of(value);
+  if((x & 0x7fffffff) > 0x7f800000) return (x >> 16) | 0x40;
+  return (x + 0x7fff + ((x >> 16) & 1)) >> 16;
+}
+
+float widen_bfloat16(const std::uint16_t b)
+{ return float_of(static_cast<std::uint32_t>(b) << 16); }
+
+#ifdef LAPLUS_F16C
+__attribute__((target("avx,f16c")))
+std::size_t widen_half_f16c(const half* src, float* dst, const std::size_t n)
+{
+  std::size_t i = 0;
+  for(; i + 8 <= n; i += 8) {
+    __m128i v0 = _mm_loadu_si128((const __m128i*)(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(v0));
+  }
+  return i;
+}
+
+__attribute__((target("avx,f16c")))
+std::size_t narrow_half_f16c(const float* src, half* dst, const std::size_t n)
+{
+  std::size_t i = 0;
+  for(; i + 8 <= n; i += 8) {
+    __m256 v0 = _mm256_loadu_ps(src + i);
+    __m128i v1 = _mm256_cvtps_ph(v0, _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128((__m128i*)(dst + i), v1);
+  }
+  return i;
+}
+
+const bool has_f16c()
+{
+  static const bool supported = __builtin_cpu_supports("f16c");
+  return supported;
+}
+#endif
+
+#ifdef LAPLUS_AVX512BF16
+__attribute__((target("avx512f,avx512vl,avx512bf16")))
+std::size_t narrow_bfloat16_avx512(const float* src, bfloat16* dst,
+                                   const std::size_t n)
+{
+  std::size_t i = 0;
+  for(; i + 16 <= n; i += 16) {
+    __m256bh v0 = _mm512_cvtneps_pbh(_mm512_loadu_ps(src + i));
+    _mm256_storeu_si256((__m256i*)(dst + i), (__m256i)v0);
+  }
+  return i;
+}
+
+const bool has_avx512bf16()
+{
+  static const bool supported = __builtin_cpu_supports("avx512bf16");
+  return supported;
+}
+#endif
+
+#ifdef LAPLUS_AVX2
+__attribute__((target("avx2")))
+std::size_t widen_bfloat16_avx2(const bfloat16* src, float* dst,
+                                const std::size_t n)
+{
+  std::size_t i = 0;
+  for(; i + 8 <= n; i += 8) {
+    __m128i v0 = _mm_loadu_si128((const __m128i*)(src + i));
+    __m256i v1 = _mm256_slli_epi32(_mm256_cvtepu16_epi32(v0), 16);
+    _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(v1));
+  }
+  return i;
+}
+
+__attribute__((target("avx2")))
+std::size_t narrow_bfloat16_avx2(const float* src, bfloat16* dst,
+                                 const std::size_t n)
+{
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i bias = _mm256_set1_epi32(0x7fff);
+  const __m256i quiet = _mm256_set1_epi32(0x40);
+  std::size_t i = 0;
+  for(; i + 8 <= n; i += 8) {
+    __m256 v0 = _mm256_loadu_ps(src + i);
+    __m256i v1 = _mm256_castps_si256(v0);
+    __m256i v2 = _mm256_and_si256(_mm256_srli_epi32(v1, 16), one);
+    __m256i v3 = _mm256_add_epi32(v1, _mm256_add_epi32(v2, bias));
+    __m256i v4 = _mm256_or_si256(_mm256_srli_epi32(v1, 16), quiet);
+    __m256 nan = _mm256_cmp_ps(v0, v0, _CMP_UNORD_Q);
+    __m256i v5 = _mm256_blendv_epi8(_mm256_srli_epi32(v3, 16), v4,
+                                    _mm256_castps_si256(nan));
+    __m128i v6 = _mm_packus_epi32(_mm256_castsi256_si128(v5),
+                                  _mm256_extracti128_si256(v5, 1));
+    _mm_storeu_si128((__m128i*)(dst + i), v6);
+  }
+  return i;
+}
+#endif
+
+}  // unnamed namespace
+
+half::half(const float value) : bits(narrow_half(value)) {}
+
+half::operator float() const
+{ return widen_half(bits); }
+
+bfloat16::bfloat16(const float value) : bits(narrow_bfloat16(value)) {}
+
+bfloat16::operator float() const
+{ return widen_bfloat16(bits); }
+
+std::ostream& operator<<(std::ostream& ostream, const half& value)
+{ return ostream << static_cast<float>(value); }
+
+std::ostream& operator<<(std::ostream& ostream, const bfloat16& value)
+{ return ostream << static_cast<float>(value); }
+
+void convert(const half* src, float* dst, const std::size_t n)
+{
+  std::size_t i = 0;
+#ifdef LAPLUS_F16C
+  if(has_f16c()) i = widen_half_f16c(src, dst, n);
+#endif
+  for(; i < n; ++i) dst[i] = widen_half(src[i].bits);
+}
+
+void convert(const float* src, half* dst, const std::size_t n)
+{
+  std::size_t i = 0;
+#ifdef LAPLUS_F16C
+  if(has_f16c()) i = narrow_half_f16c(src, dst, n);
+#endif
+  for(; i < n; ++i) dst[i].bits = narrow_half(src[i]);
+}
+
+void convert(const bfloat16* src, float* dst, const std::size_t n)
+{
+  std::size_t i = 0;
+#ifdef LAPLUS_AVX2
+  if(internal::has_avx2()) i = widen_bfloat16_avx2(src, dst, n);
+#endif
+  for(; i < n; ++i) dst[i] = widen_bfloat16(src[i].bits);
+}
+
+void convert(const float* src, bfloat16* dst, const std::size_t n)
+{
+  std::size_t i = 0;
+#ifdef LAPLUS_AVX512BF16
+  if(has_avx512bf16()) i = narrow_bfloat16_avx512(src, dst, n);
+#endif
+#ifdef LAPLUS_AVX2
+  if(internal::has_avx2()) i += narrow_bfloat16_avx2(src + i, dst + i, n - i);
+#endif
+  for(; i < n; ++i) dst[i].bits = narrow_bfloat16(src[i]);
+}
+
+}  // namespace laplus
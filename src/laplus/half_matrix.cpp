@@ -0,0 +1,574 @@
+/******************************************************************************
+ *
+ * laplus/half_matrix.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/half_matrix.hpp"
+#include "laplus/internal/parallel.hpp"
+#include "laplus/internal/simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace laplus {
+
+namespace {
+
+using simd = internal::simd<float>;
+
+// Elements widened per step of an elementwise pass.
+const std::size_t chunk = 1024;
+
+void load(const float* src, float* dst, const std::size_t n)
+{ std::copy(src, src + n, dst); }
+
+template<typename H>
+void load(const H* src, float* dst, const std::size_t n)
+{ convert(src, dst, n); }
+
+// Widens block [r0, r0 + m) x [c0, c0 + n) of a matrix into dst, laid out
+// in the given order with a leading dimension of n or m respectively.
+template<typename M>
+void pack(const M& src, const std::size_t r0, const std::size_t c0,
+          const std::size_t m, const std::size_t n,
+          const CBLAS_ORDER order, float* dst)
+{
+  const bool rowwise = (order == CblasRowMajor);
+  if(src.layout() == order) {
+    const std::size_t lines = rowwise ? m : n;
+    const std::size_t width = rowwise ? n : m;
+    for(std::size_t l = 0; l < lines; ++l) {
+      const std::size_t first = rowwise ? (r0 + l) * src.ldim() + c0
+                                        : (c0 + l) * src.ldim() + r0;
+      load(src.data() + first, dst + l * width, width);
+    }
+    return;
+  }
+  for(std::size_t i = 0; i < m; ++i) {
+    for(std::size_t j = 0; j < n; ++j) {
+      dst[rowwise ? i * n + j : j * m + i] = src(r0 + i, c0 + j);
+    }
+  }
+}
+
+template<typename MA, typename MB>
+void mixed_gemm(const float alpha, const MA& A, const MB& B,
+                const float beta, const Matrixf& C)
+{
+  assert(C.rows() == A.rows());
+  assert(C.cols() == B.cols());
+  assert(A.cols() == B.rows());
+  const std::size_t M = C.rows();
+  const std::size_t N = C.cols();
+  const std::size_t K = A.cols();
+  const std::size_t mc = 128;
+  const std::size_t kc = 256;
+  const std::size_t nc = 1024;
+  const CBLAS_ORDER order = C.layout();
+  const bool rowwise = (order == CblasRowMajor);
+
+  if(K == 0) {
+    if(beta == 0.0f) {
+      const std::size_t lines = rowwise ? M : N;
+      const std::size_t width = rowwise ? N : M;
+      for(std::size_t l = 0; l < lines; ++l) {
+        float* const line = C.data() + l * C.ldim();
+        std::fill(line, line + width, 0.0f);
+      }
+    } else {
+      Matrixf c(C);
+      c.scal(beta);
+    }
+    return;
+  }
+
+  std::vector<float> b_panel(std::min(kc, K) * std::min(nc, N));
+  for(std::size_t jj = 0; jj < N; jj += nc) {
+    const std::size_t nb = std::min(nc, N - jj);
+    for(std::size_t kk = 0; kk < K; kk += kc) {
+      const std::size_t kb = std::min(kc, K - kk);
+      const float scale = (kk == 0) ? beta : 1.0f;
+      pack(B, kk, jj, kb, nb, order, b_panel.data());
+      const std::size_t blocks = (M + mc - 1) / mc;
+      internal::parallel_run(blocks, [&](const std::size_t t) {
+        thread_local std::vector<float> a_panel;
+        const std::size_t ii = t * mc;
+        const std::size_t mb = std::min(mc, M - ii);
+        a_panel.resize(mc * kc);
+        pack(A, ii, kk, mb, kb, order, a_panel.data());
+        float* const c = C.data() + (rowwise ? ii * C.ldim() + jj
+                                             : jj * C.ldim() + ii);
+        cblas_sgemm(order, CblasNoTrans, CblasNoTrans, mb, nb, kb,
+                    alpha, a_panel.data(), rowwise ? kb : mb,
+                    b_panel.data(), rowwise ? nb : kb,
+                    scale, c, C.ldim());
+      });
+    }
+  }
+}
+
+template<typename MA, typename MB>
+Matrixf mixed_dot(const MA& A, const MB& B)
+{
+  Matrixf result(A.rows(), B.cols());
+  mixed_gemm(1.0, A, B, 0.0, result);
+  return result;
+}
+
+}  // unnamed namespace
+
+// Constructors and Destructor
+template<typename H>
+HalfMatrix<H>::HalfMatrix(const std::size_t rows, const std::size_t cols)
+  : internal::SharedArray<H>(rows * cols)
+  , shape(rows, cols), trans(CblasNoTrans)
+{}
+
+template<typename H>
+HalfMatrix<H>::HalfMatrix(const Matrixf& other)
+  : HalfMatrix(other.rows(), other.cols())
+{
+  trans = (other.layout() == CblasRowMajor) ? CblasNoTrans : CblasTrans;
+  const std::size_t lines = (trans == CblasNoTrans) ? rows() : cols();
+  const std::size_t width = (trans == CblasNoTrans) ? cols() : rows();
+  internal::parallel_for(0, lines,
+                         std::max<std::size_t>(1, internal::grain / width),
+                         [&](const std::size_t first, const std::size_t last) {
+    for(std::size_t l = first; l < last; ++l) {
+      convert(other.data() + l * other.ldim(), data() + l * width, width);
+    }
+  });
+}
+
+template<typename H>
+HalfMatrix<H>::HalfMatrix(const HalfMatrix<H>& other)
+  : internal::SharedArray<H>(other)
+  , shape(other.shape), trans(other.trans)
+{}
+
+template<typename H>
+HalfMatrix<H>::HalfMatrix(HalfMatrix<H>&& other) noexcept
+  : internal::SharedArray<H>(std::move(other))
+  , shape(other.shape), trans(other.trans)
+{ other.shape = std::make_pair(0, 0); }
+
+template<typename H>
+HalfMatrix<H>::~HalfMatrix() {}
+
+// Assignment Operators
+template<typename H>
+HalfMatrix<H>& HalfMatrix<H>::operator=(const HalfMatrix<H>& other)
+{
+  HalfMatrix<H> another(other);
+  *this = std::move(another);
+  return *this;
+}
+
+template<typename H>
+HalfMatrix<H>& HalfMatrix<H>::operator=(HalfMatrix<H>&& other) noexcept
+{
+  using std::swap;
+  swap(*this, other);
+  return *this;
+}
+
+template<typename H>
+HalfMatrix<H>& HalfMatrix<H>::operator+=(const HalfMatrix<H>& rhs)
+{
+  this->add_inplace(rhs);
+  return *this;
+}
+
+template<typename H>
+HalfMatrix<H>& HalfMatrix<H>::operator-=(const HalfMatrix<H>& rhs)
+{
+  this->sub_inplace(rhs);
+  return *this;
+}
+
+template<typename H>
+HalfMatrix<H>& HalfMatrix<H>::operator*=(const HalfMatrix<H>& rhs)
+{
+  this->mul_inplace(rhs);
+  return *this;
+}
+
+template<typename H>
+HalfMatrix<H>& HalfMatrix<H>::operator/=(const HalfMatrix<H>& rhs)
+{
+  this->div_inplace(rhs);
+  return *this;
+}
+
+template<typename H>
+HalfMatrix<H>& HalfMatrix<H>::operator+=(const float rhs)
+{
+  this->add_inplace(rhs);
+  return *this;
+}
+
+template<typename H>
+HalfMatrix<H>& HalfMatrix<H>::operator*=(const float rhs)
+{
+  this->mul_inplace(rhs);
+  return *this;
+}
+
+// Arithmetic Operators
+template<typename H>
+HalfMatrix<H> HalfMatrix<H>::operator+(const HalfMatrix<H>& other) const
+{
+  HalfMatrix<H> result(this->clone());
+  result += other;
+  return result;
+}
+
+template<typename H>
+HalfMatrix<H> HalfMatrix<H>::operator-(const HalfMatrix<H>& other) const
+{
+  HalfMatrix<H> result(this->clone());
+  result -= other;
+  return result;
+}
+
+template<typename H>
+HalfMatrix<H> HalfMatrix<H>::operator*(const HalfMatrix<H>& other) const
+{
+  HalfMatrix<H> result(this->clone());
+  result *= other;
+  return result;
+}
+
+template<typename H>
+HalfMatrix<H> HalfMatrix<H>::operator/(const HalfMatrix<H>& other) const
+{
+  HalfMatrix<H> result(this->clone());
+  result /= other;
+  return result;
+}
+
+template<typename H>
+HalfMatrix<H> HalfMatrix<H>::operator+(const float value) const
+{
+  HalfMatrix<H> result(this->clone());
+  result += value;
+  return result;
+}
+
+template<typename H>
+HalfMatrix<H> HalfMatrix<H>::operator*(const float value) const
+{
+  HalfMatrix<H> result(this->clone());
+  result *= value;
+  return result;
+}
+
+// Miscellaneous Operators
+template<typename H>
+const float HalfMatrix<H>::operator()(const std::size_t i,
+                                      const std::size_t j) const
+{
+  if(trans == CblasTrans) return static_cast<float>(data()[i + rows() * j]);
+  return static_cast<float>(data()[i * cols() + j]);
+}
+
+template<typename H>
+std::ostream& operator<<(std::ostream& ostream, const HalfMatrix<H>& matrix)
+{ return ostream << matrix.widen(); }
+
+// Utilities
+template<typename H>
+void swap(HalfMatrix<H>& a, HalfMatrix<H>& b)
+{
+  using std::swap;
+  swap(static_cast<internal::SharedArray<H>&>(a),
+       static_cast<internal::SharedArray<H>&>(b));
+  swap(a.shape, b.shape);
+  swap(a.trans, b.trans);
+}
+
+template<typename H>
+HalfMatrix<H> HalfMatrix<H>::clone() const
+{
+  HalfMatrix<H> result(rows(), cols());
+  result.trans = trans;
+  std::copy(data(), data() + rows() * cols(), result.data());
+  return result;
+}
+
+template<typename H>
+HalfMatrix<H> HalfMatrix<H>::transpose() const
+{
+  HalfMatrix<H> result(*this);
+  result.shape = std::make_pair(cols(), rows());
+  result.trans = (trans == CblasTrans) ? CblasNoTrans : CblasTrans;
+  return result;
+}
+
+template<typename H>
+Matrixf HalfMatrix<H>::widen() const
+{
+  const std::size_t lines = (trans == CblasNoTrans) ? rows() : cols();
+  const std::size_t width = (trans == CblasNoTrans) ? cols() : rows();
+  Matrixf result(lines, width);
+  internal::parallel_for(0, lines,
+                         std::max<std::size_t>(1, internal::grain / width),
+                         [&](const std::size_t first, const std::size_t last) {
+    for(std::size_t l = first; l < last; ++l) {
+      convert(data() + l * width, result.data() + l * width, width);
+    }
+  });
+  return (trans == CblasNoTrans) ? result : result.transpose();
+}
+
+template<typename H>
+void HalfMatrix<H>::set(const std::size_t i, const std::size_t j,
+                        const float value)
+{
+  if(trans == CblasTrans) data()[i + rows() * j] = H(value);
+  else data()[i * cols() + j] = H(value);
+}
+
+// Accessors
+template<typename H>
+const std::size_t HalfMatrix<H>::rows() const
+{ return shape.first; }
+
+template<typename H>
+const std::size_t HalfMatrix<H>::cols() const
+{ return shape.second; }
+
+template<typename H>
+const std::size_t HalfMatrix<H>::ldim() const
+{ return (trans == CblasTrans) ? rows() : cols(); }
+
+template<typename H>
+const CBLAS_ORDER HalfMatrix<H>::layout() const
+{ return (trans == CblasTrans) ? CblasColMajor : CblasRowMajor; }
+
+template<typename H>
+H* const HalfMatrix<H>::data() const
+{ return this->get(); }
+
+// Arithmetic Functions
+template<typename H>
+template<typename F>
+void HalfMatrix<H>::binary_inplace(const HalfMatrix<H>& other, const F& f)
+{
+  assert(rows() == other.rows());
+  assert(cols() == other.cols());
+  if(trans != other.trans) {
+    for(std::size_t i = 0; i < rows(); ++i) {
+      for(std::size_t j = 0; j < cols(); ++j) {
+        float x = (*this)(i, j);
+        float y = other(i, j);
+        f(&x, &y, 1);
+        set(i, j, x);
+      }
+    }
+    return;
+  }
+  const std::size_t n = rows() * cols();
+  internal::parallel_for(0, n, internal::grain, [&](
+      const std::size_t first, const std::size_t last) {
+    float x[chunk];
+    float y[chunk];
+    for(std::size_t i = first; i < last; i += chunk) {
+      const std::size_t m = std::min(chunk, last - i);
+      convert(data() + i, x, m);
+      convert(other.data() + i, y, m);
+      f(x, y, m);
+      convert(x, data() + i, m);
+    }
+  });
+}
+
+template<typename H>
+template<typename F>
+void HalfMatrix<H>::unary_inplace(const F& f)
+{
+  const std::size_t n = rows() * cols();
+  internal::parallel_for(0, n, internal::grain, [&](
+      const std::size_t first, const std::size_t last) {
+    float x[chunk];
+    for(std::size_t i = first; i < last; i += chunk) {
+      const std::size_t m = std::min(chunk, last - i);
+      convert(data() + i, x, m);
+      f(x, m);
+      convert(x, data() + i, m);
+    }
+  });
+}
+
+template<typename H>
+void HalfMatrix<H>::axpy(const float alpha, const HalfMatrix<H>& other)
+{
+  binary_inplace(other, [alpha](float* x, const float* y, std::size_t n) {
+    std::size_t i = 0;
+    const simd::type a = simd::set1(alpha);
+    for(; i + simd::width <= n; i += simd::width) {
+      simd::type v0 = simd::mul(a, simd::load(y + i));
+      simd::store(x + i, simd::add(simd::load(x + i), v0));
+    }
+    for(; i < n; ++i) x[i] += alpha * y[i];
+  });
+}
+
+template<typename H>
+void HalfMatrix<H>::scal(const float alpha)
+{ mul_inplace(alpha); }
+
+template<typename H>
+void HalfMatrix<H>::add_inplace(const HalfMatrix<H>& other)
+{ axpy(1.0, other); }
+
+template<typename H>
+void HalfMatrix<H>::sub_inplace(const HalfMatrix<H>& other)
+{ axpy(-1.0, other); }
+
+template<typename H>
+void HalfMatrix<H>::mul_inplace(const HalfMatrix<H>& other)
+{
+  binary_inplace(other, [](float* x, const float* y, std::size_t n) {
+    std::size_t i = 0;
+    for(; i + simd::width <= n; i += simd::width) {
+      simd::type v0 = simd::mul(simd::load(x + i), simd::load(y + i));
+      simd::store(x + i, v0);
+    }
+    for(; i < n; ++i) x[i] *= y[i];
+  });
+}
+
+template<typename H>
+void HalfMatrix<H>::div_inplace(const HalfMatrix<H>& other)
+{
+  binary_inplace(other, [](float* x, const float* y, std::size_t n) {
+    std::size_t i = 0;
+    for(; i + simd::width <= n; i += simd::width) {
+      simd::type v0 = simd::div(simd::load(x + i), simd::load(y + i));
+      simd::store(x + i, v0);
+    }
+    for(; i < n; ++i) x[i] /= y[i];
+  });
+}
+
+template<typename H>
+void HalfMatrix<H>::add_inplace(const float value)
+{
+  unary_inplace([value](float* x, std::size_t n) {
+    std::size_t i = 0;
+    const simd::type v = simd::set1(value);
+    for(; i + simd::width <= n; i += simd::width) {
+      simd::store(x + i, simd::add(simd::load(x + i), v));
+    }
+    for(; i < n; ++i) x[i] += value;
+  });
+}
+
+template<typename H>
+void HalfMatrix<H>::mul_inplace(const float value)
+{
+  unary_inplace([value](float* x, std::size_t n) {
+    std::size_t i = 0;
+    const simd::type v = simd::set1(value);
+    for(; i + simd::width <= n; i += simd::width) {
+      simd::store(x + i, simd::mul(simd::load(x + i), v));
+    }
+    for(; i < n; ++i) x[i] *= value;
+  });
+}
+
+template<typename H>
+void HalfMatrix<H>::apply_inplace(const std::function<float(float)>& f)
+{
+  unary_inplace([&f](float* x, std::size_t n) {
+    for(std::size_t i = 0; i < n; ++i) x[i] = f(x[i]);
+  });
+}
+
+template<typename H>
+HalfMatrix<H> HalfMatrix<H>::apply(const std::function<float(float)>& f) const
+{
+  HalfMatrix<H> result(this->clone());
+  result.apply_inplace(f);
+  return result;
+}
+
+// Mixed Precision BLAS
+void gemm(const float alpha, const Matrixh& A, const Matrixh& B,
+          const float beta, const Matrixf& C)
+{ mixed_gemm(alpha, A, B, beta, C); }
+
+void gemm(const float alpha, const Matrixf& A, const Matrixh& B,
+          const float beta, const Matrixf& C)
+{ mixed_gemm(alpha, A, B, beta, C); }
+
+void gemm(const float alpha, const Matrixh& A, const Matrixf& B,
+          const float beta, const Matrixf& C)
+{ mixed_gemm(alpha, A, B, beta, C); }
+
+void gemm(const float alpha, const Matrixbf& A, const Matrixbf& B,
+          const float beta, const Matrixf& C)
+{ mixed_gemm(alpha, A, B, beta, C); }
+
+void gemm(const float alpha, const Matrixf& A, const Matrixbf& B,
+          const float beta, const Matrixf& C)
+{ mixed_gemm(alpha, A, B, beta, C); }
+
+void gemm(const float alpha, const Matrixbf& A, const Matrixf& B,
+          const float beta, const Matrixf& C)
+{ mixed_gemm(alpha, A, B, beta, C); }
+
+Matrixf dot(const Matrixh& A, const Matrixh& B)
+{ return mixed_dot(A, B); }
+
+Matrixf dot(const Matrixf& A, const Matrixh& B)
+{ return mixed_dot(A, B); }
+
+Matrixf dot(const Matrixh& A, const Matrixf& B)
+{ return mixed_dot(A, B); }
+
+Matrixf dot(const Matrixbf& A, const Matrixbf& B)
+{ return mixed_dot(A, B); }
+
+Matrixf dot(const Matrixf& A, const Matrixbf& B)
+{ return mixed_dot(A, B); }
+
+Matrixf dot(const Matrixbf& A, const Matrixf& B)
+{ return mixed_dot(A, B); }
+
+// Explicit instantiations
+template class HalfMatrix<half>;
+template class HalfMatrix<bfloat16>;
+
+template std::ostream& operator<<(std::ostream&, const HalfMatrix<half>&);
+template std::ostream& operator<<(std::ostream&, const HalfMatrix<bfloat16>&);
+template void swap(HalfMatrix<half>&, HalfMatrix<half>&);
+template void swap(HalfMatrix<bfloat16>&, HalfMatrix<bfloat16>&);
+
+}  // namespace laplus
@@ -0,0 +1,79 @@
+/******************************************************************************
+ *
+ * laplus/internal/futex.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/internal/futex.hpp"
+
+#include <climits>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace laplus {
+namespace internal {
+
+namespace {
+
+const std::size_t spins = 1 << 12;
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t),
+              "futexes need plain 32-bit atomics");
+
+}  // unnamed namespace
+
+void wait_while(const std::atomic<std::uint32_t>& word,
+                const std::uint32_t value)
+{
+  for(std::size_t i = 0; i < spins; ++i)
+    if(word.load(std::memory_order_acquire) != value) return;
+  while(word.load(std::memory_order_acquire) == value) {
+#if defined(__linux__)
+    ::syscall(SYS_futex, reinterpret_cast<const std::uint32_t*>(&word),
+              FUTEX_WAIT, value, nullptr, nullptr, 0);
+#else
+    std::this_thread::yield();
+#endif
+  }
+}
+
+void wake_all(std::atomic<std::uint32_t>& word)
+{
+#if defined(__linux__)
+  ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE,
+            INT_MAX, nullptr, nullptr, 0);
+#else
+  (void)word;
+#endif
+}
+
+}  // namespace internal
+}  // namespace laplus
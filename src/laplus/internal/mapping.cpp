@@ -0,0 +1,101 @@
+/******************************************************************************
+ *
+ * laplus/internal/mapping.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/internal/mapping.hpp"
+
+#include <chrono>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace laplus {
+namespace internal {
+
+std::shared_ptr<char> map_file(const std::string& path, std::size_t& size)
+{
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if(fd < 0) return nullptr;
+
+  struct stat info;
+  if(::fstat(fd, &info) != 0 || info.st_size == 0) {
+    ::close(fd);
+    return nullptr;
+  }
+  const std::size_t length = info.st_size;
+
+  void* const addr = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if(addr == MAP_FAILED) return nullptr;
+
+  size = length;
+  return std::shared_ptr<char>(static_cast<char*>(addr), [length](char* p) {
+    ::munmap(p, length);
+  });
+}
+
+void* map_shared(const std::string& name, const std::size_t length,
+                 const bool create)
+{
+  const auto backoff = [] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  };
+
+  int fd = -1;
+  if(create) {
+    ::shm_unlink(name.c_str());
+    fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if(fd < 0) return nullptr;
+    if(::ftruncate(fd, length) != 0) {
+      ::close(fd);
+      ::shm_unlink(name.c_str());
+      return nullptr;
+    }
+  } else {
+    while((fd = ::shm_open(name.c_str(), O_RDWR, 0)) < 0) backoff();
+    struct stat info;
+    while(::fstat(fd, &info) == 0 && std::size_t(info.st_size) < length)
+      backoff();
+  }
+
+  void* const addr = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                            MAP_SHARED, fd, 0);
+  ::close(fd);
+  if(addr == MAP_FAILED) {
+    if(create) ::shm_unlink(name.c_str());
+    return nullptr;
+  }
+  return addr;
+}
+
+}  // namespace internal
+}  // namespace laplus
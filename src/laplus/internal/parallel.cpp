@@ -0,0 +1,205 @@
+/******************************************************************************
+ *
+ * laplus/internal/parallel.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/internal/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace laplus {
+namespace internal {
+
+namespace {
+
+thread_local bool inside_task = false;
+
+std::size_t default_concurrency()
+{
+  const char* env = std::getenv("LAPLUS_NUM_THREADS");
+  if(env != nullptr) {
+    const long value = std::strtol(env, nullptr, 10);
+    if(value > 0) return static_cast<std::size_t>(value);
+  }
+  const std::size_t hardware = std::thread::hardware_concurrency();
+  return hardware > 0 ? hardware : 1;
+}
+
+class ThreadPool {
+public:
+  ThreadPool(const std::size_t size)
+    : job(nullptr), tasks(0), next(0), running(0), generation(0), stop(false)
+  {
+    for(std::size_t i = 1; i < size; ++i) {
+      workers.emplace_back(&ThreadPool::work, this);
+    }
+  }
+
+  ~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    wake.notify_all();
+    for(std::thread& worker: workers) worker.join();
+  }
+
+  const std::size_t size() const
+  { return workers.size() + 1; }
+
+  void run(const std::size_t count,
+           const std::function<void(const std::size_t)>& task)
+  {
+    std::lock_guard<std::mutex> serial(dispatch);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      job = &task;
+      tasks = count;
+      next = 0;
+      running = workers.size();
+      ++generation;
+    }
+    wake.notify_all();
+    drain(task, count);
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this]() { return running == 0; });
+    job = nullptr;
+  }
+private:
+  void drain(const std::function<void(const std::size_t)>& task,
+             const std::size_t count)
+  {
+    inside_task = true;
+    for(std::size_t i = next++; i < count; i = next++) {
+      task(i);
+    }
+    inside_task = false;
+  }
+
+  void work()
+  {
+    std::size_t seen = 0;
+    for(;;) {
+      const std::function<void(const std::size_t)>* task;
+      std::size_t count;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [this, seen]() { return stop || generation != seen; });
+        if(stop) return;
+        seen = generation;
+        task = job;
+        count = tasks;
+      }
+      drain(*task, count);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        --running;
+      }
+      done.notify_one();
+    }
+  }
+
+  std::vector<std::thread> workers;
+  std::mutex dispatch;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  const std::function<void(const std::size_t)>* job;
+  std::size_t tasks;
+  std::atomic<std::size_t> next;
+  std::size_t running;
+  std::size_t generation;
+  bool stop;
+};
+
+std::unique_ptr<ThreadPool>& instance()
+{
+  static std::unique_ptr<ThreadPool> pool(
+      new ThreadPool(default_concurrency()));
+  return pool;
+}
+
+ThreadPool& pool()
+{ return *instance(); }
+
+}  // unnamed namespace
+
+const std::size_t concurrency()
+{ return pool().size(); }
+
+void set_concurrency(const std::size_t threads)
+{
+  assert(!inside_task);
+  std::unique_ptr<ThreadPool>& current = instance();
+  current.reset();
+  current.reset(new ThreadPool(threads > 0 ? threads : default_concurrency()));
+}
+
+void parallel_run(const std::size_t tasks,
+                  const std::function<void(const std::size_t)>& task)
+{
+  if(tasks == 0) return;
+  if(tasks == 1 || inside_task || concurrency() == 1) {
+    for(std::size_t i = 0; i < tasks; ++i) task(i);
+    return;
+  }
+  pool().run(tasks, task);
+}
+
+void parallel_for(const std::size_t begin, const std::size_t end,
+                  const std::size_t grain,
+                  const std::function<void(const std::size_t,
+                                           const std::size_t)>& body)
+{
+  if(begin >= end) return;
+  const std::size_t size = end - begin;
+  const std::size_t minimum = grain > 0 ? grain : 1;
+  std::size_t chunks = std::min(concurrency(), (size + minimum - 1) / minimum);
+  if(chunks <= 1 || inside_task) {
+    body(begin, end);
+    return;
+  }
+  const std::size_t step = (size + chunks - 1) / chunks;
+  chunks = (size + step - 1) / step;
+  parallel_run(chunks, [&](const std::size_t i) {
+    const std::size_t first = begin + i * step;
+    const std::size_t last = std::min(end, first + step);
+    body(first, last);
+  });
+}
+
+}  // namespace internal
+}  // namespace laplus
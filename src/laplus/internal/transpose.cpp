@@ -0,0 +1,385 @@
+/******************************************************************************
+ *
+ * laplus/internal/transpose.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/internal/transpose.hpp"
+#include "laplus/internal/parallel.hpp"
+#include "laplus/internal/simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <immintrin.h>
+
+namespace laplus {
+namespace internal {
+
+namespace {
+
+// Tile edge in elements; a pair of float tiles fits in L1.
+const std::size_t tile = 64;
+
+// Square register blocks: load rows, transpose in registers, store rows.
+// The arithmetic mirrors simd<T> so the combining kernels work on either.
+template<typename T>
+struct scalar {
+  using type = T;
+  static const std::size_t width = 1;
+  static void load(const T* const p, const std::size_t, type* const r)
+  { r[0] = p[0]; }
+  static void transpose(type* const) {}
+  static void store(T* const p, const std::size_t, const type* const r)
+  { p[0] = r[0]; }
+  static type set1(const T x) { return x; }
+  static type add(const type a, const type b) { return a + b; }
+  static type mul(const type a, const type b) { return a * b; }
+  static type div(const type a, const type b) { return a / b; }
+};
+
+template<typename T>
+struct micro : scalar<T> {};
+
+#ifdef __AVX__
+template<>
+struct micro<float> : simd<float> {
+  using type = __m256;
+  static const std::size_t width = 8;
+
+  static void load(const float* const p, const std::size_t ld, type* const r)
+  { for(std::size_t k = 0; k < 8; ++k) r[k] = _mm256_loadu_ps(p + k * ld); }
+
+  static void transpose(type* const r)
+  {
+    const __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+    const __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+    const __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+    const __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+    const __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]);
+    const __m256 t5 = _mm256_unpackhi_ps(r[4], r[5]);
+    const __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]);
+    const __m256 t7 = _mm256_unpackhi_ps(r[6], r[7]);
+    const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+    r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+  }
+
+  static void store(float* const p, const std::size_t ld,
+                    const type* const r)
+  { for(std::size_t k = 0; k < 8; ++k) _mm256_storeu_ps(p + k * ld, r[k]); }
+};
+
+template<>
+struct micro<double> : simd<double> {
+  using type = __m256d;
+  static const std::size_t width = 4;
+
+  static void load(const double* const p, const std::size_t ld,
+                   type* const r)
+  { for(std::size_t k = 0; k < 4; ++k) r[k] = _mm256_loadu_pd(p + k * ld); }
+
+  static void transpose(type* const r)
+  {
+    const __m256d t0 = _mm256_unpacklo_pd(r[0], r[1]);
+    const __m256d t1 = _mm256_unpackhi_pd(r[0], r[1]);
+    const __m256d t2 = _mm256_unpacklo_pd(r[2], r[3]);
+    const __m256d t3 = _mm256_unpackhi_pd(r[2], r[3]);
+    r[0] = _mm256_permute2f128_pd(t0, t2, 0x20);
+    r[1] = _mm256_permute2f128_pd(t1, t3, 0x20);
+    r[2] = _mm256_permute2f128_pd(t0, t2, 0x31);
+    r[3] = _mm256_permute2f128_pd(t1, t3, 0x31);
+  }
+
+  static void store(double* const p, const std::size_t ld,
+                    const type* const r)
+  { for(std::size_t k = 0; k < 4; ++k) _mm256_storeu_pd(p + k * ld, r[k]); }
+};
+#endif
+
+// Transposes one tile of at most tile x tile elements.
+template<typename T>
+void copy_tile(const T* const src, const std::size_t lds,
+               T* const dst, const std::size_t ldd,
+               const std::size_t rows, const std::size_t cols)
+{
+  using m = micro<T>;
+  const std::size_t w = m::width;
+  const std::size_t rw = rows - rows % w;
+  const std::size_t cw = cols - cols % w;
+  typename m::type r[m::width];
+  for(std::size_t i = 0; i < rw; i += w) {
+    for(std::size_t j = 0; j < cw; j += w) {
+      m::load(src + i * lds + j, lds, r);
+      m::transpose(r);
+      m::store(dst + j * ldd + i, ldd, r);
+    }
+  }
+  for(std::size_t i = 0; i < rows; ++i) {
+    for(std::size_t j = (i < rw) ? cw : 0; j < cols; ++j) {
+      dst[j * ldd + i] = src[i * lds + j];
+    }
+  }
+}
+
+// Exchanges the h x w block at (top, left) with the transpose of the
+// w x h block at (left, top). On the diagonal only pairs above it move.
+template<typename T>
+void swap_tile(T* const a, const std::size_t lda,
+               const std::size_t top, const std::size_t left,
+               const std::size_t h, const std::size_t w)
+{
+  using m = micro<T>;
+  const std::size_t k = m::width;
+  const bool diagonal = (top == left);
+  const std::size_t hw = h - h % k;
+  const std::size_t ww = w - w % k;
+  typename m::type x[m::width];
+  typename m::type y[m::width];
+  for(std::size_t i = 0; i < hw; i += k) {
+    for(std::size_t j = diagonal ? i : 0; j < ww; j += k) {
+      T* const p = a + (top + i) * lda + left + j;
+      T* const q = a + (left + j) * lda + top + i;
+      m::load(p, lda, x);
+      m::transpose(x);
+      if(p == q) {
+        m::store(p, lda, x);
+        continue;
+      }
+      m::load(q, lda, y);
+      m::transpose(y);
+      m::store(q, lda, x);
+      m::store(p, lda, y);
+    }
+  }
+  for(std::size_t i = 0; i < h; ++i) {
+    std::size_t j = diagonal ? i + 1 : 0;
+    if(i < hw) j = std::max(j, ww);
+    for(; j < w; ++j) {
+      std::swap(a[(top + i) * lda + left + j], a[(left + j) * lda + top + i]);
+    }
+  }
+}
+
+// Elementwise operators for combine(), applied to registers of kit M.
+template<typename T>
+struct axpy_op {
+  const T alpha;
+  template<typename M>
+  typename M::type apply(const typename M::type a,
+                         const typename M::type b) const
+  { return M::add(a, M::mul(M::set1(alpha), b)); }
+};
+
+template<typename T>
+struct mul_op {
+  template<typename M>
+  typename M::type apply(const typename M::type a,
+                         const typename M::type b) const
+  { return M::mul(a, b); }
+};
+
+template<typename T>
+struct div_op {
+  template<typename M>
+  typename M::type apply(const typename M::type a,
+                         const typename M::type b) const
+  { return M::div(a, b); }
+};
+
+template<typename T>
+struct pow_op {
+  template<typename M>
+  typename M::type apply(const typename M::type a,
+                         const typename M::type b) const
+  { return std::pow(a, b); }
+};
+
+// Applies a(i, j) = op(a(i, j), b(j, i)) to one tile of at most
+// tile x tile elements, transposing blocks of b in registers of kit M.
+template<typename T, typename M, typename Op>
+void combine_tile(const Op& op, const T* const b, const std::size_t ldb,
+                  T* const a, const std::size_t lda,
+                  const std::size_t rows, const std::size_t cols)
+{
+  const std::size_t w = M::width;
+  const std::size_t rw = rows - rows % w;
+  const std::size_t cw = cols - cols % w;
+  typename M::type x[M::width];
+  typename M::type y[M::width];
+  for(std::size_t i = 0; i < rw; i += w) {
+    for(std::size_t j = 0; j < cw; j += w) {
+      M::load(a + i * lda + j, lda, x);
+      M::load(b + j * ldb + i, ldb, y);
+      M::transpose(y);
+      for(std::size_t k = 0; k < w; ++k) {
+        x[k] = op.template apply<M>(x[k], y[k]);
+      }
+      M::store(a + i * lda + j, lda, x);
+    }
+  }
+  for(std::size_t i = 0; i < rows; ++i) {
+    for(std::size_t j = (i < rw) ? cw : 0; j < cols; ++j) {
+      T& v = a[i * lda + j];
+      v = op.template apply<scalar<T>>(v, b[j * ldb + i]);
+    }
+  }
+}
+
+template<typename T, typename M, typename Op>
+void combine(const Op& op, const T* const b, const std::size_t ldb,
+             T* const a, const std::size_t lda,
+             const std::size_t rows, const std::size_t cols)
+{
+  const std::size_t across = (cols + tile - 1) / tile;
+  const std::size_t tiles = (rows + tile - 1) / tile * across;
+  parallel_for(0, tiles, 4, [&](const std::size_t first,
+                                const std::size_t last) {
+    for(std::size_t t = first; t < last; ++t) {
+      const std::size_t i = t / across * tile;
+      const std::size_t j = t % across * tile;
+      combine_tile<T, M>(op, b + j * ldb + i, ldb, a + i * lda + j, lda,
+                         std::min(tile, rows - i), std::min(tile, cols - j));
+    }
+  });
+}
+
+}  // unnamed namespace
+
+template<typename T>
+void transpose(const T* const src, const std::size_t lds,
+               T* const dst, const std::size_t ldd,
+               const std::size_t rows, const std::size_t cols)
+{
+  const std::size_t across = (cols + tile - 1) / tile;
+  const std::size_t tiles = (rows + tile - 1) / tile * across;
+  parallel_for(0, tiles, 4, [&](const std::size_t first,
+                                const std::size_t last) {
+    for(std::size_t t = first; t < last; ++t) {
+      const std::size_t i = t / across * tile;
+      const std::size_t j = t % across * tile;
+      copy_tile(src + i * lds + j, lds, dst + j * ldd + i, ldd,
+                std::min(tile, rows - i), std::min(tile, cols - j));
+    }
+  });
+}
+
+template<typename T>
+void transpose(T* const a, const std::size_t lda, const std::size_t n)
+{
+  const std::size_t count = (n + tile - 1) / tile;
+  std::vector<std::pair<std::size_t, std::size_t>> pairs;
+  for(std::size_t i = 0; i < count; ++i) {
+    for(std::size_t j = i; j < count; ++j) pairs.emplace_back(i, j);
+  }
+  parallel_for(0, pairs.size(), 4, [&](const std::size_t first,
+                                       const std::size_t last) {
+    for(std::size_t p = first; p < last; ++p) {
+      const std::size_t top = pairs[p].first * tile;
+      const std::size_t left = pairs[p].second * tile;
+      swap_tile(a, lda, top, left,
+                std::min(tile, n - top), std::min(tile, n - left));
+    }
+  });
+}
+
+template<typename T>
+void transpose_axpy(const T alpha, const T* const b, const std::size_t ldb,
+                    T* const a, const std::size_t lda,
+                    const std::size_t rows, const std::size_t cols)
+{ combine<T, micro<T>>(axpy_op<T>{alpha}, b, ldb, a, lda, rows, cols); }
+
+template<typename T>
+void transpose_mul(const T* const b, const std::size_t ldb,
+                   T* const a, const std::size_t lda,
+                   const std::size_t rows, const std::size_t cols)
+{ combine<T, micro<T>>(mul_op<T>(), b, ldb, a, lda, rows, cols); }
+
+template<typename T>
+void transpose_div(const T* const b, const std::size_t ldb,
+                   T* const a, const std::size_t lda,
+                   const std::size_t rows, const std::size_t cols)
+{ combine<T, micro<T>>(div_op<T>(), b, ldb, a, lda, rows, cols); }
+
+template<typename T>
+void transpose_pow(const T* const b, const std::size_t ldb,
+                   T* const a, const std::size_t lda,
+                   const std::size_t rows, const std::size_t cols)
+{ combine<T, scalar<T>>(pow_op<T>(), b, ldb, a, lda, rows, cols); }
+
+template void transpose(const float* const, const std::size_t,
+                        float* const, const std::size_t,
+                        const std::size_t, const std::size_t);
+template void transpose(const double* const, const std::size_t,
+                        double* const, const std::size_t,
+                        const std::size_t, const std::size_t);
+template void transpose(float* const, const std::size_t, const std::size_t);
+template void transpose(double* const, const std::size_t, const std::size_t);
+
+template void transpose_axpy(const float, const float* const,
+                             const std::size_t, float* const,
+                             const std::size_t, const std::size_t,
+                             const std::size_t);
+template void transpose_axpy(const double, const double* const,
+                             const std::size_t, double* const,
+                             const std::size_t, const std::size_t,
+                             const std::size_t);
+template void transpose_mul(const float* const, const std::size_t,
+                            float* const, const std::size_t,
+                            const std::size_t, const std::size_t);
+template void transpose_mul(const double* const, const std::size_t,
+                            double* const, const std::size_t,
+                            const std::size_t, const std::size_t);
+template void transpose_div(const float* const, const std::size_t,
+                            float* const, const std::size_t,
+                            const std::size_t, const std::size_t);
+template void transpose_div(const double* const, const std::size_t,
+                            double* const, const std::size_t,
+                            const std::size_t, const std::size_t);
+template void transpose_pow(const float* const, const std::size_t,
+                            float* const, const std::size_t,
+                            const std::size_t, const std::size_t);
+template void transpose_pow(const double* const, const std::size_t,
+                            double* const, const std::size_t,
+                            const std::size_t, const std::size_t);
+
+}  // namespace internal
+}  // namespace laplus
@@ -0,0 +1,664 @@
+/******************************************************************************
+ *
+ * laplus/jit.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/jit.hpp"
+#include "laplus/internal/parallel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#if defined(__x86_64__)
+#include <sys/mman.h>
+#endif
+
+namespace laplus {
+
+namespace {
+
+const std::size_t lanes = 8;
+const std::size_t max_inputs = 32;
+
+// Machine code for the System V call
+//   f(const float* const* inputs, float* out, size_t n, const float* pool)
+// with n a positive multiple of eight. Each pool entry holds one constant
+// repeated across the eight lanes of a ymm register.
+using Function = void (*)(const float* const*, float*, std::size_t,
+                          const float*);
+
+// Appends a constant to the pool and returns its entry.
+std::size_t constant(std::vector<float>& pool, const float value)
+{
+  pool.insert(pool.end(), lanes, value);
+  return pool.size() / lanes - 1;
+}
+
+std::size_t constant(std::vector<float>& pool, const std::uint32_t bits)
+{
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return constant(pool, value);
+}
+
+// Encoder for the handful of VEX.256 instructions the kernels need. Vector
+// operands are ymm0-15, inputs are addressed as [r8 + rax], the output as
+// [rsi + rax] and pool entries as [rcx + 32k].
+class Assembler {
+public:
+  enum Map { M0F = 1, M0F38 = 2, M0F3A = 3 };
+  enum Prefix { None = 0, P66 = 1, PF3 = 2 };
+
+  std::vector<std::uint8_t> code;
+
+  void byte(const std::uint8_t b) { code.push_back(b); }
+
+  void dword(const std::uint32_t d)
+  { for(std::size_t i = 0; i < 4; ++i) byte((d >> (8 * i)) & 0xFF); }
+
+  void vex(const Map map, const Prefix pp, const std::size_t reg,
+           const std::size_t vvvv, const std::size_t base)
+  {
+    byte(0xC4);
+    byte(((reg & 8) ? 0 : 0x80) | 0x40 | ((base & 8) ? 0 : 0x20) | map);
+    byte(((~vvvv & 15) << 3) | 4 | pp);
+  }
+
+  // dst = src1 op src2
+  void rr(const std::uint8_t op, const Map map, const Prefix pp,
+          const std::size_t dst, const std::size_t src1,
+          const std::size_t src2)
+  {
+    vex(map, pp, dst, src1, src2);
+    byte(op);
+    byte(0xC0 | ((dst & 7) << 3) | (src2 & 7));
+  }
+
+  // dst = src1 op pool[k]
+  void rp(const std::uint8_t op, const Map map, const Prefix pp,
+          const std::size_t dst, const std::size_t src1, const std::size_t k)
+  {
+    vex(map, pp, dst, src1, 1);
+    byte(op);
+    byte(0x80 | ((dst & 7) << 3) | 1);
+    dword(32 * k);
+  }
+
+  void load(const std::size_t dst, const std::size_t input)
+  {
+    // mov r8, [rdi + 8 * input]
+    byte(0x4C);
+    byte(0x8B);
+    byte(0x87);
+    dword(8 * input);
+    // vmovups dst, [r8 + rax]
+    vex(M0F, None, dst, 0, 8);
+    byte(0x10);
+    byte(((dst & 7) << 3) | 4);
+    byte(0x00);
+  }
+
+  void store(const std::size_t src)
+  {
+    // vmovups [rsi + rax], src
+    vex(M0F, None, src, 0, 0);
+    byte(0x11);
+    byte(((src & 7) << 3) | 4);
+    byte(0x06);
+  }
+
+  void pool(const std::size_t dst, const std::size_t k)
+  { rp(0x10, M0F, None, dst, 0, k); }
+
+  void round(const std::size_t dst, const std::size_t src,
+             const std::uint8_t mode)
+  {
+    rr(0x08, M0F3A, P66, dst, 0, src);
+    byte(mode);
+  }
+
+  void slli(const std::size_t dst, const std::size_t src,
+            const std::uint8_t count)
+  {
+    vex(M0F, P66, 0, dst, src);
+    byte(0x72);
+    byte(0xC0 | (6 << 3) | (src & 7));
+    byte(count);
+  }
+};
+
+// Opcodes of the packed single precision operations.
+const std::uint8_t vaddps = 0x58;
+const std::uint8_t vmulps = 0x59;
+const std::uint8_t vsubps = 0x5C;
+const std::uint8_t vminps = 0x5D;
+const std::uint8_t vdivps = 0x5E;
+const std::uint8_t vmaxps = 0x5F;
+const std::uint8_t vsqrtps = 0x51;
+const std::uint8_t vandps = 0x54;
+const std::uint8_t vxorps = 0x57;
+const std::uint8_t vcvttps2dq = 0x5B;
+const std::uint8_t vpaddd = 0xFE;
+
+}  // unnamed namespace
+
+// Machine code of one expression structure.
+struct JitKernel::Code {
+  void* memory;
+  std::size_t size;
+  Function function;
+
+  ~Code()
+  {
+#if defined(__x86_64__)
+    munmap(memory, size);
+#endif
+  }
+};
+
+namespace {
+
+// Emits node into register r, using the registers above it as scratch.
+// Returns false once more than sixteen registers would be needed.
+using Node = internal::ExprNode;
+
+const bool generate(const Node& node, const std::size_t r, Assembler& as,
+                    std::vector<float>& pool)
+{
+  using A = Assembler;
+  if(r > 15) return false;
+  switch(node.op) {
+  case Node::Leaf:
+    as.load(r, node.index);
+    return true;
+  case Node::Constant:
+    as.pool(r, constant(pool, node.value));
+    return true;
+  default:
+    break;
+  }
+
+  if(!generate(*node.a, r, as, pool)) return false;
+  const Node* const b = node.b.get();
+  std::uint8_t op = 0;
+  switch(node.op) {
+  case Node::Add: op = vaddps; break;
+  case Node::Sub: op = vsubps; break;
+  case Node::Mul: op = vmulps; break;
+  case Node::Div: op = vdivps; break;
+  case Node::Min: op = vminps; break;
+  case Node::Max: op = vmaxps; break;
+  case Node::Neg:
+    as.rp(vxorps, A::M0F, A::None, r, r,
+          constant(pool, std::uint32_t(0x80000000u)));
+    return true;
+  case Node::Abs:
+    as.rp(vandps, A::M0F, A::None, r, r,
+          constant(pool, std::uint32_t(0x7FFFFFFFu)));
+    return true;
+  case Node::Sqrt:
+    as.rr(vsqrtps, A::M0F, A::None, r, 0, r);
+    return true;
+  case Node::Exp: {  // Cephes expf
+    const std::size_t t1 = r + 1, t2 = r + 2;
+    if(t2 > 15) return false;
+    as.rp(vminps, A::M0F, A::None, r, r, constant(pool, 88.3762626647949f));
+    as.rp(vmaxps, A::M0F, A::None, r, r, constant(pool, -88.3762626647949f));
+    as.pool(t1, constant(pool, 1.44269504088896341f));
+    as.rr(vmulps, A::M0F, A::None, t1, t1, r);
+    as.rp(vaddps, A::M0F, A::None, t1, t1, constant(pool, 0.5f));
+    as.round(t1, t1, 0x09);
+    as.pool(t2, constant(pool, 0.693359375f));
+    as.rr(vmulps, A::M0F, A::None, t2, t2, t1);
+    as.rr(vsubps, A::M0F, A::None, r, r, t2);
+    as.pool(t2, constant(pool, -2.12194440e-4f));
+    as.rr(vmulps, A::M0F, A::None, t2, t2, t1);
+    as.rr(vsubps, A::M0F, A::None, r, r, t2);
+    // 2^n from the exponent bits.
+    as.rr(vcvttps2dq, A::M0F, A::PF3, t1, 0, t1);
+    as.rp(vpaddd, A::M0F, A::P66, t1, t1, constant(pool, std::uint32_t(127)));
+    as.slli(t1, t1, 23);
+    // Polynomial in the reduced argument.
+    as.pool(t2, constant(pool, 1.9875691500e-4f));
+    const float p[] = {1.3981999507e-3f, 8.3334519073e-3f, 4.1665795894e-2f,
+                       1.6666665459e-1f, 5.0000001201e-1f};
+    for(const float c: p) {
+      as.rr(vmulps, A::M0F, A::None, t2, t2, r);
+      as.rp(vaddps, A::M0F, A::None, t2, t2, constant(pool, c));
+    }
+    as.rr(vmulps, A::M0F, A::None, t2, t2, r);
+    as.rr(vmulps, A::M0F, A::None, t2, t2, r);
+    as.rr(vaddps, A::M0F, A::None, t2, t2, r);
+    as.rp(vaddps, A::M0F, A::None, t2, t2, constant(pool, 1.0f));
+    as.rr(vmulps, A::M0F, A::None, r, t2, t1);
+    return true;
+  }
+  default:
+    return false;
+  }
+
+  // Binary operations take a constant straight from the pool.
+  if(b->op == Node::Constant) {
+    as.rp(op, A::M0F, A::None, r, r, constant(pool, b->value));
+    return true;
+  }
+  if(!generate(*b, r + 1, as, pool)) return false;
+  as.rr(op, A::M0F, A::None, r, r, r + 1);
+  return true;
+}
+
+}  // unnamed namespace
+
+// Generators
+Expr Expr::Input(const std::size_t index)
+{
+  return Expr(std::make_shared<const Node>(Node{Node::Leaf, index, 0.0f,
+                                                nullptr, nullptr}));
+}
+
+// Parsing
+namespace {
+
+class Parser {
+public:
+  Parser(const std::string& text) : s(text), i(0) {}
+
+  const bool parse(Expr& result)
+  {
+    if(!sum(result)) return false;
+    skip();
+    return i == s.size();
+  }
+private:
+  void skip() { while(i < s.size() && std::isspace(s[i])) ++i; }
+
+  const bool accept(const char c)
+  {
+    skip();
+    if(i < s.size() && s[i] == c) {
+      ++i;
+      return true;
+    }
+    return false;
+  }
+
+  const bool sum(Expr& result)
+  {
+    if(!product(result)) return false;
+    for(;;) {
+      Expr rhs(0.0f);
+      if(accept('+')) {
+        if(!product(rhs)) return false;
+        result = result + rhs;
+      } else if(accept('-')) {
+        if(!product(rhs)) return false;
+        result = result - rhs;
+      } else {
+        return true;
+      }
+    }
+  }
+
+  const bool product(Expr& result)
+  {
+    if(!unary(result)) return false;
+    for(;;) {
+      Expr rhs(0.0f);
+      if(accept('*')) {
+        if(!unary(rhs)) return false;
+        result = result * rhs;
+      } else if(accept('/')) {
+        if(!unary(rhs)) return false;
+        result = result / rhs;
+      } else {
+        return true;
+      }
+    }
+  }
+
+  const bool unary(Expr& result)
+  {
+    if(accept('-')) {
+      if(!unary(result)) return false;
+      result = -result;
+      return true;
+    }
+    return primary(result);
+  }
+
+  const bool primary(Expr& result)
+  {
+    skip();
+    if(i >= s.size()) return false;
+    if(accept('(')) return sum(result) && accept(')');
+    if(std::isdigit(s[i]) || s[i] == '.') {
+      char* end = nullptr;
+      const float value = std::strtof(s.c_str() + i, &end);
+      if(end == s.c_str() + i) return false;
+      i = end - s.c_str();
+      result = Expr(value);
+      return true;
+    }
+    std::size_t j = i;
+    while(j < s.size() && std::isalnum(s[j])) ++j;
+    const std::string name = s.substr(i, j - i);
+    i = j;
+    if(name.size() > 1 && name[0] == 'x'
+       && std::all_of(name.begin() + 1, name.end(), ::isdigit)) {
+      result = Expr::Input(std::strtoul(name.c_str() + 1, nullptr, 10));
+      return true;
+    }
+    Expr a(0.0f), b(0.0f);
+    if(!accept('(') || !sum(a)) return false;
+    if(name == "min" || name == "max") {
+      if(!accept(',') || !sum(b) || !accept(')')) return false;
+      result = (name == "min") ? a.min(b) : a.max(b);
+      return true;
+    }
+    if(!accept(')')) return false;
+    if(name == "abs") result = a.abs();
+    else if(name == "sqrt") result = a.sqrt();
+    else if(name == "exp") result = a.exp();
+    else if(name == "sigmoid") result = a.sigmoid();
+    else if(name == "tanh") result = a.tanh();
+    else if(name == "relu") result = a.max(0.0f);
+    else return false;
+    return true;
+  }
+
+  const std::string& s;
+  std::size_t i;
+};
+
+}  // unnamed namespace
+
+const bool Expr::Parse(const std::string& text, Expr& result)
+{ return Parser(text).parse(result); }
+
+// Constructors and Destructor
+Expr::Expr(const float value)
+  : node(std::make_shared<const Node>(Node{Node::Constant, 0, value,
+                                           nullptr, nullptr}))
+{}
+
+Expr::Expr(const std::shared_ptr<const Node>& other) : node(other) {}
+
+Expr Expr::make(const Node::Op op, const Expr& a, const Expr& b)
+{
+  return Expr(std::make_shared<const Node>(Node{op, 0, 0.0f, a.node,
+                                                b.node}));
+}
+
+// Arithmetic Operators
+Expr Expr::operator-() const
+{ return make(Node::Neg, *this, Expr(nullptr)); }
+
+Expr operator+(const Expr& a, const Expr& b)
+{ return Expr::make(Node::Add, a, b); }
+
+Expr operator-(const Expr& a, const Expr& b)
+{ return Expr::make(Node::Sub, a, b); }
+
+Expr operator*(const Expr& a, const Expr& b)
+{ return Expr::make(Node::Mul, a, b); }
+
+Expr operator/(const Expr& a, const Expr& b)
+{ return Expr::make(Node::Div, a, b); }
+
+// Arithmetic Functions
+Expr Expr::min(const Expr& other) const
+{ return make(Node::Min, *this, other); }
+
+Expr Expr::max(const Expr& other) const
+{ return make(Node::Max, *this, other); }
+
+Expr Expr::abs() const
+{ return make(Node::Abs, *this, Expr(nullptr)); }
+
+Expr Expr::sqrt() const
+{ return make(Node::Sqrt, *this, Expr(nullptr)); }
+
+Expr Expr::exp() const
+{ return make(Node::Exp, *this, Expr(nullptr)); }
+
+Expr Expr::sigmoid() const
+{ return Expr(1.0f) / (Expr(1.0f) + (-*this).exp()); }
+
+Expr Expr::tanh() const
+{ return Expr(2.0f) / (Expr(1.0f) + (*this * -2.0f).exp()) - 1.0f; }
+
+// Accessors
+const std::size_t Expr::arity() const
+{
+  std::size_t n = 0;
+  std::vector<const Node*> stack = {node.get()};
+  while(!stack.empty()) {
+    const Node* const x = stack.back();
+    stack.pop_back();
+    if(x->op == Node::Leaf) n = std::max(n, x->index + 1);
+    if(x->a) stack.push_back(x->a.get());
+    if(x->b) stack.push_back(x->b.get());
+  }
+  return n;
+}
+
+const std::string Expr::key() const
+{
+  std::string result;
+  std::vector<const Node*> stack = {node.get()};
+  while(!stack.empty()) {
+    const Node* const x = stack.back();
+    stack.pop_back();
+    result += char('a' + x->op);
+    if(x->op == Node::Leaf) result += std::to_string(x->index) + ';';
+    if(x->b) stack.push_back(x->b.get());
+    if(x->a) stack.push_back(x->a.get());
+  }
+  return result;
+}
+
+// Constructors and Destructor
+JitKernel::JitKernel(const Expr& e) : expr(e), inputs(e.arity())
+{
+#if defined(__x86_64__)
+  static const bool supported = __builtin_cpu_supports("avx2");
+  if(!supported || inputs > max_inputs) return;
+
+  Assembler as;
+  as.byte(0x48); as.byte(0xC1); as.byte(0xE2); as.byte(0x02);  // shl rdx, 2
+  as.byte(0x31); as.byte(0xC0);                                // xor eax, eax
+  const std::size_t loop = as.code.size();
+  if(!generate(*expr.node, 0, as, constants)) {
+    constants.clear();
+    return;
+  }
+  as.store(0);
+  as.byte(0x48); as.byte(0x83); as.byte(0xC0); as.byte(0x20);  // add rax, 32
+  as.byte(0x48); as.byte(0x39); as.byte(0xD0);                 // cmp rax, rdx
+  as.byte(0x0F); as.byte(0x82);                                // jb loop
+  as.dword(std::uint32_t(loop - (as.code.size() + 4)));
+  as.byte(0xC5); as.byte(0xF8); as.byte(0x77);                 // vzeroupper
+  as.byte(0xC3);                                               // ret
+
+  static std::mutex mutex;
+  static std::map<std::string, std::shared_ptr<const Code>> cache;
+  std::lock_guard<std::mutex> lock(mutex);
+  const std::string key = expr.key();
+  auto found = cache.find(key);
+  if(found != cache.end()) {
+    code = found->second;
+    return;
+  }
+
+  const std::size_t size = as.code.size();
+  void* const memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if(memory == MAP_FAILED) {
+    constants.clear();
+    return;
+  }
+  std::memcpy(memory, as.code.data(), size);
+  if(mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+    munmap(memory, size);
+    constants.clear();
+    return;
+  }
+  std::shared_ptr<Code> compiled = std::make_shared<Code>();
+  compiled->memory = memory;
+  compiled->size = size;
+  compiled->function = reinterpret_cast<Function>(memory);
+  code = compiled;
+  cache[key] = code;
+#endif
+}
+
+// Applications
+void JitKernel::operator()(const float* const* const x, float* const y,
+                           const std::size_t n) const
+{
+  if(!code) {
+    internal::parallel_for(0, n, internal::grain, [&](
+        const std::size_t first, const std::size_t last) {
+      std::vector<const float*> local(inputs);
+      for(std::size_t k = 0; k < inputs; ++k) local[k] = x[k] + first;
+      interpret(local.data(), y + first, last - first);
+    });
+    return;
+  }
+
+  const Function f = code->function;
+  const std::size_t blocks = n / lanes;
+  internal::parallel_for(0, blocks, internal::grain / lanes, [&](
+      const std::size_t first, const std::size_t last) {
+    const float* local[max_inputs];
+    for(std::size_t k = 0; k < inputs; ++k) local[k] = x[k] + first * lanes;
+    f(local, y + first * lanes, (last - first) * lanes, constants.data());
+  });
+
+  // The last partial block goes through padded copies.
+  const std::size_t done = blocks * lanes;
+  if(done == n) return;
+  float pad[max_inputs][lanes] = {};
+  float out[lanes];
+  const float* local[max_inputs];
+  for(std::size_t k = 0; k < inputs; ++k) {
+    std::copy(x[k] + done, x[k] + n, pad[k]);
+    local[k] = pad[k];
+  }
+  f(local, out, lanes, constants.data());
+  std::copy(out, out + (n - done), y + done);
+}
+
+Vectorf JitKernel::operator()(const std::vector<Vectorf>& x) const
+{
+  assert(x.size() >= inputs);
+  const std::size_t n = inputs ? x[0].size() : 0;
+  std::vector<Vectorf> dense;
+  std::vector<const float*> pointers(inputs);
+  for(std::size_t k = 0; k < inputs; ++k) {
+    assert(x[k].size() == n);
+    dense.push_back(x[k].inc() == 1 ? x[k] : x[k].clone());
+    pointers[k] = dense.back().data();
+  }
+  Vectorf y(n);
+  (*this)(pointers.data(), y.data(), n);
+  return y;
+}
+
+Matrixf JitKernel::operator()(const std::vector<Matrixf>& x) const
+{
+  assert(x.size() >= inputs && inputs > 0);
+  const std::size_t rows = x[0].rows();
+  const std::size_t cols = x[0].cols();
+  std::vector<Matrixf> dense;
+  dense.reserve(inputs);
+  std::vector<const float*> pointers(inputs);
+  for(std::size_t k = 0; k < inputs; ++k) {
+    assert(x[k].rows() == rows && x[k].cols() == cols);
+    const bool mixed = x[k].layout() != CblasRowMajor && rows > 1 && cols > 1;
+    dense.push_back(mixed ? x[k].materialize() : x[k]);
+    pointers[k] = dense.back().data();
+  }
+  Matrixf y(rows, cols);
+  (*this)(pointers.data(), y.data(), rows * cols);
+  return y;
+}
+
+// Accessors
+const std::size_t JitKernel::arity() const
+{ return inputs; }
+
+const bool JitKernel::native() const
+{ return code != nullptr; }
+
+const void* const JitKernel::entry() const
+{ return code ? code->memory : nullptr; }
+
+namespace {
+
+using Node = internal::ExprNode;
+
+const float evaluate(const Node& node, const float* const* const x,
+                     const std::size_t i)
+{
+  switch(node.op) {
+  case Node::Leaf: return x[node.index][i];
+  case Node::Constant: return node.value;
+  default: break;
+  }
+  const float a = evaluate(*node.a, x, i);
+  switch(node.op) {
+  case Node::Neg: return -a;
+  case Node::Abs: return std::fabs(a);
+  case Node::Sqrt: return std::sqrt(a);
+  case Node::Exp: return std::exp(a);
+  default: break;
+  }
+  const float b = evaluate(*node.b, x, i);
+  switch(node.op) {
+  case Node::Add: return a + b;
+  case Node::Sub: return a - b;
+  case Node::Mul: return a * b;
+  case Node::Div: return a / b;
+  case Node::Min: return std::min(a, b);
+  default: return std::max(a, b);
+  }
+}
+
+}  // unnamed namespace
+
+void JitKernel::interpret(const float* const* const x, float* const y,
+                          const std::size_t n) const
+{ for(std::size_t i = 0; i < n; ++i) y[i] = evaluate(*expr.node, x, i); }
+
+}  // namespace laplus
@@ -0,0 +1,446 @@
+/******************************************************************************
+ *
+ * laplus/linalg.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/linalg.hpp"
+
+#include <map>
+#include <tuple>
+#include <vector>
+#include <algorithm>
+
+namespace laplus {
+
+namespace {
+
+// LAPACK workspace sizes only depend on the routine and the problem shape,
+// so size queries are remembered per thread and the buffers are grown on
+// demand instead of being reallocated for every factorization.
+class Workspace {
+public:
+  using key_t = std::tuple<char, int, lapack_int, lapack_int, lapack_int>;
+
+  const bool lookup(const key_t& key, lapack_int& lwork, lapack_int& liwork)
+  {
+    auto found = queries.find(key);
+    if(found == queries.end()) return false;
+    lwork = found->second.first;
+    liwork = found->second.second;
+    return true;
+  }
+
+  void store(const key_t& key, const lapack_int lwork, const lapack_int liwork)
+  { queries[key] = std::make_pair(lwork, liwork); }
+
+  float* const work(const std::size_t size)
+  {
+    if(fwork.size() < size) fwork.resize(size);
+    return fwork.data();
+  }
+
+  lapack_int* const iwork(const std::size_t size)
+  {
+    if(iwork_.size() < size) iwork_.resize(size);
+    return iwork_.data();
+  }
+private:
+  std::map<key_t, std::pair<lapack_int, lapack_int>> queries;
+  std::vector<float> fwork;
+  std::vector<lapack_int> iwork_;
+};
+
+Workspace& workspace()
+{
+  static thread_local Workspace instance;
+  return instance;
+}
+
+int order(const Matrixf& a)
+{ return (a.layout() == CblasColMajor) ? LAPACK_COL_MAJOR : LAPACK_ROW_MAJOR; }
+
+char triangle(const CBLAS_UPLO uplo)
+{ return (uplo == CblasUpper) ? 'U' : 'L'; }
+
+// A solve that fails leaves garbage in its result, and the solvers that
+// return a value have no status to report it through.
+void solved(const lapack_int info)
+{
+  assert(info == 0);
+  (void)info;
+}
+
+Matrixf allocate(const std::size_t rows, const std::size_t cols,
+                 const CBLAS_ORDER layout)
+{
+  if(layout == CblasColMajor) return Matrixf(cols, rows).transpose();
+  return Matrixf(rows, cols);
+}
+
+Matrixf duplicate(const Matrixf& a, const CBLAS_ORDER layout)
+{
+  Matrixf result = allocate(a.rows(), a.cols(), layout);
+  if(a.layout() == layout) {
+    result.copy(a);
+    return result;
+  }
+  for(std::size_t i = 0; i < a.rows(); ++i) {
+    for(std::size_t j = 0; j < a.cols(); ++j) {
+      result(i, j) = a(i, j);
+    }
+  }
+  return result;
+}
+
+Matrixf conform(const Matrixf& a, const CBLAS_ORDER layout)
+{
+  if(a.layout() == layout) return a;
+  return duplicate(a, layout);
+}
+
+void restore(const Matrixf& a, const Matrixf& conformed)
+{
+  if(a.data() == conformed.data()) return;
+  for(std::size_t i = 0; i < a.rows(); ++i) {
+    for(std::size_t j = 0; j < a.cols(); ++j) {
+      a(i, j) = conformed(i, j);
+    }
+  }
+}
+
+Matrixf column(const Vectorf& b, const CBLAS_ORDER layout)
+{
+  Matrixf result = allocate(b.size(), 1, layout);
+  result.set_col(0, b);
+  return result;
+}
+
+Matrixf lower(const Matrixf& a, const std::size_t cols, const bool unit)
+{
+  Matrixf result(a.rows(), cols);
+  for(std::size_t i = 0; i < a.rows(); ++i) {
+    for(std::size_t j = 0; j < cols && j <= i; ++j) {
+      result(i, j) = (unit && i == j) ? 1.0 : a(i, j);
+    }
+  }
+  return result;
+}
+
+Matrixf upper(const Matrixf& a, const std::size_t rows)
+{
+  Matrixf result(rows, a.cols());
+  for(std::size_t i = 0; i < rows; ++i) {
+    for(std::size_t j = i; j < a.cols(); ++j) {
+      result(i, j) = a(i, j);
+    }
+  }
+  return result;
+}
+
+}  // unnamed namespace
+
+// LU
+LU::LU(const Matrixf& a)
+  : lu(a), ipiv(std::min(a.rows(), a.cols())), status(0)
+{
+  status = LAPACKE_sgetrf_work(order(lu), lu.rows(), lu.cols(),
+                               lu.data(), lu.ldim(), ipiv.data());
+}
+
+const Matrixf& LU::factors() const
+{ return lu; }
+
+const std::vector<lapack_int>& LU::pivots() const
+{ return ipiv; }
+
+const lapack_int LU::info() const
+{ return status; }
+
+Matrixf LU::L() const
+{ return lower(lu, std::min(lu.rows(), lu.cols()), true); }
+
+Matrixf LU::U() const
+{ return upper(lu, std::min(lu.rows(), lu.cols())); }
+
+const lapack_int LU::solve_inplace(const Matrixf& b) const
+{
+  assert(lu.rows() == lu.cols());
+  assert(lu.rows() == b.rows());
+  Matrixf x = conform(b, lu.layout());
+  const lapack_int info =
+    LAPACKE_sgetrs_work(order(lu), 'N', lu.rows(), x.cols(),
+                        lu.data(), lu.ldim(), ipiv.data(),
+                        x.data(), x.ldim());
+  restore(b, x);
+  return info;
+}
+
+Matrixf LU::solve(const Matrixf& b) const
+{
+  Matrixf x = duplicate(b, lu.layout());
+  solved(solve_inplace(x));
+  return x;
+}
+
+Vectorf LU::solve(const Vectorf& b) const
+{
+  Matrixf x = column(b, lu.layout());
+  solved(solve_inplace(x));
+  return x.col(0);
+}
+
+// Cholesky
+Cholesky::Cholesky(const Matrixf& a, const CBLAS_UPLO uplo)
+  : llt(a), uplo(uplo), status(0)
+{
+  assert(a.rows() == a.cols());
+  status = LAPACKE_spotrf_work(order(llt), triangle(uplo), llt.rows(),
+                               llt.data(), llt.ldim());
+}
+
+const Matrixf& Cholesky::factors() const
+{ return llt; }
+
+const lapack_int Cholesky::info() const
+{ return status; }
+
+Matrixf Cholesky::L() const
+{
+  if(uplo == CblasLower) return lower(llt, llt.cols(), false);
+  return upper(llt, llt.rows()).transpose();
+}
+
+Matrixf Cholesky::U() const
+{ return L().transpose(); }
+
+const lapack_int Cholesky::solve_inplace(const Matrixf& b) const
+{
+  assert(llt.rows() == b.rows());
+  Matrixf x = conform(b, llt.layout());
+  const lapack_int info =
+    LAPACKE_spotrs_work(order(llt), triangle(uplo), llt.rows(), x.cols(),
+                        llt.data(), llt.ldim(), x.data(), x.ldim());
+  restore(b, x);
+  return info;
+}
+
+Matrixf Cholesky::solve(const Matrixf& b) const
+{
+  Matrixf x = duplicate(b, llt.layout());
+  solved(solve_inplace(x));
+  return x;
+}
+
+Vectorf Cholesky::solve(const Vectorf& b) const
+{
+  Matrixf x = column(b, llt.layout());
+  solved(solve_inplace(x));
+  return x.col(0);
+}
+
+// QR
+QR::QR(const Matrixf& a)
+  : qr(a), tau(std::min(a.rows(), a.cols())), status(0)
+{
+  Workspace& ws = workspace();
+  Workspace::key_t key('q', order(qr), qr.rows(), qr.cols(), 0);
+  lapack_int lwork, liwork;
+  if(!ws.lookup(key, lwork, liwork)) {
+    float query;
+    LAPACKE_sgeqrf_work(order(qr), qr.rows(), qr.cols(), qr.data(),
+                        qr.ldim(), tau.data(), &query, -1);
+    lwork = static_cast<lapack_int>(query);
+    liwork = 0;
+    ws.store(key, lwork, liwork);
+  }
+  status = LAPACKE_sgeqrf_work(order(qr), qr.rows(), qr.cols(), qr.data(),
+                               qr.ldim(), tau.data(), ws.work(lwork), lwork);
+}
+
+const Matrixf& QR::factors() const
+{ return qr; }
+
+const Vectorf& QR::reflectors() const
+{ return tau; }
+
+const lapack_int QR::info() const
+{ return status; }
+
+Matrixf QR::Q() const
+{
+  const std::size_t k = tau.size();
+  Matrixf q = allocate(qr.rows(), k, qr.layout());
+  for(std::size_t j = 0; j < k; ++j) {
+    q.set_col(j, qr.col(j));
+  }
+  Workspace& ws = workspace();
+  Workspace::key_t key('g', order(q), q.rows(), k, k);
+  lapack_int lwork, liwork;
+  if(!ws.lookup(key, lwork, liwork)) {
+    float query;
+    LAPACKE_sorgqr_work(order(q), q.rows(), k, k, q.data(), q.ldim(),
+                        tau.data(), &query, -1);
+    lwork = static_cast<lapack_int>(query);
+    liwork = 0;
+    ws.store(key, lwork, liwork);
+  }
+  LAPACKE_sorgqr_work(order(q), q.rows(), k, k, q.data(), q.ldim(),
+                      tau.data(), ws.work(lwork), lwork);
+  return q;
+}
+
+Matrixf QR::R() const
+{ return upper(qr, tau.size()); }
+
+Matrixf QR::solve(const Matrixf& b) const
+{
+  assert(qr.rows() >= qr.cols());
+  assert(qr.rows() == b.rows());
+  const std::size_t n = qr.cols();
+  Matrixf c = duplicate(b, qr.layout());
+  Workspace& ws = workspace();
+  Workspace::key_t key('m', order(c), c.rows(), c.cols(), n);
+  lapack_int lwork, liwork;
+  if(!ws.lookup(key, lwork, liwork)) {
+    float query;
+    LAPACKE_sormqr_work(order(c), 'L', 'T', c.rows(), c.cols(), n,
+                        qr.data(), qr.ldim(), tau.data(),
+                        c.data(), c.ldim(), &query, -1);
+    lwork = static_cast<lapack_int>(query);
+    liwork = 0;
+    ws.store(key, lwork, liwork);
+  }
+  solved(LAPACKE_sormqr_work(order(c), 'L', 'T', c.rows(), c.cols(), n,
+                             qr.data(), qr.ldim(), tau.data(),
+                             c.data(), c.ldim(), ws.work(lwork), lwork));
+  // R is singular, and x undefined, when a is rank deficient.
+  solved(LAPACKE_strtrs_work(order(c), 'U', 'N', 'N', n, c.cols(),
+                             qr.data(), qr.ldim(), c.data(), c.ldim()));
+  Matrixf x(n, c.cols());
+  for(std::size_t i = 0; i < n; ++i) {
+    x.set_row(i, c.row(i));
+  }
+  return x;
+}
+
+Vectorf QR::solve(const Vectorf& b) const
+{ return solve(column(b, qr.layout())).col(0); }
+
+// SVD
+SVD::SVD(const Matrixf& a)
+  : u(allocate(a.rows(), std::min(a.rows(), a.cols()), a.layout()))
+  , s(std::min(a.rows(), a.cols()))
+  , vt(allocate(std::min(a.rows(), a.cols()), a.cols(), a.layout()))
+  , status(0)
+{
+  Workspace& ws = workspace();
+  Workspace::key_t key('s', order(a), a.rows(), a.cols(), 0);
+  lapack_int lwork, liwork;
+  if(!ws.lookup(key, lwork, liwork)) {
+    float query;
+    LAPACKE_sgesdd_work(order(a), 'S', a.rows(), a.cols(), a.data(), a.ldim(),
+                        s.data(), u.data(), u.ldim(), vt.data(), vt.ldim(),
+                        &query, -1, ws.iwork(8 * s.size()));
+    lwork = static_cast<lapack_int>(query);
+    liwork = 8 * s.size();
+    ws.store(key, lwork, liwork);
+  }
+  status = LAPACKE_sgesdd_work(order(a), 'S', a.rows(), a.cols(),
+                               a.data(), a.ldim(), s.data(),
+                               u.data(), u.ldim(), vt.data(), vt.ldim(),
+                               ws.work(lwork), lwork, ws.iwork(liwork));
+}
+
+const Matrixf& SVD::U() const
+{ return u; }
+
+const Vectorf& SVD::S() const
+{ return s; }
+
+const Matrixf& SVD::Vt() const
+{ return vt; }
+
+const lapack_int SVD::info() const
+{ return status; }
+
+// Eigh
+Eigh::Eigh(const Matrixf& a, const CBLAS_UPLO uplo)
+  : w(a.rows()), v(a), status(0)
+{
+  assert(a.rows() == a.cols());
+  Workspace& ws = workspace();
+  Workspace::key_t key('e', order(v), v.rows(), v.cols(), triangle(uplo));
+  lapack_int lwork, liwork;
+  if(!ws.lookup(key, lwork, liwork)) {
+    float query;
+    lapack_int iquery;
+    LAPACKE_ssyevd_work(order(v), 'V', triangle(uplo), v.rows(),
+                        v.data(), v.ldim(), w.data(),
+                        &query, -1, &iquery, -1);
+    lwork = static_cast<lapack_int>(query);
+    liwork = iquery;
+    ws.store(key, lwork, liwork);
+  }
+  status = LAPACKE_ssyevd_work(order(v), 'V', triangle(uplo), v.rows(),
+                               v.data(), v.ldim(), w.data(),
+                               ws.work(lwork), lwork,
+                               ws.iwork(liwork), liwork);
+}
+
+const Vectorf& Eigh::values() const
+{ return w; }
+
+const Matrixf& Eigh::vectors() const
+{ return v; }
+
+const lapack_int Eigh::info() const
+{ return status; }
+
+// Decompositions
+LU lu(const Matrixf& a)
+{ return LU(a); }
+
+Cholesky cholesky(const Matrixf& a, const CBLAS_UPLO uplo)
+{ return Cholesky(a, uplo); }
+
+QR qr(const Matrixf& a)
+{ return QR(a); }
+
+SVD svd(const Matrixf& a)
+{ return SVD(a); }
+
+Eigh eigh(const Matrixf& a, const CBLAS_UPLO uplo)
+{ return Eigh(a, uplo); }
+
+// Solvers
+Matrixf solve(const Matrixf& a, const Matrixf& b)
+{ return lu(duplicate(a, a.layout())).solve(b); }
+
+Matrixf lstsq(const Matrixf& a, const Matrixf& b)
+{ return qr(duplicate(a, a.layout())).solve(b); }
+
+}  // namespace laplus
@@ -0,0 +1,1006 @@
+/******************************************************************************
+ *
+ * laplus/matrix.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#include "laplus/matrix.hpp"
+#include "laplus/random.hpp"
+#include "laplus/internal/blas.hpp"
+#include "laplus/internal/transpose.hpp"
+#include "laplus/typedef.hpp"
+
+namespace laplus {
+
+namespace {
+
+template<typename T>
+vector1d<T> flatten(const vector2d<T>& vectors)
+{
+  std::size_t size = 0;
+  for(const vector1d<T>& vector: vectors) size += vector.size();
+
+  vector1d<T> result;
+  result.reserve(size);
+  for(const vector1d<T>& vector: vectors) {
+    result.insert(result.end(), vector.begin(), vector.end());
+  }
+  return result;
+}
+
+template<typename T>
+shape_t get_shape(const vector2d<T>& vectors)
+{
+  std::size_t rows = vectors.size();
+  std::size_t cols = vectors.front().size();
+  for(const vector1d<T>& vector: vectors) {
+    assert(vector.size() == cols);
+  }
+  return std::pair<std::size_t, std::size_t>(rows, cols);
+}
+
+shape_t flip(const shape_t& shape)
+{ return shape_t(shape.second, shape.first); }
+
+template<typename T>
+using blas = internal::blas<T>;
+
+}  // unnamed namespace
+
+// Generators
+template<typename T>
+Matrix<T> Matrix<T>::Uniform(const std::size_t rows, const std::size_t cols)
+{ return Uniform(rows, cols, 0.0, 1.0); }
+
+template<typename T>
+Matrix<T> Matrix<T>::Uniform(const std::size_t rows, const std::size_t cols,
+                             const T max)
+{ return Uniform(rows, cols, 0.0, max); }
+
+template<typename T>
+Matrix<T> Matrix<T>::Uniform(const std::size_t rows, const std::size_t cols,
+                             const T min, const T max)
+{
+  Matrix<T> result(rows, cols);
+  Philox::next().uniform(result.data(), rows * cols, min, max);
+  return result;
+
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::Normal(const std::size_t rows, const std::size_t cols)
+{ return Normal(rows, cols, 0.0, 1.0); }
+
+template<typename T>
+Matrix<T> Matrix<T>::Normal(const std::size_t rows, const std::size_t cols,
+                            const T mean, const T stddev)
+{
+  Matrix<T> result(rows, cols);
+  Philox::next().normal(result.data(), rows * cols, mean, stddev);
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::Identity(const std::size_t size)
+{
+  Matrix<T> result(size, size);
+  for(std::size_t i = 0; i < size; ++i) {
+    result[i][i] = 1.0;
+  }
+  return result;
+}
+
+// Constructors and Destructor
+template<typename T>
+Matrix<T>::Matrix(const std::size_t rows, const std::size_t cols)
+  : Vector<T>(rows * cols), shape(shape_t(rows, cols)), trans(CblasNoTrans)
+{}
+
+template<typename T>
+Matrix<T>::Matrix(const shape_t shape)
+  : Vector<T>(shape.first * shape.second), shape(shape), trans(CblasNoTrans)
+{}
+
+template<typename T>
+Matrix<T>::Matrix(const vector1d<T>& values,
+                  const std::size_t rows, const std::size_t cols)
+  : Vector<T>(values), shape(shape_t(rows, cols)), trans(CblasNoTrans)
+{ assert(values.size() == rows * cols); }
+
+template<typename T>
+Matrix<T>::Matrix(vector1d<T>&& values,
+                  const std::size_t rows, const std::size_t cols)
+  : Vector<T>(std::move(values))
+  , shape(shape_t(rows, cols)), trans(CblasNoTrans)
+{ assert(this->size() == rows * cols); }
+
+template<typename T>
+Matrix<T>::Matrix(T* const values,
+                  const std::size_t rows, const std::size_t cols,
+                  const std::function<void(T*)>& deleter)
+  : Vector<T>(values, rows * cols, deleter)
+  , shape(shape_t(rows, cols)), trans(CblasNoTrans)
+{}
+
+template<typename T>
+Matrix<T>::Matrix(const vector2d<T>& values)
+  : Vector<T>(flatten(values)), shape(get_shape(values)), trans(CblasNoTrans)
+{}
+
+template<typename T>
+Matrix<T>::Matrix(const Matrix<T>& other)
+  : Vector<T>(other), shape(other.shape), trans(other.trans)
+{}
+
+template<typename T>
+Matrix<T>::Matrix(Matrix<T>&& other) noexcept
+  : Vector<T>(std::forward<Matrix<T>>(other))
+  , shape(other.shape), trans(other.trans)
+{ other.shape = shape_t(0, 0); }
+
+template<typename T>
+Matrix<T>::Matrix(const Vector<T>& other)
+  : Vector<T>(other), shape(shape_t(1, other.size())), trans(CblasNoTrans)
+{}
+
+template<typename T>
+Matrix<T>::~Matrix() {}
+
+// Assignment Operators
+template<typename T>
+Matrix<T>& Matrix<T>::operator=(const Matrix<T>& other)
+{
+  Matrix<T> another(other);
+  *this = std::move(another);
+  return *this;
+}
+
+template<typename T>
+Matrix<T>& Matrix<T>::operator=(Matrix<T>&& other) noexcept
+{
+  using std::swap;
+  swap(*this, other);
+  return other;
+}
+
+template<typename T>
+Matrix<T>& Matrix<T>::operator+=(const Matrix<T>& rhs)
+{
+  this->axpy(1.0, rhs);
+  return *this;
+}
+
+template<typename T>
+Matrix<T>& Matrix<T>::operator-=(const Matrix<T>& rhs)
+{
+  this->axpy(-1.0, rhs);
+  return *this;
+}
+
+template<typename T>
+Matrix<T>& Matrix<T>::operator*=(const Matrix<T>& rhs)
+{
+  this->mul_inplace(rhs);
+  return *this;
+}
+
+template<typename T>
+Matrix<T>& Matrix<T>::operator/=(const Matrix<T>& rhs)
+{
+  this->div_inplace(rhs);
+  return *this;
+}
+
+template<typename T>
+Matrix<T>& Matrix<T>::operator^=(const Matrix<T>& rhs)
+{
+  this->pow_inplace(rhs);
+  return *this;
+}
+
+template<typename T>
+Matrix<T>& Matrix<T>::operator+=(const T rhs)
+{
+  this->add_inplace(rhs);
+  return *this;
+}
+
+template<typename T>
+Matrix<T>& Matrix<T>::operator-=(const T rhs)
+{
+  this->sub_inplace(rhs);
+  return *this;
+}
+
+template<typename T>
+Matrix<T>& Matrix<T>::operator*=(const T rhs)
+{
+  this->mul_inplace(rhs);
+  return *this;
+}
+
+template<typename T>
+Matrix<T>& Matrix<T>::operator/=(const T rhs)
+{
+  this->div_inplace(rhs);
+  return *this;
+}
+
+template<typename T>
+Matrix<T>& Matrix<T>::operator^=(const T rhs)
+{
+  this->pow_inplace(rhs);
+  return *this;
+}
+
+// Arithmetic Operators
+template<typename T>
+Matrix<T> Matrix<T>::operator+() const
+{ return this->clone(); }
+
+template<typename T>
+Matrix<T> Matrix<T>::operator-() const
+{
+  Matrix<T> result(this->clone());
+  result.scal(-1.0);
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::operator+(const Matrix<T>& other) const
+{
+  Matrix<T> result(this->clone());
+  result += other;
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::operator-(const Matrix<T>& other) const
+{
+  Matrix<T> result(this->clone());
+  result -= other;
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::operator*(const Matrix<T>& other) const
+{
+  Matrix<T> result(this->clone());
+  result *= other;
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::operator/(const Matrix<T>& other) const
+{
+  Matrix<T> result(this->clone());
+  result /= other;
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::operator^(const Matrix<T>& other) const
+{
+  Matrix<T> result(this->clone());
+  result ^= other;
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::operator+(const T value) const
+{
+  Matrix<T> result(this->clone());
+  result += value;
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::operator-(const T value) const
+{
+  Matrix<T> result(this->clone());
+  result -= value;
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::operator*(const T value) const
+{
+  Matrix<T> result(this->clone());
+  result *= value;
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::operator/(const T value) const
+{
+  Matrix<T> result(this->clone());
+  result /= value;
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::operator^(const T value) const
+{
+  Matrix<T> result(this->clone());
+  result ^= value;
+  return result;
+}
+
+template<typename T>
+Matrix<T> operator+(const typename Matrix<T>::value_type& value,
+                    const Matrix<T>& vector)
+{ return vector + value; }
+
+template<typename T>
+Matrix<T> operator-(const typename Matrix<T>::value_type& value,
+                    const Matrix<T>& vector)
+{ return -vector + value; }
+
+template<typename T>
+Matrix<T> operator*(const typename Matrix<T>::value_type& value,
+                    const Matrix<T>& vector)
+{ return vector * value; }
+
+template<typename T>
+Matrix<T> operator/(const typename Matrix<T>::value_type& value,
+                    const Matrix<T>& vector)
+{
+  Matrix<T> result(vector.clone());
+  for(std::size_t i = 0; i < result.rows(); ++i) {
+    for(std::size_t j = 0; j < result.cols(); ++j) {
+      result(i, j) = value / result(i, j);
+    }
+  }
+  return result;
+}
+
+template<typename T>
+Matrix<T> operator^(const typename Matrix<T>::value_type& value,
+                    const Matrix<T>& vector)
+{
+  Matrix<T> result(vector.clone());
+  for(std::size_t i = 0; i < result.rows(); ++i) {
+    for(std::size_t j = 0; j < result.cols(); ++j) {
+      result(i, j) = std::pow(value, result(i, j));
+    }
+  }
+  return result;
+}
+
+// Miscellaneous Operators
+template<typename T>
+const Vector<T> Matrix<T>::operator[](const std::size_t index) const
+{
+  if(trans == CblasTrans)
+    return view(index, shape.first, shape.second);
+  return view(index * shape.second, 1, shape.second);
+}
+
+template<typename T>
+T& Matrix<T>::operator()(const std::size_t i, const std::size_t j) const
+{
+  if(trans == CblasTrans)
+    return Vector<T>::operator[](i + shape.first * j);
+  return Vector<T>::operator[](i * shape.second + j);
+}
+
+template<typename T>
+std::ostream& operator<<(std::ostream& ostream, const Matrix<T>& matrix)
+{
+  ostream << "[";
+  for(std::size_t i = 0; i < matrix.rows(); ++i) {
+    if(i != 0) ostream << std::endl << " ";
+    ostream << matrix[i];
+  }
+  return ostream << "]";
+}
+
+// Utilities
+template<typename T>
+void swap(Matrix<T>& a, Matrix<T>& b)
+{
+  using std::swap;
+  swap(static_cast<Vector<T>&>(a), static_cast<Vector<T>&>(b));
+  swap(a.shape, b.shape);
+  swap(a.trans, b.trans);
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::clone() const
+{
+  Matrix<T> other(this->shape);
+  other.trans = trans;
+  other.copy(*this);
+  return other;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::transpose() const
+{
+  Matrix<T> other(*this);
+  other.shape = flip(shape);
+  other.trans = (trans == CblasTrans) ? CblasNoTrans : CblasTrans;
+  return other;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::transpose_copy() const
+{ return transpose().materialize(); }
+
+template<typename T>
+Matrix<T> Matrix<T>::materialize() const
+{
+  if(trans == CblasNoTrans) return clone();
+  return Matrix<T>(shape).aligned(*this);
+}
+
+// This matrix when it is already dense and row-major, a row-major copy
+// otherwise.
+template<typename T>
+Matrix<T> Matrix<T>::row_major() const
+{
+  if(trans == CblasNoTrans && this->inc() == 1) return *this;
+  return materialize();
+}
+
+template<typename T>
+void Matrix<T>::transpose_inplace()
+{
+  assert(rows() == cols());
+  assert(this->inc() == 1);
+  internal::transpose(this->data(), ldim(), rows());
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::reshape(const std::size_t rows,
+                             const std::size_t cols) const
+{
+  assert(rows * cols == this->size());
+  Matrix<T> other(*this);
+  other.shape = shape_t(rows, cols);
+  return other;
+}
+
+// Accessors
+template<typename T>
+const std::size_t Matrix<T>::rows() const
+{ return shape.first; }
+
+template<typename T>
+const std::size_t Matrix<T>::cols() const
+{ return shape.second; }
+
+template<typename T>
+const std::size_t Matrix<T>::ldim() const
+{ return (trans == CblasTrans) ? rows() : cols(); }
+
+template<typename T>
+const CBLAS_ORDER Matrix<T>::layout() const
+{ return (trans == CblasTrans) ? CblasColMajor : CblasRowMajor; }
+
+template<typename T>
+const Vector<T> Matrix<T>::view(const std::size_t first,
+                               const std::size_t stride,
+                               const std::size_t length) const
+{ return Vector<T>(*this, this->offset + first, stride, length); }
+
+template<typename T>
+const Vector<T> Matrix<T>::row(const std::size_t index) const
+{
+  if(trans == CblasTrans)
+    return view(index, shape.first, shape.second);
+  return view(index * shape.second, 1, shape.second);
+}
+
+template<typename T>
+const Vector<T> Matrix<T>::col(const std::size_t index) const
+{
+  if(trans == CblasTrans)
+    return view(index * shape.first, 1, shape.first);
+  return view(index, shape.second, shape.first);
+}
+
+template<typename T>
+void Matrix<T>::set_row(const std::size_t index, const Vector<T>& vector)
+{
+  assert(shape.second == vector.size());
+  if(trans == CblasTrans) {
+    Vector<T> target = view(index, shape.first, shape.second);
+    target.copy(vector);
+  } else {
+    Vector<T> target = view(index * shape.second, 1, shape.second);
+    target.copy(vector);
+  }
+}
+
+template<typename T>
+void Matrix<T>::set_col(const std::size_t index, const Vector<T>& vector)
+{
+  assert(shape.first == vector.size());
+  if(trans == CblasTrans) {
+    Vector<T> target = view(index * shape.first, 1, shape.first);
+    target.copy(vector);
+  } else {
+    Vector<T> target = view(index, shape.second, shape.first);
+    target.copy(vector);
+  }
+}
+
+// Level 1 BLAS
+template<typename T>
+void Matrix<T>::axpy(const T alpha, const Matrix<T>& other)
+{
+  assert(rows() == other.rows());
+  assert(cols() == other.cols());
+  if(!mixed(other)) {
+    Vector<T>::axpy(alpha, other);
+  } else if(this->inc() == 1 && other.inc() == 1) {
+    internal::transpose_axpy(alpha, other.data(), other.ldim(),
+                             this->data(), ldim(), this->size() / ldim(),
+                             ldim());
+  } else {
+    Vector<T>::axpy(alpha, aligned(other));
+  }
+}
+
+// Level 2 BLAS
+template<typename T>
+void Matrix<T>::ger(const T alpha, const Vector<T>& x, const Vector<T>& y)
+{
+  assert(this->rows() == x.size());
+  assert(this->cols() == y.size());
+  blas<T>::ger(this->layout(), this->rows(), this->cols(), alpha,
+               x.data(), x.inc(), y.data(), y.inc(),
+               this->data(), this->ldim());
+}
+
+template<typename T>
+void Matrix<T>::syr(const CBLAS_UPLO uplo, const T alpha, const Vector<T>& x)
+{
+  assert(this->rows() == this->cols());
+  assert(this->rows() == x.size());
+  blas<T>::syr(this->layout(), uplo, this->rows(), alpha,
+               x.data(), x.inc(),
+               this->data(), this->ldim());
+}
+
+template<typename T>
+void Matrix<T>::syr2(const CBLAS_UPLO uplo, const T alpha,
+                     const Vector<T>& x, const Vector<T>& y)
+{
+  assert(this->rows() == this->cols());
+  assert(this->rows() == x.size());
+  assert(this->rows() == y.size());
+  blas<T>::syr2(this->layout(), uplo, this->rows(), alpha,
+                x.data(), x.inc(), y.data(), y.inc(),
+                this->data(), this->ldim());
+}
+
+// Level 3 BLAS
+template<typename T>
+void Matrix<T>::gemm(const T alpha, const Matrix<T>& A,
+                     const Matrix<T>& B, const T beta)
+{
+  assert(this->rows() == A.rows());
+  assert(this->cols() == B.cols());
+  assert(A.cols() == B.rows());
+  blas<T>::gemm(this->layout(), this->relative(A), this->relative(B),
+                A.rows(), B.cols(), A.cols(),
+                alpha, A.data(), A.ldim(), B.data(), B.ldim(),
+                beta, this->data(), this->ldim());
+}
+
+template<typename T>
+void Matrix<T>::symm(const CBLAS_SIDE side, const CBLAS_UPLO uplo,
+                     const T alpha, const Matrix<T>& A,
+                     const Matrix<T>& B, const T beta)
+{
+  assert(A.rows() == A.cols());
+  assert(this->rows() == B.rows());
+  assert(this->cols() == B.cols());
+  assert(A.rows() == (side == CblasLeft ? B.rows() : B.cols()));
+  const Matrix<T> b = this->aligned(B);
+  blas<T>::symm(this->layout(), side, this->relative(A, uplo),
+                this->rows(), this->cols(),
+                alpha, A.data(), A.ldim(), b.data(), b.ldim(),
+                beta, this->data(), this->ldim());
+}
+
+template<typename T>
+void Matrix<T>::syrk(const CBLAS_UPLO uplo, const T alpha,
+                     const Matrix<T>& A, const T beta)
+{
+  assert(this->rows() == this->cols());
+  assert(this->rows() == A.rows());
+  blas<T>::syrk(this->layout(), uplo, this->relative(A), A.rows(), A.cols(),
+                alpha, A.data(), A.ldim(),
+                beta, this->data(), this->ldim());
+}
+
+template<typename T>
+void Matrix<T>::syr2k(const CBLAS_UPLO uplo, const T alpha,
+                      const Matrix<T>& A, const Matrix<T>& B, const T beta)
+{
+  assert(this->rows() == this->cols());
+  assert(this->rows() == A.rows());
+  assert(A.rows() == B.rows());
+  assert(A.cols() == B.cols());
+  const Matrix<T> b = A.aligned(B);
+  blas<T>::syr2k(this->layout(), uplo, this->relative(A), A.rows(), A.cols(),
+                 alpha, A.data(), A.ldim(), b.data(), b.ldim(),
+                 beta, this->data(), this->ldim());
+}
+
+template<typename T>
+void Matrix<T>::trmm(const CBLAS_SIDE side, const CBLAS_UPLO uplo,
+                     const CBLAS_DIAG diag, const T alpha, const Matrix<T>& A)
+{
+  assert(A.rows() == A.cols());
+  assert(A.rows() == (side == CblasLeft ? this->rows() : this->cols()));
+  blas<T>::trmm(this->layout(), side, this->relative(A, uplo),
+                this->relative(A), diag, this->rows(), this->cols(),
+                alpha, A.data(), A.ldim(),
+                this->data(), this->ldim());
+}
+
+template<typename T>
+void Matrix<T>::trsm(const CBLAS_SIDE side, const CBLAS_UPLO uplo,
+                     const CBLAS_DIAG diag, const T alpha, const Matrix<T>& A)
+{
+  assert(A.rows() == A.cols());
+  assert(A.rows() == (side == CblasLeft ? this->rows() : this->cols()));
+  blas<T>::trsm(this->layout(), side, this->relative(A, uplo),
+                this->relative(A), diag, this->rows(), this->cols(),
+                alpha, A.data(), A.ldim(),
+                this->data(), this->ldim());
+}
+
+// Arithmetic Functions
+template<typename T>
+void Matrix<T>::mul_inplace(const Matrix<T>& other)
+{
+  assert(rows() == other.rows());
+  assert(cols() == other.cols());
+  if(!mixed(other)) {
+    Vector<T>::mul_inplace(other);
+  } else if(this->inc() == 1 && other.inc() == 1) {
+    internal::transpose_mul(other.data(), other.ldim(), this->data(), ldim(),
+                            this->size() / ldim(), ldim());
+  } else {
+    Vector<T>::mul_inplace(aligned(other));
+  }
+}
+
+template<typename T>
+void Matrix<T>::div_inplace(const Matrix<T>& other)
+{
+  assert(rows() == other.rows());
+  assert(cols() == other.cols());
+  if(!mixed(other)) {
+    Vector<T>::div_inplace(other);
+  } else if(this->inc() == 1 && other.inc() == 1) {
+    internal::transpose_div(other.data(), other.ldim(), this->data(), ldim(),
+                            this->size() / ldim(), ldim());
+  } else {
+    Vector<T>::div_inplace(aligned(other));
+  }
+}
+
+template<typename T>
+void Matrix<T>::pow_inplace(const Matrix<T>& other)
+{
+  assert(rows() == other.rows());
+  assert(cols() == other.cols());
+  if(!mixed(other)) {
+    Vector<T>::pow_inplace(other);
+  } else if(this->inc() == 1 && other.inc() == 1) {
+    internal::transpose_pow(other.data(), other.ldim(), this->data(), ldim(),
+                            this->size() / ldim(), ldim());
+  } else {
+    Vector<T>::pow_inplace(aligned(other));
+  }
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::mul(const Matrix<T>& other) const
+{
+  Matrix<T> result(this->clone());
+  result.mul_inplace(other);
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::div(const Matrix<T>& other) const
+{
+  Matrix<T> result(this->clone());
+  result.div_inplace(other);
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::pow(const Matrix<T>& other) const
+{
+  Matrix<T> result(this->clone());
+  result.pow_inplace(other);
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::add(const T value) const
+{
+  Matrix<T> result(this->clone());
+  result.add_inplace(value);
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::sub(const T value) const
+{
+  Matrix<T> result(this->clone());
+  result.sub_inplace(value);
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::mul(const T value) const
+{
+  Matrix<T> result(this->clone());
+  result.mul_inplace(value);
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::div(const T value) const
+{
+  Matrix<T> result(this->clone());
+  result.div_inplace(value);
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::pow(const T value) const
+{
+  Matrix<T> result(this->clone());
+  result.pow_inplace(value);
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::log() const
+{
+  Matrix<T> result(this->clone());
+  result.log_inplace();
+  return result;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::apply(const std::function<T(T)>& f)
+{
+  Matrix<T> result(this->clone());
+  result.apply_inplace(f);
+  return result;
+}
+
+// Extensions
+template<typename T>
+const T Matrix<T>::maxCoeff() const
+{ return Vector<T>::maxCoeff(); }
+
+template<typename T>
+const T Matrix<T>::minCoeff() const
+{ return Vector<T>::minCoeff(); }
+
+template<typename T>
+const T Matrix<T>::maxCoeff(std::size_t& max_i, std::size_t& max_j) const
+{
+  T max_v = (*this)(0, 0);
+  for(std::size_t i = 1; i < this->rows(); ++i) {
+    for(std::size_t j = 1; j < this->cols(); ++j) {
+      if(max_v < (*this)(i, j)) {
+        max_v = (*this)(i, j);
+        max_i = i;
+        max_j = j;
+      }
+    }
+  }
+  return max_v;
+}
+
+template<typename T>
+const T Matrix<T>::minCoeff(std::size_t& min_i, std::size_t& min_j) const
+{
+  T min_v = (*this)(0, 0);
+  for(std::size_t i = 1; i < this->rows(); ++i) {
+    for(std::size_t j = 1; j < this->cols(); ++j) {
+      if(min_v > (*this)(i, j)) {
+        min_v = (*this)(i, j);
+        min_i = i;
+        min_j = j;
+      }
+    }
+  }
+  return min_v;
+}
+
+// Linear Algebra
+template<typename T>
+Matrix<T> Matrix<T>::dot(const Matrix<T>& other) const
+{
+  Matrix<T> result(this->rows(), other.cols());
+  result.gemm(1.0, *this, other, 0.0);
+  return result;
+}
+
+template<typename T>
+Vector<T> Matrix<T>::dot(const Vector<T>& other) const
+{ return Vector<T>(Matrix<T>(other).dot(this->transpose())); }
+
+template<typename T>
+void Matrix<T>::dot(const Matrix<T>& a, const Matrix<T>& b)
+{ this->gemm(1.0, a, b, 0.0); }
+
+// Layout Helpers
+template<typename T>
+const bool Matrix<T>::mixed(const Matrix<T>& other) const
+{ return other.trans != trans && rows() > 1 && cols() > 1; }
+
+template<typename T>
+const CBLAS_TRANSPOSE Matrix<T>::relative(const Matrix<T>& other) const
+{ return (other.trans == trans) ? CblasNoTrans : CblasTrans; }
+
+template<typename T>
+const CBLAS_UPLO Matrix<T>::relative(const Matrix<T>& other,
+                                     const CBLAS_UPLO uplo) const
+{
+  if(other.trans == trans) return uplo;
+  return (uplo == CblasUpper) ? CblasLower : CblasUpper;
+}
+
+template<typename T>
+Matrix<T> Matrix<T>::aligned(const Matrix<T>& other) const
+{
+  if(other.trans == trans) return other;
+  Matrix<T> result(other.shape);
+  result.trans = trans;
+  if(other.inc() == 1) {
+    const std::size_t major = (other.trans == CblasTrans) ? other.cols()
+                                                          : other.rows();
+    internal::transpose(other.data(), other.ldim(), result.data(),
+                        result.ldim(), major, other.ldim());
+    return result;
+  }
+  for(std::size_t i = 0; i < other.rows(); ++i) {
+    for(std::size_t j = 0; j < other.cols(); ++j) {
+      result(i, j) = other(i, j);
+    }
+  }
+  return result;
+}
+
+template<typename T>
+const bool operator==(const Matrix<T>& a, const Matrix<T>& b)
+{
+  assert(a.rows() == b.rows());
+  assert(a.cols() == b.cols());
+  for(std::size_t i = 0; i < a.rows(); ++i) {
+    for(std::size_t j = 0; j < b.cols(); ++j) {
+      if(a(i, j) != b(i, j)) return false;
+    }
+  }
+  return true;
+}
+
+template<typename T>
+const bool operator!=(const Matrix<T>& a, const Matrix<T>& b)
+{ return !(a == b); }
+
+template<typename T>
+const bool operator==(const Matrix<T>& matrix, const vector1d<T>& vector)
+{
+  std::size_t k = 0;
+  for(std::size_t i = 0; i < matrix.rows(); ++i) {
+    for(std::size_t j = 0; j < matrix.cols(); ++j, ++k) {
+      if(matrix(i, j) != vector[k]) return false;
+    }
+  }
+  return true;
+}
+
+template<typename T>
+const bool operator!=(const Matrix<T>& matrix, const vector1d<T>& vector)
+{ return !(matrix == vector); }
+
+template<typename T>
+const bool operator==(const Matrix<T>& matrix, const vector2d<T>& vector)
+{
+  for(std::size_t i = 0; i < matrix.rows(); ++i) {
+    for(std::size_t j = 0; j < matrix.cols(); ++j) {
+      if(matrix(i, j) != vector[i][j]) return false;
+    }
+  }
+  return true;
+}
+
+template<typename T>
+const bool operator!=(const Matrix<T>& matrix, const vector2d<T>& vector)
+{ return !(matrix == vector); }
+
+template<typename T>
+const bool operator==(const vector1d<T>& vector, const Matrix<T>& matrix)
+{ return matrix == vector; }
+
+template<typename T>
+const bool operator!=(const vector1d<T>& vector, const Matrix<T>& matrix)
+{ return matrix != vector; }
+
+template<typename T>
+const bool operator==(const vector2d<T>& vector, const Matrix<T>& matrix)
+{ return matrix == vector; }
+
+template<typename T>
+const bool operator!=(const vector2d<T>& vector, const Matrix<T>& matrix)
+{ return matrix != vector; }
+
+// Explicit instantiations
+template class Matrix<float>;
+template class Matrix<double>;
+
+template Matrix<float> operator+(const float&, const Matrix<float>&);
+template Matrix<float> operator-(const float&, const Matrix<float>&);
+template Matrix<float> operator*(const float&, const Matrix<float>&);
+template Matrix<float> operator/(const float&, const Matrix<float>&);
+template Matrix<float> operator^(const float&, const Matrix<float>&);
+template std::ostream& operator<<(std::ostream&, const Matrix<float>&);
+template void swap(Matrix<float>&, Matrix<float>&);
+template const bool operator==(const Matrix<float>&, const Matrix<float>&);
+template const bool operator!=(const Matrix<float>&, const Matrix<float>&);
+template const bool operator==(const Matrix<float>&, const vector1d<float>&);
+template const bool operator!=(const Matrix<float>&, const vector1d<float>&);
+template const bool operator==(const vector1d<float>&, const Matrix<float>&);
+template const bool operator!=(const vector1d<float>&, const Matrix<float>&);
+template const bool operator==(const Matrix<float>&, const vector2d<float>&);
+template const bool operator!=(const Matrix<float>&, const vector2d<float>&);
+template const bool operator==(const vector2d<float>&, const Matrix<float>&);
+template const bool operator!=(const vector2d<float>&, const Matrix<float>&);
+
+template Matrix<double> operator+(const double&, const Matrix<double>&);
+template Matrix<double> operator-(const double&, const Matrix<double>&);
+template Matrix<double> operator*(const double&, const Matrix<double>&);
+template Matrix<double> operator/(const double&, const Matrix<double>&);
+template Matrix<double> operator^(const double&, const Matrix<double>&);
+template std::ostream& operator<<(std::ostream&, const Matrix<double>&);
+template void swap(Matrix<double>&, Matrix<double>&);
+template const bool operator==(const Matrix<double>&, const Matrix<double>&);
+template const bool operator!=(const Matrix<double>&, const Matrix<double>&);
+template const bool operator==(const Matrix<double>&, const vector1d<double>&);
+template const bool operator!=(const Matrix<double>&, const vector1d<double>&);
+template const bool operator==(const vector1d<double>&, const Matrix<double>&);
+template const bool operator!=(const vector1d<double>&, const Matrix<double>&);
+template const bool operator==(const Matrix<double>&, const vector2d<double>&);
+template const bool operator!=(const Matrix<double>&, const vector2d<double>&);
+template const bool operator==(const vector2d<double>&, const Matrix<double>&);
+template const bool operator!=(const vector2d<double>&, const Matrix<double>&);
+
+}  // namespace laplus
@@ -0,0 +1,712 @@
+/******************************************************************************
+ *
+ * laplus/nn.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/nn.hpp"
+#include "laplus/internal/parallel.hpp"
+#include "laplus/internal/simd.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace laplus {
+
+namespace {
+
+using simd = internal::simd<float>;
+
+const std::size_t width = simd::width;
+
+// Dimensions and strides of a pooling pass.
+struct Window {
+  std::size_t n, c, h, w;
+  std::size_t kh, kw, sh, sw, ph, pw;
+  std::size_t oh, ow;
+  std::size_t groups, lanes;
+  std::size_t xc, xr, xq;
+  std::size_t yc, yr, yq;
+
+  const std::size_t image() const { return c * h * w; }
+  const std::size_t output() const { return c * oh * ow; }
+};
+
+Window geometry(const dims_t& x, const PoolParams& params)
+{
+  assert(x.size() == 4);
+  assert(params.stride_h > 0 && params.stride_w > 0);
+  assert(params.pad_h < params.kernel_h && params.pad_w < params.kernel_w);
+  const bool planar = (params.layout == NCHW);
+  Window s;
+  s.n = x[0];
+  s.c = planar ? x[1] : x[3];
+  s.h = planar ? x[2] : x[1];
+  s.w = planar ? x[3] : x[2];
+  s.kh = params.kernel_h;
+  s.kw = params.kernel_w;
+  s.sh = params.stride_h;
+  s.sw = params.stride_w;
+  s.ph = params.pad_h;
+  s.pw = params.pad_w;
+  assert(s.h + 2 * s.ph >= s.kh && s.w + 2 * s.pw >= s.kw);
+  s.oh = (s.h + 2 * s.ph - s.kh) / s.sh + 1;
+  s.ow = (s.w + 2 * s.pw - s.kw) / s.sw + 1;
+
+  // NCHW images are pooled one plane per task and NHWC images one image
+  // per task with all channels of a pixel processed as one vector.
+  s.groups = planar ? s.c : 1;
+  s.lanes = planar ? 1 : s.c;
+  s.xc = planar ? s.h * s.w : 1;
+  s.xr = planar ? s.w : s.w * s.c;
+  s.xq = planar ? 1 : s.c;
+  s.yc = planar ? s.oh * s.ow : 1;
+  s.yr = planar ? s.ow : s.ow * s.c;
+  s.yq = planar ? 1 : s.c;
+  return s;
+}
+
+dims_t output_dims(const Window& s, const ConvLayout layout)
+{
+  if(layout == NCHW) return dims_t({s.n, s.c, s.oh, s.ow});
+  return dims_t({s.n, s.oh, s.ow, s.c});
+}
+
+// Input rows or columns [first, last) covered by output coordinate o.
+void clip(const std::size_t o, const std::size_t kernel,
+          const std::size_t stride, const std::size_t pad,
+          const std::size_t size, std::size_t& first, std::size_t& last)
+{
+  const std::size_t start = o * stride;
+  first = std::max(start, pad) - pad;
+  last = std::min(start + kernel, pad + size) - pad;
+}
+
+struct MaxPool {
+  static float init() { return -std::numeric_limits<float>::infinity(); }
+  static float apply(const float a, const float b) { return std::max(a, b); }
+  static simd::type apply(const simd::type a, const simd::type b)
+  { return simd::max(a, b); }
+  static float finish(const float a, const std::size_t) { return a; }
+};
+
+struct AvgPool {
+  static float init() { return 0.0f; }
+  static float apply(const float a, const float b) { return a + b; }
+  static simd::type apply(const simd::type a, const simd::type b)
+  { return simd::add(a, b); }
+  static float finish(const float a, const std::size_t count)
+  { return a / count; }
+};
+
+template<typename Op>
+void pool(const Window& s, const float* x, float* y)
+{
+  internal::parallel_run(s.n * s.groups, [&](const std::size_t t) {
+    thread_local std::vector<float> acc;
+    const std::size_t n = t / s.groups;
+    const float* const image = x + n * s.image() + (t % s.groups) * s.xc;
+    float* const out = y + n * s.output() + (t % s.groups) * s.yc;
+    acc.resize(s.lanes);
+    for(std::size_t r = 0; r < s.oh; ++r) {
+      std::size_t h0, h1;
+      clip(r, s.kh, s.sh, s.ph, s.h, h0, h1);
+      for(std::size_t q = 0; q < s.ow; ++q) {
+        std::size_t w0, w1;
+        clip(q, s.kw, s.sw, s.pw, s.w, w0, w1);
+        std::fill(acc.begin(), acc.end(), Op::init());
+        for(std::size_t h = h0; h < h1; ++h) {
+          for(std::size_t w = w0; w < w1; ++w) {
+            const float* const src = image + h * s.xr + w * s.xq;
+            std::size_t c = 0;
+            for(; c + width <= s.lanes; c += width) {
+              simd::store(&acc[c], Op::apply(simd::load(&acc[c]),
+                                             simd::load(src + c)));
+            }
+            for(; c < s.lanes; ++c) acc[c] = Op::apply(acc[c], src[c]);
+          }
+        }
+        const std::size_t count = (h1 - h0) * (w1 - w0);
+        float* const dst = out + r * s.yr + q * s.yq;
+        for(std::size_t c = 0; c < s.lanes; ++c) {
+          dst[c] = Op::finish(acc[c], count);
+        }
+      }
+    }
+  });
+}
+
+// Row-major view of a matrix, copying it only when it is transposed.
+Matrixf rowmajor(const Matrixf& x)
+{
+  if(x.layout() == CblasRowMajor) return x;
+  Matrixf y(x.rows(), x.cols());
+  internal::parallel_for(0, x.rows(), 16, [&](const std::size_t first,
+                                              const std::size_t last) {
+    for(std::size_t i = first; i < last; ++i) {
+      for(std::size_t j = 0; j < x.cols(); ++j) y(i, j) = x(i, j);
+    }
+  });
+  return y;
+}
+
+std::vector<float> values(const Vectorf& v)
+{
+  std::vector<float> result(v.size());
+  for(std::size_t i = 0; i < v.size(); ++i) result[i] = v[i];
+  return result;
+}
+
+Vectorf as_vector(const std::vector<double>& v)
+{
+  Vectorf result(v.size());
+  for(std::size_t i = 0; i < v.size(); ++i) result[i] = v[i];
+  return result;
+}
+
+const float hsum(const simd::type v)
+{
+  float lanes[width];
+  simd::store(lanes, v);
+  float sum = 0.0f;
+  for(std::size_t i = 0; i < width; ++i) sum += lanes[i];
+  return sum;
+}
+
+// Splits rows [0, n) into one range per task, at least grain rows each,
+// and returns the number of tasks.
+const std::size_t chunks(const std::size_t n, const std::size_t grain,
+                         const std::function<void(const std::size_t,
+                                                  const std::size_t,
+                                                  const std::size_t)>& f)
+{
+  const std::size_t tasks = std::max<std::size_t>(
+      1, std::min(internal::concurrency(), n / grain));
+  internal::parallel_run(tasks, [&](const std::size_t t) {
+    f(t, n * t / tasks, n * (t + 1) / tasks);
+  });
+  return tasks;
+}
+
+// Rows per task of a normalization pass.
+const std::size_t grain = 64;
+
+// y = x * a + b along a row.
+void affine(const float* x, const float* a, const float* b, float* y,
+            const std::size_t n)
+{
+  std::size_t j = 0;
+  for(; j + width <= n; j += width) {
+    const simd::type v = simd::mul(simd::load(x + j), simd::load(a + j));
+    simd::store(y + j, simd::add(v, simd::load(b + j)));
+  }
+  for(; j < n; ++j) y[j] = x[j] * a[j] + b[j];
+}
+
+// Mean and variance of a row from sums shifted by its first element, which
+// keeps the single-pass variance accurate when the mean is large.
+void moments(const float* x, const std::size_t n, float& mean, float& var)
+{
+  const float k = x[0];
+  const simd::type shift = simd::set1(k);
+  simd::type s = simd::set1(0.0f);
+  simd::type q = simd::set1(0.0f);
+  std::size_t j = 0;
+  for(; j + width <= n; j += width) {
+    const simd::type d = simd::sub(simd::load(x + j), shift);
+    s = simd::add(s, d);
+    q = simd::add(q, simd::mul(d, d));
+  }
+  double sum = hsum(s);
+  double sqr = hsum(q);
+  for(; j < n; ++j) {
+    sum += x[j] - k;
+    sqr += (x[j] - k) * (x[j] - k);
+  }
+  mean = k + sum / n;
+  var = std::max(0.0, sqr / n - (sum / n) * (sum / n));
+}
+
+// Mixes a 32-bit word (the MurmurHash3 finalizer).
+inline std::uint32_t mix(std::uint32_t h)
+{
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+}
+
+#ifdef LAPLUS_AVX2
+__attribute__((target("avx2,fma")))
+inline __m256i mix(__m256i h)
+{
+  h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+  h = _mm256_mullo_epi32(h, _mm256_set1_epi32(0x85ebca6b));
+  h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 13));
+  h = _mm256_mullo_epi32(h, _mm256_set1_epi32(0xc2b2ae35));
+  h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+  return h;
+}
+#endif
+
+#ifdef LAPLUS_AVX2
+__attribute__((target("avx2,fma")))
+std::size_t mask_avx2(const float* x, float* y, const std::size_t first,
+                      const std::size_t n, const std::uint32_t threshold,
+                      const float scale, const std::uint32_t k0,
+                      const std::uint32_t k1)
+{
+  std::size_t j = 0;
+  const __m256i sign = _mm256_set1_epi32(0x80000000);
+  const __m256i limit = _mm256_xor_si256(_mm256_set1_epi32(threshold), sign);
+  const __m256i step = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  const simd::type factor = simd::set1(scale);
+  for(; j + width <= n; j += width) {
+    const std::uint32_t base = static_cast<std::uint32_t>(first + j) + k0;
+    __m256i h = _mm256_add_epi32(_mm256_set1_epi32(base), step);
+    h = mix(_mm256_xor_si256(mix(h), _mm256_set1_epi32(k1)));
+    const __m256 drop = _mm256_castsi256_ps(
+        _mm256_cmpgt_epi32(limit, _mm256_xor_si256(h, sign)));
+    const simd::type v = simd::mul(simd::load(x + j), factor);
+    simd::store(y + j, _mm256_andnot_ps(drop, v));
+  }
+  return j;
+}
+#endif
+
+// Applies the dropout mask of elements [first, first + n) to a row.
+void mask(const float* x, float* y, const std::size_t first,
+          const std::size_t n, const float rate, const std::uint64_t seed)
+{
+  const std::uint32_t k0 = static_cast<std::uint32_t>(seed);
+  const std::uint32_t k1 = static_cast<std::uint32_t>(seed >> 32);
+  const std::uint32_t threshold =
+      static_cast<std::uint32_t>(rate * 4294967296.0);
+  const float scale = 1.0f / (1.0f - rate);
+  std::size_t j = 0;
+#ifdef LAPLUS_AVX2
+  if(internal::has_avx2())
+    j = mask_avx2(x, y, first, n, threshold, scale, k0, k1);
+#endif
+  for(; j < n; ++j) {
+    const std::uint32_t i = static_cast<std::uint32_t>(first + j);
+    const std::uint32_t h = mix(mix(i + k0) ^ k1);
+    y[j] = (h < threshold) ? 0.0f : x[j] * scale;
+  }
+}
+
+}  // unnamed namespace
+
+// Pooling
+Tensorf max_pool2d(const Tensorf& x, const PoolParams& params)
+{
+  const Window s = geometry(x.dims(), params);
+  const Tensorf a = x.materialize();
+  Tensorf y(output_dims(s, params.layout));
+  pool<MaxPool>(s, a.data(), y.data());
+  return y;
+}
+
+Tensorf max_pool2d_backward(const Tensorf& x, const Tensorf& dy,
+                            const PoolParams& params)
+{
+  const Window s = geometry(x.dims(), params);
+  assert(dy.dims() == output_dims(s, params.layout));
+  const Tensorf a = x.materialize();
+  const Tensorf b = dy.materialize();
+  Tensorf dx(x.dims());
+  internal::parallel_run(s.n * s.groups, [&](const std::size_t t) {
+    const std::size_t n = t / s.groups;
+    const std::size_t g = t % s.groups;
+    const float* const image = a.data() + n * s.image() + g * s.xc;
+    const float* const grad = b.data() + n * s.output() + g * s.yc;
+    float* const out = dx.data() + n * s.image() + g * s.xc;
+    for(std::size_t r = 0; r < s.oh; ++r) {
+      std::size_t h0, h1;
+      clip(r, s.kh, s.sh, s.ph, s.h, h0, h1);
+      for(std::size_t q = 0; q < s.ow; ++q) {
+        std::size_t w0, w1;
+        clip(q, s.kw, s.sw, s.pw, s.w, w0, w1);
+        for(std::size_t c = 0; c < s.lanes; ++c) {
+          std::size_t at = h0 * s.xr + w0 * s.xq + c;
+          for(std::size_t h = h0; h < h1; ++h) {
+            for(std::size_t w = w0; w < w1; ++w) {
+              const std::size_t i = h * s.xr + w * s.xq + c;
+              if(image[i] > image[at]) at = i;
+            }
+          }
+          out[at] += grad[r * s.yr + q * s.yq + c];
+        }
+      }
+    }
+  });
+  return dx;
+}
+
+Tensorf avg_pool2d(const Tensorf& x, const PoolParams& params)
+{
+  const Window s = geometry(x.dims(), params);
+  const Tensorf a = x.materialize();
+  Tensorf y(output_dims(s, params.layout));
+  pool<AvgPool>(s, a.data(), y.data());
+  return y;
+}
+
+Tensorf avg_pool2d_backward(const Tensorf& dy, const dims_t& dims,
+                            const PoolParams& params)
+{
+  const Window s = geometry(dims, params);
+  assert(dy.dims() == output_dims(s, params.layout));
+  const Tensorf b = dy.materialize();
+  Tensorf dx(dims);
+  internal::parallel_run(s.n * s.groups, [&](const std::size_t t) {
+    const std::size_t n = t / s.groups;
+    const std::size_t g = t % s.groups;
+    const float* const grad = b.data() + n * s.output() + g * s.yc;
+    float* const out = dx.data() + n * s.image() + g * s.xc;
+    for(std::size_t r = 0; r < s.oh; ++r) {
+      std::size_t h0, h1;
+      clip(r, s.kh, s.sh, s.ph, s.h, h0, h1);
+      for(std::size_t q = 0; q < s.ow; ++q) {
+        std::size_t w0, w1;
+        clip(q, s.kw, s.sw, s.pw, s.w, w0, w1);
+        const float* const src = grad + r * s.yr + q * s.yq;
+        const simd::type scale = simd::set1(1.0f / ((h1 - h0) * (w1 - w0)));
+        for(std::size_t h = h0; h < h1; ++h) {
+          for(std::size_t w = w0; w < w1; ++w) {
+            float* const dst = out + h * s.xr + w * s.xq;
+            std::size_t c = 0;
+            for(; c + width <= s.lanes; c += width) {
+              const simd::type v = simd::mul(simd::load(src + c), scale);
+              simd::store(dst + c, simd::add(simd::load(dst + c), v));
+            }
+            for(; c < s.lanes; ++c) {
+              dst[c] += src[c] / ((h1 - h0) * (w1 - w0));
+            }
+          }
+        }
+      }
+    }
+  });
+  return dx;
+}
+
+// Normalization
+Matrixf batch_norm(const Matrixf& x, const Vectorf& gamma,
+                   const Vectorf& beta, const float eps, NormStats& stats)
+{
+  const Matrixf a = rowmajor(x);
+  const std::size_t n = a.rows();
+  const std::size_t d = a.cols();
+  assert(n > 0);
+  const float* const shift = a.data();
+  std::vector<float> partial(2 * internal::concurrency() * d, 0.0f);
+  const std::size_t tasks = chunks(n, grain, [&](const std::size_t t,
+                                                 const std::size_t first,
+                                                 const std::size_t last) {
+    float* const s = partial.data() + 2 * t * d;
+    float* const q = s + d;
+    for(std::size_t i = first; i < last; ++i) {
+      const float* const row = a.data() + i * d;
+      std::size_t j = 0;
+      for(; j + width <= d; j += width) {
+        const simd::type v = simd::sub(simd::load(row + j),
+                                       simd::load(shift + j));
+        simd::store(s + j, simd::add(simd::load(s + j), v));
+        simd::store(q + j, simd::add(simd::load(q + j), simd::mul(v, v)));
+      }
+      for(; j < d; ++j) {
+        s[j] += row[j] - shift[j];
+        q[j] += (row[j] - shift[j]) * (row[j] - shift[j]);
+      }
+    }
+  });
+
+  stats.mean.assign(d, 0.0f);
+  stats.rstd.assign(d, 0.0f);
+  for(std::size_t j = 0; j < d; ++j) {
+    double sum = 0.0, sqr = 0.0;
+    for(std::size_t t = 0; t < tasks; ++t) {
+      sum += partial[2 * t * d + j];
+      sqr += partial[(2 * t + 1) * d + j];
+    }
+    const double var = std::max(0.0, sqr / n - (sum / n) * (sum / n));
+    stats.mean[j] = shift[j] + sum / n;
+    stats.rstd[j] = 1.0 / std::sqrt(var + eps);
+  }
+  return batch_norm(a, gamma, beta, stats);
+}
+
+Matrixf batch_norm(const Matrixf& x, const Vectorf& gamma,
+                   const Vectorf& beta, const NormStats& stats)
+{
+  const Matrixf a = rowmajor(x);
+  const std::size_t n = a.rows();
+  const std::size_t d = a.cols();
+  assert(gamma.size() == d && beta.size() == d);
+  assert(stats.mean.size() == d && stats.rstd.size() == d);
+
+  // Folds the statistics into one multiply-add per element.
+  std::vector<float> scale = values(gamma);
+  std::vector<float> bias = values(beta);
+  for(std::size_t j = 0; j < d; ++j) {
+    scale[j] *= stats.rstd[j];
+    bias[j] -= stats.mean[j] * scale[j];
+  }
+  Matrixf y(n, d);
+  internal::parallel_for(0, n, grain, [&](const std::size_t first,
+                                          const std::size_t last) {
+    for(std::size_t i = first; i < last; ++i) {
+      affine(a.data() + i * d, scale.data(), bias.data(), y.data() + i * d,
+             d);
+    }
+  });
+  return y;
+}
+
+NormGrads batch_norm_backward(const Matrixf& dy, const Matrixf& x,
+                              const Vectorf& gamma, const NormStats& stats)
+{
+  const Matrixf a = rowmajor(x);
+  const Matrixf b = rowmajor(dy);
+  const std::size_t n = a.rows();
+  const std::size_t d = a.cols();
+  assert(b.rows() == n && b.cols() == d);
+  assert(gamma.size() == d);
+  const float* const mean = stats.mean.data();
+  const float* const rstd = stats.rstd.data();
+
+  std::vector<float> partial(2 * internal::concurrency() * d, 0.0f);
+  const std::size_t tasks = chunks(n, grain, [&](const std::size_t t,
+                                                 const std::size_t first,
+                                                 const std::size_t last) {
+    float* const sg = partial.data() + 2 * t * d;
+    float* const sb = sg + d;
+    for(std::size_t i = first; i < last; ++i) {
+      const float* const xi = a.data() + i * d;
+      const float* const gi = b.data() + i * d;
+      std::size_t j = 0;
+      for(; j + width <= d; j += width) {
+        const simd::type h = simd::mul(simd::sub(simd::load(xi + j),
+                                                 simd::load(mean + j)),
+                                       simd::load(rstd + j));
+        const simd::type g = simd::load(gi + j);
+        simd::store(sg + j, simd::add(simd::load(sg + j), simd::mul(g, h)));
+        simd::store(sb + j, simd::add(simd::load(sb + j), g));
+      }
+      for(; j < d; ++j) {
+        sg[j] += gi[j] * (xi[j] - mean[j]) * rstd[j];
+        sb[j] += gi[j];
+      }
+    }
+  });
+
+  std::vector<double> dgamma(d, 0.0);
+  std::vector<double> dbeta(d, 0.0);
+  for(std::size_t t = 0; t < tasks; ++t) {
+    for(std::size_t j = 0; j < d; ++j) {
+      dgamma[j] += partial[2 * t * d + j];
+      dbeta[j] += partial[(2 * t + 1) * d + j];
+    }
+  }
+
+  // dx = rstd * gamma * (dy - mean(dy) - xhat * mean(dy * xhat))
+  std::vector<float> scale = values(gamma);
+  std::vector<float> u(d);
+  std::vector<float> v(d);
+  for(std::size_t j = 0; j < d; ++j) {
+    scale[j] *= rstd[j];
+    u[j] = dbeta[j] / n;
+    v[j] = dgamma[j] / n;
+  }
+  Matrixf dx(n, d);
+  internal::parallel_for(0, n, grain, [&](const std::size_t first,
+                                          const std::size_t last) {
+    for(std::size_t i = first; i < last; ++i) {
+      const float* const xi = a.data() + i * d;
+      const float* const gi = b.data() + i * d;
+      float* const di = dx.data() + i * d;
+      std::size_t j = 0;
+      for(; j + width <= d; j += width) {
+        const simd::type h = simd::mul(simd::sub(simd::load(xi + j),
+                                                 simd::load(mean + j)),
+                                       simd::load(rstd + j));
+        const simd::type e = simd::sub(simd::sub(simd::load(gi + j),
+                                                 simd::load(&u[j])),
+                                       simd::mul(h, simd::load(&v[j])));
+        simd::store(di + j, simd::mul(simd::load(&scale[j]), e));
+      }
+      for(; j < d; ++j) {
+        const float h = (xi[j] - mean[j]) * rstd[j];
+        di[j] = scale[j] * (gi[j] - u[j] - h * v[j]);
+      }
+    }
+  });
+  return NormGrads{dx, as_vector(dgamma), as_vector(dbeta)};
+}
+
+Matrixf layer_norm(const Matrixf& x, const Vectorf& gamma,
+                   const Vectorf& beta, const float eps, NormStats& stats)
+{
+  const Matrixf a = rowmajor(x);
+  const std::size_t n = a.rows();
+  const std::size_t d = a.cols();
+  assert(d > 0);
+  assert(gamma.size() == d && beta.size() == d);
+  const std::vector<float> g = values(gamma);
+  const std::vector<float> b = values(beta);
+  stats.mean.assign(n, 0.0f);
+  stats.rstd.assign(n, 0.0f);
+
+  Matrixf y(n, d);
+  internal::parallel_for(0, n, grain, [&](const std::size_t first,
+                                          const std::size_t last) {
+    for(std::size_t i = first; i < last; ++i) {
+      const float* const xi = a.data() + i * d;
+      float* const yi = y.data() + i * d;
+      float mean, var;
+      moments(xi, d, mean, var);
+      const float rstd = 1.0f / std::sqrt(var + eps);
+      stats.mean[i] = mean;
+      stats.rstd[i] = rstd;
+      const simd::type m = simd::set1(mean);
+      const simd::type r = simd::set1(rstd);
+      std::size_t j = 0;
+      for(; j + width <= d; j += width) {
+        const simd::type h = simd::mul(simd::sub(simd::load(xi + j), m), r);
+        simd::store(yi + j, simd::add(simd::mul(h, simd::load(&g[j])),
+                                      simd::load(&b[j])));
+      }
+      for(; j < d; ++j) yi[j] = (xi[j] - mean) * rstd * g[j] + b[j];
+    }
+  });
+  return y;
+}
+
+NormGrads layer_norm_backward(const Matrixf& dy, const Matrixf& x,
+                              const Vectorf& gamma, const NormStats& stats)
+{
+  const Matrixf a = rowmajor(x);
+  const Matrixf b = rowmajor(dy);
+  const std::size_t n = a.rows();
+  const std::size_t d = a.cols();
+  assert(b.rows() == n && b.cols() == d);
+  assert(gamma.size() == d);
+  assert(stats.mean.size() == n && stats.rstd.size() == n);
+  const std::vector<float> g = values(gamma);
+
+  Matrixf dx(n, d);
+  std::vector<float> partial(2 * internal::concurrency() * d, 0.0f);
+  const std::size_t tasks = chunks(n, grain, [&](const std::size_t t,
+                                                 const std::size_t first,
+                                                 const std::size_t last) {
+    float* const sg = partial.data() + 2 * t * d;
+    float* const sb = sg + d;
+    for(std::size_t i = first; i < last; ++i) {
+      const float* const xi = a.data() + i * d;
+      const float* const gi = b.data() + i * d;
+      float* const di = dx.data() + i * d;
+      const simd::type m = simd::set1(stats.mean[i]);
+      const simd::type r = simd::set1(stats.rstd[i]);
+
+      // Row sums of dxhat and dxhat * xhat, plus the column sums of the
+      // parameter gradients.
+      simd::type s0 = simd::set1(0.0f);
+      simd::type s1 = simd::set1(0.0f);
+      std::size_t j = 0;
+      for(; j + width <= d; j += width) {
+        const simd::type h = simd::mul(simd::sub(simd::load(xi + j), m), r);
+        const simd::type e = simd::load(gi + j);
+        const simd::type f = simd::mul(e, simd::load(&g[j]));
+        s0 = simd::add(s0, f);
+        s1 = simd::add(s1, simd::mul(f, h));
+        simd::store(sg + j, simd::add(simd::load(sg + j), simd::mul(e, h)));
+        simd::store(sb + j, simd::add(simd::load(sb + j), e));
+      }
+      float sum0 = hsum(s0);
+      float sum1 = hsum(s1);
+      for(; j < d; ++j) {
+        const float h = (xi[j] - stats.mean[i]) * stats.rstd[i];
+        sum0 += gi[j] * g[j];
+        sum1 += gi[j] * g[j] * h;
+        sg[j] += gi[j] * h;
+        sb[j] += gi[j];
+      }
+
+      // dx = rstd * (dxhat - mean(dxhat) - xhat * mean(dxhat * xhat))
+      const simd::type u = simd::set1(sum0 / d);
+      const simd::type v = simd::set1(sum1 / d);
+      for(j = 0; j + width <= d; j += width) {
+        const simd::type h = simd::mul(simd::sub(simd::load(xi + j), m), r);
+        const simd::type f = simd::mul(simd::load(gi + j),
+                                       simd::load(&g[j]));
+        const simd::type e = simd::sub(simd::sub(f, u), simd::mul(h, v));
+        simd::store(di + j, simd::mul(r, e));
+      }
+      for(; j < d; ++j) {
+        const float h = (xi[j] - stats.mean[i]) * stats.rstd[i];
+        di[j] = stats.rstd[i] * (gi[j] * g[j] - sum0 / d - h * sum1 / d);
+      }
+    }
+  });
+
+  std::vector<double> dgamma(d, 0.0);
+  std::vector<double> dbeta(d, 0.0);
+  for(std::size_t t = 0; t < tasks; ++t) {
+    for(std::size_t j = 0; j < d; ++j) {
+      dgamma[j] += partial[2 * t * d + j];
+      dbeta[j] += partial[(2 * t + 1) * d + j];
+    }
+  }
+  return NormGrads{dx, as_vector(dgamma), as_vector(dbeta)};
+}
+
+// Dropout
+Matrixf dropout(const Matrixf& x, const float rate, const std::uint64_t seed)
+{
+  assert(0.0f <= rate && rate < 1.0f);
+  const Matrixf a = rowmajor(x);
+  const std::size_t d = a.cols();
+  Matrixf y(a.rows(), d);
+  internal::parallel_for(0, a.rows(), grain, [&](const std::size_t first,
+                                                 const std::size_t last) {
+    for(std::size_t i = first; i < last; ++i) {
+      mask(a.data() + i * d, y.data() + i * d, i * d, d, rate, seed);
+    }
+  });
+  return y;
+}
+
+Matrixf dropout_backward(const Matrixf& dy, const float rate,
+                         const std::uint64_t seed)
+{ return dropout(dy, rate, seed); }
+
+}  // namespace laplus
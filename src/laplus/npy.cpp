@@ -0,0 +1,568 @@
+/******************************************************************************
+ *
+ * laplus/npy.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/npy.hpp"
+#include "laplus/half.hpp"
+#include "laplus/typedef.hpp"
+#include "laplus/internal/mapping.hpp"
+#include "laplus/internal/parallel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace laplus {
+
+namespace {
+
+const char magic[6] = {'\x93', 'N', 'U', 'M', 'P', 'Y'};
+
+// Zip record signatures and the 32 bit field overflow marker.
+const std::uint32_t local_signature = 0x04034b50;
+const std::uint32_t central_signature = 0x02014b50;
+const std::uint32_t end_signature = 0x06054b50;
+const std::uint32_t end64_signature = 0x06064b50;
+const std::uint32_t locator_signature = 0x07064b50;
+const std::uint32_t overflow = 0xFFFFFFFF;
+
+struct Header {
+  char kind;
+  std::size_t itemsize;
+  bool swap;
+  bool fortran;
+  dims_t dims;
+  std::size_t offset;
+};
+
+struct Payload {
+  std::string header;
+  const char* data;
+  std::size_t bytes;
+};
+
+template<typename U>
+U read(const char* const p)
+{
+  U value;
+  std::memcpy(&value, p, sizeof(U));
+  return value;
+}
+
+void put(std::string& out, const std::uint64_t value, const std::size_t bytes)
+{ for(std::size_t i = 0; i < bytes; ++i) out += char(value >> (8 * i)); }
+
+// Position of the value of key in a Python dict literal.
+bool find(const std::string& dict, const std::string& key, std::size_t& pos)
+{
+  pos = dict.find("'" + key + "'");
+  if(pos == std::string::npos) return false;
+  pos = dict.find(':', pos);
+  if(pos == std::string::npos) return false;
+  pos = dict.find_first_not_of(' ', pos + 1);
+  return pos != std::string::npos;
+}
+
+bool valid(const char kind, const std::size_t itemsize)
+{
+  switch(kind) {
+  case 'f': return itemsize == 2 || itemsize == 4 || itemsize == 8;
+  case 'i':
+  case 'u': return itemsize == 1 || itemsize == 2
+                || itemsize == 4 || itemsize == 8;
+  case 'b': return itemsize == 1;
+  default: return false;
+  }
+}
+
+bool parse(const char* const p, const std::size_t size, Header& header)
+{
+  if(size < 10 || std::memcmp(p, magic, sizeof(magic)) != 0) return false;
+
+  std::size_t length = 0;
+  std::size_t start = 0;
+  if(p[6] == 1) {
+    length = read<std::uint16_t>(p + 8);
+    start = 10;
+  } else if((p[6] == 2 || p[6] == 3) && size >= 12) {
+    length = read<std::uint32_t>(p + 8);
+    start = 12;
+  } else {
+    return false;
+  }
+  if(length > size - start) return false;
+  const std::string dict(p + start, length);
+  header.offset = start + length;
+
+  std::size_t pos = 0;
+  if(!find(dict, "descr", pos) || dict[pos] != '\'') return false;
+  const std::size_t end = dict.find('\'', pos + 1);
+  if(end == std::string::npos || end - pos < 4) return false;
+  const std::string descr = dict.substr(pos + 1, end - pos - 1);
+  const char order = descr[0];
+  if(order != '<' && order != '>' && order != '|' && order != '=') {
+    return false;
+  }
+  char* tail = nullptr;
+  header.kind = descr[1];
+  header.itemsize = std::strtoul(descr.c_str() + 2, &tail, 10);
+  header.swap = (order == '>') && (header.itemsize > 1);
+  if(*tail != '\0' || !valid(header.kind, header.itemsize)) return false;
+
+  if(!find(dict, "fortran_order", pos)) return false;
+  header.fortran = (dict.compare(pos, 4, "True") == 0);
+
+  if(!find(dict, "shape", pos) || dict[pos] != '(') return false;
+  const std::size_t close = dict.find(')', pos);
+  if(close == std::string::npos) return false;
+  header.dims.clear();
+  const char* q = dict.c_str() + pos + 1;
+  const char* const last = dict.c_str() + close;
+  while(q < last) {
+    if(*q == ' ' || *q == ',' || *q == 'L') {
+      ++q;
+      continue;
+    }
+    char* next = nullptr;
+    header.dims.push_back(std::strtoull(q, &next, 10));
+    if(next == q) return false;
+    q = next;
+  }
+  if(header.dims.size() > 2) return false;
+
+  const std::size_t max = std::numeric_limits<std::size_t>::max();
+  std::size_t count = 1;
+  for(std::size_t d: header.dims) {
+    if(d != 0 && count > max / d) return false;
+    count *= d;
+  }
+  return count <= (size - header.offset) / header.itemsize;
+}
+
+template<typename S>
+S load(const char* const p, const bool swap)
+{
+  char bytes[sizeof(S)];
+  std::memcpy(bytes, p, sizeof(S));
+  if(swap) std::reverse(bytes, bytes + sizeof(S));
+  return read<S>(bytes);
+}
+
+template<typename S, typename T>
+void cast(const char* const src, const bool swap,
+          T* const dst, const std::size_t n)
+{
+  internal::parallel_for(0, n, internal::grain, [&](
+      const std::size_t first, const std::size_t last) {
+    for(std::size_t i = first; i < last; ++i) {
+      dst[i] = static_cast<T>(load<S>(src + i * sizeof(S), swap));
+    }
+  });
+}
+
+template<typename T>
+void cast_half(const char* const src, const bool swap,
+               T* const dst, const std::size_t n)
+{
+  internal::parallel_for(0, n, internal::grain, [&](
+      const std::size_t first, const std::size_t last) {
+    for(std::size_t i = first; i < last; ++i) {
+      half value;
+      value.bits = load<std::uint16_t>(src + 2 * i, swap);
+      dst[i] = static_cast<float>(value);
+    }
+  });
+}
+
+template<typename T>
+void convert(const char* const src, const Header& header,
+             T* const dst, const std::size_t n)
+{
+  const bool swap = header.swap;
+  switch(header.kind * 16 + header.itemsize) {
+  case 'f' * 16 + 2: cast_half(src, swap, dst, n); break;
+  case 'f' * 16 + 4: cast<float>(src, swap, dst, n); break;
+  case 'f' * 16 + 8: cast<double>(src, swap, dst, n); break;
+  case 'i' * 16 + 1: cast<std::int8_t>(src, swap, dst, n); break;
+  case 'i' * 16 + 2: cast<std::int16_t>(src, swap, dst, n); break;
+  case 'i' * 16 + 4: cast<std::int32_t>(src, swap, dst, n); break;
+  case 'i' * 16 + 8: cast<std::int64_t>(src, swap, dst, n); break;
+  case 'u' * 16 + 1: cast<std::uint8_t>(src, swap, dst, n); break;
+  case 'u' * 16 + 2: cast<std::uint16_t>(src, swap, dst, n); break;
+  case 'u' * 16 + 4: cast<std::uint32_t>(src, swap, dst, n); break;
+  case 'u' * 16 + 8: cast<std::uint64_t>(src, swap, dst, n); break;
+  case 'b' * 16 + 1: cast<std::uint8_t>(src, swap, dst, n); break;
+  }
+}
+
+// Reads the array stored in [begin, begin + size) of the mapping.
+template<typename T>
+bool load(const std::shared_ptr<char>& mapping, const std::size_t begin,
+          const std::size_t size, Matrix<T>& matrix)
+{
+  Header header;
+  if(!parse(mapping.get() + begin, size, header)) return false;
+
+  const std::size_t rank = header.dims.size();
+  const std::size_t rows = (rank == 2) ? header.dims[0] : 1;
+  const std::size_t cols = (rank == 0) ? 1 : header.dims.back();
+  const std::size_t count = rows * cols;
+  char* const src = mapping.get() + begin + header.offset;
+
+  const bool direct = (header.kind == 'f') && (header.itemsize == sizeof(T))
+                   && !header.swap
+                   && (reinterpret_cast<std::uintptr_t>(src) % alignof(T) == 0);
+  const internal::SharedArray<T> storage = direct
+      ? internal::SharedArray<T>(
+            std::shared_ptr<T>(mapping, reinterpret_cast<T*>(src)), count)
+      : internal::SharedArray<T>(count);
+  if(!direct) convert(src, header, storage.get(), count);
+
+  const Matrix<T> flat(Vector<T>(storage, 0, 1, count));
+  if(header.fortran && rank == 2) {
+    matrix = flat.reshape(cols, rows).transpose();
+  } else {
+    matrix = flat.reshape(rows, cols);
+  }
+  return true;
+}
+
+template<typename T>
+const char* const descr();
+
+template<>
+const char* const descr<float>()
+{ return "<f4"; }
+
+template<>
+const char* const descr<double>()
+{ return "<f8"; }
+
+// Version 1.0 header, padded so that the data starts 64 byte aligned.
+std::string header(const char* const descr, const bool fortran,
+                   const dims_t& dims)
+{
+  std::string dict = std::string("{'descr': '") + descr
+                   + "', 'fortran_order': " + (fortran ? "True" : "False")
+                   + ", 'shape': (";
+  for(std::size_t i = 0; i < dims.size(); ++i) {
+    if(i > 0) dict += ", ";
+    dict += std::to_string(dims[i]);
+  }
+  dict += (dims.size() == 1) ? ",), }" : "), }";
+
+  const std::size_t length = (10 + dict.size() + 1 + 63) / 64 * 64 - 10;
+  dict.resize(length - 1, ' ');
+  dict += '\n';
+
+  std::string result(magic, sizeof(magic));
+  result += '\x01';
+  result += '\x00';
+  put(result, length, 2);
+  return result + dict;
+}
+
+template<typename T>
+Payload payload(const Matrix<T>& matrix)
+{
+  return {header(descr<T>(), matrix.layout() == CblasColMajor,
+                 {matrix.rows(), matrix.cols()}),
+          reinterpret_cast<const char*>(matrix.data()),
+          matrix.rows() * matrix.cols() * sizeof(T)};
+}
+
+bool write(const std::string& path, const Payload& payload)
+{
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  stream.write(payload.header.data(), payload.header.size());
+  stream.write(payload.data, payload.bytes);
+  return stream.good();
+}
+
+std::uint32_t crc32(std::uint32_t crc, const char* const p,
+                    const std::size_t n)
+{
+  static const std::vector<std::uint32_t> table = [] {
+    std::vector<std::uint32_t> t(256);
+    for(std::uint32_t i = 0; i < 256; ++i) {
+      std::uint32_t c = i;
+      for(std::size_t k = 0; k < 8; ++k) {
+        c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+      }
+      t[i] = c;
+    }
+    return t;
+  }();
+
+  crc = ~crc;
+  for(std::size_t i = 0; i < n; ++i) {
+    crc = table[(crc ^ static_cast<std::uint8_t>(p[i])) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+// Replaces 32 bit sizes and offsets of a central directory entry that
+// overflowed with the values of its Zip64 extended information field.
+bool extend(const char* p, const char* const last, std::uint64_t& usize,
+            std::uint64_t& csize, std::uint64_t& offset)
+{
+  while(p + 4 <= last) {
+    const std::uint16_t id = read<std::uint16_t>(p);
+    const std::uint16_t size = read<std::uint16_t>(p + 2);
+    p += 4;
+    if(p + size > last) return false;
+    if(id == 0x0001) {
+      const char* q = p;
+      for(std::uint64_t* field: {&usize, &csize, &offset}) {
+        if(*field != overflow) continue;
+        if(q + 8 > p + size) return false;
+        *field = read<std::uint64_t>(q);
+        q += 8;
+      }
+      return true;
+    }
+    p += size;
+  }
+  return usize != overflow && csize != overflow && offset != overflow;
+}
+
+}  // unnamed namespace
+
+template<typename T>
+const bool load_npy(const std::string& path, Matrix<T>& matrix)
+{
+  std::size_t size = 0;
+  const std::shared_ptr<char> mapping = internal::map_file(path, size);
+  return mapping && load(mapping, 0, size, matrix);
+}
+
+template<typename T>
+const bool load_npz(const std::string& path,
+                    std::map<std::string, Matrix<T>>& arrays)
+{
+  std::size_t size = 0;
+  const std::shared_ptr<char> mapping = internal::map_file(path, size);
+  if(!mapping || size < 22) return false;
+  const char* const base = mapping.get();
+
+  // The end of central directory record is followed by a comment of at
+  // most 65535 bytes.
+  std::size_t end = size - 22;
+  const std::size_t stop = (end > 0xFFFF) ? end - 0xFFFF : 0;
+  while(read<std::uint32_t>(base + end) != end_signature) {
+    if(end == stop) return false;
+    --end;
+  }
+  std::uint64_t count = read<std::uint16_t>(base + end + 10);
+  std::uint64_t position = read<std::uint32_t>(base + end + 16);
+  if(end >= 20 && read<std::uint32_t>(base + end - 20) == locator_signature) {
+    const std::uint64_t record = read<std::uint64_t>(base + end - 12);
+    if(size < 56 || record > size - 56
+       || read<std::uint32_t>(base + record) != end64_signature) {
+      return false;
+    }
+    count = read<std::uint64_t>(base + record + 32);
+    position = read<std::uint64_t>(base + record + 48);
+  }
+
+  std::map<std::string, Matrix<T>> result;
+  for(std::uint64_t i = 0; i < count; ++i) {
+    if(size < 46 || position > size - 46) return false;
+    const char* const entry = base + position;
+    if(read<std::uint32_t>(entry) != central_signature) return false;
+    const std::uint16_t method = read<std::uint16_t>(entry + 10);
+    std::uint64_t csize = read<std::uint32_t>(entry + 20);
+    std::uint64_t usize = read<std::uint32_t>(entry + 24);
+    const std::size_t name_size = read<std::uint16_t>(entry + 28);
+    const std::size_t extra_size = read<std::uint16_t>(entry + 30);
+    const std::size_t comment_size = read<std::uint16_t>(entry + 32);
+    std::uint64_t offset = read<std::uint32_t>(entry + 42);
+    if(name_size + extra_size > size - position - 46) return false;
+    const char* const extra = entry + 46 + name_size;
+    if(!extend(extra, extra + extra_size, usize, csize, offset)) return false;
+
+    // Only stored members can be used in place.
+    if(method != 0 || csize != usize) return false;
+    if(size < 30 || offset > size - 30
+       || read<std::uint32_t>(base + offset) != local_signature) {
+      return false;
+    }
+    const std::uint64_t begin = offset + 30
+                              + read<std::uint16_t>(base + offset + 26)
+                              + read<std::uint16_t>(base + offset + 28);
+    if(begin > size || usize > size - begin) return false;
+
+    std::string name(entry + 46, name_size);
+    if(name.size() > 4 && name.compare(name.size() - 4, 4, ".npy") == 0) {
+      name.resize(name.size() - 4);
+    }
+    Matrix<T> matrix(0, 0);
+    if(!load(mapping, begin, usize, matrix)) return false;
+    result.insert(std::make_pair(name, matrix));
+    position += 46 + name_size + extra_size + comment_size;
+  }
+
+  arrays.swap(result);
+  return true;
+}
+
+template<typename T>
+const bool save_npy(const std::string& path, const Vector<T>& vector)
+{
+  const Vector<T> values = (vector.inc() == 1) ? vector : vector.clone();
+  return write(path, {header(descr<T>(), false, {values.size()}),
+                      reinterpret_cast<const char*>(values.data()),
+                      values.size() * sizeof(T)});
+}
+
+template<typename T>
+const bool save_npy(const std::string& path, const Matrix<T>& matrix)
+{ return write(path, payload(matrix)); }
+
+template<typename T>
+const bool save_npz(const std::string& path,
+                    const std::map<std::string, Matrix<T>>& arrays)
+{
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  std::string directory;
+  std::uint64_t position = 0;
+
+  for(const auto& item: arrays) {
+    const Payload array = payload(item.second);
+    const std::string name = item.first + ".npy";
+    const std::uint64_t size = array.header.size() + array.bytes;
+    const std::uint32_t crc = crc32(crc32(0, array.header.data(),
+                                          array.header.size()),
+                                    array.data, array.bytes);
+    const bool zip64 = (size >= overflow) || (position >= overflow);
+
+    std::string local;
+    put(local, local_signature, 4);
+    put(local, zip64 ? 45 : 20, 2);
+    put(local, 0, 2);                     // flags
+    put(local, 0, 2);                     // stored
+    put(local, 0, 2);                     // time
+    put(local, 0x21, 2);                  // date, 1980-01-01
+    put(local, crc, 4);
+    put(local, zip64 ? overflow : size, 4);
+    put(local, zip64 ? overflow : size, 4);
+    put(local, name.size(), 2);
+    put(local, zip64 ? 20 : 0, 2);
+    local += name;
+    if(zip64) {
+      put(local, 0x0001, 2);
+      put(local, 16, 2);
+      put(local, size, 8);
+      put(local, size, 8);
+    }
+
+    put(directory, central_signature, 4);
+    put(directory, 45, 2);
+    put(directory, zip64 ? 45 : 20, 2);
+    put(directory, 0, 2);
+    put(directory, 0, 2);
+    put(directory, 0, 2);
+    put(directory, 0x21, 2);
+    put(directory, crc, 4);
+    put(directory, zip64 ? overflow : size, 4);
+    put(directory, zip64 ? overflow : size, 4);
+    put(directory, name.size(), 2);
+    put(directory, zip64 ? 28 : 0, 2);
+    put(directory, 0, 2);                 // comment
+    put(directory, 0, 2);                 // disk
+    put(directory, 0, 2);                 // internal attributes
+    put(directory, 0, 4);                 // external attributes
+    put(directory, zip64 ? overflow : position, 4);
+    directory += name;
+    if(zip64) {
+      put(directory, 0x0001, 2);
+      put(directory, 24, 2);
+      put(directory, size, 8);
+      put(directory, size, 8);
+      put(directory, position, 8);
+    }
+
+    stream.write(local.data(), local.size());
+    stream.write(array.header.data(), array.header.size());
+    stream.write(array.data, array.bytes);
+    position += local.size() + size;
+  }
+
+  const std::uint64_t count = arrays.size();
+  const std::uint64_t bytes = directory.size();
+  std::string end;
+  if(count >= 0xFFFF || bytes >= overflow || position >= overflow) {
+    put(end, end64_signature, 4);
+    put(end, 44, 8);
+    put(end, 45, 2);
+    put(end, 45, 2);
+    put(end, 0, 4);
+    put(end, 0, 4);
+    put(end, count, 8);
+    put(end, count, 8);
+    put(end, bytes, 8);
+    put(end, position, 8);
+    put(end, locator_signature, 4);
+    put(end, 0, 4);
+    put(end, position + bytes, 8);
+    put(end, 1, 4);
+  }
+  put(end, end_signature, 4);
+  put(end, 0, 2);
+  put(end, 0, 2);
+  put(end, std::min<std::uint64_t>(count, 0xFFFF), 2);
+  put(end, std::min<std::uint64_t>(count, 0xFFFF), 2);
+  put(end, std::min<std::uint64_t>(bytes, overflow), 4);
+  put(end, std::min<std::uint64_t>(position, overflow), 4);
+  put(end, 0, 2);
+
+  stream.write(directory.data(), directory.size());
+  stream.write(end.data(), end.size());
+  return stream.good();
+}
+
+template const bool load_npy(const std::string&, Matrix<float>&);
+template const bool load_npy(const std::string&, Matrix<double>&);
+template const bool load_npz(const std::string&,
+                             std::map<std::string, Matrix<float>>&);
+template const bool load_npz(const std::string&,
+                             std::map<std::string, Matrix<double>>&);
+
+template const bool save_npy(const std::string&, const Vector<float>&);
+template const bool save_npy(const std::string&, const Vector<double>&);
+template const bool save_npy(const std::string&, const Matrix<float>&);
+template const bool save_npy(const std::string&, const Matrix<double>&);
+template const bool save_npz(const std::string&,
+                             const std::map<std::string, Matrix<float>>&);
+template const bool save_npz(const std::string&,
+                             const std::map<std::string, Matrix<double>>&);
+
+}  // namespace laplus
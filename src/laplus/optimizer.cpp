@@ -0,0 +1,281 @@
+/******************************************************************************
+ *
+ * laplus/optimizer.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/optimizer.hpp"
+#include "laplus/internal/parallel.hpp"
+#include "laplus/internal/simd.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+namespace laplus {
+
+namespace {
+
+using simd = internal::simd<float>;
+
+const std::size_t width = simd::width;
+
+// w -= lr * d, where d is the decayed gradient or its (Nesterov) velocity.
+void sgd(float* const w, const float* const g, float* const v,
+         const std::size_t first, const std::size_t last,
+         const float lr, const float mu, const float wd, const bool nesterov)
+{
+  const simd::type vlr = simd::set1(lr);
+  const simd::type vmu = simd::set1(mu);
+  const simd::type vwd = simd::set1(wd);
+  std::size_t i = first;
+  for(; i + width <= last; i += width) {
+    const simd::type x = simd::load(w + i);
+    simd::type d = simd::add(simd::load(g + i), simd::mul(vwd, x));
+    if(v) {
+      const simd::type u = simd::add(simd::mul(vmu, simd::load(v + i)), d);
+      simd::store(v + i, u);
+      d = nesterov ? simd::add(d, simd::mul(vmu, u)) : u;
+    }
+    simd::store(w + i, simd::sub(x, simd::mul(vlr, d)));
+  }
+  for(; i < last; ++i) {
+    float d = g[i] + wd * w[i];
+    if(v) {
+      v[i] = mu * v[i] + d;
+      d = nesterov ? d + mu * v[i] : v[i];
+    }
+    w[i] -= lr * d;
+  }
+}
+
+// Adam with the bias corrections folded into step = lr / (1 - beta1^t)
+// and rcorr = 1 / sqrt(1 - beta2^t). AdamW passes its decay as keep and
+// Adam as the L2 term wd.
+void adam(float* const w, const float* const g,
+          float* const m, float* const v,
+          const std::size_t first, const std::size_t last,
+          const float step, const float b1, const float b2, const float eps,
+          const float wd, const float keep, const float rcorr)
+{
+  const simd::type vstep = simd::set1(step);
+  const simd::type vb1 = simd::set1(b1);
+  const simd::type vc1 = simd::set1(1.0f - b1);
+  const simd::type vb2 = simd::set1(b2);
+  const simd::type vc2 = simd::set1(1.0f - b2);
+  const simd::type veps = simd::set1(eps);
+  const simd::type vwd = simd::set1(wd);
+  const simd::type vkeep = simd::set1(keep);
+  const simd::type vrcorr = simd::set1(rcorr);
+  std::size_t i = first;
+  for(; i + width <= last; i += width) {
+    const simd::type x = simd::load(w + i);
+    const simd::type d = simd::add(simd::load(g + i), simd::mul(vwd, x));
+    const simd::type a = simd::add(simd::mul(vb1, simd::load(m + i)),
+                                   simd::mul(vc1, d));
+    const simd::type b = simd::add(simd::mul(vb2, simd::load(v + i)),
+                                   simd::mul(vc2, simd::mul(d, d)));
+    simd::store(m + i, a);
+    simd::store(v + i, b);
+    const simd::type r = simd::add(simd::mul(simd::sqrt(b), vrcorr), veps);
+    simd::store(w + i, simd::sub(simd::mul(vkeep, x),
+                                 simd::div(simd::mul(vstep, a), r)));
+  }
+  for(; i < last; ++i) {
+    const float d = g[i] + wd * w[i];
+    m[i] = b1 * m[i] + (1.0f - b1) * d;
+    v[i] = b2 * v[i] + (1.0f - b2) * d * d;
+    w[i] = keep * w[i] - step * m[i] / (std::sqrt(v[i]) * rcorr + eps);
+  }
+}
+
+// RMSProp with an optional velocity buffer b.
+void rmsprop(float* const w, const float* const g,
+             float* const v, float* const b,
+             const std::size_t first, const std::size_t last,
+             const float lr, const float alpha, const float eps,
+             const float wd, const float mu)
+{
+  const simd::type vlr = simd::set1(lr);
+  const simd::type valpha = simd::set1(alpha);
+  const simd::type vc = simd::set1(1.0f - alpha);
+  const simd::type veps = simd::set1(eps);
+  const simd::type vwd = simd::set1(wd);
+  const simd::type vmu = simd::set1(mu);
+  std::size_t i = first;
+  for(; i + width <= last; i += width) {
+    const simd::type x = simd::load(w + i);
+    const simd::type d = simd::add(simd::load(g + i), simd::mul(vwd, x));
+    const simd::type s = simd::add(simd::mul(valpha, simd::load(v + i)),
+                                   simd::mul(vc, simd::mul(d, d)));
+    simd::store(v + i, s);
+    simd::type u = simd::div(d, simd::add(simd::sqrt(s), veps));
+    if(b) {
+      u = simd::add(simd::mul(vmu, simd::load(b + i)), u);
+      simd::store(b + i, u);
+    }
+    simd::store(w + i, simd::sub(x, simd::mul(vlr, u)));
+  }
+  for(; i < last; ++i) {
+    const float d = g[i] + wd * w[i];
+    v[i] = alpha * v[i] + (1.0f - alpha) * d * d;
+    float u = d / (std::sqrt(v[i]) + eps);
+    if(b) u = b[i] = mu * b[i] + u;
+    w[i] -= lr * u;
+  }
+}
+
+// A matrix over a slot buffer with the shape and layout of like.
+Matrixf view(std::vector<float>& buffer, const Matrixf& like)
+{
+  const auto keep = [](float*) {};
+  if(like.layout() == CblasRowMajor) {
+    return Matrixf(buffer.data(), like.rows(), like.cols(), keep);
+  }
+  return Matrixf(buffer.data(), like.cols(), like.rows(), keep).transpose();
+}
+
+}  // unnamed namespace
+
+// Constructors and Destructor
+Optimizer::Optimizer(const OptimizerParams& params) : p(params) {}
+
+const std::size_t Optimizer::add(const Vectorf& w)
+{
+  const std::size_t n = w.size();
+  const bool momentum = (p.momentum != 0.0f);
+  Slot slot;
+  slot.t = 0;
+  switch(p.algorithm) {
+  case OptimizerSGD:
+    if(momentum) slot.v.assign(n, 0.0f);
+    break;
+  case OptimizerAdam:
+  case OptimizerAdamW:
+    slot.m.assign(n, 0.0f);
+    slot.v.assign(n, 0.0f);
+    break;
+  case OptimizerRMSProp:
+    slot.v.assign(n, 0.0f);
+    if(momentum) slot.m.assign(n, 0.0f);
+    break;
+  }
+  slots.push_back(std::move(slot));
+  return slots.size() - 1;
+}
+
+void Optimizer::step(const std::size_t slot, Vectorf& w, const Vectorf& g)
+{
+  assert(slot < slots.size());
+  assert(w.size() == g.size());
+  assert(w.inc() == 1 && g.inc() == 1);
+  update(slots[slot], w.data(), g.data(), w.size());
+}
+
+void Optimizer::step(const std::size_t slot, Matrixf& w, const Matrixf& g)
+{
+  assert(w.rows() == g.rows() && w.cols() == g.cols());
+  if(w.layout() == g.layout() || w.rows() == 1 || w.cols() == 1) {
+    step(slot, static_cast<Vectorf&>(w), g);
+  } else if(w.layout() == CblasRowMajor) {
+    step(slot, static_cast<Vectorf&>(w), g.materialize());
+  } else {
+    step(slot, static_cast<Vectorf&>(w), g.transpose_copy());
+  }
+}
+
+void Optimizer::step(const std::size_t slot, Matrixf& w,
+                     const Matrixf& a, const Matrixf& b)
+{
+  assert(slot < slots.size());
+  assert(w.rows() == a.rows() && w.cols() == b.cols());
+  Slot& s = slots[slot];
+  if(p.algorithm == OptimizerSGD && p.momentum == 0.0f) {
+    w.gemm(-p.lr, a, b, 1.0f - p.lr * p.weight_decay);
+    ++s.t;
+    return;
+  }
+  if(p.algorithm == OptimizerSGD && !p.nesterov && p.weight_decay == 0.0f) {
+    Matrixf v = view(s.v, w);
+    v.gemm(1.0f, a, b, p.momentum);
+    w.axpy(-p.lr, v);
+    ++s.t;
+    return;
+  }
+  if(s.g.size() != w.size()) s.g.resize(w.size());
+  view(s.g, w).gemm(1.0f, a, b, 0.0f);
+  update(s, w.data(), s.g.data(), w.size());
+}
+
+// Accessors
+const OptimizerParams& Optimizer::params() const
+{ return p; }
+
+void Optimizer::set_lr(const float lr)
+{ p.lr = lr; }
+
+const std::size_t Optimizer::steps(const std::size_t slot) const
+{ return slots[slot].t; }
+
+void Optimizer::update(Slot& s, float* const w, const float* const g,
+                       const std::size_t n)
+{
+  assert(s.v.empty() || s.v.size() == n);
+  const std::size_t t = ++s.t;
+  float* const m = s.m.empty() ? nullptr : s.m.data();
+  float* const v = s.v.empty() ? nullptr : s.v.data();
+  const OptimizerParams q = p;
+
+  float step = q.lr, wd = q.weight_decay, keep = 1.0f, rcorr = 1.0f;
+  if(q.algorithm == OptimizerAdam || q.algorithm == OptimizerAdamW) {
+    step /= 1.0f - std::pow(q.beta1, float(t));
+    rcorr = 1.0f / std::sqrt(1.0f - std::pow(q.beta2, float(t)));
+    if(q.algorithm == OptimizerAdamW) {
+      keep -= q.lr * q.weight_decay;
+      wd = 0.0f;
+    }
+  }
+
+  internal::parallel_for(0, n, internal::grain, [&](
+      const std::size_t first, const std::size_t last) {
+    switch(q.algorithm) {
+    case OptimizerSGD:
+      sgd(w, g, v, first, last, q.lr, q.momentum, wd, q.nesterov);
+      break;
+    case OptimizerAdam:
+    case OptimizerAdamW:
+      adam(w, g, m, v, first, last, step, q.beta1, q.beta2, q.eps, wd, keep,
+           rcorr);
+      break;
+    case OptimizerRMSProp:
+      rmsprop(w, g, v, m, first, last, q.lr, q.beta2, q.eps, wd,
+              q.momentum);
+      break;
+    }
+  });
+}
+
+}  // namespace laplus
@@ -0,0 +1,273 @@
+/******************************************************************************
+ *
+ * laplus/process_grid.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/process_grid.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace laplus {
+
+namespace {
+
+const std::size_t default_panel = 256;
+
+// A slice [first, last) of the shared dimension whose columns of a live
+// on grid column col and whose rows of b live on grid row row.
+struct Panel {
+  std::size_t first;
+  std::size_t last;
+  std::size_t col;
+  std::size_t row;
+};
+
+// The part of n split into parts that holds index x.
+const std::size_t owner(const std::size_t n, const std::size_t parts,
+                        const std::size_t x)
+{
+  std::size_t p = 0;
+  while(ProcessGrid::split(n, parts, p + 1) <= x) ++p;
+  return p;
+}
+
+// Cuts k at the block boundaries of both distributions and at most width
+// apart.
+std::vector<Panel> plan(const std::size_t k, const std::size_t rows,
+                        const std::size_t cols, const std::size_t width)
+{
+  std::vector<Panel> panels;
+  for(std::size_t first = 0; first < k;) {
+    Panel p;
+    p.first = first;
+    p.col = owner(k, cols, first);
+    p.row = owner(k, rows, first);
+    p.last = std::min(std::min(ProcessGrid::split(k, cols, p.col + 1),
+                               ProcessGrid::split(k, rows, p.row + 1)),
+                      first + width);
+    panels.push_back(p);
+    first = p.last;
+  }
+  return panels;
+}
+
+// Copies rows x cols of src with leading dimension lds into dst with
+// leading dimension ldd.
+void copy(const float* src, const std::size_t lds, float* dst,
+          const std::size_t ldd, const std::size_t rows,
+          const std::size_t cols)
+{
+  for(std::size_t r = 0; r < rows; ++r)
+    std::memcpy(dst + r * ldd, src + r * lds, cols * sizeof(float));
+}
+
+}  // unnamed namespace
+
+// Constructors and Destructor
+ProcessGrid::ProcessGrid(Transport& transport, const std::size_t rows,
+                         const std::size_t cols)
+  : comm(transport), nrows(rows), ncols(cols)
+{ assert(rows * cols == transport.size()); }
+
+const std::size_t ProcessGrid::split(const std::size_t n,
+                                     const std::size_t parts,
+                                     const std::size_t p)
+{ return n * p / parts; }
+
+// Distribution
+Matrixf ProcessGrid::block(const Matrixf& global) const
+{
+  const Matrixf g = global.row_major();
+  const std::size_t r0 = split(g.rows(), nrows, row());
+  const std::size_t r1 = split(g.rows(), nrows, row() + 1);
+  const std::size_t c0 = split(g.cols(), ncols, col());
+  const std::size_t c1 = split(g.cols(), ncols, col() + 1);
+  Matrixf result(r1 - r0, c1 - c0);
+  copy(g.data() + r0 * g.cols() + c0, g.cols(), result.data(), c1 - c0,
+       r1 - r0, c1 - c0);
+  return result;
+}
+
+// Every rank sends its block to rank + s while receiving from rank - s,
+// for s = 1, 2, ..., so each step pairs up and nobody waits on a cycle.
+Matrixf ProcessGrid::gather(const Matrixf& local, const std::size_t m,
+                            const std::size_t n) const
+{
+  const Matrixf b = local.row_major();
+  const std::size_t size = comm.size();
+  const std::size_t me = comm.rank();
+  std::thread sender([&] {
+    for(std::size_t s = 1; s < size; ++s)
+      comm.send((me + s) % size, b.data(), b.size() * sizeof(float));
+  });
+
+  Matrixf result(m, n);
+  std::vector<float> buffer;
+  for(std::size_t s = 0; s < size; ++s) {
+    const std::size_t peer = (me + size - s) % size;
+    const std::size_t i = peer / ncols;
+    const std::size_t j = peer % ncols;
+    const std::size_t r0 = split(m, nrows, i);
+    const std::size_t r1 = split(m, nrows, i + 1);
+    const std::size_t c0 = split(n, ncols, j);
+    const std::size_t c1 = split(n, ncols, j + 1);
+    const float* source = b.data();
+    if(s > 0) {
+      buffer.resize((r1 - r0) * (c1 - c0));
+      comm.recv(peer, buffer.data(), buffer.size() * sizeof(float));
+      source = buffer.data();
+    }
+    copy(source, c1 - c0, result.data() + r0 * n + c0, n, r1 - r0, c1 - c0);
+  }
+  sender.join();
+  return result;
+}
+
+void ProcessGrid::gemm(const float alpha, const Matrixf& a, const Matrixf& b,
+                       const float beta, Matrixf& c, const std::size_t k) const
+{ gemm(alpha, a, b, beta, c, k, default_panel); }
+
+void ProcessGrid::gemm(const float alpha, const Matrixf& a, const Matrixf& b,
+                       const float beta, Matrixf& c, const std::size_t k,
+                       const std::size_t width) const
+{
+  assert(width > 0);
+  const std::size_t i = row();
+  const std::size_t j = col();
+  const std::size_t m = c.rows();
+  const std::size_t n = c.cols();
+  const std::size_t ka = split(k, ncols, j);
+  const std::size_t kb = split(k, nrows, i);
+  assert(a.rows() == m && a.cols() == split(k, ncols, j + 1) - ka);
+  assert(b.cols() == n && b.rows() == split(k, nrows, i + 1) - kb);
+  assert(c.layout() == CblasRowMajor && c.inc() == 1);
+
+  const Matrixf A = a.row_major();
+  const Matrixf B = b.row_major();
+  if(beta == 0.0f) {
+    for(std::size_t r = 0; r < m; ++r)
+      std::fill(c.data() + r * c.ldim(), c.data() + r * c.ldim() + n, 0.0f);
+  } else if(beta != 1.0f) {
+    c *= beta;
+  }
+  const std::vector<Panel> panels = plan(k, nrows, ncols, width);
+
+  // Two panels in flight: the fetcher fills slot p % 2 once the product
+  // of panel p - 2 is done. Panels of b owned here are used in place.
+  std::vector<float> apanel[2];
+  std::vector<float> bpanel[2];
+  const float* bsource[2] = {nullptr, nullptr};
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::size_t fetched = 0;
+  std::size_t consumed = 0;
+
+  std::thread fetcher([&] {
+    for(std::size_t p = 0; p < panels.size(); ++p) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return consumed + 2 > p; });
+      }
+      const Panel& q = panels[p];
+      const std::size_t w = q.last - q.first;
+      const std::size_t abytes = m * w * sizeof(float);
+      const std::size_t bbytes = w * n * sizeof(float);
+      std::vector<float>& pa = apanel[p % 2];
+      pa.resize(m * w);
+      if(q.col == j) {
+        copy(A.data() + (q.first - ka), A.cols(), pa.data(), w, m, w);
+        for(std::size_t jj = 0; jj < ncols; ++jj)
+          if(jj != j) comm.send(rank(i, jj), pa.data(), abytes);
+      } else {
+        comm.recv(rank(i, q.col), pa.data(), abytes);
+      }
+      if(q.row == i) {
+        const float* const source = B.data() + (q.first - kb) * n;
+        for(std::size_t ii = 0; ii < nrows; ++ii)
+          if(ii != i) comm.send(rank(ii, j), source, bbytes);
+        bsource[p % 2] = source;
+      } else {
+        std::vector<float>& pb = bpanel[p % 2];
+        pb.resize(w * n);
+        comm.recv(rank(q.row, j), pb.data(), bbytes);
+        bsource[p % 2] = pb.data();
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        fetched = p + 1;
+      }
+      changed.notify_all();
+    }
+  });
+
+  for(std::size_t p = 0; p < panels.size(); ++p) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      changed.wait(lock, [&] { return fetched > p; });
+    }
+    const std::size_t w = panels[p].last - panels[p].first;
+    if(m > 0 && n > 0) {
+      cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, m, n, w,
+                  alpha, apanel[p % 2].data(), w, bsource[p % 2], n,
+                  1.0f, c.data(), n);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      consumed = p + 1;
+    }
+    changed.notify_all();
+  }
+  fetcher.join();
+}
+
+// Accessors
+Transport& ProcessGrid::transport() const
+{ return comm; }
+
+const std::size_t ProcessGrid::rows() const
+{ return nrows; }
+
+const std::size_t ProcessGrid::cols() const
+{ return ncols; }
+
+const std::size_t ProcessGrid::row() const
+{ return comm.rank() / ncols; }
+
+const std::size_t ProcessGrid::col() const
+{ return comm.rank() % ncols; }
+
+const std::size_t ProcessGrid::rank(const std::size_t i,
+                                    const std::size_t j) const
+{ return i * ncols + j; }
+
+}  // namespace laplus
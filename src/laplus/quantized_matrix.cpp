@@ -0,0 +1,572 @@
+/******************************************************************************
+ *
+ * laplus/quantized_matrix.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/quantized_matrix.hpp"
+#include "laplus/internal/parallel.hpp"
+#include "laplus/internal/simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <immintrin.h>
+
+namespace laplus {
+
+namespace {
+
+const std::int32_t qmin(const QuantType type)
+{ return (type == Int8) ? -128 : 0; }
+
+const std::int32_t qmax(const QuantType type)
+{ return (type == Int8) ? 127 : 255; }
+
+const std::size_t channels(const QuantAxis axis,
+                           const std::size_t rows, const std::size_t cols)
+{
+  if(axis == PerRow) return rows;
+  if(axis == PerCol) return cols;
+  return 1;
+}
+
+// Stored bytes are reinterpreted as signed for Int8 data.
+std::int32_t load(const std::uint8_t byte, const QuantType type)
+{
+  if(type == Int8) return static_cast<std::int8_t>(byte);
+  return byte;
+}
+
+// Scale parameters for one storage line. When the quantization axis runs
+// along the line the arrays hold one entry per element, otherwise a single
+// entry applies to the whole line.
+struct Line {
+  const float* scale;
+  const std::int32_t* zero;
+  bool varying;
+};
+
+#ifdef LAPLUS_AVX2
+__attribute__((target("avx2,fma")))
+std::size_t quantize_line_avx2(const float* x, std::uint8_t* q,
+                               const std::size_t n, const Line& line,
+                               const QuantType type)
+{
+  std::size_t p = 0;
+  const __m256 lo = _mm256_set1_ps(qmin(type));
+  const __m256 hi = _mm256_set1_ps(qmax(type));
+  for(; p + 8 <= n; p += 8) {
+    __m256 s = line.varying ? _mm256_loadu_ps(line.scale + p)
+                            : _mm256_set1_ps(line.scale[0]);
+    __m256i z = line.varying ? _mm256_loadu_si256((__m256i*)(line.zero + p))
+                             : _mm256_set1_epi32(line.zero[0]);
+    __m256 v0 = _mm256_mul_ps(_mm256_loadu_ps(x + p), s);
+    __m256 v1 = _mm256_round_ps(v0, _MM_FROUND_TO_NEAREST_INT
+                                  | _MM_FROUND_NO_EXC);
+    __m256 v2 = _mm256_add_ps(v1, _mm256_cvtepi32_ps(z));
+    __m256 v3 = _mm256_min_ps(_mm256_max_ps(v2, lo), hi);
+    __m256i v4 = _mm256_cvtps_epi32(v3);
+    __m128i v5 = _mm_packs_epi32(_mm256_castsi256_si128(v4),
+                                 _mm256_extracti128_si256(v4, 1));
+    __m128i v6 = (type == Int8) ? _mm_packs_epi16(v5, v5)
+                                : _mm_packus_epi16(v5, v5);
+    _mm_storel_epi64((__m128i*)(q + p), v6);
+  }
+  return p;
+}
+
+__attribute__((target("avx2,fma")))
+std::size_t dequantize_line_avx2(const std::uint8_t* q, float* x,
+                                 const std::size_t n, const Line& line,
+                                 const QuantType type)
+{
+  std::size_t p = 0;
+  for(; p + 8 <= n; p += 8) {
+    __m256 s = line.varying ? _mm256_loadu_ps(line.scale + p)
+                            : _mm256_set1_ps(line.scale[0]);
+    __m256i z = line.varying ? _mm256_loadu_si256((__m256i*)(line.zero + p))
+                             : _mm256_set1_epi32(line.zero[0]);
+    __m128i v0 = _mm_loadl_epi64((const __m128i*)(q + p));
+    __m256i v1 = (type == Int8) ? _mm256_cvtepi8_epi32(v0)
+                                : _mm256_cvtepu8_epi32(v0);
+    __m256 v2 = _mm256_cvtepi32_ps(_mm256_sub_epi32(v1, z));
+    _mm256_storeu_ps(x + p, _mm256_mul_ps(v2, s));
+  }
+  return p;
+}
+#endif
+
+void quantize_line(const float* x, std::uint8_t* q, const std::size_t n,
+                   const Line& line, const QuantType type)
+{
+  std::size_t p = 0;
+#ifdef LAPLUS_AVX2
+  if(internal::has_avx2()) p = quantize_line_avx2(x, q, n, line, type);
+#endif
+  for(; p < n; ++p) {
+    const std::size_t k = line.varying ? p : 0;
+    float v = std::nearbyint(x[p] * line.scale[k]) + line.zero[k];
+    v = std::min<float>(std::max<float>(v, qmin(type)), qmax(type));
+    q[p] = static_cast<std::uint8_t>(static_cast<std::int32_t>(v));
+  }
+}
+
+void dequantize_line(const std::uint8_t* q, float* x, const std::size_t n,
+                     const Line& line, const QuantType type)
+{
+  std::size_t p = 0;
+#ifdef LAPLUS_AVX2
+  if(internal::has_avx2()) p = dequantize_line_avx2(q, x, n, line, type);
+#endif
+  for(; p < n; ++p) {
+    const std::size_t k = line.varying ? p : 0;
+    x[p] = (load(q[p], type) - line.zero[k]) * line.scale[k];
+  }
+}
+
+// Sums a[k] * b[c][k] over k for four columns of B at once.
+void dot4_scalar(const std::uint8_t* a, const std::uint8_t* const* b,
+                 const std::size_t first, const std::size_t n,
+                 std::int32_t* sums)
+{
+  for(std::size_t c = 0; c < 4; ++c) {
+    std::int32_t sum = 0;
+    for(std::size_t k = first; k < n; ++k) {
+      sum += a[k] * static_cast<std::int8_t>(b[c][k]);
+    }
+    sums[c] += sum;
+  }
+}
+
+#ifdef LAPLUS_AVX2
+__attribute__((target("avx2,fma")))
+std::int32_t reduce(const __m256i v)
+{
+  __m128i v0 = _mm_add_epi32(_mm256_castsi256_si128(v),
+                             _mm256_extracti128_si256(v, 1));
+  v0 = _mm_hadd_epi32(v0, v0);
+  v0 = _mm_hadd_epi32(v0, v0);
+  return _mm_cvtsi128_si32(v0);
+}
+
+// Widens both operands to int16 and multiplies with vpmaddwd. Unlike
+// vpmaddubsw this cannot saturate for full range uint8 x int8 inputs.
+__attribute__((target("avx2,fma")))
+std::size_t dot4_avx2(const std::uint8_t* a, const std::uint8_t* const* b,
+                      const std::size_t n, std::int32_t* sums)
+{
+  __m256i acc[4] = {_mm256_setzero_si256(), _mm256_setzero_si256(),
+                    _mm256_setzero_si256(), _mm256_setzero_si256()};
+  std::size_t k = 0;
+  for(; k + 16 <= n; k += 16) {
+    __m256i a0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i*)(a + k)));
+    for(std::size_t c = 0; c < 4; ++c) {
+      __m128i b0 = _mm_loadu_si128((const __m128i*)(b[c] + k));
+      __m256i b1 = _mm256_cvtepi8_epi16(b0);
+      acc[c] = _mm256_add_epi32(acc[c], _mm256_madd_epi16(a0, b1));
+    }
+  }
+  for(std::size_t c = 0; c < 4; ++c) sums[c] += reduce(acc[c]);
+  return k;
+}
+#endif
+
+#ifdef LAPLUS_AVX512VNNI
+__attribute__((target("avx512f,avx512bw,avx512vnni")))
+std::size_t dot4_vnni(const std::uint8_t* a, const std::uint8_t* const* b,
+                      const std::size_t n, std::int32_t* sums)
+{
+  __m512i acc[4] = {_mm512_setzero_si512(), _mm512_setzero_si512(),
+                    _mm512_setzero_si512(), _mm512_setzero_si512()};
+  std::size_t k = 0;
+  for(; k + 64 <= n; k += 64) {
+    __m512i a0 = _mm512_loadu_si512(a + k);
+    for(std::size_t c = 0; c < 4; ++c) {
+      __m512i b0 = _mm512_loadu_si512(b[c] + k);
+      acc[c] = _mm512_dpbusd_epi32(acc[c], a0, b0);
+    }
+  }
+  for(std::size_t c = 0; c < 4; ++c) sums[c] += _mm512_reduce_add_epi32(acc[c]);
+  return k;
+}
+
+const bool has_vnni()
+{
+  static const bool supported = __builtin_cpu_supports("avx512vnni")
+                             && __builtin_cpu_supports("avx512bw");
+  return supported;
+}
+#endif
+
+void dot4(const std::uint8_t* a, const std::uint8_t* const* b,
+          const std::size_t n, std::int32_t* sums)
+{
+  std::size_t k = 0;
+#ifdef LAPLUS_AVX512VNNI
+  if(has_vnni()) k = dot4_vnni(a, b, n, sums);
+#endif
+#ifdef LAPLUS_AVX2
+  if(k == 0 && internal::has_avx2()) k = dot4_avx2(a, b, n, sums);
+#endif
+  dot4_scalar(a, b, k, n, sums);
+}
+
+// Runs the integer product of A and B and hands every finished row of
+// zero point corrected int32 accumulators to emit(i, row).
+template<typename F>
+void accumulate(const QuantizedMatrix& A, const QuantizedMatrix& B,
+                const F& emit)
+{
+  assert(A.cols() == B.rows());
+  assert(A.params().type == UInt8 && A.params().axis != PerCol);
+  assert(B.params().type == Int8 && B.params().axis != PerRow);
+  const QuantizedMatrix a = (A.layout() == CblasRowMajor)
+                          ? A : A.pack(CblasRowMajor);
+  const QuantizedMatrix b = (B.layout() == CblasColMajor)
+                          ? B : B.pack(CblasColMajor);
+  const std::size_t M = A.rows();
+  const std::size_t N = B.cols();
+  const std::size_t K = A.cols();
+  const std::vector<std::int32_t>& za = A.params().zero_points;
+  const std::vector<std::int32_t>& zb = B.params().zero_points;
+
+  std::vector<std::int32_t> col_sums(N);
+  for(std::size_t j = 0; j < N; ++j) {
+    const std::uint8_t* const bj = b.data() + j * K;
+    for(std::size_t k = 0; k < K; ++k) {
+      col_sums[j] += static_cast<std::int8_t>(bj[k]);
+    }
+  }
+
+  internal::parallel_for(0, M, 4, [&](const std::size_t first,
+                                      const std::size_t last) {
+    std::vector<std::int32_t> row(N + 4);
+    for(std::size_t i = first; i < last; ++i) {
+      const std::uint8_t* const ai = a.data() + i * K;
+      std::int32_t row_sum = 0;
+      for(std::size_t k = 0; k < K; ++k) row_sum += ai[k];
+      const std::int32_t zai = za[(A.params().axis == PerRow) ? i : 0];
+
+      std::fill(row.begin(), row.end(), 0);
+      for(std::size_t j = 0; j < N; j += 4) {
+        const std::uint8_t* cols[4];
+        for(std::size_t c = 0; c < 4; ++c) {
+          cols[c] = (j + c < N) ? b.data() + (j + c) * K : ai;
+        }
+        dot4(ai, cols, K, row.data() + j);
+      }
+      for(std::size_t j = 0; j < N; ++j) {
+        const std::int32_t zbj = zb[(B.params().axis == PerCol) ? j : 0];
+        row[j] += static_cast<std::int32_t>(K) * zai * zbj
+                - zbj * row_sum - zai * col_sums[j];
+      }
+      emit(i, row.data());
+    }
+  });
+}
+
+}  // unnamed namespace
+
+// Calibrator
+Calibrator::Calibrator(const QuantAxis axis) : axis(axis) {}
+
+void Calibrator::observe(const Matrixf& matrix)
+{
+  const std::size_t n = channels(axis, matrix.rows(), matrix.cols());
+  if(lower.empty()) {
+    lower.assign(n, std::numeric_limits<float>::max());
+    upper.assign(n, std::numeric_limits<float>::lowest());
+  }
+  assert(lower.size() == n);
+  for(std::size_t i = 0; i < matrix.rows(); ++i) {
+    for(std::size_t j = 0; j < matrix.cols(); ++j) {
+      const std::size_t k = (axis == PerRow) ? i : (axis == PerCol) ? j : 0;
+      lower[k] = std::min(lower[k], matrix(i, j));
+      upper[k] = std::max(upper[k], matrix(i, j));
+    }
+  }
+}
+
+QuantParams Calibrator::params(const QuantType type,
+                               const bool symmetric) const
+{
+  assert(!lower.empty());
+  QuantParams result = {type, axis, std::vector<float>(lower.size()),
+                        std::vector<std::int32_t>(lower.size())};
+  for(std::size_t k = 0; k < lower.size(); ++k) {
+    const float lo = std::min(lower[k], 0.0f);
+    const float hi = std::max(upper[k], 0.0f);
+    float scale;
+    std::int32_t zero;
+    if(symmetric) {
+      scale = std::max(-lo, hi) / 127.0f;
+      zero = (type == Int8) ? 0 : 128;
+    } else {
+      scale = (hi - lo) / (qmax(type) - qmin(type));
+      zero = 0;
+    }
+    if(scale == 0.0) scale = 1.0;
+    if(!symmetric) {
+      zero = qmin(type) - static_cast<std::int32_t>(std::nearbyint(lo / scale));
+      zero = std::min(std::max(zero, qmin(type)), qmax(type));
+    }
+    result.scales[k] = scale;
+    result.zero_points[k] = zero;
+  }
+  return result;
+}
+
+// Constructors and Destructor
+QuantizedMatrix::QuantizedMatrix(const std::size_t rows,
+                                 const std::size_t cols,
+                                 const QuantParams& params,
+                                 const CBLAS_TRANSPOSE trans)
+  : shape(rows, cols), trans(trans), quant(params), storage(rows * cols)
+{
+  assert(quant.scales.size() == channels(quant.axis, rows, cols));
+  assert(quant.zero_points.size() == quant.scales.size());
+}
+
+QuantizedMatrix::QuantizedMatrix(const Matrixf& matrix,
+                                 const QuantParams& params)
+  : QuantizedMatrix(matrix, params, matrix.layout())
+{}
+
+QuantizedMatrix::QuantizedMatrix(const Matrixf& matrix,
+                                 const QuantParams& params,
+                                 const CBLAS_ORDER order)
+  : QuantizedMatrix(matrix.rows(), matrix.cols(), params,
+                    (order == CblasRowMajor) ? CblasNoTrans : CblasTrans)
+{
+  const bool rowwise = (order == CblasRowMajor);
+  const std::size_t lines = rowwise ? rows() : cols();
+  const std::size_t width = rowwise ? cols() : rows();
+  const QuantAxis along = rowwise ? PerCol : PerRow;
+  std::vector<float> inverse(quant.scales.size());
+  for(std::size_t k = 0; k < inverse.size(); ++k) {
+    inverse[k] = 1.0f / quant.scales[k];
+  }
+
+  internal::parallel_for(0, lines, 16, [&](const std::size_t first,
+                                           const std::size_t last) {
+    std::vector<float> buffer(width);
+    for(std::size_t l = first; l < last; ++l) {
+      const float* x = matrix.data() + l * matrix.ldim();
+      if(matrix.layout() != order) {
+        for(std::size_t p = 0; p < width; ++p) {
+          buffer[p] = rowwise ? matrix(l, p) : matrix(p, l);
+        }
+        x = buffer.data();
+      }
+      const std::size_t k = (quant.axis == along || quant.axis == PerTensor)
+                          ? 0 : l;
+      const Line line = {inverse.data() + k, quant.zero_points.data() + k,
+                         quant.axis == along};
+      quantize_line(x, data() + l * width, width, line, quant.type);
+    }
+  });
+}
+
+QuantizedMatrix::QuantizedMatrix(const Matrixf& matrix, const QuantAxis axis,
+                                 const QuantType type)
+  : QuantizedMatrix(matrix, [&]() {
+      Calibrator calibrator(axis);
+      calibrator.observe(matrix);
+      return calibrator.params(type);
+    }())
+{}
+
+QuantizedMatrix::QuantizedMatrix(const QuantizedMatrix& other)
+  : shape(other.shape), trans(other.trans), quant(other.quant)
+  , storage(other.storage)
+{}
+
+QuantizedMatrix::QuantizedMatrix(QuantizedMatrix&& other) noexcept
+  : shape(other.shape), trans(other.trans), quant(std::move(other.quant))
+  , storage(std::move(other.storage))
+{ other.shape = std::make_pair(0, 0); }
+
+QuantizedMatrix::~QuantizedMatrix() {}
+
+// Assignment Operators
+QuantizedMatrix& QuantizedMatrix::operator=(const QuantizedMatrix& other)
+{
+  QuantizedMatrix another(other);
+  *this = std::move(another);
+  return *this;
+}
+
+QuantizedMatrix& QuantizedMatrix::operator=(QuantizedMatrix&& other) noexcept
+{
+  using std::swap;
+  swap(*this, other);
+  return *this;
+}
+
+// Miscellaneous Operators
+const float QuantizedMatrix::operator()(const std::size_t i,
+                                        const std::size_t j) const
+{
+  const std::size_t k = (quant.axis == PerRow) ? i
+                      : (quant.axis == PerCol) ? j : 0;
+  return (value(i, j) - quant.zero_points[k]) * quant.scales[k];
+}
+
+// Utilities
+void swap(QuantizedMatrix& a, QuantizedMatrix& b)
+{
+  using std::swap;
+  swap(a.shape, b.shape);
+  swap(a.trans, b.trans);
+  swap(a.quant, b.quant);
+  swap(a.storage, b.storage);
+}
+
+QuantizedMatrix QuantizedMatrix::transpose() const
+{
+  QuantizedMatrix result(*this);
+  result.shape = std::make_pair(cols(), rows());
+  result.trans = (trans == CblasTrans) ? CblasNoTrans : CblasTrans;
+  if(quant.axis != PerTensor) {
+    result.quant.axis = (quant.axis == PerRow) ? PerCol : PerRow;
+  }
+  return result;
+}
+
+QuantizedMatrix QuantizedMatrix::pack(const CBLAS_ORDER order) const
+{
+  const CBLAS_TRANSPOSE target = (order == CblasRowMajor) ? CblasNoTrans
+                                                          : CblasTrans;
+  QuantizedMatrix result(rows(), cols(), quant, target);
+  for(std::size_t i = 0; i < rows(); ++i) {
+    for(std::size_t j = 0; j < cols(); ++j) {
+      result.data()[result.index(i, j)] = data()[index(i, j)];
+    }
+  }
+  return result;
+}
+
+Matrixf QuantizedMatrix::dequantize() const
+{
+  const bool rowwise = (trans == CblasNoTrans);
+  const std::size_t lines = rowwise ? rows() : cols();
+  const std::size_t width = rowwise ? cols() : rows();
+  const QuantAxis along = rowwise ? PerCol : PerRow;
+  Matrixf result(lines, width);
+  internal::parallel_for(0, lines, 16, [&](const std::size_t first,
+                                           const std::size_t last) {
+    for(std::size_t l = first; l < last; ++l) {
+      const std::size_t k = (quant.axis == along || quant.axis == PerTensor)
+                          ? 0 : l;
+      const Line line = {quant.scales.data() + k,
+                         quant.zero_points.data() + k, quant.axis == along};
+      dequantize_line(data() + l * width, result.data() + l * width, width,
+                      line, quant.type);
+    }
+  });
+  return rowwise ? result : result.transpose();
+}
+
+// Accessors
+const std::size_t QuantizedMatrix::rows() const
+{ return shape.first; }
+
+const std::size_t QuantizedMatrix::cols() const
+{ return shape.second; }
+
+const std::size_t QuantizedMatrix::ldim() const
+{ return (trans == CblasTrans) ? rows() : cols(); }
+
+const CBLAS_ORDER QuantizedMatrix::layout() const
+{ return (trans == CblasTrans) ? CblasColMajor : CblasRowMajor; }
+
+const QuantParams& QuantizedMatrix::params() const
+{ return quant; }
+
+const std::int32_t QuantizedMatrix::value(const std::size_t i,
+                                          const std::size_t j) const
+{ return load(data()[index(i, j)], quant.type); }
+
+std::uint8_t* const QuantizedMatrix::data() const
+{ return storage.get(); }
+
+const std::size_t QuantizedMatrix::index(const std::size_t i,
+                                         const std::size_t j) const
+{ return (trans == CblasTrans) ? i + rows() * j : i * cols() + j; }
+
+// Quantized BLAS
+void gemm(const QuantizedMatrix& A, const QuantizedMatrix& B,
+          std::int32_t* const C)
+{
+  const std::size_t N = B.cols();
+  accumulate(A, B, [&](const std::size_t i, const std::int32_t* row) {
+    std::copy(row, row + N, C + i * N);
+  });
+}
+
+Matrixf dot(const QuantizedMatrix& A, const QuantizedMatrix& B)
+{
+  Matrixf result(A.rows(), B.cols());
+  const QuantParams& pa = A.params();
+  const QuantParams& pb = B.params();
+  accumulate(A, B, [&](const std::size_t i, const std::int32_t* row) {
+    const float sa = pa.scales[(pa.axis == PerRow) ? i : 0];
+    float* const ci = result.data() + i * result.cols();
+    for(std::size_t j = 0; j < result.cols(); ++j) {
+      ci[j] = sa * pb.scales[(pb.axis == PerCol) ? j : 0] * row[j];
+    }
+  });
+  return result;
+}
+
+QuantizedMatrix dot(const QuantizedMatrix& A, const QuantizedMatrix& B,
+                    const QuantParams& params)
+{
+  QuantizedMatrix result(A.rows(), B.cols(), params, CblasNoTrans);
+  const QuantParams& pa = A.params();
+  const QuantParams& pb = B.params();
+  std::vector<float> inverse(params.scales.size());
+  for(std::size_t k = 0; k < inverse.size(); ++k) {
+    inverse[k] = 1.0f / params.scales[k];
+  }
+  const std::size_t N = B.cols();
+  accumulate(A, B, [&](const std::size_t i, const std::int32_t* row) {
+    std::vector<float> real(N);
+    const float sa = pa.scales[(pa.axis == PerRow) ? i : 0];
+    for(std::size_t j = 0; j < N; ++j) {
+      real[j] = sa * pb.scales[(pb.axis == PerCol) ? j : 0] * row[j];
+    }
+    const std::size_t k = (params.axis == PerRow) ? i : 0;
+    const Line line = {inverse.data() + k, params.zero_points.data() + k,
+                       params.axis == PerCol};
+    quantize_line(real.data(), result.data() + i * N, N, line, params.type);
+  });
+  return result;
+}
+
+}  // namespace laplus
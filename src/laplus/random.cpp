@@ -0,0 +1,412 @@
+/******************************************************************************
+ *
+ * laplus/random.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/random.hpp"
+#include "laplus/internal/parallel.hpp"
+#include "laplus/internal/simd.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#include <immintrin.h>
+
+namespace laplus {
+
+namespace {
+
+const std::uint32_t M0 = 0xD2511F53u;
+const std::uint32_t M1 = 0xCD9E8D57u;
+const std::uint32_t W0 = 0x9E3779B9u;
+const std::uint32_t W1 = 0xBB67AE85u;
+
+const float pi = 3.14159265358979323846f;
+
+std::atomic<std::uint64_t> global_seed(0);
+std::atomic<std::uint64_t> global_stream(0);
+
+// Blocks generated per task of a parallel fill.
+const std::size_t grain = 4096;
+
+void philox(std::uint32_t* const c, std::uint32_t k0, std::uint32_t k1)
+{
+  for(std::size_t r = 0; r < 10; ++r) {
+    if(r > 0) {
+      k0 += W0;
+      k1 += W1;
+    }
+    const std::uint64_t p0 = static_cast<std::uint64_t>(M0) * c[0];
+    const std::uint64_t p1 = static_cast<std::uint64_t>(M1) * c[2];
+    const std::uint32_t c0 = static_cast<std::uint32_t>(p1 >> 32) ^ c[1] ^ k0;
+    const std::uint32_t c2 = static_cast<std::uint32_t>(p0 >> 32) ^ c[3] ^ k1;
+    c[1] = static_cast<std::uint32_t>(p1);
+    c[3] = static_cast<std::uint32_t>(p0);
+    c[0] = c0;
+    c[2] = c2;
+  }
+}
+
+// Uniform floats in [0, 1) and (0, 1] from the top 24 bits of a word.
+inline float closed_open(const std::uint32_t x)
+{ return (x >> 8) * (1.0f / 16777216.0f); }
+
+inline float open_closed(const std::uint32_t x)
+{ return ((x >> 8) + 1) * (1.0f / 16777216.0f); }
+
+// Uniform doubles in [0, 1) and (0, 1] from the top 53 bits of two words.
+inline double closed_open(const std::uint32_t x, const std::uint32_t y)
+{
+  const std::uint64_t bits = (static_cast<std::uint64_t>(x) << 21) | (y >> 11);
+  return bits * (1.0 / 9007199254740992.0);
+}
+
+inline double open_closed(const std::uint32_t x, const std::uint32_t y)
+{
+  const std::uint64_t bits = (static_cast<std::uint64_t>(x) << 21) | (y >> 11);
+  return (bits + 1) * (1.0 / 9007199254740992.0);
+}
+
+// Minimax polynomials for sin and cos on [-pi/4, pi/4] (Cephes).
+inline float sin_poly(const float x, const float z)
+{
+  return x + x * z * (-1.6666654611e-1f
+                      + z * (8.3321608736e-3f + z * -1.9515295891e-4f));
+}
+
+inline float cos_poly(const float z)
+{
+  return 1.0f - 0.5f * z
+       + z * z * (4.166664568298827e-2f
+                  + z * (-1.388731625493765e-3f + z * 2.443315711809948e-5f));
+}
+
+// Box-Muller pair from two words. The second word picks a quadrant with
+// its top two bits and an offset within it with the next 24, so sin and
+// cos only need to be evaluated on [-pi/4, pi/4].
+void box_muller(const std::uint32_t x, const std::uint32_t y,
+                float& a, float& b)
+{
+  const float r = std::sqrt(-2.0f * std::log(open_closed(x)));
+  const float t = (((y >> 6) & 0xFFFFFF) * (1.0f / 16777216.0f) - 0.5f)
+                * (0.5f * pi);
+  const float z = t * t;
+  float c = cos_poly(z);
+  float s = sin_poly(t, z);
+  if(y & 0x40000000u) std::swap(c, s);
+  if((y ^ (y << 1)) & 0x80000000u) c = -c;
+  if(y & 0x80000000u) s = -s;
+  a = r * c;
+  b = r * s;
+}
+
+#ifdef LAPLUS_AVX2
+__attribute__((target("avx2,fma")))
+inline void mulhilo(const __m256i a, const __m256i b, __m256i& hi, __m256i& lo)
+{
+  const __m256i even = _mm256_mul_epu32(a, b);
+  const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32),
+                                       _mm256_srli_epi64(b, 32));
+  lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+  hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+}
+
+// Eight blocks starting at block b, one per lane of c[0..3].
+__attribute__((target("avx2,fma")))
+void philox8(const std::uint64_t b, const std::uint64_t key,
+             const std::uint64_t stream, __m256i* const c)
+{
+  const std::uint32_t lo = static_cast<std::uint32_t>(b);
+  const std::uint32_t hi = static_cast<std::uint32_t>(b >> 32);
+  c[0] = _mm256_add_epi32(_mm256_set1_epi32(lo),
+                          _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+  c[1] = _mm256_set1_epi32(hi + (lo > 0xFFFFFFF8u ? 1 : 0));
+  if(lo > 0xFFFFFFF8u) {
+    // The low word wraps inside this group; fix the carry lane by lane.
+    alignas(32) std::uint32_t h[8];
+    for(std::size_t i = 0; i < 8; ++i) h[i] = (lo + i < lo) ? hi + 1 : hi;
+    c[1] = _mm256_load_si256(reinterpret_cast<const __m256i*>(h));
+  }
+  c[2] = _mm256_set1_epi32(static_cast<std::uint32_t>(stream));
+  c[3] = _mm256_set1_epi32(static_cast<std::uint32_t>(stream >> 32));
+
+  const __m256i m0 = _mm256_set1_epi32(M0);
+  const __m256i m1 = _mm256_set1_epi32(M1);
+  std::uint32_t k0 = static_cast<std::uint32_t>(key);
+  std::uint32_t k1 = static_cast<std::uint32_t>(key >> 32);
+  for(std::size_t r = 0; r < 10; ++r) {
+    if(r > 0) {
+      k0 += W0;
+      k1 += W1;
+    }
+    __m256i hi0, lo0, hi1, lo1;
+    mulhilo(m0, c[0], hi0, lo0);
+    mulhilo(m1, c[2], hi1, lo1);
+    c[0] = _mm256_xor_si256(_mm256_xor_si256(hi1, c[1]),
+                            _mm256_set1_epi32(k0));
+    c[2] = _mm256_xor_si256(_mm256_xor_si256(hi0, c[3]),
+                            _mm256_set1_epi32(k1));
+    c[1] = lo1;
+    c[3] = lo0;
+  }
+}
+
+__attribute__((target("avx2,fma")))
+inline __m256 to_float(const __m256i x, const std::uint32_t bias)
+{
+  const __m256i v = _mm256_add_epi32(_mm256_srli_epi32(x, 8),
+                                     _mm256_set1_epi32(bias));
+  return _mm256_mul_ps(_mm256_cvtepi32_ps(v),
+                       _mm256_set1_ps(1.0f / 16777216.0f));
+}
+
+// Natural logarithm of positive normal floats (Cephes logf).
+__attribute__((target("avx2,fma")))
+__m256 log8(__m256 x)
+{
+  const __m256 one = _mm256_set1_ps(1.0f);
+  __m256i e = _mm256_srli_epi32(_mm256_castps_si256(x), 23);
+  x = _mm256_and_ps(x, _mm256_castsi256_ps(_mm256_set1_epi32(0x807FFFFF)));
+  x = _mm256_or_ps(x, _mm256_set1_ps(0.5f));
+  e = _mm256_sub_epi32(e, _mm256_set1_epi32(0x7E));
+  __m256 f = _mm256_cvtepi32_ps(e);
+
+  const __m256 small = _mm256_cmp_ps(x, _mm256_set1_ps(0.707106781186547524f),
+                                     _CMP_LT_OS);
+  const __m256 t = _mm256_and_ps(x, small);
+  x = _mm256_sub_ps(x, one);
+  f = _mm256_sub_ps(f, _mm256_and_ps(one, small));
+  x = _mm256_add_ps(x, t);
+
+  const __m256 z = _mm256_mul_ps(x, x);
+  __m256 y = _mm256_set1_ps(7.0376836292e-2f);
+  const float p[] = {-1.1514610310e-1f, 1.1676998740e-1f, -1.2420140846e-1f,
+                     1.4249322787e-1f, -1.6668057665e-1f, 2.0000714765e-1f,
+                     -2.4999993993e-1f, 3.3333331174e-1f};
+  for(float c: p) y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(c));
+  y = _mm256_mul_ps(_mm256_mul_ps(y, x), z);
+  y = _mm256_fmadd_ps(f, _mm256_set1_ps(-2.12194440e-4f), y);
+  y = _mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), y);
+  x = _mm256_add_ps(x, y);
+  return _mm256_fmadd_ps(f, _mm256_set1_ps(0.693359375f), x);
+}
+
+__attribute__((target("avx2,fma")))
+void box_muller8(const __m256i x, const __m256i y, __m256& a, __m256& b)
+{
+  const __m256 r = _mm256_sqrt_ps(_mm256_mul_ps(_mm256_set1_ps(-2.0f),
+                                                log8(to_float(x, 1))));
+  const __m256i w = _mm256_and_si256(_mm256_slli_epi32(y, 2),
+                                     _mm256_set1_epi32(0xFFFFFF00));
+  const __m256 t = _mm256_mul_ps(
+      _mm256_sub_ps(to_float(w, 0), _mm256_set1_ps(0.5f)),
+      _mm256_set1_ps(0.5f * pi));
+  const __m256 z = _mm256_mul_ps(t, t);
+
+  __m256 s = _mm256_fmadd_ps(z, _mm256_set1_ps(-1.9515295891e-4f),
+                             _mm256_set1_ps(8.3321608736e-3f));
+  s = _mm256_fmadd_ps(z, s, _mm256_set1_ps(-1.6666654611e-1f));
+  s = _mm256_fmadd_ps(_mm256_mul_ps(t, z), s, t);
+  __m256 c = _mm256_fmadd_ps(z, _mm256_set1_ps(2.443315711809948e-5f),
+                             _mm256_set1_ps(-1.388731625493765e-3f));
+  c = _mm256_fmadd_ps(z, c, _mm256_set1_ps(4.166664568298827e-2f));
+  c = _mm256_fmadd_ps(_mm256_mul_ps(z, z), c,
+                      _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z,
+                                       _mm256_set1_ps(1.0f)));
+
+  const __m256 odd = _mm256_castsi256_ps(_mm256_slli_epi32(y, 1));
+  const __m256 sign = _mm256_castsi256_ps(
+      _mm256_set1_epi32(static_cast<int>(0x80000000u)));
+  const __m256 cs = _mm256_blendv_ps(c, s, odd);
+  const __m256 sn = _mm256_blendv_ps(s, c, odd);
+  const __m256 flip_c = _mm256_and_ps(
+      _mm256_castsi256_ps(_mm256_xor_si256(y, _mm256_slli_epi32(y, 1))), sign);
+  const __m256 flip_s = _mm256_and_ps(_mm256_castsi256_ps(y), sign);
+  a = _mm256_mul_ps(r, _mm256_xor_ps(cs, flip_c));
+  b = _mm256_mul_ps(r, _mm256_xor_ps(sn, flip_s));
+}
+
+// The 32 elements of the eight blocks starting at block b, scaled by a and
+// shifted by c.
+__attribute__((target("avx2,fma")))
+void uniform8(const std::uint64_t b, const std::uint64_t key,
+              const std::uint64_t stream, const float a, const float c,
+              float* const out)
+{
+  __m256i x[4];
+  alignas(32) float v[4][8];
+  philox8(b, key, stream, x);
+  for(std::size_t k = 0; k < 4; ++k) {
+    const __m256 u = to_float(x[k], 0);
+    _mm256_store_ps(v[k], _mm256_fmadd_ps(u, _mm256_set1_ps(a),
+                                          _mm256_set1_ps(c)));
+  }
+  for(std::size_t i = 0; i < 8; ++i) {
+    for(std::size_t k = 0; k < 4; ++k) out[4 * i + k] = v[k][i];
+  }
+}
+
+__attribute__((target("avx2,fma")))
+void normal8(const std::uint64_t b, const std::uint64_t key,
+             const std::uint64_t stream, const float a, const float c,
+             float* const out)
+{
+  __m256i x[4];
+  __m256 z[4];
+  alignas(32) float v[4][8];
+  philox8(b, key, stream, x);
+  box_muller8(x[0], x[1], z[0], z[1]);
+  box_muller8(x[2], x[3], z[2], z[3]);
+  for(std::size_t k = 0; k < 4; ++k) {
+    _mm256_store_ps(v[k], _mm256_fmadd_ps(z[k], _mm256_set1_ps(a),
+                                          _mm256_set1_ps(c)));
+  }
+  for(std::size_t i = 0; i < 8; ++i) {
+    for(std::size_t k = 0; k < 4; ++k) out[4 * i + k] = v[k][i];
+  }
+}
+#endif
+
+// Calls f(g) for the groups of 32 elements covering n elements, eight
+// blocks of four floats or sixteen blocks of two doubles each. Groups are
+// fixed by the element index, so each element is produced by the same
+// code path for any thread count.
+template<typename F>
+void groups(const std::size_t n, const F& f)
+{
+  const std::size_t count = (n + 31) / 32;
+  internal::parallel_for(0, count, grain / 8, [&](const std::size_t first,
+                                                  const std::size_t last) {
+    for(std::size_t g = first; g < last; ++g) f(g);
+  });
+}
+
+}  // unnamed namespace
+
+// Generators
+Philox Philox::next()
+{ return Philox(global_seed.load(), global_stream.fetch_add(1)); }
+
+// Constructors and Destructor
+Philox::Philox(const std::uint64_t key, const std::uint64_t stream)
+  : key(key), stream(stream)
+{}
+
+// Utilities
+void Philox::block(const std::uint64_t index, std::uint32_t* const out) const
+{
+  out[0] = static_cast<std::uint32_t>(index);
+  out[1] = static_cast<std::uint32_t>(index >> 32);
+  out[2] = static_cast<std::uint32_t>(stream);
+  out[3] = static_cast<std::uint32_t>(stream >> 32);
+  philox(out, static_cast<std::uint32_t>(key),
+         static_cast<std::uint32_t>(key >> 32));
+}
+
+void Philox::uniform(float* const out, const std::size_t n,
+                     const float min, const float max) const
+{
+  const float scale = max - min;
+  groups(n, [&](const std::size_t g) {
+    const std::size_t first = 32 * g;
+#ifdef LAPLUS_AVX2
+    if(first + 32 <= n && internal::has_avx2()) {
+      uniform8(8 * g, key, stream, scale, min, out + first);
+      return;
+    }
+#endif
+    for(std::size_t b = 8 * g; b < 8 * g + 8 && 4 * b < n; ++b) {
+      std::uint32_t w[4];
+      block(b, w);
+      for(std::size_t k = 0; k < 4 && 4 * b + k < n; ++k) {
+        out[4 * b + k] = min + closed_open(w[k]) * scale;
+      }
+    }
+  });
+}
+
+void Philox::uniform(double* const out, const std::size_t n,
+                     const double min, const double max) const
+{
+  const double scale = max - min;
+  groups(n, [&](const std::size_t g) {
+    for(std::size_t b = 16 * g; b < 16 * g + 16 && 2 * b < n; ++b) {
+      std::uint32_t w[4];
+      block(b, w);
+      out[2 * b] = min + closed_open(w[0], w[1]) * scale;
+      if(2 * b + 1 < n) out[2 * b + 1] = min + closed_open(w[2], w[3]) * scale;
+    }
+  });
+}
+
+void Philox::normal(float* const out, const std::size_t n,
+                    const float mean, const float stddev) const
+{
+  groups(n, [&](const std::size_t g) {
+    const std::size_t first = 32 * g;
+#ifdef LAPLUS_AVX2
+    if(first + 32 <= n && internal::has_avx2()) {
+      normal8(8 * g, key, stream, stddev, mean, out + first);
+      return;
+    }
+#endif
+    for(std::size_t b = 8 * g; b < 8 * g + 8 && 4 * b < n; ++b) {
+      std::uint32_t w[4];
+      float z[4];
+      block(b, w);
+      box_muller(w[0], w[1], z[0], z[1]);
+      box_muller(w[2], w[3], z[2], z[3]);
+      for(std::size_t k = 0; k < 4 && 4 * b + k < n; ++k) {
+        out[4 * b + k] = mean + z[k] * stddev;
+      }
+    }
+  });
+}
+
+void Philox::normal(double* const out, const std::size_t n,
+                    const double mean, const double stddev) const
+{
+  groups(n, [&](const std::size_t g) {
+    for(std::size_t b = 16 * g; b < 16 * g + 16 && 2 * b < n; ++b) {
+      std::uint32_t w[4];
+      block(b, w);
+      const double r = std::sqrt(-2.0 * std::log(open_closed(w[0], w[1])));
+      const double t = 2.0 * M_PI * closed_open(w[2], w[3]);
+      out[2 * b] = mean + r * std::cos(t) * stddev;
+      if(2 * b + 1 < n) out[2 * b + 1] = mean + r * std::sin(t) * stddev;
+    }
+  });
+}
+
+void seed(const std::uint64_t value)
+{
+  global_seed.store(value);
+  global_stream.store(0);
+}
+
+}  // namespace laplus
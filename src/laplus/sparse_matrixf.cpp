@@ -0,0 +1,581 @@
+/******************************************************************************
+ *
+ * laplus/sparse_matrixf.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/sparse_matrixf.hpp"
+#include "laplus/internal/parallel.hpp"
+#include "laplus/internal/simd.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <vector>
+
+#include <immintrin.h>
+
+namespace laplus {
+
+namespace {
+
+struct View {
+  float* data;
+  std::size_t rs;
+  std::size_t cs;
+};
+
+View view(const Matrixf& matrix)
+{
+  if(matrix.layout() == CblasRowMajor)
+    return View{matrix.data(), matrix.ldim(), 1};
+  return View{matrix.data(), 1, matrix.ldim()};
+}
+
+void scale(const std::size_t n, const float beta,
+           float* const y, const std::size_t incy)
+{
+  if(beta == 1.0) return;
+  if(beta == 0.0) {
+    for(std::size_t i = 0; i < n; ++i) y[i * incy] = 0.0;
+  } else {
+    for(std::size_t i = 0; i < n; ++i) y[i * incy] *= beta;
+  }
+}
+
+void axpy(const std::size_t n, const float alpha,
+          const float* const x, const std::size_t incx,
+          float* const y, const std::size_t incy)
+{
+  std::size_t i = 0;
+  if(incx == 1 && incy == 1) {
+    const __m256 a = _mm256_set1_ps(alpha);
+    for(; i + 8 <= n; i += 8) {
+      __m256 v0 = _mm256_loadu_ps(x + i);
+      __m256 v1 = _mm256_loadu_ps(y + i);
+      _mm256_storeu_ps(y + i, _mm256_add_ps(v1, _mm256_mul_ps(a, v0)));
+    }
+  }
+  for(; i < n; ++i) y[i * incy] += alpha * x[i * incx];
+}
+
+#ifdef LAPLUS_AVX2
+__attribute__((target("avx2,fma")))
+std::size_t gather_dot_avx2(const std::int32_t* const index,
+                            const float* const value, const std::size_t n,
+                            const float* const x, float& sum)
+{
+  std::size_t p = 0;
+  __m256 acc = _mm256_setzero_ps();
+  for(; p + 8 <= n; p += 8) {
+    __m256i i0 = _mm256_loadu_si256((const __m256i*)(index + p));
+    __m256 v0 = _mm256_loadu_ps(value + p);
+    __m256 x0 = _mm256_i32gather_ps(x, i0, 4);
+    acc = _mm256_fmadd_ps(v0, x0, acc);
+  }
+  __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc),
+                           _mm256_extractf128_ps(acc, 1));
+  half = _mm_hadd_ps(half, half);
+  half = _mm_hadd_ps(half, half);
+  sum = _mm_cvtss_f32(half);
+  return p;
+}
+#endif
+
+float gather_dot(const std::int32_t* const index, const float* const value,
+                 const std::size_t n, const float* const x,
+                 const std::size_t incx)
+{
+  std::size_t p = 0;
+  float sum = 0.0;
+#ifdef LAPLUS_AVX2
+  if(incx == 1 && internal::has_avx2())
+    p = gather_dot_avx2(index, value, n, x, sum);
+#endif
+  for(; p < n; ++p) sum += value[p] * x[index[p] * incx];
+  return sum;
+}
+
+// Splits [0, major) into parts carrying roughly the same number of stored
+// entries, counting every row or column as one unit of work as well.
+std::vector<std::size_t> balance(const std::size_t* const indptr,
+                                 const std::size_t major)
+{
+  const std::size_t work = indptr[major] + major;
+  std::size_t parts = internal::concurrency() * 4;
+  if(work < 16384 || internal::concurrency() == 1) parts = 1;
+  std::vector<std::size_t> bounds(parts + 1, major);
+  bounds[0] = 0;
+  for(std::size_t t = 1; t < parts; ++t) {
+    const std::size_t target = work * t / parts;
+    std::size_t lo = bounds[t - 1];
+    std::size_t hi = major;
+    while(lo < hi) {
+      const std::size_t mid = (lo + hi) / 2;
+      if(indptr[mid] + mid < target) lo = mid + 1;
+      else hi = mid;
+    }
+    bounds[t] = lo;
+  }
+  return bounds;
+}
+
+void parallel_major(const std::size_t* const indptr, const std::size_t major,
+                    const std::function<void(const std::size_t,
+                                             const std::size_t)>& body)
+{
+  const std::vector<std::size_t> bounds = balance(indptr, major);
+  internal::parallel_run(bounds.size() - 1, [&](const std::size_t t) {
+    body(bounds[t], bounds[t + 1]);
+  });
+}
+
+}  // unnamed namespace
+
+// Constructors and Destructor
+SparseMatrixf::SparseMatrixf(const std::size_t rows, const std::size_t cols,
+                             const SparseFormat format)
+  : SparseMatrixf(rows, cols, format, 0)
+{}
+
+SparseMatrixf::SparseMatrixf(const std::size_t rows, const std::size_t cols,
+                             const SparseFormat format, const std::size_t nnz)
+  : shape(rows, cols), storage(format)
+  , offsets((format == CSR ? rows : cols) + 1), positions(nnz), entries(nnz)
+{
+  // Minor indices are stored as 32 bit integers.
+  assert(minor() <= static_cast<std::size_t>(
+           std::numeric_limits<std::int32_t>::max()));
+}
+
+SparseMatrixf::SparseMatrixf(const std::size_t rows, const std::size_t cols,
+                             const std::vector<Triplet>& triplets,
+                             const SparseFormat format)
+  : SparseMatrixf(rows, cols, format, 0)
+{
+  const std::size_t n_major = major();
+  const std::size_t n_minor = minor();
+  auto major_of = [format](const Triplet& t)
+  { return format == CSR ? t.row : t.col; };
+  auto minor_of = [format](const Triplet& t)
+  { return format == CSR ? t.col : t.row; };
+
+  // Two stable counting sorts order the entries by (major, minor).
+  std::vector<std::size_t> count(std::max(n_major, n_minor) + 1);
+  std::vector<std::size_t> by_minor(triplets.size());
+  std::vector<std::size_t> order(triplets.size());
+  for(const Triplet& t: triplets) {
+    assert(t.row < rows && t.col < cols);
+    ++count[minor_of(t) + 1];
+  }
+  for(std::size_t i = 0; i < n_minor; ++i) count[i + 1] += count[i];
+  for(std::size_t i = 0; i < triplets.size(); ++i) {
+    by_minor[count[minor_of(triplets[i])]++] = i;
+  }
+  std::fill(count.begin(), count.end(), 0);
+  for(const Triplet& t: triplets) ++count[major_of(t) + 1];
+  for(std::size_t i = 0; i < n_major; ++i) count[i + 1] += count[i];
+  for(const std::size_t i: by_minor) {
+    order[count[major_of(triplets[i])]++] = i;
+  }
+
+  // Duplicate coordinates are summed.
+  std::size_t nnz = 0;
+  for(std::size_t k = 0; k < order.size(); ++k) {
+    if(k == 0 || major_of(triplets[order[k]]) != major_of(triplets[order[k - 1]])
+    || minor_of(triplets[order[k]]) != minor_of(triplets[order[k - 1]])) ++nnz;
+  }
+  SparseMatrixf result(rows, cols, format, nnz);
+  std::size_t* const indptr = result.offsets.get();
+  std::int32_t* const index = result.positions.get();
+  float* const value = result.entries.get();
+  std::size_t p = 0;
+  for(std::size_t k = 0; k < order.size(); ++k) {
+    const Triplet& t = triplets[order[k]];
+    if(k != 0 && major_of(t) == major_of(triplets[order[k - 1]])
+    && minor_of(t) == minor_of(triplets[order[k - 1]])) {
+      value[p - 1] += t.value;
+      continue;
+    }
+    ++indptr[major_of(t) + 1];
+    index[p] = static_cast<std::int32_t>(minor_of(t));
+    value[p] = t.value;
+    ++p;
+  }
+  for(std::size_t i = 0; i < n_major; ++i) indptr[i + 1] += indptr[i];
+  *this = std::move(result);
+}
+
+SparseMatrixf::SparseMatrixf(const Matrixf& matrix, const SparseFormat format)
+  : SparseMatrixf(matrix.rows(), matrix.cols(), format, 0)
+{
+  const std::size_t n_major = major();
+  const std::size_t n_minor = minor();
+  auto at = [&](const std::size_t i, const std::size_t j)
+  { return format == CSR ? matrix(i, j) : matrix(j, i); };
+
+  std::size_t nnz = 0;
+  for(std::size_t i = 0; i < n_major; ++i) {
+    for(std::size_t j = 0; j < n_minor; ++j) {
+      if(at(i, j) != 0.0) ++nnz;
+    }
+  }
+  SparseMatrixf result(rows(), cols(), format, nnz);
+  std::size_t* const indptr = result.offsets.get();
+  std::int32_t* const index = result.positions.get();
+  float* const value = result.entries.get();
+  std::size_t p = 0;
+  for(std::size_t i = 0; i < n_major; ++i) {
+    for(std::size_t j = 0; j < n_minor; ++j) {
+      const float v = at(i, j);
+      if(v == 0.0) continue;
+      index[p] = static_cast<std::int32_t>(j);
+      value[p] = v;
+      ++p;
+    }
+    indptr[i + 1] = p;
+  }
+  *this = std::move(result);
+}
+
+SparseMatrixf::SparseMatrixf(const SparseMatrixf& other)
+  : shape(other.shape), storage(other.storage)
+  , offsets(other.offsets), positions(other.positions), entries(other.entries)
+{}
+
+SparseMatrixf::SparseMatrixf(SparseMatrixf&& other) noexcept
+  : shape(other.shape), storage(other.storage)
+  , offsets(std::move(other.offsets)), positions(std::move(other.positions))
+  , entries(std::move(other.entries))
+{ other.shape = std::make_pair(0, 0); }
+
+SparseMatrixf::~SparseMatrixf() {}
+
+// Assignment Operators
+SparseMatrixf& SparseMatrixf::operator=(const SparseMatrixf& other)
+{
+  SparseMatrixf another(other);
+  *this = std::move(another);
+  return *this;
+}
+
+SparseMatrixf& SparseMatrixf::operator=(SparseMatrixf&& other) noexcept
+{
+  using std::swap;
+  swap(*this, other);
+  return *this;
+}
+
+// Miscellaneous Operators
+const float SparseMatrixf::operator()(const std::size_t i,
+                                      const std::size_t j) const
+{
+  assert(i < rows() && j < cols());
+  const std::size_t m = (storage == CSR) ? i : j;
+  const std::int32_t n = static_cast<std::int32_t>((storage == CSR) ? j : i);
+  const std::int32_t* const first = indices() + indptr()[m];
+  const std::int32_t* const last = indices() + indptr()[m + 1];
+  const std::int32_t* const found = std::lower_bound(first, last, n);
+  if(found == last || *found != n) return 0.0;
+  return values()[found - indices()];
+}
+
+std::ostream& operator<<(std::ostream& ostream, const SparseMatrixf& matrix)
+{ return ostream << matrix.dense(); }
+
+// Utilities
+void swap(SparseMatrixf& a, SparseMatrixf& b)
+{
+  using std::swap;
+  swap(a.shape, b.shape);
+  swap(a.storage, b.storage);
+  swap(a.offsets, b.offsets);
+  swap(a.positions, b.positions);
+  swap(a.entries, b.entries);
+}
+
+SparseMatrixf SparseMatrixf::clone() const
+{
+  SparseMatrixf result(rows(), cols(), storage, nnz());
+  std::copy(indptr(), indptr() + major() + 1, result.offsets.get());
+  std::copy(indices(), indices() + nnz(), result.positions.get());
+  std::copy(values(), values() + nnz(), result.entries.get());
+  return result;
+}
+
+SparseMatrixf SparseMatrixf::transpose() const
+{
+  SparseMatrixf result(*this);
+  result.shape = std::make_pair(shape.second, shape.first);
+  result.storage = (storage == CSR) ? CSC : CSR;
+  return result;
+}
+
+SparseMatrixf SparseMatrixf::convert(const SparseFormat format) const
+{
+  if(format == storage) return *this;
+  const std::size_t n_major = major();
+  const std::size_t n_minor = minor();
+  SparseMatrixf result(rows(), cols(), format, nnz());
+  std::size_t* const indptr = result.offsets.get();
+  std::int32_t* const index = result.positions.get();
+  float* const value = result.entries.get();
+  for(std::size_t p = 0; p < nnz(); ++p) ++indptr[indices()[p] + 1];
+  for(std::size_t j = 0; j < n_minor; ++j) indptr[j + 1] += indptr[j];
+  std::vector<std::size_t> cursor(indptr, indptr + n_minor);
+  for(std::size_t i = 0; i < n_major; ++i) {
+    for(std::size_t p = this->indptr()[i]; p < this->indptr()[i + 1]; ++p) {
+      const std::size_t q = cursor[indices()[p]]++;
+      index[q] = static_cast<std::int32_t>(i);
+      value[q] = values()[p];
+    }
+  }
+  return result;
+}
+
+Matrixf SparseMatrixf::dense() const
+{
+  Matrixf result(rows(), cols());
+  for(std::size_t i = 0; i < major(); ++i) {
+    for(std::size_t p = indptr()[i]; p < indptr()[i + 1]; ++p) {
+      if(storage == CSR) result(i, indices()[p]) = values()[p];
+      else result(indices()[p], i) = values()[p];
+    }
+  }
+  return result;
+}
+
+// Accessors
+const std::size_t SparseMatrixf::rows() const
+{ return shape.first; }
+
+const std::size_t SparseMatrixf::cols() const
+{ return shape.second; }
+
+const std::size_t SparseMatrixf::nnz() const
+{ return entries.size(); }
+
+const SparseFormat SparseMatrixf::format() const
+{ return storage; }
+
+const std::size_t* const SparseMatrixf::indptr() const
+{ return offsets.get(); }
+
+const std::int32_t* const SparseMatrixf::indices() const
+{ return positions.get(); }
+
+float* const SparseMatrixf::values() const
+{ return entries.get(); }
+
+const std::size_t SparseMatrixf::major() const
+{ return (storage == CSR) ? shape.first : shape.second; }
+
+const std::size_t SparseMatrixf::minor() const
+{ return (storage == CSR) ? shape.second : shape.first; }
+
+// Sparse BLAS
+void SparseMatrixf::spmv(const float alpha, const Vectorf& x,
+                         const float beta, const Vectorf& y) const
+{
+  assert(x.size() == cols());
+  assert(y.size() == rows());
+  const std::size_t* const indptr = this->indptr();
+  const std::int32_t* const index = this->indices();
+  const float* const value = this->values();
+  const float* const px = x.data();
+  float* const py = y.data();
+  const std::size_t incx = x.inc();
+  const std::size_t incy = y.inc();
+
+  if(storage == CSR) {
+    parallel_major(indptr, rows(), [&](const std::size_t first,
+                                       const std::size_t last) {
+      for(std::size_t i = first; i < last; ++i) {
+        const float sum = gather_dot(index + indptr[i], value + indptr[i],
+                                     indptr[i + 1] - indptr[i], px, incx);
+        py[i * incy] = alpha * sum
+                     + (beta == 0.0 ? 0.0f : beta * py[i * incy]);
+      }
+    });
+    return;
+  }
+
+  // Columns scatter into y, so every worker accumulates into its own buffer
+  // and the partial results are reduced afterwards.
+  scale(rows(), beta, py, incy);
+  const std::vector<std::size_t> bounds = balance(indptr, cols());
+  const std::size_t parts = bounds.size() - 1;
+  if(parts == 1) {
+    for(std::size_t j = 0; j < cols(); ++j) {
+      const float a = alpha * px[j * incx];
+      for(std::size_t p = indptr[j]; p < indptr[j + 1]; ++p) {
+        py[index[p] * incy] += a * value[p];
+      }
+    }
+    return;
+  }
+  std::vector<float> partial(parts * rows());
+  internal::parallel_run(parts, [&](const std::size_t t) {
+    float* const acc = partial.data() + t * rows();
+    for(std::size_t j = bounds[t]; j < bounds[t + 1]; ++j) {
+      const float a = alpha * px[j * incx];
+      for(std::size_t p = indptr[j]; p < indptr[j + 1]; ++p) {
+        acc[index[p]] += a * value[p];
+      }
+    }
+  });
+  internal::parallel_for(0, rows(), 4096, [&](const std::size_t first,
+                                               const std::size_t last) {
+    for(std::size_t t = 0; t < parts; ++t) {
+      const float* const acc = partial.data() + t * rows();
+      for(std::size_t i = first; i < last; ++i) py[i * incy] += acc[i];
+    }
+  });
+}
+
+void SparseMatrixf::spmm(const CBLAS_SIDE side, const float alpha,
+                         const Matrixf& B, const float beta,
+                         const Matrixf& C) const
+{
+  const std::size_t* const indptr = this->indptr();
+  const std::int32_t* const index = this->indices();
+  const float* const value = this->values();
+  const View b = view(B);
+  const View c = view(C);
+
+  if(side == CblasLeft) {
+    // C = alpha * A * B + beta * C
+    assert(rows() == C.rows());
+    assert(cols() == B.rows());
+    assert(B.cols() == C.cols());
+    const std::size_t n = C.cols();
+
+    if(storage == CSR) {
+      parallel_major(indptr, rows(), [&](const std::size_t first,
+                                         const std::size_t last) {
+        for(std::size_t i = first; i < last; ++i) {
+          float* const ci = c.data + i * c.rs;
+          scale(n, beta, ci, c.cs);
+          for(std::size_t p = indptr[i]; p < indptr[i + 1]; ++p) {
+            axpy(n, alpha * value[p], b.data + index[p] * b.rs, b.cs,
+                 ci, c.cs);
+          }
+        }
+      });
+      return;
+    }
+
+    // Columns of A scatter into rows of C. Wide outputs are split by
+    // column blocks; narrow ones are regrouped by row first so the rows of
+    // C can be distributed without write conflicts.
+    const std::size_t block = 64;
+    const std::size_t blocks = (n + block - 1) / block;
+    if(blocks < internal::concurrency() && nnz() >= 16384) {
+      convert(CSR).spmm(side, alpha, B, beta, C);
+      return;
+    }
+    internal::parallel_run(blocks, [&](const std::size_t t) {
+      const std::size_t first = t * block;
+      const std::size_t width = std::min(n, first + block) - first;
+      for(std::size_t i = 0; i < rows(); ++i) {
+        scale(width, beta, c.data + i * c.rs + first * c.cs, c.cs);
+      }
+      for(std::size_t j = 0; j < cols(); ++j) {
+        const float* const bj = b.data + j * b.rs + first * b.cs;
+        for(std::size_t p = indptr[j]; p < indptr[j + 1]; ++p) {
+          axpy(width, alpha * value[p], bj, b.cs,
+               c.data + index[p] * c.rs + first * c.cs, c.cs);
+        }
+      }
+    });
+    return;
+  }
+
+  // C = alpha * B * A + beta * C
+  assert(B.rows() == C.rows());
+  assert(B.cols() == rows());
+  assert(cols() == C.cols());
+  const std::size_t m = C.rows();
+  const std::size_t n = C.cols();
+  const std::size_t k = rows();
+
+  if(storage == CSR) {
+    internal::parallel_for(0, m, 16, [&](const std::size_t first,
+                                         const std::size_t last) {
+      for(std::size_t i = first; i < last; ++i) {
+        float* const ci = c.data + i * c.rs;
+        const float* const bi = b.data + i * b.rs;
+        scale(n, beta, ci, c.cs);
+        for(std::size_t l = 0; l < k; ++l) {
+          const float a = alpha * bi[l * b.cs];
+          if(a == 0.0) continue;
+          for(std::size_t p = indptr[l]; p < indptr[l + 1]; ++p) {
+            ci[index[p] * c.cs] += a * value[p];
+          }
+        }
+      }
+    });
+    return;
+  }
+
+  internal::parallel_for(0, m, 16, [&](const std::size_t first,
+                                       const std::size_t last) {
+    for(std::size_t i = first; i < last; ++i) {
+      float* const ci = c.data + i * c.rs;
+      const float* const bi = b.data + i * b.rs;
+      for(std::size_t j = 0; j < n; ++j) {
+        const float sum = gather_dot(index + indptr[j], value + indptr[j],
+                                     indptr[j + 1] - indptr[j], bi, b.cs);
+        ci[j * c.cs] = alpha * sum
+                     + (beta == 0.0 ? 0.0f : beta * ci[j * c.cs]);
+      }
+    }
+  });
+}
+
+// Linear Algebra
+Vectorf SparseMatrixf::dot(const Vectorf& x) const
+{
+  Vectorf result(rows());
+  spmv(1.0, x, 0.0, result);
+  return result;
+}
+
+Matrixf SparseMatrixf::dot(const Matrixf& B) const
+{
+  Matrixf result(rows(), B.cols());
+  spmm(CblasLeft, 1.0, B, 0.0, result);
+  return result;
+}
+
+Matrixf dot(const Matrixf& B, const SparseMatrixf& A)
+{
+  Matrixf result(B.rows(), A.cols());
+  A.spmm(CblasRight, 1.0, B, 0.0, result);
+  return result;
+}
+
+}  // namespace laplus
@@ -0,0 +1,315 @@
+/******************************************************************************
+ *
+ * laplus/strassen.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/strassen.hpp"
+#include "laplus/internal/parallel.hpp"
+#include "laplus/internal/simd.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace laplus {
+
+namespace {
+
+using simd = internal::simd<float>;
+
+const std::size_t width = simd::width;
+const std::size_t default_cutoff = 1024;
+
+// A block of a row-major matrix.
+struct Block {
+  float* data;
+  std::size_t ld;
+
+  Block at(const std::size_t i, const std::size_t j) const
+  { return Block{data + i * ld + j, ld}; }
+};
+
+// z = x + sign * y over rows x cols blocks. z may alias x or y.
+void combine(const std::size_t rows, const std::size_t cols,
+             const Block x, const Block y, const Block z, const float sign)
+{
+  const simd::type vsign = simd::set1(sign);
+  const std::size_t chunk =
+    std::max<std::size_t>(1, internal::grain / (cols + 1));
+  internal::parallel_for(0, rows, chunk, [&](const std::size_t first,
+                                             const std::size_t last) {
+    for(std::size_t i = first; i < last; ++i) {
+      const float* const xi = x.data + i * x.ld;
+      const float* const yi = y.data + i * y.ld;
+      float* const zi = z.data + i * z.ld;
+      std::size_t j = 0;
+      for(; j + width <= cols; j += width) {
+        simd::store(zi + j, simd::add(simd::load(xi + j),
+                                      simd::mul(vsign, simd::load(yi + j))));
+      }
+      for(; j < cols; ++j) zi[j] = xi[j] + sign * yi[j];
+    }
+  });
+}
+
+void add(const std::size_t rows, const std::size_t cols,
+         const Block x, const Block y, const Block z)
+{ combine(rows, cols, x, y, z, 1.0f); }
+
+void sub(const std::size_t rows, const std::size_t cols,
+         const Block x, const Block y, const Block z)
+{ combine(rows, cols, x, y, z, -1.0f); }
+
+const bool is_leaf(const std::size_t m, const std::size_t k,
+                   const std::size_t n, const std::size_t cutoff)
+{ return std::min(std::min(m, k), n) <= std::max<std::size_t>(cutoff, 1); }
+
+// Floats of workspace the sequential schedule needs below m x k x n.
+const std::size_t sequential(const std::size_t m, const std::size_t k,
+                             const std::size_t n, const std::size_t cutoff)
+{
+  if(is_leaf(m, k, n, cutoff)) return 0;
+  const std::size_t mh = m / 2, kh = k / 2, nh = n / 2;
+  return mh * std::max(kh, nh) + kh * nh + sequential(mh, kh, nh, cutoff);
+}
+
+// The same for the parallel top level: eight operand sums, three products
+// and the private workspace of seven sequential subproducts.
+const std::size_t concurrent(const std::size_t m, const std::size_t k,
+                             const std::size_t n, const std::size_t cutoff)
+{
+  if(is_leaf(m, k, n, cutoff)) return 0;
+  const std::size_t mh = m / 2, kh = k / 2, nh = n / 2;
+  return 4 * mh * kh + 4 * kh * nh + 3 * mh * nh
+    + 7 * sequential(mh, kh, nh, cutoff);
+}
+
+void multiply(const std::size_t, const std::size_t, const std::size_t,
+              const Block, const Block, const Block, float* const,
+              const std::size_t, const bool);
+
+// The even part of the product, with the schedule of Boyer, Dumas, Pernet
+// and Zhou that needs two temporaries per level: X holds a quadrant of a,
+// then one of c, and Y a quadrant of b.
+void winograd(const std::size_t mh, const std::size_t kh,
+              const std::size_t nh, const Block a, const Block b,
+              const Block c, float* const work, const std::size_t cutoff)
+{
+  const Block a11 = a, a12 = a.at(0, kh), a21 = a.at(mh, 0);
+  const Block a22 = a.at(mh, kh);
+  const Block b11 = b, b12 = b.at(0, nh), b21 = b.at(kh, 0);
+  const Block b22 = b.at(kh, nh);
+  const Block c11 = c, c12 = c.at(0, nh), c21 = c.at(mh, 0);
+  const Block c22 = c.at(mh, nh);
+  const Block xa = {work, kh};
+  const Block xc = {work, nh};
+  const Block y = {work + mh * std::max(kh, nh), nh};
+  float* const next = y.data + kh * nh;
+
+  sub(mh, kh, a11, a21, xa);                              // S3
+  sub(kh, nh, b22, b12, y);                               // T3
+  multiply(mh, kh, nh, xa, y, c21, next, cutoff, false);  // P7
+  add(mh, kh, a21, a22, xa);                              // S1
+  sub(kh, nh, b12, b11, y);                               // T1
+  multiply(mh, kh, nh, xa, y, c22, next, cutoff, false);  // P5
+  sub(mh, kh, xa, a11, xa);                               // S2
+  sub(kh, nh, b22, y, y);                                 // T2
+  multiply(mh, kh, nh, xa, y, c12, next, cutoff, false);  // P6
+  sub(mh, kh, a12, xa, xa);                               // S4
+  multiply(mh, kh, nh, xa, b22, c11, next, cutoff, false);  // P3
+  multiply(mh, kh, nh, a11, b11, xc, next, cutoff, false);  // P1
+  add(mh, nh, xc, c12, c12);                              // U2
+  add(mh, nh, c12, c21, c21);                             // U3
+  add(mh, nh, c12, c22, c12);                             // U4
+  add(mh, nh, c21, c22, c22);                             // U7
+  add(mh, nh, c12, c11, c12);                             // U5
+  sub(kh, nh, y, b21, y);                                 // T4
+  multiply(mh, kh, nh, a22, y, c11, next, cutoff, false);  // P4
+  sub(mh, nh, c21, c11, c21);                             // U6
+  multiply(mh, kh, nh, a12, b21, c11, next, cutoff, false);  // P2
+  add(mh, nh, xc, c11, c11);                              // U1
+}
+
+// The seven products of one level computed concurrently, each subproduct
+// recursing sequentially in its own share of the workspace.
+void winograd_parallel(const std::size_t mh, const std::size_t kh,
+                       const std::size_t nh, const Block a, const Block b,
+                       const Block c, float* const work,
+                       const std::size_t cutoff)
+{
+  const Block a11 = a, a12 = a.at(0, kh), a21 = a.at(mh, 0);
+  const Block a22 = a.at(mh, kh);
+  const Block b11 = b, b12 = b.at(0, nh), b21 = b.at(kh, 0);
+  const Block b22 = b.at(kh, nh);
+  const Block c11 = c, c12 = c.at(0, nh), c21 = c.at(mh, 0);
+  const Block c22 = c.at(mh, nh);
+
+  float* p = work;
+  const auto take = [&p](const std::size_t rows, const std::size_t cols) {
+    const Block block = {p, cols};
+    p += rows * cols;
+    return block;
+  };
+  const Block s1 = take(mh, kh), s2 = take(mh, kh);
+  const Block s3 = take(mh, kh), s4 = take(mh, kh);
+  const Block t1 = take(kh, nh), t2 = take(kh, nh);
+  const Block t3 = take(kh, nh), t4 = take(kh, nh);
+  const Block p1 = take(mh, nh), p3 = take(mh, nh), p4 = take(mh, nh);
+  const std::size_t share = sequential(mh, kh, nh, cutoff);
+
+  add(mh, kh, a21, a22, s1);
+  sub(mh, kh, s1, a11, s2);
+  sub(mh, kh, a11, a21, s3);
+  sub(mh, kh, a12, s2, s4);
+  sub(kh, nh, b12, b11, t1);
+  sub(kh, nh, b22, t1, t2);
+  sub(kh, nh, b22, b12, t3);
+  sub(kh, nh, t2, b21, t4);
+
+  const Block lhs[] = {a11, a12, s4, a22, s1, s2, s3};
+  const Block rhs[] = {b11, b21, b22, t4, t1, t2, t3};
+  const Block out[] = {p1, c11, p3, p4, c22, c12, c21};
+  internal::parallel_run(7, [&](const std::size_t i) {
+    multiply(mh, kh, nh, lhs[i], rhs[i], out[i], p + i * share, cutoff,
+             false);
+  });
+
+  add(mh, nh, c11, p1, c11);  // U1
+  add(mh, nh, c12, p1, c12);  // U2
+  add(mh, nh, c21, c12, c21);  // U3
+  add(mh, nh, c12, c22, c12);  // U4
+  add(mh, nh, c22, c21, c22);  // U7
+  add(mh, nh, c12, p3, c12);  // U5
+  sub(mh, nh, c21, p4, c21);  // U6
+}
+
+// c = a b for an m x k a and a k x n b.
+void multiply(const std::size_t m, const std::size_t k, const std::size_t n,
+              const Block a, const Block b, const Block c, float* const work,
+              const std::size_t cutoff, const bool parallel)
+{
+  if(is_leaf(m, k, n, cutoff)) {
+    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, m, n, k,
+                1.0f, a.data, a.ld, b.data, b.ld, 0.0f, c.data, c.ld);
+    return;
+  }
+
+  const std::size_t mh = m / 2, kh = k / 2, nh = n / 2;
+  if(parallel) winograd_parallel(mh, kh, nh, a, b, c, work, cutoff);
+  else winograd(mh, kh, nh, a, b, c, work, cutoff);
+
+  // Dynamic peeling of the odd row, column and inner index.
+  const std::size_t m2 = 2 * mh, k2 = 2 * kh, n2 = 2 * nh;
+  if(k2 < k) {
+    cblas_sger(CblasRowMajor, m2, n2, 1.0f, a.data + k2, a.ld,
+               b.data + k2 * b.ld, 1, c.data, c.ld);
+  }
+  if(n2 < n) {
+    cblas_sgemv(CblasRowMajor, CblasNoTrans, m, k, 1.0f, a.data, a.ld,
+                b.data + n2, b.ld, 0.0f, c.data + n2, c.ld);
+  }
+  if(m2 < m) {
+    cblas_sgemv(CblasRowMajor, CblasTrans, k, n2, 1.0f, b.data, b.ld,
+                a.data + m2 * a.ld, 1, 0.0f, c.data + m2 * c.ld, 1);
+  }
+}
+
+}  // unnamed namespace
+
+// Constructors and Destructor
+Strassen::Strassen() : leaf(default_cutoff), parallel(true) {}
+
+Strassen::Strassen(const std::size_t cutoff, const bool concurrent)
+  : leaf(cutoff), parallel(concurrent)
+{}
+
+// Multiplication
+void Strassen::gemm(const float alpha, const Matrixf& a, const Matrixf& b,
+                    const float beta, Matrixf& c)
+{
+  assert(a.cols() == b.rows());
+  assert(c.rows() == a.rows() && c.cols() == b.cols());
+  assert(c.layout() == CblasRowMajor && c.inc() == 1);
+  const std::size_t m = a.rows(), k = a.cols(), n = b.cols();
+  if(m == 0 || n == 0) return;
+  if(k == 0) {
+    if(beta == 0.0f) {
+      for(std::size_t i = 0; i < m; ++i)
+        std::fill(c.data() + i * c.ldim(), c.data() + i * c.ldim() + n, 0.0f);
+    } else {
+      c *= beta;
+    }
+    return;
+  }
+  const Matrixf A = a.row_major();
+  const Matrixf B = b.row_major();
+
+  const bool split = parallel && internal::concurrency() > 1;
+  const bool direct = (alpha == 1.0f && beta == 0.0f);
+  const std::size_t scratch = split ? concurrent(m, k, n, leaf)
+                                    : sequential(m, k, n, leaf);
+  const std::size_t need = scratch + (direct ? 0 : m * n);
+  if(pool.size() < need) pool.resize(need);
+
+  float* const product = direct ? c.data() : pool.data() + scratch;
+  multiply(m, k, n, Block{const_cast<float*>(A.data()), k},
+           Block{const_cast<float*>(B.data()), n}, Block{product, n},
+           pool.data(), leaf, split);
+  if(direct) return;
+
+  float* const out = c.data();
+  internal::parallel_for(0, m * n, internal::grain, [&](
+      const std::size_t first, const std::size_t last) {
+    if(beta == 0.0f) {
+      for(std::size_t i = first; i < last; ++i) out[i] = alpha * product[i];
+    } else {
+      for(std::size_t i = first; i < last; ++i)
+        out[i] = alpha * product[i] + beta * out[i];
+    }
+  });
+}
+
+Matrixf Strassen::dot(const Matrixf& a, const Matrixf& b)
+{
+  Matrixf c(a.rows(), b.cols());
+  gemm(1.0f, a, b, 0.0f, c);
+  return c;
+}
+
+// Accessors
+const std::size_t Strassen::cutoff() const
+{ return leaf; }
+
+void Strassen::set_cutoff(const std::size_t cutoff)
+{ leaf = cutoff; }
+
+const std::size_t Strassen::workspace() const
+{ return pool.size(); }
+
+void Strassen::release()
+{ std::vector<float>().swap(pool); }
+
+}  // namespace laplus
@@ -0,0 +1,754 @@
+/******************************************************************************
+ *
+ * laplus/tensor.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/tensor.hpp"
+#include "laplus/internal/parallel.hpp"
+#include "laplus/internal/simd.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace laplus {
+
+namespace {
+
+template<typename T>
+using simd = internal::simd<T>;
+
+const std::size_t product(const dims_t& dims)
+{
+  std::size_t n = 1;
+  for(std::size_t d: dims) n *= d;
+  return n;
+}
+
+// Row-major strides of a densely packed tensor.
+dims_t packed(const dims_t& dims)
+{
+  dims_t steps(dims.size());
+  std::size_t s = 1;
+  for(std::size_t i = dims.size(); i > 0; --i) {
+    steps[i - 1] = s;
+    s *= dims[i - 1];
+  }
+  return steps;
+}
+
+// Strides that address a tensor of the given shape and strides with a new
+// shape without moving any element, or an empty vector if some group of
+// merged axes is not laid out contiguously.
+dims_t restride(const dims_t& shape, const dims_t& steps, const dims_t& dims)
+{
+  dims_t o;
+  dims_t os;
+  for(std::size_t i = 0; i < shape.size(); ++i) {
+    if(shape[i] != 1) {
+      o.push_back(shape[i]);
+      os.push_back(steps[i]);
+    }
+  }
+
+  dims_t result(dims.size(), 1);
+  std::size_t oi = 0, oj = 1, ni = 0, nj = 1;
+  while(ni < dims.size() && oi < o.size()) {
+    std::size_t np = dims[ni];
+    std::size_t op = o[oi];
+    while(np != op) {
+      if(np < op) np *= dims[nj++];
+      else op *= o[oj++];
+    }
+    for(std::size_t k = oi; k + 1 < oj; ++k) {
+      if(os[k] != o[k + 1] * os[k + 1]) return dims_t();
+    }
+    result[nj - 1] = os[oj - 1];
+    for(std::size_t k = nj - 1; k > ni; --k) {
+      result[k - 1] = result[k] * dims[k];
+    }
+    ni = nj++;
+    oi = oj++;
+  }
+  return result;
+}
+
+// Elementwise operators in scalar and packed form.
+template<typename T>
+struct Assign {
+  using V = typename simd<T>::type;
+  static T apply(const T, const T y) { return y; }
+  static V apply(const V, const V y) { return y; }
+};
+
+template<typename T>
+struct Add {
+  using V = typename simd<T>::type;
+  static T apply(const T x, const T y) { return x + y; }
+  static V apply(const V x, const V y) { return simd<T>::add(x, y); }
+};
+
+template<typename T>
+struct Sub {
+  using V = typename simd<T>::type;
+  static T apply(const T x, const T y) { return x - y; }
+  static V apply(const V x, const V y) { return simd<T>::sub(x, y); }
+};
+
+template<typename T>
+struct Mul {
+  using V = typename simd<T>::type;
+  static T apply(const T x, const T y) { return x * y; }
+  static V apply(const V x, const V y) { return simd<T>::mul(x, y); }
+};
+
+template<typename T>
+struct Div {
+  using V = typename simd<T>::type;
+  static T apply(const T x, const T y) { return x / y; }
+  static V apply(const V x, const V y) { return simd<T>::div(x, y); }
+};
+
+// x[i * sx] = op(x[i * sx], y[i * sy]) for i in [0, n).
+template<typename T, typename Op>
+void line(T* x, const std::size_t sx,
+          const T* y, const std::size_t sy, const std::size_t n)
+{
+  const std::size_t w = simd<T>::width;
+  std::size_t i = 0;
+  if(sx == 1 && sy == 1) {
+    for(; i + w <= n; i += w) {
+      simd<T>::store(x + i, Op::apply(simd<T>::load(x + i),
+                                      simd<T>::load(y + i)));
+    }
+  } else if(sx == 1 && sy == 0) {
+    const typename simd<T>::type v = simd<T>::set1(*y);
+    for(; i + w <= n; i += w) {
+      simd<T>::store(x + i, Op::apply(simd<T>::load(x + i), v));
+    }
+  }
+  for(; i < n; ++i) x[i * sx] = Op::apply(x[i * sx], y[i * sy]);
+}
+
+// Calls f(x, sx, y, sy, n) on lines that together cover every element of
+// a shape addressed through strides xs in x and ys in y. Unit axes are
+// dropped, the axis along which x is densest is moved innermost and
+// neighbouring axes that are contiguous in both operands are merged, so
+// most passes reduce to a few long lines.
+template<typename T, typename F>
+void walk(const dims_t& shape, T* x, const dims_t& xs,
+          const T* y, const dims_t& ys, const F& f)
+{
+  if(product(shape) == 0) return;
+
+  dims_t n, a, b;
+  for(std::size_t i = 0; i < shape.size(); ++i) {
+    if(shape[i] != 1) {
+      n.push_back(shape[i]);
+      a.push_back(xs[i]);
+      b.push_back(ys[i]);
+    }
+  }
+  if(n.empty()) {
+    f(x, 1, y, 1, 1);
+    return;
+  }
+
+  const std::size_t k = std::min_element(a.begin(), a.end()) - a.begin();
+  std::rotate(n.begin() + k, n.begin() + k + 1, n.end());
+  std::rotate(a.begin() + k, a.begin() + k + 1, a.end());
+  std::rotate(b.begin() + k, b.begin() + k + 1, b.end());
+
+  std::size_t r = n.size() - 1;
+  for(std::size_t i = n.size() - 1; i > 0; --i) {
+    if(a[i - 1] == a[r] * n[r] && b[i - 1] == b[r] * n[r]) {
+      n[r] *= n[i - 1];
+    } else {
+      --r;
+      n[r] = n[i - 1];
+      a[r] = a[i - 1];
+      b[r] = b[i - 1];
+    }
+  }
+  n.erase(n.begin(), n.begin() + r);
+  a.erase(a.begin(), a.begin() + r);
+  b.erase(b.begin(), b.begin() + r);
+
+  const std::size_t outer = n.size() - 1;
+  const std::size_t inner = n.back();
+  const std::size_t lines = product(n) / inner;
+  internal::parallel_for(0, lines,
+                         std::max<std::size_t>(1, internal::grain / inner),
+                         [&](const std::size_t first,
+                             const std::size_t last) {
+    for(std::size_t l = first; l < last; ++l) {
+      std::size_t rest = l, ox = 0, oy = 0;
+      for(std::size_t d = outer; d > 0; --d) {
+        const std::size_t index = rest % n[d - 1];
+        rest /= n[d - 1];
+        ox += index * a[d - 1];
+        oy += index * b[d - 1];
+      }
+      f(x + ox, a.back(), y + oy, b.back(), inner);
+    }
+  });
+}
+
+}  // unnamed namespace
+
+dims_t broadcast(const dims_t& a, const dims_t& b)
+{
+  dims_t result(std::max(a.size(), b.size()));
+  for(std::size_t i = 0; i < result.size(); ++i) {
+    const std::size_t x = (i < a.size()) ? a[a.size() - 1 - i] : 1;
+    const std::size_t y = (i < b.size()) ? b[b.size() - 1 - i] : 1;
+    assert(x == y || x == 1 || y == 1);
+    result[result.size() - 1 - i] = (x == 1) ? y : x;
+  }
+  return result;
+}
+
+// Constructors and Destructor
+template<typename T>
+Tensor<T>::Tensor(const dims_t& dims)
+  : internal::SharedArray<T>(product(dims))
+  , offset(0), shape(dims), steps(packed(dims))
+{}
+
+template<typename T>
+Tensor<T>::Tensor(const std::vector<T>& values, const dims_t& dims)
+  : internal::SharedArray<T>(values)
+  , offset(0), shape(dims), steps(packed(dims))
+{ assert(values.size() == product(dims)); }
+
+template<typename T>
+Tensor<T>::Tensor(const Matrix<T>& matrix)
+  : internal::SharedArray<T>(matrix)
+  , offset(matrix.data() - matrix.get())
+  , shape({matrix.rows(), matrix.cols()})
+  , steps(matrix.layout() == CblasRowMajor
+          ? dims_t({matrix.ldim(), 1}) : dims_t({1, matrix.ldim()}))
+{}
+
+template<typename T>
+Tensor<T>::Tensor(const Tensor<T>& other)
+  : internal::SharedArray<T>(other)
+  , offset(other.offset), shape(other.shape), steps(other.steps)
+{}
+
+template<typename T>
+Tensor<T>::Tensor(Tensor<T>&& other) noexcept
+  : internal::SharedArray<T>(std::forward<Tensor<T>>(other))
+  , offset(other.offset)
+  , shape(std::move(other.shape)), steps(std::move(other.steps))
+{ other.offset = 0; }
+
+template<typename T>
+Tensor<T>::Tensor(const internal::SharedArray<T>& storage,
+                  const std::size_t offset,
+                  const dims_t& dims, const dims_t& strides)
+  : internal::SharedArray<T>(storage)
+  , offset(offset), shape(dims), steps(strides)
+{}
+
+template<typename T>
+Tensor<T>::~Tensor() {}
+
+// Assignment Operators
+template<typename T>
+Tensor<T>& Tensor<T>::operator=(const Tensor<T>& other)
+{
+  Tensor<T> another(other);
+  *this = std::move(another);
+  return *this;
+}
+
+template<typename T>
+Tensor<T>& Tensor<T>::operator=(Tensor<T>&& other) noexcept
+{
+  swap(*this, other);
+  return *this;
+}
+
+template<typename T>
+Tensor<T>& Tensor<T>::operator+=(const Tensor<T>& other)
+{
+  add_inplace(other);
+  return *this;
+}
+
+template<typename T>
+Tensor<T>& Tensor<T>::operator-=(const Tensor<T>& other)
+{
+  sub_inplace(other);
+  return *this;
+}
+
+template<typename T>
+Tensor<T>& Tensor<T>::operator*=(const Tensor<T>& other)
+{
+  mul_inplace(other);
+  return *this;
+}
+
+template<typename T>
+Tensor<T>& Tensor<T>::operator/=(const Tensor<T>& other)
+{
+  div_inplace(other);
+  return *this;
+}
+
+template<typename T>
+Tensor<T>& Tensor<T>::operator+=(const T value)
+{
+  add_inplace(value);
+  return *this;
+}
+
+template<typename T>
+Tensor<T>& Tensor<T>::operator-=(const T value)
+{
+  sub_inplace(value);
+  return *this;
+}
+
+template<typename T>
+Tensor<T>& Tensor<T>::operator*=(const T value)
+{
+  mul_inplace(value);
+  return *this;
+}
+
+template<typename T>
+Tensor<T>& Tensor<T>::operator/=(const T value)
+{
+  div_inplace(value);
+  return *this;
+}
+
+// Arithmetic Operators
+template<typename T>
+Tensor<T> Tensor<T>::operator+() const
+{ return clone(); }
+
+template<typename T>
+Tensor<T> Tensor<T>::operator-() const
+{
+  Tensor<T> result = clone();
+  result.mul_inplace(-1);
+  return result;
+}
+
+template<typename T>
+Tensor<T> Tensor<T>::operator+(const Tensor<T>& other) const
+{
+  Tensor<T> result = broadcast_to(broadcast(shape, other.shape)).clone();
+  result.add_inplace(other);
+  return result;
+}
+
+template<typename T>
+Tensor<T> Tensor<T>::operator-(const Tensor<T>& other) const
+{
+  Tensor<T> result = broadcast_to(broadcast(shape, other.shape)).clone();
+  result.sub_inplace(other);
+  return result;
+}
+
+template<typename T>
+Tensor<T> Tensor<T>::operator*(const Tensor<T>& other) const
+{
+  Tensor<T> result = broadcast_to(broadcast(shape, other.shape)).clone();
+  result.mul_inplace(other);
+  return result;
+}
+
+template<typename T>
+Tensor<T> Tensor<T>::operator/(const Tensor<T>& other) const
+{
+  Tensor<T> result = broadcast_to(broadcast(shape, other.shape)).clone();
+  result.div_inplace(other);
+  return result;
+}
+
+template<typename T>
+Tensor<T> Tensor<T>::operator+(const T value) const
+{
+  Tensor<T> result = clone();
+  result.add_inplace(value);
+  return result;
+}
+
+template<typename T>
+Tensor<T> Tensor<T>::operator-(const T value) const
+{
+  Tensor<T> result = clone();
+  result.sub_inplace(value);
+  return result;
+}
+
+template<typename T>
+Tensor<T> Tensor<T>::operator*(const T value) const
+{
+  Tensor<T> result = clone();
+  result.mul_inplace(value);
+  return result;
+}
+
+template<typename T>
+Tensor<T> Tensor<T>::operator/(const T value) const
+{
+  Tensor<T> result = clone();
+  result.div_inplace(value);
+  return result;
+}
+
+// Miscellaneous Operators
+template<typename T>
+const Tensor<T> Tensor<T>::operator[](const std::size_t index) const
+{ return select(0, index); }
+
+template<typename T>
+T& Tensor<T>::operator()(const dims_t& index) const
+{
+  assert(index.size() == rank());
+  std::size_t position = offset;
+  for(std::size_t i = 0; i < index.size(); ++i) {
+    assert(index[i] < shape[i]);
+    position += index[i] * steps[i];
+  }
+  return internal::SharedArray<T>::operator[](position);
+}
+
+template<typename T>
+std::ostream& operator<<(std::ostream& ostream, const Tensor<T>& tensor)
+{
+  if(tensor.rank() == 0) return ostream << tensor(dims_t());
+  ostream << "[";
+  for(std::size_t i = 0; i < tensor.dim(0); ++i) {
+    if(i != 0) {
+      if(tensor.rank() == 1) ostream << " ";
+      else ostream << std::endl << " ";
+    }
+    ostream << tensor[i];
+  }
+  return ostream << "]";
+}
+
+// Utilities
+template<typename T>
+void swap(Tensor<T>& a, Tensor<T>& b)
+{
+  using std::swap;
+  swap(static_cast<internal::SharedArray<T>&>(a),
+       static_cast<internal::SharedArray<T>&>(b));
+  swap(a.offset, b.offset);
+  swap(a.shape, b.shape);
+  swap(a.steps, b.steps);
+}
+
+template<typename T>
+Tensor<T> Tensor<T>::clone() const
+{
+  Tensor<T> result(shape);
+  result.copy(*this);
+  return result;
+}
+
+template<typename T>
+Tensor<T> Tensor<T>::materialize() const
+{ return contiguous() ? *this : clone(); }
+
+template<typename T>
+Tensor<T> Tensor<T>::reshape(const dims_t& dims) const
+{
+  assert(product(dims) == size());
+  if(size() == 0) return Tensor<T>(dims);
+  const dims_t strides = restride(shape, steps, dims);
+  if(strides.empty() && !dims.empty()) return clone().reshape(dims);
+  return Tensor<T>(*this, offset, dims, strides);
+}
+
+template<typename T>
+Tensor<T> Tensor<T>::permute(const dims_t& order) const
+{
+  assert(order.size() == rank());
+  dims_t dims(rank());
+  dims_t strides(rank());
+  std::vector<bool> seen(rank(), false);
+  for(std::size_t i = 0; i < rank(); ++i) {
+    assert(order[i] < rank() && !seen[order[i]]);
+    seen[order[i]] = true;
+    dims[i] = shape[order[i]];
+    strides[i] = steps[order[i]];
+  }
+  return Tensor<T>(*this, offset, dims, strides);
+}
+
+template<typename T>
+Tensor<T> Tensor<T>::transpose() const
+{
+  return Tensor<T>(*this, offset,
+                   dims_t(shape.rbegin(), shape.rend()),
+                   dims_t(steps.rbegin(), steps.rend()));
+}
+
+template<typename T>
+Tensor<T> Tensor<T>::slice(const std::size_t axis, const std::size_t begin,
+                           const std::size_t end,
+                           const std::size_t step) const
+{
+  assert(axis < rank());
+  assert(begin <= end && end <= shape[axis]);
+  assert(step > 0);
+  dims_t dims(shape);
+  dims_t strides(steps);
+  dims[axis] = (end - begin + step - 1) / step;
+  strides[axis] *= step;
+  return Tensor<T>(*this, offset + begin * steps[axis], dims, strides);
+}
+
+template<typename T>
+Tensor<T> Tensor<T>::select(const std::size_t axis,
+                            const std::size_t index) const
+{
+  assert(axis < rank());
+  assert(index < shape[axis]);
+  dims_t dims(shape);
+  dims_t strides(steps);
+  dims.erase(dims.begin() + axis);
+  strides.erase(strides.begin() + axis);
+  return Tensor<T>(*this, offset + index * steps[axis], dims, strides);
+}
+
+template<typename T>
+Tensor<T> Tensor<T>::squeeze(const std::size_t axis) const
+{
+  assert(axis < rank());
+  assert(shape[axis] == 1);
+  return select(axis, 0);
+}
+
+template<typename T>
+Tensor<T> Tensor<T>::unsqueeze(const std::size_t axis) const
+{
+  assert(axis <= rank());
+  dims_t dims(shape);
+  dims_t strides(steps);
+  dims.insert(dims.begin() + axis, 1);
+  strides.insert(strides.begin() + axis,
+                 (axis < rank()) ? steps[axis] * shape[axis] : 1);
+  return Tensor<T>(*this, offset, dims, strides);
+}
+
+template<typename T>
+Tensor<T> Tensor<T>::broadcast_to(const dims_t& dims) const
+{
+  assert(dims.size() >= rank());
+  const std::size_t lead = dims.size() - rank();
+  dims_t strides(dims.size(), 0);
+  for(std::size_t i = 0; i < rank(); ++i) {
+    if(shape[i] == dims[lead + i]) {
+      strides[lead + i] = steps[i];
+    } else {
+      assert(shape[i] == 1);
+    }
+  }
+  return Tensor<T>(*this, offset, dims, strides);
+}
+
+template<typename T>
+Matrix<T> Tensor<T>::matrix() const
+{ return matrix((rank() > 0) ? rank() - 1 : 0); }
+
+template<typename T>
+Matrix<T> Tensor<T>::matrix(const std::size_t axis) const
+{
+  assert(axis <= rank());
+  const std::size_t rows = product(dims_t(shape.begin(), shape.begin() + axis));
+  const std::size_t cols = product(dims_t(shape.begin() + axis, shape.end()));
+  const Tensor<T> t = reshape({rows, cols});
+  const Vector<T> values(t, t.offset, 1, rows * cols);
+  if((cols <= 1 || t.steps[1] == 1) && (rows <= 1 || t.steps[0] == cols)) {
+    return Matrix<T>(values).reshape(rows, cols);
+  }
+  if((rows <= 1 || t.steps[0] == 1) && (cols <= 1 || t.steps[1] == rows)) {
+    return Matrix<T>(values).reshape(cols, rows).transpose();
+  }
+  return t.clone().matrix(1);
+}
+
+template<typename T>
+void Tensor<T>::copy(const Tensor<T>& other)
+{ binary_inplace(other, line<T, Assign<T>>); }
+
+// Accessors
+template<typename T>
+const std::size_t Tensor<T>::rank() const
+{ return shape.size(); }
+
+template<typename T>
+const std::size_t Tensor<T>::size() const
+{ return product(shape); }
+
+template<typename T>
+const std::size_t Tensor<T>::dim(const std::size_t axis) const
+{ return shape[axis]; }
+
+template<typename T>
+const dims_t& Tensor<T>::dims() const
+{ return shape; }
+
+template<typename T>
+const dims_t& Tensor<T>::strides() const
+{ return steps; }
+
+template<typename T>
+const bool Tensor<T>::contiguous() const
+{
+  std::size_t s = 1;
+  for(std::size_t i = rank(); i > 0; --i) {
+    if(shape[i - 1] != 1 && steps[i - 1] != s) return false;
+    s *= shape[i - 1];
+  }
+  return true;
+}
+
+template<typename T>
+T* const Tensor<T>::data() const
+{ return this->get() + offset; }
+
+// Arithmetic Functions
+template<typename T>
+template<typename F>
+void Tensor<T>::binary_inplace(const Tensor<T>& other, const F& f)
+{
+  for(std::size_t i = 0; i < rank(); ++i) {
+    assert(shape[i] == 1 || steps[i] != 0);
+  }
+  const Tensor<T> source = other.broadcast_to(shape);
+  walk(shape, data(), steps, source.data(), source.steps, f);
+}
+
+template<typename T>
+void Tensor<T>::add_inplace(const Tensor<T>& other)
+{ binary_inplace(other, line<T, Add<T>>); }
+
+template<typename T>
+void Tensor<T>::sub_inplace(const Tensor<T>& other)
+{ binary_inplace(other, line<T, Sub<T>>); }
+
+template<typename T>
+void Tensor<T>::mul_inplace(const Tensor<T>& other)
+{ binary_inplace(other, line<T, Mul<T>>); }
+
+template<typename T>
+void Tensor<T>::div_inplace(const Tensor<T>& other)
+{ binary_inplace(other, line<T, Div<T>>); }
+
+template<typename T>
+void Tensor<T>::add_inplace(const T value)
+{ add_inplace(Tensor<T>(std::vector<T>(1, value), dims_t())); }
+
+template<typename T>
+void Tensor<T>::sub_inplace(const T value)
+{ sub_inplace(Tensor<T>(std::vector<T>(1, value), dims_t())); }
+
+template<typename T>
+void Tensor<T>::mul_inplace(const T value)
+{ mul_inplace(Tensor<T>(std::vector<T>(1, value), dims_t())); }
+
+template<typename T>
+void Tensor<T>::div_inplace(const T value)
+{ div_inplace(Tensor<T>(std::vector<T>(1, value), dims_t())); }
+
+template<typename T>
+void Tensor<T>::apply_inplace(const std::function<T(T)>& f)
+{
+  walk(shape, data(), steps, data(), steps,
+       [&f](T* x, const std::size_t sx, const T*, const std::size_t,
+            const std::size_t n) {
+    for(std::size_t i = 0; i < n; ++i) x[i * sx] = f(x[i * sx]);
+  });
+}
+
+template<typename T>
+Tensor<T> Tensor<T>::apply(const std::function<T(T)>& f) const
+{
+  Tensor<T> result = clone();
+  result.apply_inplace(f);
+  return result;
+}
+
+template<typename T>
+const bool operator==(const Tensor<T>& a, const Tensor<T>& b)
+{
+  if(a.dims() != b.dims()) return false;
+  const Tensor<T> x = a.materialize();
+  const Tensor<T> y = b.materialize();
+  return std::equal(x.data(), x.data() + x.size(), y.data());
+}
+
+template<typename T>
+const bool operator!=(const Tensor<T>& a, const Tensor<T>& b)
+{ return !(a == b); }
+
+template<typename T>
+const bool operator==(const Tensor<T>& tensor, const std::vector<T>& values)
+{
+  if(tensor.size() != values.size()) return false;
+  const Tensor<T> x = tensor.materialize();
+  return std::equal(x.data(), x.data() + x.size(), values.begin());
+}
+
+template<typename T>
+const bool operator!=(const Tensor<T>& tensor, const std::vector<T>& values)
+{ return !(tensor == values); }
+
+// Explicit instantiations
+template class Tensor<float>;
+template class Tensor<double>;
+
+template std::ostream& operator<<(std::ostream&, const Tensor<float>&);
+template void swap(Tensor<float>&, Tensor<float>&);
+template const bool operator==(const Tensor<float>&, const Tensor<float>&);
+template const bool operator!=(const Tensor<float>&, const Tensor<float>&);
+template const bool operator==(const Tensor<float>&,
+                               const std::vector<float>&);
+template const bool operator!=(const Tensor<float>&,
+                               const std::vector<float>&);
+
+template std::ostream& operator<<(std::ostream&, const Tensor<double>&);
+template void swap(Tensor<double>&, Tensor<double>&);
+template const bool operator==(const Tensor<double>&, const Tensor<double>&);
+template const bool operator!=(const Tensor<double>&, const Tensor<double>&);
+template const bool operator==(const Tensor<double>&,
+                               const std::vector<double>&);
+template const bool operator!=(const Tensor<double>&,
+                               const std::vector<double>&);
+
+}  // namespace laplus
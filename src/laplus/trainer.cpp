@@ -0,0 +1,185 @@
+/******************************************************************************
+ *
+ * laplus/trainer.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/trainer.hpp"
+#include "laplus/internal/parallel.hpp"
+#include "laplus/internal/simd.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace laplus {
+
+namespace {
+
+using simd = internal::simd<float>;
+
+const std::size_t width = simd::width;
+
+// A zero matrix with the shape and layout of like.
+Matrixf zeros_like(const Matrixf& like)
+{
+  if(like.layout() == CblasRowMajor) return Matrixf(like.rows(), like.cols());
+  return Matrixf(like.cols(), like.rows()).transpose();
+}
+
+// Rows [first, last) of a dense row-major matrix, without copying.
+Matrixf slice(const Matrixf& m, const std::size_t first,
+              const std::size_t last)
+{
+  return Matrixf(m.data() + first * m.cols(), last - first, m.cols(),
+                 [](float*) {});
+}
+
+}  // unnamed namespace
+
+// Constructors and Destructor
+Trainer::Trainer(const std::vector<Matrixf>& weights, const Gradient& g,
+                 const OptimizerParams& optimizer, const TrainerParams& params)
+  : w(weights), gradient(g), opt(optimizer), p(params)
+{
+  assert(p.mode != TrainerHogwild || (optimizer.algorithm == OptimizerSGD
+                                      && optimizer.momentum == 0.0f));
+  if(p.workers == 0) p.workers = internal::concurrency();
+  for(const Matrixf& x: w) {
+    assert(x.inc() == 1);
+    opt.add(x);
+  }
+  grads.resize(p.workers);
+  for(std::vector<Matrixf>& buffers: grads)
+    for(const Matrixf& x: w) buffers.push_back(zeros_like(x));
+  losses.assign(p.workers, 0.0f);
+}
+
+// Training
+const float Trainer::step(const Matrixf& x, const Matrixf& t)
+{
+  assert(x.rows() == t.rows());
+  const std::size_t n = x.rows();
+  if(n == 0) return 0.0f;
+
+  const Matrixf xs = x.row_major();
+  const Matrixf ts = t.row_major();
+  const std::size_t active = std::min(p.workers, n);
+  internal::parallel_run(active, [&](const std::size_t k) {
+    const std::size_t first = n * k / active;
+    const std::size_t last = n * (k + 1) / active;
+    losses[k] = gradient(k, slice(xs, first, last), slice(ts, first, last),
+                         w, grads[k]);
+  });
+
+  float loss = 0.0f;
+  for(std::size_t k = 0; k < active; ++k) loss += losses[k];
+  for(std::size_t i = 0; i < w.size(); ++i) {
+    reduce(i, active);
+    opt.step(i, w[i], grads[0][i]);
+  }
+  return loss;
+}
+
+const float Trainer::epoch(const Matrixf& x, const Matrixf& t,
+                           const std::size_t batch)
+{
+  assert(batch > 0);
+  assert(x.rows() == t.rows());
+  const Matrixf xs = x.row_major();
+  const Matrixf ts = t.row_major();
+  if(p.mode == TrainerHogwild) return hogwild(xs, ts, batch);
+
+  const std::size_t n = x.rows();
+  float loss = 0.0f;
+  for(std::size_t first = 0; first < n; first += batch) {
+    const std::size_t last = std::min(n, first + batch);
+    loss += step(slice(xs, first, last), slice(ts, first, last));
+  }
+  return loss;
+}
+
+// Accessors
+const std::vector<Matrixf>& Trainer::weights() const
+{ return w; }
+
+const std::size_t Trainer::workers() const
+{ return p.workers; }
+
+const Optimizer& Trainer::optimizer() const
+{ return opt; }
+
+// Worker k takes minibatches k, k + workers, ... and writes its updates
+// straight into the shared weights. Lost or torn updates between workers
+// are tolerated by design.
+const float Trainer::hogwild(const Matrixf& x, const Matrixf& t,
+                             const std::size_t batch)
+{
+  const std::size_t n = x.rows();
+  const std::size_t batches = (n + batch - 1) / batch;
+  const float lr = opt.params().lr;
+  const float wd = opt.params().weight_decay;
+  internal::parallel_run(p.workers, [&](const std::size_t k) {
+    losses[k] = 0.0f;
+    for(std::size_t b = k; b < batches; b += p.workers) {
+      const std::size_t first = b * batch;
+      const std::size_t last = std::min(n, first + batch);
+      losses[k] += gradient(k, slice(x, first, last), slice(t, first, last),
+                            w, grads[k]);
+      for(std::size_t i = 0; i < w.size(); ++i) {
+        Matrixf& g = grads[k][i];
+        if(wd != 0.0f) g.axpy(wd, w[i]);
+        w[i].axpy(-lr, g);
+      }
+    }
+  });
+
+  float loss = 0.0f;
+  for(const float l: losses) loss += l;
+  return loss;
+}
+
+// Sums the gradients of weight i from workers [1, active) into worker 0.
+// Every task owns a disjoint range of elements.
+void Trainer::reduce(const std::size_t i, const std::size_t active)
+{
+  float* const sum = grads[0][i].data();
+  for(std::size_t k = 1; k < active; ++k)
+    assert(grads[k][i].layout() == grads[0][i].layout());
+  internal::parallel_for(0, w[i].size(), internal::grain, [&](
+      const std::size_t first, const std::size_t last) {
+    for(std::size_t k = 1; k < active; ++k) {
+      const float* const g = grads[k][i].data();
+      std::size_t j = first;
+      for(; j + width <= last; j += width) {
+        simd::store(sum + j, simd::add(simd::load(sum + j),
+                                       simd::load(g + j)));
+      }
+      for(; j < last; ++j) sum[j] += g[j];
+    }
+  });
+}
+
+}  // namespace laplus
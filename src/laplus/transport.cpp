@@ -0,0 +1,375 @@
+/******************************************************************************
+ *
+ * laplus/transport.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/transport.hpp"
+#include "laplus/internal/futex.hpp"
+#include "laplus/internal/mapping.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace laplus {
+
+Transport::~Transport() {}
+
+namespace {
+
+void backoff()
+{ std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+// A socket address for the given rank together with its length.
+struct Address {
+  sockaddr_storage storage;
+  socklen_t length;
+};
+
+const bool resolve(const SocketFamily family, const std::string& address,
+                   const std::size_t rank, Address& result)
+{
+  std::memset(&result.storage, 0, sizeof(result.storage));
+  if(family == SocketUnix) {
+    sockaddr_un& un = reinterpret_cast<sockaddr_un&>(result.storage);
+    const std::string path = address + "." + std::to_string(rank);
+    if(path.size() >= sizeof(un.sun_path)) return false;
+    un.sun_family = AF_UNIX;
+    std::strcpy(un.sun_path, path.c_str());
+    result.length = sizeof(sockaddr_un);
+    return true;
+  }
+  const std::size_t colon = address.rfind(':');
+  if(colon == std::string::npos) return false;
+  sockaddr_in& in = reinterpret_cast<sockaddr_in&>(result.storage);
+  in.sin_family = AF_INET;
+  const unsigned long port = std::strtoul(address.c_str() + colon + 1,
+                                          nullptr, 10) + rank;
+  if(port == 0 || port > 65535) return false;
+  in.sin_port = htons(port);
+  if(::inet_pton(AF_INET, address.substr(0, colon).c_str(),
+                 &in.sin_addr) != 1) {
+    return false;
+  }
+  result.length = sizeof(sockaddr_in);
+  return true;
+}
+
+void configure(const int fd, const SocketFamily family)
+{
+  if(family == SocketTCP) {
+    const int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  }
+}
+
+// Writes or reads exactly n bytes, retrying after interruptions.
+const bool write_all(const int fd, const char* p, std::size_t n)
+{
+  while(n > 0) {
+    const ssize_t k = ::send(fd, p, n, MSG_NOSIGNAL);
+    if(k < 0 && errno == EINTR) continue;
+    if(k <= 0) return false;
+    p += k;
+    n -= k;
+  }
+  return true;
+}
+
+const bool read_all(const int fd, char* p, std::size_t n)
+{
+  while(n > 0) {
+    const ssize_t k = ::recv(fd, p, n, 0);
+    if(k < 0 && errno == EINTR) continue;
+    if(k <= 0) return false;
+    p += k;
+    n -= k;
+  }
+  return true;
+}
+
+}  // unnamed namespace
+
+// Constructors and Destructor
+SocketTransport::SocketTransport(const SocketFamily family,
+                                 const std::string& address,
+                                 const std::size_t rank,
+                                 const std::size_t size)
+  : me(rank), ranks(size), sockets(size, -1), open(false)
+{
+  assert(rank < size);
+  const int domain = (family == SocketUnix) ? AF_UNIX : AF_INET;
+
+  Address local;
+  if(!resolve(family, address, me, local)) return;
+  const int listener = ::socket(domain, SOCK_STREAM, 0);
+  if(listener < 0) return;
+  const int one = 1;
+  ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  if(family == SocketUnix) {
+    ::unlink(reinterpret_cast<sockaddr_un&>(local.storage).sun_path);
+  }
+  const sockaddr* const local_addr =
+      reinterpret_cast<const sockaddr*>(&local.storage);
+  if(::bind(listener, local_addr, local.length) != 0
+     || ::listen(listener, int(size)) != 0) {
+    ::close(listener);
+    return;
+  }
+
+  // Connections to lower ranks queue in their backlog, so every rank can
+  // dial before it accepts.
+  bool ok = true;
+  for(std::size_t peer = 0; ok && peer < me; ++peer) {
+    Address remote;
+    ok = resolve(family, address, peer, remote);
+    const sockaddr* const remote_addr =
+        reinterpret_cast<const sockaddr*>(&remote.storage);
+    while(ok) {
+      const int fd = ::socket(domain, SOCK_STREAM, 0);
+      if(fd < 0) {
+        ok = false;
+      } else if(::connect(fd, remote_addr, remote.length) == 0) {
+        const std::uint64_t id = me;
+        configure(fd, family);
+        ok = write_all(fd, reinterpret_cast<const char*>(&id), sizeof(id));
+        sockets[peer] = fd;
+        break;
+      } else {
+        ::close(fd);
+        backoff();
+      }
+    }
+  }
+  for(std::size_t accepted = me + 1; ok && accepted < ranks; ++accepted) {
+    const int fd = ::accept(listener, nullptr, nullptr);
+    std::uint64_t id = 0;
+    if(fd < 0) {
+      ok = (errno == EINTR);
+      --accepted;
+      continue;
+    }
+    configure(fd, family);
+    ok = read_all(fd, reinterpret_cast<char*>(&id), sizeof(id))
+      && id > me && id < ranks && sockets[id] < 0;
+    if(ok) sockets[id] = fd;
+    else ::close(fd);
+  }
+
+  ::close(listener);
+  if(family == SocketUnix) {
+    ::unlink(reinterpret_cast<sockaddr_un&>(local.storage).sun_path);
+  }
+  open = ok;
+}
+
+SocketTransport::~SocketTransport()
+{ for(const int fd: sockets) if(fd >= 0) ::close(fd); }
+
+// Transfers
+void SocketTransport::send(const std::size_t peer, const void* data,
+                           const std::size_t n)
+{
+  assert(peer < ranks && peer != me);
+  if(!open) return;
+  if(!write_all(sockets[peer], static_cast<const char*>(data), n))
+    open = false;
+}
+
+void SocketTransport::recv(const std::size_t peer, void* data,
+                           const std::size_t n)
+{
+  assert(peer < ranks && peer != me);
+  if(!open) return;
+  if(!read_all(sockets[peer], static_cast<char*>(data), n)) open = false;
+}
+
+// Accessors
+const bool SocketTransport::is_open() const
+{ return open; }
+
+const std::size_t SocketTransport::rank() const
+{ return me; }
+
+const std::size_t SocketTransport::size() const
+{ return ranks; }
+
+// The producer advances head and the consumer tail, each on a cache line
+// of its own; both count bytes modulo 2^32, which the power of two
+// capacity divides.
+struct SharedTransport::Ring {
+  alignas(64) std::atomic<std::uint32_t> head;
+  alignas(64) std::atomic<std::uint32_t> tail;
+  alignas(64) char data[64];
+};
+
+namespace {
+
+const std::size_t header_size = 64;
+const std::size_t ring_header = 128;
+const std::size_t default_bytes = 1 << 20;
+
+struct Join {
+  std::atomic<std::uint32_t> joined;
+};
+
+const std::size_t round_up(const std::size_t n)
+{
+  std::size_t p = 64;
+  while(p < n) p <<= 1;
+  return p;
+}
+
+}  // unnamed namespace
+
+// Constructors and Destructor
+SharedTransport::SharedTransport(const std::string& name,
+                                 const std::size_t rank,
+                                 const std::size_t size)
+  : SharedTransport(name, rank, size, default_bytes)
+{}
+
+SharedTransport::SharedTransport(const std::string& name,
+                                 const std::size_t rank,
+                                 const std::size_t size,
+                                 const std::size_t capacity)
+  : me(rank), ranks(size), bytes(round_up(capacity))
+  , length(header_size + size * size * (ring_header + bytes))
+  , memory(nullptr)
+{
+  static_assert(offsetof(Ring, data) == ring_header, "unexpected padding");
+  assert(rank < size);
+  assert(bytes <= (std::size_t(1) << 30));
+  const std::string path = (name[0] == '/') ? name : "/" + name;
+  memory = internal::map_shared(path, length, me == 0);
+  if(!memory) return;
+
+  // Rank 0 keeps the name until everyone has mapped the segment.
+  Join& join = *static_cast<Join*>(memory);
+  std::uint32_t joined = join.joined.fetch_add(1) + 1;
+  internal::wake_all(join.joined);
+  while(joined < ranks) {
+    internal::wait_while(join.joined, joined);
+    joined = join.joined.load(std::memory_order_acquire);
+  }
+  if(me == 0) ::shm_unlink(path.c_str());
+}
+
+SharedTransport::~SharedTransport()
+{ if(memory) ::munmap(memory, length); }
+
+// Transfers
+void SharedTransport::send(const std::size_t peer, const void* data,
+                           const std::size_t n)
+{
+  assert(peer < ranks && peer != me);
+  if(!memory) return;
+  Ring& r = ring(me, peer);
+  const char* p = static_cast<const char*>(data);
+  std::size_t left = n;
+  while(left > 0) {
+    const std::uint32_t head = r.head.load(std::memory_order_relaxed);
+    std::uint32_t tail = r.tail.load(std::memory_order_acquire);
+    while(head - tail == bytes) {
+      internal::wait_while(r.tail, tail);
+      tail = r.tail.load(std::memory_order_acquire);
+    }
+    const std::size_t count = std::min<std::size_t>(left,
+                                                    bytes - (head - tail));
+    const std::size_t at = head & (bytes - 1);
+    const std::size_t first = std::min(count, bytes - at);
+    std::memcpy(r.data + at, p, first);
+    std::memcpy(r.data, p + first, count - first);
+    r.head.store(head + std::uint32_t(count), std::memory_order_release);
+    internal::wake_all(r.head);
+    p += count;
+    left -= count;
+  }
+}
+
+void SharedTransport::recv(const std::size_t peer, void* data,
+                           const std::size_t n)
+{
+  assert(peer < ranks && peer != me);
+  if(!memory) return;
+  Ring& r = ring(peer, me);
+  char* p = static_cast<char*>(data);
+  std::size_t left = n;
+  while(left > 0) {
+    const std::uint32_t tail = r.tail.load(std::memory_order_relaxed);
+    std::uint32_t head = r.head.load(std::memory_order_acquire);
+    while(head == tail) {
+      internal::wait_while(r.head, head);
+      head = r.head.load(std::memory_order_acquire);
+    }
+    const std::size_t count = std::min<std::size_t>(left, head - tail);
+    const std::size_t at = tail & (bytes - 1);
+    const std::size_t first = std::min(count, bytes - at);
+    std::memcpy(p, r.data + at, first);
+    std::memcpy(p + first, r.data, count - first);
+    r.tail.store(tail + std::uint32_t(count), std::memory_order_release);
+    internal::wake_all(r.tail);
+    p += count;
+    left -= count;
+  }
+}
+
+// Accessors
+const bool SharedTransport::is_open() const
+{ return memory != nullptr; }
+
+const std::size_t SharedTransport::rank() const
+{ return me; }
+
+const std::size_t SharedTransport::size() const
+{ return ranks; }
+
+const std::size_t SharedTransport::capacity() const
+{ return bytes; }
+
+SharedTransport::Ring& SharedTransport::ring(const std::size_t from,
+                                             const std::size_t to) const
+{
+  char* const base = static_cast<char*>(memory) + header_size;
+  const std::size_t stride = ring_header + bytes;
+  return *reinterpret_cast<Ring*>(base + (from * ranks + to) * stride);
+}
+
+}  // namespace laplus
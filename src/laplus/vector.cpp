@@ -0,0 +1,802 @@
+/******************************************************************************
+ *
+ * laplus/vector.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#include "laplus/vector.hpp"
+#include "laplus/matrix.hpp"
+#include "laplus/random.hpp"
+#include "laplus/internal/blas.hpp"
+#include "laplus/internal/simd.hpp"
+#include "laplus/typedef.hpp"
+
+namespace laplus {
+
+namespace {
+
+template<typename T>
+using blas = internal::blas<T>;
+
+template<typename T>
+using simd = internal::simd<T>;
+
+}  // unnamed namespace
+
+// Generators
+template<typename T>
+Vector<T> Vector<T>::Uniform(const std::size_t size)
+{ return Uniform(size, 0.0, 1.0); }
+
+template<typename T>
+Vector<T> Vector<T>::Uniform(const std::size_t size, const T max)
+{ return Uniform(size, 0.0, max); }
+
+template<typename T>
+Vector<T> Vector<T>::Uniform(const std::size_t size,
+                             const T min, const T max)
+{
+  Vector<T> result(size);
+  Philox::next().uniform(result.data(), size, min, max);
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::Normal(const std::size_t size)
+{ return Normal(size, 0.0, 1.0); }
+
+template<typename T>
+Vector<T> Vector<T>::Normal(const std::size_t size,
+                            const T mean, const T stddev)
+{
+  Vector<T> result(size);
+  Philox::next().normal(result.data(), size, mean, stddev);
+  return result;
+}
+
+// Constructors and Destructor
+template<typename T>
+Vector<T>::Vector(const std::size_t size)
+  : internal::SharedArray<T>(size)
+  , offset(0), stride(1), length(size)
+{}
+
+template<typename T>
+Vector<T>::Vector(const vector1d<T>& values)
+  : internal::SharedArray<T>(values)
+  , offset(0), stride(1), length(values.size())
+{}
+
+template<typename T>
+Vector<T>::Vector(vector1d<T>&& values)
+  : internal::SharedArray<T>(std::move(values))
+  , offset(0), stride(1), length(internal::SharedArray<T>::size())
+{}
+
+template<typename T>
+Vector<T>::Vector(T* const values, const std::size_t size,
+                  const std::function<void(T*)>& deleter)
+  : internal::SharedArray<T>(std::shared_ptr<T>(values, deleter), size)
+  , offset(0), stride(1), length(size)
+{}
+
+template<typename T>
+Vector<T>::Vector(const internal::SharedArray<T>& other, std::size_t offset,
+                  std::size_t stride, std::size_t length)
+  : internal::SharedArray<T>(other)
+  , offset(offset), stride(stride), length(length)
+{}
+
+template<typename T>
+Vector<T>::Vector(const Vector<T>& other)
+  : internal::SharedArray<T>(other)
+  , offset(other.offset), stride(other.stride), length(other.length)
+{}
+
+template<typename T>
+Vector<T>::Vector(Vector<T>&& other) noexcept
+  : internal::SharedArray<T>(std::forward<Vector<T>>(other))
+  , offset(other.offset), stride(other.stride), length(other.length)
+{
+  other.length = 0;
+}
+
+template<typename T>
+Vector<T>::~Vector() {}
+
+// Assignment Operators
+template<typename T>
+Vector<T>& Vector<T>::operator=(const Vector<T>& other)
+{
+  Vector<T> another(other);
+  *this = std::move(another);
+  return *this;
+}
+
+template<typename T>
+Vector<T>& Vector<T>::operator=(Vector<T>&& other) noexcept
+{
+  using std::swap;
+  swap(*this, other);
+  return *this;
+}
+
+template<typename T>
+Vector<T>& Vector<T>::operator+=(const Vector<T>& rhs)
+{
+  this->axpy(1.0, rhs);
+  return *this;
+}
+
+template<typename T>
+Vector<T>& Vector<T>::operator-=(const Vector<T>& rhs)
+{
+  *this += -rhs;
+  return *this;
+}
+
+template<typename T>
+Vector<T>& Vector<T>::operator*=(const Vector<T>& rhs)
+{
+  this->mul_inplace(rhs);
+  return *this;
+}
+
+template<typename T>
+Vector<T>& Vector<T>::operator/=(const Vector<T>& rhs)
+{
+  this->div_inplace(rhs);
+  return *this;
+}
+
+template<typename T>
+Vector<T>& Vector<T>::operator^=(const Vector<T>& rhs)
+{
+  this->pow_inplace(rhs);
+  return *this;
+}
+
+template<typename T>
+Vector<T>& Vector<T>::operator+=(const T rhs)
+{
+  this->add_inplace(rhs);
+  return *this;
+}
+
+template<typename T>
+Vector<T>& Vector<T>::operator-=(const T rhs)
+{
+  this->sub_inplace(rhs);
+  return *this;
+}
+
+template<typename T>
+Vector<T>& Vector<T>::operator*=(const T rhs)
+{
+  this->mul_inplace(rhs);
+  return *this;
+}
+
+template<typename T>
+Vector<T>& Vector<T>::operator/=(const T rhs)
+{
+  this->div_inplace(rhs);
+  return *this;
+}
+
+template<typename T>
+Vector<T>& Vector<T>::operator^=(const T rhs)
+{
+  this->pow_inplace(rhs);
+  return *this;
+}
+
+// Arithmetic Operators
+template<typename T>
+Vector<T> Vector<T>::operator+() const
+{ return this->clone(); }
+
+template<typename T>
+Vector<T> Vector<T>::operator-() const
+{
+  Vector<T> result(this->clone());
+  result.scal(-1.0);
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::operator+(const Vector<T>& other) const
+{
+  Vector<T> result(this->clone());
+  result += other;
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::operator-(const Vector<T>& other) const
+{
+  Vector<T> result(this->clone());
+  result -= other;
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::operator*(const Vector<T>& other) const
+{
+  Vector<T> result(this->clone());
+  result *= other;
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::operator/(const Vector<T>& other) const
+{
+  Vector<T> result(this->clone());
+  result /= other;
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::operator^(const Vector<T>& other) const
+{
+  Vector<T> result(this->clone());
+  result ^= other;
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::operator+(const T value) const
+{
+  Vector<T> result(this->clone());
+  result += value;
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::operator-(const T value) const
+{
+  Vector<T> result(this->clone());
+  result -= value;
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::operator*(const T value) const
+{
+  Vector<T> result(this->clone());
+  result *= value;
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::operator/(const T value) const
+{
+  Vector<T> result(this->clone());
+  result /= value;
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::operator^(const T value) const
+{
+  Vector<T> result(this->clone());
+  result ^= value;
+  return result;
+}
+
+template<typename T>
+Vector<T> operator+(const typename Vector<T>::value_type& value,
+                    const Vector<T>& vector)
+{ return vector + value; }
+
+template<typename T>
+Vector<T> operator-(const typename Vector<T>::value_type& value,
+                    const Vector<T>& vector)
+{ return -vector + value; }
+
+template<typename T>
+Vector<T> operator*(const typename Vector<T>::value_type& value,
+                    const Vector<T>& vector)
+{ return vector * value; }
+
+template<typename T>
+Vector<T> operator/(const typename Vector<T>::value_type& value,
+                    const Vector<T>& vector)
+{
+  Vector<T> result(vector.clone());
+  for(std::size_t i = 0; i < result.size(); ++i) {
+    result[i] = value / result[i];
+  }
+  return result;
+}
+
+template<typename T>
+Vector<T> operator^(const typename Vector<T>::value_type& value,
+                    const Vector<T>& vector)
+{
+  Vector<T> result(vector.clone());
+  for(std::size_t i = 0; i < result.size(); ++i) {
+    result[i] = std::pow(value, result[i]);
+  }
+  return result;
+}
+
+// Miscellaneous Operators
+template<typename T>
+T& Vector<T>::operator[](const std::size_t index) const
+{ return internal::SharedArray<T>::operator[](offset + stride * index); }
+
+template<typename T>
+T& Vector<T>::operator()(const std::size_t index) const
+{ return (*this)[index]; }
+
+template<typename T>
+std::ostream& operator<<(std::ostream& ostream, const Vector<T>& vector)
+{
+  ostream << "[";
+  for(std::size_t i = 0; i < vector.size(); ++i) {
+    if(i != 0) ostream << " ";
+    ostream << vector[i];
+  }
+  return ostream << "]";
+}
+
+//Utilities
+template<typename T>
+void swap(Vector<T>& a, Vector<T>& b)
+{
+  using std::swap;
+  swap(static_cast<internal::SharedArray<T>&>(a),
+       static_cast<internal::SharedArray<T>&>(b));
+  swap(a.offset, b.offset);
+  swap(a.stride, b.stride);
+  swap(a.length, b.length);
+}
+
+template<typename T>
+Vector<T> Vector<T>::clone() const
+{
+  Vector<T> result(this->length);
+  result.copy(*this);
+  return result;
+}
+
+// Accessors
+template<typename T>
+const std::size_t Vector<T>::size() const
+{ return length; }
+
+template<typename T>
+const std::size_t Vector<T>::aligned_size() const
+{ return internal::align<T>(length); }
+
+template<typename T>
+T* const Vector<T>::data() const
+{ return this->get() + offset; }
+
+template<typename T>
+const std::size_t Vector<T>::inc() const
+{ return stride; }
+
+// Level 1 BLAS
+template<typename T>
+void Vector<T>::swap(Vector<T>& other)
+{ blas<T>::swap(this->length, other.data(), other.stride,
+                this->data(), this->stride); }
+
+template<typename T>
+void Vector<T>::scal(const T alpha)
+{ blas<T>::scal(this->length, alpha, this->data(), this->stride); }
+
+template<typename T>
+void Vector<T>::copy(const Vector<T>& other)
+{
+  assert(this->length == other.length);
+  blas<T>::copy(this->length, other.data(), other.stride,
+                this->data(), this->stride);
+}
+
+template<typename T>
+void Vector<T>::axpy(const T alpha, const Vector<T>& other)
+{
+  assert(this->length == other.length);
+  blas<T>::axpy(this->length, alpha, other.data(), other.stride,
+                this->data(), this->stride);
+}
+
+template<typename T>
+const T Vector<T>::dot(const Vector<T>& other) const
+{
+  assert(this->length == other.length);
+  return blas<T>::dot(this->length, other.data(), other.stride,
+                      this->data(), this->stride);
+}
+
+template<typename T>
+const T Vector<T>::nrm2() const
+{ return blas<T>::nrm2(this->length, this->data(), this->stride); }
+
+template<typename T>
+const T Vector<T>::asum() const
+{ return blas<T>::asum(this->length, this->data(), this->stride); }
+
+template<typename T>
+const std::size_t Vector<T>::iamax() const
+{ return blas<T>::iamax(this->length, this->data(), this->stride); }
+
+// Level 2 BLAS
+template<typename T>
+void Vector<T>::gemv(const T alpha, const Matrix<T>& A,
+                     const Vector<T>& x, const T beta)
+{
+  assert(this->length == A.rows());
+  assert(x.length == A.cols());
+  blas<T>::gemv(A.layout(), CblasNoTrans, A.rows(), A.cols(),
+                alpha, A.data(), A.ldim(), x.data(), x.stride,
+                beta, this->data(), this->stride);
+}
+
+template<typename T>
+void Vector<T>::symv(const CBLAS_UPLO uplo, const T alpha,
+                     const Matrix<T>& A, const Vector<T>& x, const T beta)
+{
+  assert(A.rows() == A.cols());
+  assert(this->length == A.rows());
+  assert(x.length == A.cols());
+  blas<T>::symv(A.layout(), uplo, A.rows(),
+                alpha, A.data(), A.ldim(), x.data(), x.stride,
+                beta, this->data(), this->stride);
+}
+
+template<typename T>
+void Vector<T>::trmv(const CBLAS_UPLO uplo, const CBLAS_DIAG diag,
+                     const Matrix<T>& A)
+{
+  assert(A.rows() == A.cols());
+  assert(this->length == A.rows());
+  blas<T>::trmv(A.layout(), uplo, CblasNoTrans, diag, A.rows(),
+                A.data(), A.ldim(), this->data(), this->stride);
+}
+
+template<typename T>
+void Vector<T>::trsv(const CBLAS_UPLO uplo, const CBLAS_DIAG diag,
+                     const Matrix<T>& A)
+{
+  assert(A.rows() == A.cols());
+  assert(this->length == A.rows());
+  blas<T>::trsv(A.layout(), uplo, CblasNoTrans, diag, A.rows(),
+                A.data(), A.ldim(), this->data(), this->stride);
+}
+
+// Arithmetic Functions
+template<typename T>
+void Vector<T>::mul_inplace(const Vector<T>& other)
+{
+  assert(this->length == other.length);
+  if(this->stride == 1 && this->length == this->aligned_size()
+     && other.stride == 1 && other.length == other.aligned_size()) {
+    contiguous_mul_inplace(other);
+  } else {
+    for(std::size_t i = 0; i < this->length; ++i) {
+      (*this)[i] *= other[i];
+    }
+  }
+}
+
+template<typename T>
+void Vector<T>::div_inplace(const Vector<T>& other)
+{
+  assert(this->length == other.length);
+  if(this->stride == 1 && this->length == this->aligned_size()
+     && other.stride == 1 && other.length == other.aligned_size()) {
+    contiguous_div_inplace(other);
+  } else {
+    for(std::size_t i = 0; i < this->length; ++i) {
+      (*this)[i] /= other[i];
+    }
+  }
+}
+
+template<typename T>
+void Vector<T>::pow_inplace(const Vector<T>& other)
+{
+  assert(this->length == other.length);
+  for(std::size_t i = 0; i < this->length; ++i) {
+    (*this)[i] = std::pow((*this)[i], other[i]);
+  }
+}
+
+template<typename T>
+void Vector<T>::contiguous_mul_inplace(const Vector<T>& other)
+{
+  for(std::size_t i = 0; i < this->aligned_size(); i += simd<T>::width) {
+    typename simd<T>::type v0 = simd<T>::load(this->data() + i);
+    typename simd<T>::type v1 = simd<T>::load(other.data() + i);
+    simd<T>::store(this->data() + i, simd<T>::mul(v0, v1));
+  }
+}
+
+template<typename T>
+void Vector<T>::contiguous_div_inplace(const Vector<T>& other)
+{
+  for(std::size_t i = 0; i < this->aligned_size(); i += simd<T>::width) {
+    typename simd<T>::type v0 = simd<T>::load(this->data() + i);
+    typename simd<T>::type v1 = simd<T>::load(other.data() + i);
+    simd<T>::store(this->data() + i, simd<T>::div(v0, v1));
+  }
+}
+
+template<typename T>
+void Vector<T>::add_inplace(const T value)
+{ for(std::size_t i = 0; i < this->length; ++i) (*this)[i] += value; }
+
+template<typename T>
+void Vector<T>::sub_inplace(const T value)
+{ for(std::size_t i = 0; i < this->length; ++i) (*this)[i] -= value; }
+
+template<typename T>
+void Vector<T>::mul_inplace(const T value)
+{ for(std::size_t i = 0; i < this->length; ++i) (*this)[i] *= value; }
+
+template<typename T>
+void Vector<T>::div_inplace(const T value)
+{ for(std::size_t i = 0; i < this->length; ++i) (*this)[i] /= value; }
+
+template<typename T>
+void Vector<T>::pow_inplace(const T value)
+{ for(std::size_t i = 0; i < this->length; ++i)
+    (*this)[i] = std::pow((*this)[i], value); }
+
+template<typename T>
+void Vector<T>::log_inplace()
+{ for(std::size_t i = 0; i < this->length; ++i)
+    (*this)[i] = std::log((*this)[i]); }
+
+template<typename T>
+void Vector<T>::apply_inplace(const std::function<T(T)>& f)
+{ for(std::size_t i = 0; i < this->length; ++i) (*this)[i] = f((*this)[i]); }
+
+template<typename T>
+Vector<T> Vector<T>::mul(const Vector<T>& other) const
+{
+  Vector<T> result(this->clone());
+  result.mul_inplace(other);
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::div(const Vector<T>& other) const
+{
+  Vector<T> result(this->clone());
+  result.div_inplace(other);
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::pow(const Vector<T>& other) const
+{
+  Vector<T> result(this->clone());
+  result.pow_inplace(other);
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::add(const T value) const
+{
+  Vector<T> result(this->clone());
+  result.add_inplace(value);
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::sub(const T value) const
+{
+  Vector<T> result(this->clone());
+  result.sub_inplace(value);
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::mul(const T value) const
+{
+  Vector<T> result(this->clone());
+  result.mul_inplace(value);
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::div(const T value) const
+{
+  Vector<T> result(this->clone());
+  result.div_inplace(value);
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::pow(const T value) const
+{
+  Vector<T> result(this->clone());
+  result.pow_inplace(value);
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::log() const
+{
+  Vector<T> result(this->clone());
+  result.log_inplace();
+  return result;
+}
+
+template<typename T>
+Vector<T> Vector<T>::apply(const std::function<T(T)>& f)
+{
+  Vector<T> result(this->clone());
+  result.apply_inplace(f);
+  return result;
+}
+
+// Extensions
+template<typename T>
+const T Vector<T>::sum() const
+{
+  T sum = 0.0;
+  for(std::size_t i = 0; i < length; ++i) {
+    sum += (*this)[i];
+  }
+  return sum;
+}
+
+template<typename T>
+const T Vector<T>::maxCoeff() const
+{
+  T max_v = (*this)[0];
+  for(std::size_t i = 1; i < length; ++i) {
+    if(max_v < (*this)[i]) {
+      max_v = (*this)[i];
+    }
+  }
+  return max_v;
+}
+
+template<typename T>
+const T Vector<T>::minCoeff() const
+{
+  T min_v = (*this)[0];
+  for(std::size_t i = 1; i < length; ++i) {
+    if(min_v > (*this)[i]) {
+      min_v = (*this)[i];
+    }
+  }
+  return min_v;
+}
+
+template<typename T>
+const T Vector<T>::maxCoeff(std::size_t& max_i) const
+{
+  max_i = 0;
+  T max_v = (*this)[max_i];
+  for(std::size_t i = 1; i < length; ++i) {
+    if(max_v < (*this)[i]) {
+      max_v = (*this)[i];
+      max_i = i;
+    }
+  }
+  return max_v;
+}
+
+template<typename T>
+const T Vector<T>::minCoeff(std::size_t& min_i) const
+{
+  min_i = 0;
+  T min_v = (*this)[min_i];
+  for(std::size_t i = 1; i < length; ++i) {
+    if(min_v > (*this)[i]) {
+      min_v = (*this)[i];
+      min_i = i;
+    }
+  }
+  return min_v;
+}
+
+// Linear Algebra
+template<typename T>
+T Vector<T>::inner(const Vector<T>& other) const
+{ return this->dot(other); }
+
+template<typename T>
+Vector<T> Vector<T>::dot(const Matrix<T>& other) const
+{ return Vector<T>(Matrix<T>(*this).dot(other)); }
+
+// Non-member functions
+template<typename T>
+const bool operator==(const Vector<T>& a, const Vector<T>& b)
+{
+  assert(a.size() == b.size());
+  for(std::size_t i = 0; i < a.size(); ++i) {
+    if(a[i] != b[i]) return false;
+  }
+  return true;
+}
+
+template<typename T>
+const bool operator!=(const Vector<T>& a, const Vector<T>& b)
+{ return !(a == b); }
+
+template<typename T>
+const bool operator==(const Vector<T>& a, const vector1d<T>& b)
+{
+  assert(a.size() == b.size());
+  for(std::size_t i = 0; i < a.size(); ++i) {
+    if(a[i] != b[i]) return false;
+  }
+  return true;
+}
+
+template<typename T>
+const bool operator!=(const Vector<T>& a, const vector1d<T>& b)
+{ return !(a == b); }
+
+template<typename T>
+const bool operator==(const vector1d<T>& a, const Vector<T>& b)
+{ return b == a; }
+
+template<typename T>
+const bool operator!=(const vector1d<T>& a, const Vector<T>& b)
+{ return b != a; }
+
+// Explicit instantiations
+template class Vector<float>;
+template class Vector<double>;
+
+template Vector<float> operator+(const float&, const Vector<float>&);
+template Vector<float> operator-(const float&, const Vector<float>&);
+template Vector<float> operator*(const float&, const Vector<float>&);
+template Vector<float> operator/(const float&, const Vector<float>&);
+template Vector<float> operator^(const float&, const Vector<float>&);
+template std::ostream& operator<<(std::ostream&, const Vector<float>&);
+template void swap(Vector<float>&, Vector<float>&);
+template const bool operator==(const Vector<float>&, const Vector<float>&);
+template const bool operator!=(const Vector<float>&, const Vector<float>&);
+template const bool operator==(const Vector<float>&, const vector1d<float>&);
+template const bool operator!=(const Vector<float>&, const vector1d<float>&);
+template const bool operator==(const vector1d<float>&, const Vector<float>&);
+template const bool operator!=(const vector1d<float>&, const Vector<float>&);
+
+template Vector<double> operator+(const double&, const Vector<double>&);
+template Vector<double> operator-(const double&, const Vector<double>&);
+template Vector<double> operator*(const double&, const Vector<double>&);
+template Vector<double> operator/(const double&, const Vector<double>&);
+template Vector<double> operator^(const double&, const Vector<double>&);
+template std::ostream& operator<<(std::ostream&, const Vector<double>&);
+template void swap(Vector<double>&, Vector<double>&);
+template const bool operator==(const Vector<double>&, const Vector<double>&);
+template const bool operator!=(const Vector<double>&, const Vector<double>&);
+template const bool operator==(const Vector<double>&, const vector1d<double>&);
+template const bool operator!=(const Vector<double>&, const vector1d<double>&);
+template const bool operator==(const vector1d<double>&, const Vector<double>&);
+template const bool operator!=(const vector1d<double>&, const Vector<double>&);
+
+}  // namespace laplus
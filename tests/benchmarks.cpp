@@ -58,6 +58,371 @@ static void dot(benchmark::State& state)
   }
 }
 
+static void cwise_half(benchmark::State& state)
+{
+  int M = state.range(0);
+  int N = state.range(1);
+
+  lp::Matrixh A(M, N);
+  lp::Matrixh B(M, N);
+
+  while(state.KeepRunning()) {
+    lp::Matrixh C = A * B;
+  }
+}
+
+static void dot_half(benchmark::State& state)
+{
+  int M = state.range(0);
+  int K = state.range(1);
+  int N = state.range(2);
+
+  lp::Matrixf A(M, K);
+  lp::Matrixh B(K, N);
+
+  while(state.KeepRunning()) {
+    lp::Matrixf C = lp::dot(A, B);
+  }
+}
+
+static void dot_int8(benchmark::State& state)
+{
+  int M = state.range(0);
+  int K = state.range(1);
+  int N = state.range(2);
+
+  lp::QuantizedMatrix A(lp::Matrixf(M, K), lp::PerTensor, lp::UInt8);
+  lp::QuantizedMatrix B(lp::Matrixf(K, N), lp::PerCol, lp::Int8);
+
+  while(state.KeepRunning()) {
+    lp::Matrixf C = lp::dot(A, B);
+  }
+}
+
+static void conv2d(benchmark::State& state)
+{
+  int C = state.range(0);
+  int H = state.range(1);
+  lp::ConvAlgorithm algorithm = lp::ConvAlgorithm(state.range(2));
+
+  lp::Tensorf x(lp::dims_t({8, std::size_t(C), std::size_t(H),
+                                std::size_t(H)}));
+  lp::Tensorf w(lp::dims_t({std::size_t(C), std::size_t(C), 3, 3}));
+
+  while(state.KeepRunning()) {
+    lp::Tensorf y = lp::conv2d(x, w, {lp::NCHW, 1, 1, 1, 1, algorithm});
+  }
+}
+
+static void normal(benchmark::State& state)
+{
+  int M = state.range(0);
+  int N = state.range(1);
+
+  while(state.KeepRunning()) {
+    lp::Matrixf A = lp::Matrixf::Normal(M, N);
+  }
+}
+
+static void from_u8(benchmark::State& state)
+{
+  int M = state.range(0);
+  int N = state.range(1);
+
+  std::vector<std::uint8_t> X(M * N);
+
+  while(state.KeepRunning()) {
+    lp::Matrixf A = lp::from_u8(X.data(), M, N, 1.0f / 255.0f, 0.0f);
+  }
+}
+
+static void transpose_copy(benchmark::State& state)
+{
+  int M = state.range(0);
+  int N = state.range(1);
+
+  lp::Matrixf A(M, N);
+
+  while(state.KeepRunning()) {
+    lp::Matrixf B = A.transpose_copy();
+  }
+}
+
+static void transpose_inplace(benchmark::State& state)
+{
+  int N = state.range(0);
+
+  lp::Matrixf A(N, N);
+
+  while(state.KeepRunning()) {
+    A.transpose_inplace();
+  }
+}
+
+static void cwise_mixed(benchmark::State& state)
+{
+  int M = state.range(0);
+  int N = state.range(1);
+
+  lp::Matrixf A(M, N);
+  lp::Matrixf B(N, M);
+
+  while(state.KeepRunning()) {
+    lp::Matrixf C = A * B.transpose();
+  }
+}
+
+static void cwise_materialized(benchmark::State& state)
+{
+  int M = state.range(0);
+  int N = state.range(1);
+
+  lp::Matrixf A(M, N);
+  lp::Matrixf B(N, M);
+
+  while(state.KeepRunning()) {
+    lp::Matrixf C = A * B.transpose_copy();
+  }
+}
+
+static void adam(benchmark::State& state)
+{
+  int M = state.range(0);
+  int N = state.range(1);
+
+  lp::Matrixf W(M, N);
+  lp::Matrixf G(M, N);
+  lp::Optimizer optimizer({lp::OptimizerAdam, 1e-3, 0.0, 0.9, 0.999, 1e-8,
+                           0.0, false});
+  const std::size_t slot = optimizer.add(W);
+
+  while(state.KeepRunning()) {
+    optimizer.step(slot, W, G);
+  }
+}
+
+static void mlp_manual(benchmark::State& state)
+{
+  int M = state.range(0);
+  int N = state.range(1);
+
+  lp::Matrixf X(M, N);
+  lp::Matrixf T(M, 10);
+  lp::Matrixf W0(N, N);
+  lp::Matrixf W1(N, 10);
+
+  while(state.KeepRunning()) {
+    lp::Matrixf H = X.dot(W0).apply(lp::sigmoid);
+    lp::Matrixf Y = H.dot(W1).apply(lp::sigmoid);
+    lp::Matrixf E1 = (Y - T) * Y.apply(lp::dsigmoid);
+    lp::Matrixf E0 = E1.dot(W1.transpose()) * H.apply(lp::dsigmoid);
+    W1.gemm(-0.1, H.transpose(), E1, 1.0);
+    W0.gemm(-0.1, X.transpose(), E0, 1.0);
+  }
+}
+
+static void mlp_tape(benchmark::State& state)
+{
+  int M = state.range(0);
+  int N = state.range(1);
+
+  lp::Matrixf X(M, N);
+  lp::Matrixf T(M, 10);
+  lp::Matrixf W0(N, N);
+  lp::Matrixf W1(N, 10);
+  lp::Tape tape;
+
+  while(state.KeepRunning()) {
+    tape.clear();
+    lp::Var w0 = tape.variable(W0);
+    lp::Var w1 = tape.variable(W1);
+    lp::Var h = tape.sigmoid(tape.dot(tape.constant(X), w0));
+    lp::Var y = tape.sigmoid(tape.dot(h, w1));
+    tape.backward(tape.mse(y, tape.constant(T)));
+    W1.axpy(-0.1, tape.grad(w1));
+    W0.axpy(-0.1, tape.grad(w0));
+  }
+}
+
+static void dfa_eager(benchmark::State& state)
+{
+  int M = state.range(0);
+  int N = state.range(1);
+
+  lp::Matrixf X(M, N);
+  lp::Matrixf T(M, 10);
+  lp::Matrixf W0(N, N);
+  lp::Matrixf W1(N, 10);
+  lp::Matrixf B0(10, N);
+
+  while(state.KeepRunning()) {
+    lp::Matrixf H = X.dot(W0).apply(lp::sigmoid);
+    lp::Matrixf Y = H.dot(W1).apply(lp::sigmoid);
+    lp::Matrixf E = Y - T;
+    lp::Matrixf D = E.dot(B0) * H.apply(lp::dsigmoid);
+    W0.gemm(-0.1, X.transpose(), D, 1.0);
+    W1.gemm(-0.1, H.transpose(), E, 1.0);
+  }
+}
+
+static void dfa_graph(benchmark::State& state)
+{
+  int M = state.range(0);
+  int N = state.range(1);
+
+  lp::Matrixf X(M, N);
+  lp::Matrixf T(M, 10);
+  lp::Matrixf W0(N, N);
+  lp::Matrixf W1(N, 10);
+  lp::Matrixf B0(10, N);
+
+  lp::Graph g;
+  std::size_t x = g.input(M, N);
+  std::size_t t = g.input(M, 10);
+  std::size_t w0 = g.parameter(W0);
+  std::size_t w1 = g.parameter(W1);
+  std::size_t h = g.sigmoid(g.dot(x, w0));
+  std::size_t e = g.sub(g.sigmoid(g.dot(h, w1)), t);
+  std::size_t d = g.mul(g.dot(e, g.parameter(B0)), g.dsigmoid(h));
+  g.update(w0, -0.1, x, d, CblasTrans);
+  g.update(w1, -0.1, h, e, CblasTrans);
+  g.compile();
+
+  while(state.KeepRunning()) {
+    g.bind(x, X);
+    g.bind(t, T);
+    g.run();
+  }
+}
+
+static void apply_sigmoid(benchmark::State& state)
+{
+  int M = state.range(0);
+  int N = state.range(1);
+
+  lp::Matrixf A = lp::Matrixf::Uniform(M, N);
+
+  while(state.KeepRunning()) {
+    lp::Matrixf C = A.apply(lp::sigmoid);
+  }
+}
+
+static void jit_sigmoid(benchmark::State& state)
+{
+  int M = state.range(0);
+  int N = state.range(1);
+
+  std::vector<lp::Matrixf> A = {lp::Matrixf::Uniform(M, N)};
+  lp::JitKernel kernel(lp::Expr::Input(0).sigmoid());
+
+  while(state.KeepRunning()) {
+    lp::Matrixf C = kernel(A);
+  }
+}
+
+static const float least_squares(const std::size_t, const lp::Matrixf& x,
+                                 const lp::Matrixf& t,
+                                 const std::vector<lp::Matrixf>& w,
+                                 std::vector<lp::Matrixf>& g)
+{
+  lp::Matrixf e = x.dot(w[0]) - t;
+  g[0].gemm(1.0f, x.transpose(), e, 0.0f);
+  return 0.0f;
+}
+
+static void train(benchmark::State& state, const lp::TrainerMode mode)
+{
+  int M = state.range(0);
+  int N = state.range(1);
+
+  lp::Matrixf X = lp::Matrixf::Uniform(M, N);
+  lp::Matrixf T = lp::Matrixf::Uniform(M, 10);
+  lp::Matrixf W(N, 10);
+  lp::Trainer trainer({W}, least_squares,
+                      {lp::OptimizerSGD, 1e-4f, 0.0f, 0.9f, 0.999f, 1e-8f,
+                       0.0f, false}, {mode, 0});
+
+  while(state.KeepRunning()) {
+    trainer.epoch(X, T, 64);
+  }
+}
+
+static void train_synchronous(benchmark::State& state)
+{ train(state, lp::TrainerSynchronous); }
+
+static void train_hogwild(benchmark::State& state)
+{ train(state, lp::TrainerHogwild); }
+
+static void dot_square(benchmark::State& state)
+{
+  int N = state.range(0);
+
+  lp::Matrixf A = lp::Matrixf::Uniform(N, N);
+  lp::Matrixf B = lp::Matrixf::Uniform(N, N);
+
+  while(state.KeepRunning()) {
+    lp::Matrixf C = A.dot(B);
+  }
+}
+
+static void strassen_square(benchmark::State& state)
+{
+  int N = state.range(0);
+
+  lp::Matrixf A = lp::Matrixf::Uniform(N, N);
+  lp::Matrixf B = lp::Matrixf::Uniform(N, N);
+  lp::Strassen strassen(state.range(1), true);
+
+  while(state.KeepRunning()) {
+    lp::Matrixf C = strassen.dot(A, B);
+  }
+}
+
+static void gram_gemm(benchmark::State& state)
+{
+  int M = state.range(0);
+  int N = state.range(1);
+
+  lp::Matrixf A(M, N);
+  lp::Matrixf C(N, N);
+
+  while(state.KeepRunning()) {
+    C.gemm(1.0, A.transpose(), A, 0.0);
+  }
+}
+
+static void gram_syrk(benchmark::State& state)
+{
+  int M = state.range(0);
+  int N = state.range(1);
+
+  lp::Matrixf A(M, N);
+  lp::Matrixf C(N, N);
+
+  while(state.KeepRunning()) {
+    C.syrk(CblasUpper, 1.0, A.transpose(), 0.0);
+  }
+}
+
+static void sparse_gradient(benchmark::State& state)
+{
+  std::size_t M = state.range(0);
+  std::size_t K = state.range(1);
+  std::size_t N = state.range(2);
+
+  std::vector<lp::Triplet> T;
+  for(std::size_t i = 0; i < M; ++i) {
+    for(std::size_t k = i % 16; k < K; k += 16) T.push_back({i, k, 1.0});
+  }
+  lp::SparseMatrixf X(M, K, T, lp::CSR);
+  lp::Matrixf E(M, N);
+  lp::Matrixf W(K, N);
+
+  while(state.KeepRunning()) {
+    X.transpose().spmm(CblasLeft, -1.0, E, 1.0, W);
+  }
+}
+
 static void Step2(benchmark::internal::Benchmark* b)
 {
   int m = 1;
@@ -93,7 +458,43 @@ static void Step3(benchmark::internal::Benchmark* b)
   }
 }
 
+static void ConvSteps(benchmark::internal::Benchmark* b)
+{
+  for(int c: {8, 16, 64}) {
+    for(int h: {16, 56}) {
+      b->Args({c, h, lp::ConvIm2col});
+      b->Args({c, h, lp::ConvWinograd});
+    }
+  }
+}
+
 BENCHMARK(cwise)->Apply(Step2);
 BENCHMARK(dot)->Apply(Step3);
+BENCHMARK(cwise_half)->Apply(Step2);
+BENCHMARK(dot_half)->Apply(Step3);
+BENCHMARK(dot_int8)->Apply(Step3);
+BENCHMARK(conv2d)->Apply(ConvSteps);
+BENCHMARK(normal)->Apply(Step2);
+BENCHMARK(from_u8)->Apply(Step2);
+BENCHMARK(transpose_copy)->Apply(Step2)->Args({4096, 4096});
+BENCHMARK(transpose_inplace)->Arg(512)->Arg(4096);
+BENCHMARK(cwise_mixed)->Apply(Step2)->Args({4096, 4096});
+BENCHMARK(cwise_materialized)->Apply(Step2)->Args({4096, 4096});
+BENCHMARK(adam)->Apply(Step2)->Args({4096, 4096});
+BENCHMARK(mlp_manual)->Args({64, 256})->Args({256, 1024});
+BENCHMARK(mlp_tape)->Args({64, 256})->Args({256, 1024});
+BENCHMARK(dfa_eager)->Args({1, 64})->Args({8, 256})->Args({64, 256});
+BENCHMARK(dfa_graph)->Args({1, 64})->Args({8, 256})->Args({64, 256});
+BENCHMARK(apply_sigmoid)->Apply(Step2);
+BENCHMARK(jit_sigmoid)->Apply(Step2);
+BENCHMARK(train_synchronous)->Args({4096, 256});
+BENCHMARK(train_hogwild)->Args({4096, 256});
+BENCHMARK(dot_square)->Arg(2048)->Arg(4096)->Arg(8192)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(strassen_square)->Args({2048, 1024})->Args({4096, 1024})
+  ->Args({8192, 1024})->Args({8192, 2048})->Unit(benchmark::kMillisecond);
+BENCHMARK(gram_gemm)->Apply(Step2);
+BENCHMARK(gram_syrk)->Apply(Step2);
+BENCHMARK(sparse_gradient)->Apply(Step3);
 
 BENCHMARK_MAIN();
@@ -0,0 +1,152 @@
+/******************************************************************************
+ *
+ * laplus/archive.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/archive.hpp"
+#include "laplus/vectorf.hpp"
+#include "laplus/matrixf.hpp"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace laplus {
+
+namespace {
+
+const std::string path = "laplus_archive_test.lpa";
+
+}  // unnamed namespace
+
+TEST(LAPlusArchive, RoundTrip)
+{
+  const Matrixf A = Matrixf::Uniform(5, 7);
+  const Matrixf B = Matrixf::Uniform(3, 4).transpose();
+  const Matrix<double> C = Matrix<double>::Normal(2, 9);
+  const Vectorf u = Vectorf::Uniform(11);
+  const Vectorf v = A.col(2);
+
+  {
+    ArchiveWriter writer(path);
+    ASSERT_TRUE(writer.is_open());
+    writer.write("A", A);
+    writer.write("B", B);
+    writer.write("C", C);
+    writer.write("u", u);
+    writer.write("layer.0.bias", v);
+  }
+
+  const Archive archive(path);
+  ASSERT_TRUE(archive.is_open());
+  ASSERT_EQ(5, archive.names().size());
+  ASSERT_TRUE(archive.contains("layer.0.bias"));
+  ASSERT_FALSE(archive.contains("D"));
+  ASSERT_EQ(Float64, archive.dtype("C"));
+  ASSERT_EQ(shape_t(4, 3), archive.shape("B"));
+
+  const Matrixf A0 = archive.matrix<float>("A");
+  const Matrixf B0 = archive.matrix<float>("B");
+  ASSERT_EQ(A, A0);
+  ASSERT_EQ(B, B0);
+  ASSERT_EQ(CblasColMajor, B0.layout());
+  ASSERT_EQ(C, archive.matrix<double>("C"));
+  ASSERT_EQ(u, archive.vector<float>("u"));
+  ASSERT_EQ(v, archive.vector<float>("layer.0.bias"));
+
+  // Payloads are aligned views of the mapping.
+  ASSERT_EQ(0, reinterpret_cast<std::uintptr_t>(A0.data()) % 64);
+  ASSERT_EQ(0, reinterpret_cast<std::uintptr_t>(B0.data()) % 64);
+
+  std::remove(path.c_str());
+}
+
+TEST(LAPlusArchive, Lifetime)
+{
+  const Matrixf A = Matrixf::Uniform(16, 16);
+  {
+    ArchiveWriter writer(path);
+    writer.write("A", A);
+  }
+
+  Matrixf A0(1, 1);
+  {
+    const Archive archive(path);
+    A0 = archive.matrix<float>("A");
+    ASSERT_EQ(2, A0.use_count());
+  }
+  ASSERT_EQ(1, A0.use_count());
+  ASSERT_EQ(A, A0);
+
+  // Writes are private to the process and never reach the file.
+  A0(0, 0) = -1.0;
+  ASSERT_FLOAT_EQ(-1.0, A0(0, 0));
+  ASSERT_EQ(A, Archive(path).matrix<float>("A"));
+
+  std::remove(path.c_str());
+}
+
+TEST(LAPlusArchive, Invalid)
+{
+  ASSERT_FALSE(Archive("laplus_archive_missing.lpa").is_open());
+
+  {
+    std::ofstream stream(path, std::ios::binary);
+    stream << std::string(128, 'x');
+  }
+  ASSERT_FALSE(Archive(path).is_open());
+
+  {
+    ArchiveWriter writer(path);
+    writer.write("A", Matrixf::Uniform(8, 8));
+  }
+  {
+    std::ofstream stream(path, std::ios::binary | std::ios::in);
+    stream.seekp(64 + 16);
+    const std::uint64_t rows = 1 << 20;
+    stream.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+  }
+  ASSERT_FALSE(Archive(path).is_open());
+
+  // The product of the dimensions wraps around to the real payload size.
+  {
+    ArchiveWriter writer(path);
+    writer.write("A", Matrixf::Uniform(8, 8));
+  }
+  {
+    std::ofstream stream(path, std::ios::binary | std::ios::in);
+    stream.seekp(64 + 16);
+    const std::uint64_t rows = (std::uint64_t(1) << 59) + 8;
+    stream.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+  }
+  ASSERT_FALSE(Archive(path).is_open());
+
+  std::remove(path.c_str());
+}
+
+}  // namespace laplus
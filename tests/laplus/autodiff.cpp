@@ -0,0 +1,172 @@
+/******************************************************************************
+ *
+ * laplus/autodiff.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/autodiff.hpp"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <functional>
+
+namespace laplus {
+
+namespace {
+
+using Loss = std::function<Var(Tape&, const Var&)>;
+
+// Compares the gradient of f at x with central differences.
+void CheckGradient(const Matrixf& x, const Loss& f)
+{
+  Tape tape;
+  const Var v = tape.variable(x);
+  tape.backward(f(tape, v));
+  const Matrixf g = tape.grad(v).clone();
+
+  const float h = 1e-2f;
+  for(std::size_t i = 0; i < x.rows(); ++i) {
+    for(std::size_t j = 0; j < x.cols(); ++j) {
+      const float x0 = x(i, j);
+      x(i, j) = x0 + h;
+      tape.clear();
+      const float f1 = tape.value(f(tape, tape.variable(x)))(0, 0);
+      x(i, j) = x0 - h;
+      tape.clear();
+      const float f0 = tape.value(f(tape, tape.variable(x)))(0, 0);
+      x(i, j) = x0;
+      ASSERT_NEAR(g(i, j), (f1 - f0) / (2 * h), 2e-2);
+    }
+  }
+}
+
+}  // unnamed namespace
+
+TEST(LAPlusAutodiff, Elementwise) {
+  const Matrixf x = Matrixf::Uniform(3, 5, -1.0, 1.0);
+  const Matrixf c = Matrixf::Uniform(3, 5, -1.0, 1.0);
+
+  CheckGradient(x, [&](Tape& t, const Var& v) {
+    return t.sum(t.sigmoid(v) * (v + t.constant(c)));
+  });
+  CheckGradient(x, [&](Tape& t, const Var& v) {
+    return t.mean(t.tanh(v - t.constant(c)) * 3.0f);
+  });
+  CheckGradient(x, [&](Tape& t, const Var& v) {
+    return t.sum(t.relu(v) * v);
+  });
+}
+
+TEST(LAPlusAutodiff, Dot) {
+  const Matrixf x = Matrixf::Uniform(4, 3, -1.0, 1.0);
+  const Matrixf w = Matrixf::Uniform(3, 5, -1.0, 1.0);
+  const Matrixf b = Matrixf::Uniform(1, 5, -1.0, 1.0);
+  const Matrixf t0 = Matrixf::Uniform(4, 5, 0.0, 1.0);
+
+  CheckGradient(w, [&](Tape& t, const Var& v) {
+    return t.mse(t.sigmoid(t.dot(t.constant(x), v) + t.constant(b)),
+                 t.constant(t0));
+  });
+  CheckGradient(x, [&](Tape& t, const Var& v) {
+    return t.mse(t.dot(v, t.constant(w)), t.constant(t0));
+  });
+  CheckGradient(b, [&](Tape& t, const Var& v) {
+    return t.sum(t.tanh(t.dot(t.constant(x), t.constant(w)) + v));
+  });
+}
+
+TEST(LAPlusAutodiff, SoftmaxCrossEntropy) {
+  const Matrixf x = Matrixf::Uniform(4, 6, -2.0, 2.0);
+  Matrixf p(4, 6);
+  for(std::size_t i = 0; i < 4; ++i) p(i, i + 1) = 1.0f;
+
+  CheckGradient(x, [&](Tape& t, const Var& v) {
+    return t.softmax_cross_entropy(v, t.constant(p));
+  });
+
+  Tape tape;
+  const Var y = tape.softmax_cross_entropy(tape.constant(x),
+                                           tape.constant(p));
+  double expected = 0.0;
+  for(std::size_t i = 0; i < 4; ++i) {
+    double s = 0.0;
+    for(std::size_t j = 0; j < 6; ++j) s += std::exp(x(i, j));
+    expected -= x(i, i + 1) - std::log(s);
+  }
+  ASSERT_NEAR(tape.value(y)(0, 0), expected / 4, 1e-5);
+}
+
+TEST(LAPlusAutodiff, Accumulate) {
+  const Matrixf x = Matrixf::Uniform(2, 3, -1.0, 1.0);
+  Tape tape;
+  const Var v = tape.variable(x);
+  tape.backward(tape.sum(v + v));
+
+  const Matrixf g = tape.grad(v);
+  for(std::size_t i = 0; i < g.size(); ++i) {
+    ASSERT_FLOAT_EQ(g.data()[i], 2.0f);
+  }
+}
+
+TEST(LAPlusAutodiff, Transposed) {
+  const Matrixf x = Matrixf::Uniform(5, 4, -1.0, 1.0).transpose();
+  const Matrixf c = Matrixf::Uniform(4, 5, -1.0, 1.0);
+
+  Tape tape;
+  const Var v = tape.variable(x);
+  const Var y = v * tape.constant(c);
+  tape.backward(tape.sum(y));
+
+  const Matrixf g = tape.grad(v);
+  for(std::size_t i = 0; i < 4; ++i) {
+    for(std::size_t j = 0; j < 5; ++j) {
+      ASSERT_FLOAT_EQ(tape.value(y)(i, j), x(i, j) * c(i, j));
+      ASSERT_FLOAT_EQ(g(i, j), c(i, j));
+    }
+  }
+}
+
+TEST(LAPlusAutodiff, ReuseBuffers) {
+  const Matrixf x = Matrixf::Uniform(8, 6, -1.0, 1.0);
+  const Matrixf w0 = Matrixf::Uniform(6, 5, -1.0, 1.0);
+  const Matrixf w1 = Matrixf::Uniform(5, 3, -1.0, 1.0);
+  const Matrixf p = Matrixf::Uniform(8, 3, 0.0, 1.0);
+
+  Tape tape;
+  std::size_t buffers = 0;
+  for(std::size_t k = 0; k < 3; ++k) {
+    tape.clear();
+    const Var h = tape.sigmoid(tape.dot(tape.constant(x),
+                                        tape.variable(w0)));
+    const Var y = tape.dot(h, tape.variable(w1));
+    tape.backward(tape.mse(y, tape.constant(p)));
+    if(k == 0) buffers = tape.buffers();
+    ASSERT_EQ(tape.size(), 8);
+    ASSERT_EQ(tape.buffers(), buffers);
+  }
+}
+
+}  // namespace laplus
@@ -0,0 +1,114 @@
+/******************************************************************************
+ *
+ * laplus/communicator.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/communicator.hpp"
+#include "gtest/gtest.h"
+#include "process.hpp"
+
+#include <string>
+#include <vector>
+
+namespace laplus {
+
+namespace {
+
+const std::size_t ranks = 4;
+
+Matrixf filled(const std::size_t rows, const std::size_t cols,
+               const std::size_t rank)
+{
+  std::vector<float> values(rows * cols);
+  for(std::size_t i = 0; i < values.size(); ++i)
+    values[i] = 100.0f * rank + i;
+  return Matrixf(values, rows, cols);
+}
+
+}  // unnamed namespace
+
+TEST(LAPlusCommunicator, Allreduce) {
+  const std::string name = unique("allreduce");
+  EXPECT_TRUE(spawn(ranks, [&](const std::size_t rank) {
+    Communicator comm(name, rank, ranks, 5);
+    if(!comm.is_open()) return false;
+    Matrixf m = filled(7, 3, rank);
+    comm.allreduce(m);
+    for(std::size_t i = 0; i < m.size(); ++i)
+      if(m.data()[i] != 600.0f + 4.0f * i) return false;
+    return true;
+  }));
+}
+
+TEST(LAPlusCommunicator, Broadcast) {
+  const std::string name = unique("broadcast");
+  EXPECT_TRUE(spawn(ranks, [&](const std::size_t rank) {
+    Communicator comm(name, rank, ranks, 4);
+    Matrixf m = filled(5, 5, rank);
+    comm.broadcast(m, 2);
+    for(std::size_t i = 0; i < m.size(); ++i)
+      if(m.data()[i] != 200.0f + i) return false;
+    return true;
+  }));
+}
+
+TEST(LAPlusCommunicator, Allgather) {
+  const std::string name = unique("allgather");
+  EXPECT_TRUE(spawn(ranks, [&](const std::size_t rank) {
+    Communicator comm(name, rank, ranks, 4);
+    const Matrixf m = filled(2, 3, rank);
+    Matrixf result = filled(ranks * 2, 3, 0);
+    comm.allgather(m, result);
+    for(std::size_t k = 0; k < ranks; ++k)
+      for(std::size_t i = 0; i < 6; ++i)
+        if(result.data()[6 * k + i] != 100.0f * k + i) return false;
+    return true;
+  }));
+}
+
+TEST(LAPlusCommunicator, Sequence) {
+  // Alternating collectives of odd chunk counts reuse both banks.
+  const std::string name = unique("sequence");
+  EXPECT_TRUE(spawn(ranks, [&](const std::size_t rank) {
+    Communicator comm(name, rank, ranks, 3);
+    bool ok = (comm.rank() == rank && comm.size() == ranks);
+    for(std::size_t n = 0; n < 10; ++n) {
+      Matrixf a = filled(1, 7, rank);
+      comm.allreduce(a);
+      Matrixf b = filled(1, 5, rank);
+      comm.broadcast(b, n % ranks);
+      for(std::size_t i = 0; i < 7; ++i)
+        ok = ok && a.data()[i] == 600.0f + 4.0f * i;
+      for(std::size_t i = 0; i < 5; ++i)
+        ok = ok && b.data()[i] == 100.0f * (n % ranks) + i;
+      comm.barrier();
+    }
+    return ok;
+  }));
+}
+
+}  // namespace laplus
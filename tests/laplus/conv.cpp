@@ -0,0 +1,146 @@
+/******************************************************************************
+ *
+ * laplus/conv.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/conv.hpp"
+#include "laplus/matrixf.hpp"
+#include "gtest/gtest.h"
+#include "helpers.hpp"
+
+namespace laplus {
+
+namespace {
+
+dims_t Dims(const ConvLayout layout, const std::size_t n,
+            const std::size_t c, const std::size_t h, const std::size_t w)
+{
+  if(layout == NCHW) return dims_t({n, c, h, w});
+  return dims_t({n, h, w, c});
+}
+
+// Direct convolution calling f(x, w, y) with the index of every product
+// that contributes to the output.
+template<typename F>
+void Reference(const dims_t& x, const dims_t& w, const ConvParams& p,
+               const F& f)
+{
+  const bool planar = (p.layout == NCHW);
+  const std::size_t N = x[0], C = planar ? x[1] : x[3];
+  const std::size_t H = planar ? x[2] : x[1], W = planar ? x[3] : x[2];
+  const std::size_t O = w[0];
+  const std::size_t KH = planar ? w[2] : w[1], KW = planar ? w[3] : w[2];
+  const std::size_t OH = (H + 2 * p.pad_h - KH) / p.stride_h + 1;
+  const std::size_t OW = (W + 2 * p.pad_w - KW) / p.stride_w + 1;
+  for(std::size_t n = 0; n < N; ++n)
+  for(std::size_t o = 0; o < O; ++o)
+  for(std::size_t r = 0; r < OH; ++r)
+  for(std::size_t q = 0; q < OW; ++q)
+  for(std::size_t c = 0; c < C; ++c)
+  for(std::size_t i = 0; i < KH; ++i)
+  for(std::size_t j = 0; j < KW; ++j) {
+    const long h = long(r * p.stride_h + i) - long(p.pad_h);
+    const long v = long(q * p.stride_w + j) - long(p.pad_w);
+    if(h < 0 || v < 0 || h >= long(H) || v >= long(W)) continue;
+    f(n, c, h, v, o, i, j, r, q);
+  }
+}
+
+void Check(const std::size_t N, const std::size_t C, const std::size_t H,
+           const std::size_t W, const std::size_t O, const std::size_t K,
+           const ConvParams& p)
+{
+  const ConvLayout l = p.layout;
+  const Tensorf x = Random(Dims(l, N, C, H, W));
+  const Tensorf w = Random(Dims(l, O, C, K, K));
+  const Tensorf y = conv2d(x, w, p);
+  const Tensorf dy = Random(y.dims());
+  const Tensorf dx = conv2d_backward_data(dy, w, x.dims(), p);
+  const Tensorf dw = conv2d_backward_weight(x, dy, w.dims(), p);
+
+  Tensorf y0(y.dims());
+  Tensorf dx0(x.dims());
+  Tensorf dw0(w.dims());
+  Reference(x.dims(), w.dims(), p,
+            [&](std::size_t n, std::size_t c, std::size_t h, std::size_t v,
+                std::size_t o, std::size_t i, std::size_t j,
+                std::size_t r, std::size_t q) {
+    At(y0, l, n, o, r, q) += At(x, l, n, c, h, v) * At(w, l, o, c, i, j);
+    At(dx0, l, n, c, h, v) += At(dy, l, n, o, r, q) * At(w, l, o, c, i, j);
+    At(dw0, l, o, c, i, j) += At(dy, l, n, o, r, q) * At(x, l, n, c, h, v);
+  });
+
+  const Tensorf e0 = y - y0;
+  const Tensorf e1 = dx - dx0;
+  const Tensorf e2 = dw - dw0;
+  for(std::size_t k = 0; k < y.size(); ++k) {
+    ASSERT_NEAR(e0.data()[k], 0.0, 1e-4);
+  }
+  for(std::size_t k = 0; k < x.size(); ++k) {
+    ASSERT_NEAR(e1.data()[k], 0.0, 1e-4);
+  }
+  for(std::size_t k = 0; k < w.size(); ++k) {
+    ASSERT_NEAR(e2.data()[k], 0.0, 1e-4);
+  }
+}
+
+}  // unnamed namespace
+
+TEST(LAPlusConv, Im2colNCHW) {
+  Check(2, 3, 7, 9, 4, 3, {NCHW, 1, 1, 1, 1, ConvIm2col});
+  Check(3, 2, 9, 8, 5, 3, {NCHW, 2, 2, 0, 0, ConvIm2col});
+  Check(1, 4, 10, 6, 3, 5, {NCHW, 2, 1, 2, 1, ConvIm2col});
+  Check(2, 70, 12, 12, 3, 1, {NCHW, 1, 1, 0, 0, ConvIm2col});
+}
+
+TEST(LAPlusConv, Im2colNHWC) {
+  Check(2, 3, 7, 9, 4, 3, {NHWC, 1, 1, 1, 1, ConvIm2col});
+  Check(3, 2, 9, 8, 5, 3, {NHWC, 2, 2, 0, 0, ConvIm2col});
+  Check(1, 4, 10, 6, 3, 5, {NHWC, 2, 1, 2, 1, ConvIm2col});
+  Check(2, 70, 12, 12, 3, 1, {NHWC, 1, 1, 0, 0, ConvIm2col});
+}
+
+TEST(LAPlusConv, Winograd) {
+  Check(2, 3, 7, 9, 4, 3, {NCHW, 1, 1, 1, 1, ConvWinograd});
+  Check(2, 3, 8, 5, 4, 3, {NCHW, 1, 1, 0, 2, ConvWinograd});
+  Check(2, 3, 7, 9, 4, 3, {NHWC, 1, 1, 1, 1, ConvWinograd});
+  Check(1, 17, 6, 6, 16, 3, {NHWC, 1, 1, 1, 0, ConvAuto});
+}
+
+TEST(LAPlusConv, View) {
+  const Tensorf x = Random({2, 5, 5, 3});
+  const Tensorf w = Random({4, 3, 3, 3});
+  const Tensorf y0 = conv2d(x, w, {NHWC, 1, 1, 1, 1, ConvIm2col});
+  const Tensorf y1 = conv2d(x.permute({0, 3, 1, 2}), w.permute({0, 3, 1, 2}),
+                            {NCHW, 1, 1, 1, 1, ConvWinograd});
+  const Tensorf e0 = y0 - y1.permute({0, 2, 3, 1});
+  for(std::size_t k = 0; k < e0.size(); ++k) {
+    ASSERT_NEAR(e0.data()[k], 0.0, 1e-4);
+  }
+}
+
+}  // namespace laplus
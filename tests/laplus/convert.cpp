@@ -0,0 +1,140 @@
+/******************************************************************************
+ *
+ * laplus/convert.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/convert.hpp"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace laplus {
+
+TEST(LAPlusConvert, Widen)
+{
+  const std::size_t n = 1000;
+  std::vector<std::uint8_t> u8(n);
+  std::vector<std::int16_t> i16(n);
+  std::vector<std::int32_t> i32(n);
+  std::vector<double> f64(n);
+  for(std::size_t i = 0; i < n; ++i) {
+    u8[i] = (i * 37) % 256;
+    i16[i] = static_cast<std::int16_t>(i * 997 - 30000);
+    i32[i] = static_cast<std::int32_t>(i * 123457) - 60000000;
+    f64[i] = std::sin(double(i)) * 1e3;
+  }
+
+  std::vector<float> y(n);
+  convert(u8.data(), y.data(), n, 1.0f / 255, -0.5f);
+  for(std::size_t i = 0; i < n; ++i) {
+    ASSERT_NEAR(u8[i] / 255.0f - 0.5f, y[i], 1e-6);
+  }
+  convert(i16.data(), y.data(), n, 0.5f, 1.0f);
+  for(std::size_t i = 0; i < n; ++i) ASSERT_FLOAT_EQ(i16[i] * 0.5f + 1, y[i]);
+  convert(i32.data(), y.data(), n, 1.0f, 0.0f);
+  for(std::size_t i = 0; i < n; ++i) ASSERT_FLOAT_EQ(float(i32[i]), y[i]);
+  convert(f64.data(), y.data(), n, 2.0f, 0.0f);
+  for(std::size_t i = 0; i < n; ++i) ASSERT_FLOAT_EQ(float(f64[i]) * 2, y[i]);
+
+  const Matrixf A = from_u8(u8.data(), 25, 40, 2.0f, 1.0f);
+  ASSERT_EQ(25, A.rows());
+  ASSERT_EQ(40, A.cols());
+  for(std::size_t i = 0; i < 25; ++i) {
+    for(std::size_t j = 0; j < 40; ++j) {
+      ASSERT_FLOAT_EQ(u8[i * 40 + j] * 2.0f + 1.0f, A(i, j));
+    }
+  }
+  ASSERT_EQ(from_i32(i32.data(), 10, 100, 1.0f, 0.0f)(3, 7), float(i32[307]));
+}
+
+TEST(LAPlusConvert, Narrow)
+{
+  const std::size_t n = 1003;
+  std::vector<float> x(n);
+  for(std::size_t i = 0; i < n; ++i) x[i] = (float(i) - 500.0f) * 0.75f;
+  x[0] = std::numeric_limits<float>::quiet_NaN();
+  x[1] = 2.5f;
+  x[2] = 3.5f;
+  x[3] = 1e10f;
+  x[4] = -1e10f;
+
+  std::vector<std::uint8_t> u8(n);
+  convert(x.data(), u8.data(), n, 1.0f, 0.0f);
+  std::vector<std::int16_t> i16(n);
+  convert(x.data(), i16.data(), n, 100.0f, 0.0f);
+  std::vector<std::int32_t> i32(n);
+  convert(x.data(), i32.data(), n, 1.0f, 0.5f);
+  std::vector<double> f64(n);
+  convert(x.data(), f64.data(), n, 1.0f, 0.0f);
+
+  ASSERT_EQ(0, u8[0]);
+  ASSERT_EQ(2, u8[1]);
+  ASSERT_EQ(4, u8[2]);
+  ASSERT_EQ(255, u8[3]);
+  ASSERT_EQ(0, u8[4]);
+  ASSERT_EQ(-32768, i16[0]);
+  ASSERT_EQ(32767, i16[3]);
+  ASSERT_EQ(-32768, i16[4]);
+  ASSERT_EQ(2147483520, i32[3]);
+  ASSERT_EQ(-2147483647 - 1, i32[4]);
+  ASSERT_EQ(3, i32[1]);
+  ASSERT_EQ(4, i32[2]);
+  for(std::size_t i = 5; i < n; ++i) {
+    const float v = x[i];
+    ASSERT_EQ(std::nearbyint(std::min(std::max(v, 0.0f), 255.0f)), u8[i]);
+    ASSERT_EQ(std::nearbyint(std::min(std::max(v * 100, -32768.0f),
+                                      32767.0f)), i16[i]);
+    ASSERT_EQ(std::nearbyint(v + 0.5f), i32[i]);
+    ASSERT_EQ(double(v), f64[i]);
+  }
+}
+
+TEST(LAPlusConvert, Matrix)
+{
+  std::vector<std::int16_t> values(37 * 19);
+  for(std::size_t i = 0; i < values.size(); ++i) values[i] = i - 300;
+  const Matrixf A = from_i16(values.data(), 37, 19, 1.0f, 0.0f);
+
+  std::vector<std::int16_t> a(values.size());
+  to_i16(A, a.data(), 1.0f, 0.0f);
+  ASSERT_EQ(values, a);
+
+  // Transposed matrices are written in row-major order of their view.
+  const Matrixf B = from_i16(values.data(), 19, 37, 1.0f, 0.0f).transpose();
+  std::vector<double> b(values.size());
+  to_f64(B, b.data(), 2.0f, 0.0f);
+  for(std::size_t i = 0; i < 37; ++i) {
+    for(std::size_t j = 0; j < 19; ++j) {
+      ASSERT_EQ(2.0 * values[j * 37 + i], b[i * 19 + j]);
+    }
+  }
+}
+
+}  // namespace laplus
@@ -0,0 +1,166 @@
+/******************************************************************************
+ *
+ * laplus/data_loader.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/data_loader.hpp"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace laplus {
+
+namespace {
+
+const std::string images = "laplus_loader_images.idx";
+const std::string labels = "laplus_loader_labels.idx";
+
+void WriteIDX(const std::string& path, const std::vector<std::uint32_t>& dims,
+              const std::vector<std::uint8_t>& data)
+{
+  std::string header("\x00\x00\x08", 3);
+  header += char(dims.size());
+  for(std::uint32_t d: dims) {
+    for(int shift = 24; shift >= 0; shift -= 8) header += char(d >> shift);
+  }
+  std::ofstream stream(path, std::ios::binary);
+  stream.write(header.data(), header.size());
+  stream.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+// Ten 3 x 3 images whose pixels are all 10 * i + label i % 4.
+void WriteDataset()
+{
+  std::vector<std::uint8_t> x;
+  std::vector<std::uint8_t> t;
+  for(std::size_t i = 0; i < 10; ++i) {
+    for(std::size_t j = 0; j < 9; ++j) x.push_back(10 * i + j);
+    t.push_back(i % 4);
+  }
+  WriteIDX(images, {10, 3, 3}, x);
+  WriteIDX(labels, {10}, t);
+}
+
+}  // unnamed namespace
+
+TEST(LAPlusDataLoader, Records)
+{
+  WriteDataset();
+  const Records x = Records::IDX(images);
+  ASSERT_TRUE(x.is_open());
+  ASSERT_EQ(10, x.size());
+  ASSERT_EQ(9, x.record_size());
+  ASSERT_EQ(34, x[3][4]);
+
+  const Records y(labels, 8, 1);
+  ASSERT_TRUE(y.is_open());
+  ASSERT_EQ(10, y.size());
+  ASSERT_EQ(3, y[7][0]);
+
+  ASSERT_FALSE(Records::IDX("laplus_loader_missing.idx").is_open());
+
+  std::remove(images.c_str());
+  std::remove(labels.c_str());
+}
+
+TEST(LAPlusDataLoader, Sequential)
+{
+  WriteDataset();
+  DataLoader loader(Records::IDX(images), Records::IDX(labels),
+                    {4, 4, 0.5, -1.0, false, false, 0, 2, 2});
+  ASSERT_EQ(3, loader.batches());
+
+  Matrixf x(1, 1);
+  Matrixf t(1, 1);
+  for(std::size_t epoch = 0; epoch < 3; ++epoch) {
+    ASSERT_EQ(epoch, loader.epoch());
+    for(std::size_t b = 0; b < 3; ++b) {
+      ASSERT_TRUE(loader.next(x, t));
+      const std::size_t rows = (b < 2) ? 4 : 2;
+      ASSERT_EQ(rows, x.rows());
+      ASSERT_EQ(9, x.cols());
+      ASSERT_EQ(rows, t.rows());
+      ASSERT_EQ(4, t.cols());
+      for(std::size_t i = 0; i < rows; ++i) {
+        const std::size_t index = 4 * b + i;
+        for(std::size_t j = 0; j < 9; ++j) {
+          ASSERT_FLOAT_EQ(0.5 * (10 * index + j) - 1.0, x(i, j));
+        }
+        for(std::size_t j = 0; j < 4; ++j) {
+          ASSERT_FLOAT_EQ(j == index % 4 ? 1.0 : 0.0, t(i, j));
+        }
+      }
+    }
+    ASSERT_FALSE(loader.next(x, t));
+  }
+
+  std::remove(images.c_str());
+  std::remove(labels.c_str());
+}
+
+TEST(LAPlusDataLoader, Shuffle)
+{
+  WriteDataset();
+  const Records x = Records::IDX(images);
+  const Records y = Records::IDX(labels);
+
+  std::vector<std::vector<float>> runs;
+  for(std::size_t workers: {1, 3}) {
+    DataLoader loader(x, y, {3, 0, 1.0, 0.0, true, true, 7, 3, workers});
+    ASSERT_EQ(3, loader.batches());
+
+    std::vector<float> run;
+    Matrixf xb(1, 1);
+    Matrixf tb(1, 1);
+    for(std::size_t epoch = 0; epoch < 4; ++epoch) {
+      std::set<float> seen;
+      while(loader.next(xb, tb)) {
+        ASSERT_EQ(3, xb.rows());
+        ASSERT_EQ(1, tb.cols());
+        for(std::size_t i = 0; i < xb.rows(); ++i) {
+          ASSERT_FLOAT_EQ(xb(i, 0) / 10, tb(i, 0) + 4 * int(xb(i, 0) / 40));
+          seen.insert(xb(i, 0));
+          run.push_back(xb(i, 0));
+        }
+      }
+      ASSERT_EQ(9, seen.size());
+    }
+    runs.push_back(run);
+  }
+  ASSERT_EQ(runs[0], runs[1]);
+  ASSERT_NE(std::vector<float>(runs[0].begin(), runs[0].begin() + 9),
+            std::vector<float>(runs[0].begin() + 9, runs[0].begin() + 18));
+
+  std::remove(images.c_str());
+  std::remove(labels.c_str());
+}
+
+}  // namespace laplus
@@ -0,0 +1,171 @@
+/******************************************************************************
+ *
+ * laplus/graph.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/graph.hpp"
+#include "laplus/math.hpp"
+#include "gtest/gtest.h"
+#include "helpers.hpp"
+
+namespace laplus {
+
+TEST(LAPlusGraph, Forward) {
+  const Matrixf x = Matrixf::Uniform(37, 20, -1.0, 1.0);
+  const Matrixf w = Matrixf::Uniform(20, 30, -1.0, 1.0);
+  const Matrixf b = Matrixf::Uniform(1, 30, -1.0, 1.0);
+  const Matrixf t = Matrixf::Uniform(37, 30, -1.0, 1.0);
+
+  Graph g;
+  const std::size_t gx = g.input(37, 20);
+  const std::size_t gw = g.parameter(w);
+  const std::size_t gb = g.parameter(b);
+  const std::size_t gt = g.input(37, 30);
+  const std::size_t y = g.sigmoid(g.add(g.dot(gx, gw), gb));
+  const std::size_t e = g.mul(g.sub(y, gt), g.dsigmoid(y));
+  g.output(y);
+  g.output(e);
+  g.compile();
+
+  // One GEMM, the sigmoid kernel and one fused kernel for e.
+  ASSERT_EQ(g.kernels(), 3);
+
+  g.bind(gx, x);
+  g.bind(gt, t);
+  g.run();
+
+  Matrixf z = x.dot(w);
+  for(std::size_t i = 0; i < z.rows(); ++i) {
+    for(std::size_t j = 0; j < z.cols(); ++j) {
+      z(i, j) = sigmoid(z(i, j) + b(0, j));
+    }
+  }
+  ExpectNear(g.value(y), z, 1e-5);
+  ExpectNear(g.value(e), (z - t) * z.apply(dsigmoid), 1e-5);
+}
+
+TEST(LAPlusGraph, Update) {
+  const Matrixf x = Matrixf::Uniform(16, 12, -1.0, 1.0);
+  const Matrixf b = Matrixf::Uniform(5, 8, -1.0, 1.0);
+  const Matrixf t = Matrixf::Uniform(16, 5, 0.0, 1.0);
+  Matrixf w0 = Matrixf::Uniform(12, 8, -1.0, 1.0);
+  Matrixf w1 = Matrixf::Uniform(8, 5, -1.0, 1.0);
+  Matrixf v0 = w0.clone();
+  Matrixf v1 = w1.clone();
+
+  // A direct feedback alignment step.
+  Graph g;
+  const std::size_t gx = g.input(16, 12);
+  const std::size_t gt = g.input(16, 5);
+  const std::size_t p0 = g.parameter(w0);
+  const std::size_t p1 = g.parameter(w1);
+  const std::size_t pb = g.parameter(b);
+  const std::size_t h = g.sigmoid(g.dot(gx, p0));
+  const std::size_t y = g.sigmoid(g.dot(h, p1));
+  const std::size_t e = g.sub(y, gt);
+  const std::size_t d = g.mul(g.dot(e, pb), g.dsigmoid(h));
+  g.update(p0, -0.1f, gx, d, CblasTrans);
+  g.update(p1, -0.1f, h, e, CblasTrans);
+  g.compile();
+
+  for(std::size_t k = 0; k < 3; ++k) {
+    g.bind(gx, x);
+    g.bind(gt, t);
+    g.run();
+
+    Matrixf hv = x.dot(v0).apply(sigmoid);
+    Matrixf yv = hv.dot(v1).apply(sigmoid);
+    Matrixf ev = yv - t;
+    Matrixf dv = ev.dot(b) * hv.apply(dsigmoid);
+    v0.gemm(-0.1, x.transpose(), dv, 1.0);
+    v1.gemm(-0.1, hv.transpose(), ev, 1.0);
+  }
+  ExpectNear(w0, v0, 1e-5);
+  ExpectNear(w1, v1, 1e-5);
+}
+
+TEST(LAPlusGraph, Registers) {
+  const Matrixf x = Matrixf::Uniform(9, 40, -1.0, 1.0);
+  const Matrixf y = Matrixf::Uniform(9, 40, -1.0, 1.0);
+
+  // The chain fills all but one register, which the load of gy needs.
+  Graph g;
+  const std::size_t gx = g.input(9, 40);
+  const std::size_t gy = g.input(9, 40);
+  std::size_t chain = gx;
+  for(std::size_t k = 0; k < 14; ++k) chain = g.tanh(chain);
+  const std::size_t z = g.mul(chain, gy);
+  g.output(z);
+  g.compile();
+
+  g.bind(gx, x);
+  g.bind(gy, y);
+  g.run();
+
+  Matrixf v = x.clone();
+  for(std::size_t k = 0; k < 14; ++k) v = v.apply(tanh);
+  ExpectNear(g.value(z), v * y, 1e-5);
+}
+
+TEST(LAPlusGraph, Inplace) {
+  const Matrixf x = Matrixf::Uniform(8, 32, -1.0, 1.0);
+
+  Graph g;
+  const std::size_t gx = g.input(8, 32);
+  const std::size_t a = g.relu(g.dot(gx, gx, CblasNoTrans, CblasTrans));
+  const std::size_t b = g.mul(a, a);
+  const std::size_t c = g.add(b, b);
+  g.output(c);
+  g.compile();
+
+  // The product, a, b and c all share one 8x8 buffer.
+  ASSERT_EQ(g.kernels(), 4);
+  ASSERT_EQ(g.arena(), 64);
+
+  g.bind(gx, x);
+  g.run();
+
+  const Matrixf z = x.dot(x.transpose()).apply(relu);
+  ExpectNear(g.value(c), z * z * 2.0f, 1e-5);
+}
+
+TEST(LAPlusGraph, Arena) {
+  Graph g;
+  const std::size_t gx = g.input(4, 16);
+  const std::size_t gw = g.input(16, 16);
+  std::size_t h = gx;
+  for(std::size_t k = 0; k < 6; ++k) h = g.tanh(g.dot(h, gw));
+  g.output(h);
+  g.compile();
+
+  // Each product dies as soon as its tanh has read it, so two buffers
+  // suffice however deep the chain is.
+  ASSERT_EQ(g.kernels(), 12);
+  ASSERT_EQ(g.arena(), 2 * 64);
+}
+
+}  // namespace laplus
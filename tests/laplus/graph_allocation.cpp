@@ -0,0 +1,113 @@
+/******************************************************************************
+ *
+ * laplus/graph_allocation.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/graph.hpp"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// This file is built as its own executable: it replaces the global
+// allocation functions to count the allocations made by Graph::run().
+
+namespace {
+
+std::atomic<bool> counting(false);
+std::atomic<std::size_t> allocations(0);
+
+void* allocate(const std::size_t size)
+{
+  if(counting) ++allocations;
+  return std::malloc(size ? size : 1);
+}
+
+}  // unnamed namespace
+
+void* operator new(std::size_t size)
+{
+  void* p = allocate(size);
+  if(!p) throw std::bad_alloc();
+  return p;
+}
+
+void* operator new[](std::size_t size)
+{ return operator new(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{ return allocate(size); }
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{ return allocate(size); }
+
+void operator delete(void* p) noexcept
+{ std::free(p); }
+
+void operator delete[](void* p) noexcept
+{ std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept
+{ std::free(p); }
+
+void operator delete[](void* p, std::size_t) noexcept
+{ std::free(p); }
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{ std::free(p); }
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{ std::free(p); }
+
+namespace laplus {
+
+TEST(LAPlusGraph, ZeroAllocation) {
+  const Matrixf x = Matrixf::Uniform(32, 64, -1.0, 1.0);
+  Matrixf w = Matrixf::Uniform(64, 10, -1.0, 1.0);
+
+  Graph g;
+  const std::size_t gx = g.input(32, 64);
+  const std::size_t gw = g.parameter(w);
+  const std::size_t y = g.sigmoid(g.dot(gx, gw));
+  g.update(gw, -0.01f, gx, g.dsigmoid(y), CblasTrans);
+  g.compile();
+  g.bind(gx, x);
+  g.run();
+
+  allocations = 0;
+  counting = true;
+  for(std::size_t k = 0; k < 10; ++k) {
+    g.bind(gx, x);
+    g.run();
+  }
+  counting = false;
+  ASSERT_EQ(allocations.load(), 0);
+}
+
+
+}  // namespace laplus
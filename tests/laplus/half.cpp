@@ -0,0 +1,112 @@
+/******************************************************************************
+ *
+ * laplus/half.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/half.hpp"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace laplus {
+
+TEST(LAPlusHalf, Narrow) {
+  ASSERT_EQ(half(0.0).bits, 0x0000);
+  ASSERT_EQ(half(-0.0).bits, 0x8000);
+  ASSERT_EQ(half(1.0).bits, 0x3c00);
+  ASSERT_EQ(half(-2.0).bits, 0xc000);
+  ASSERT_EQ(half(65504.0).bits, 0x7bff);
+  ASSERT_EQ(half(65520.0).bits, 0x7c00);
+  ASSERT_EQ(half(std::ldexp(1.0f, -24)).bits, 0x0001);
+  ASSERT_EQ(half(std::ldexp(1.0f, -25)).bits, 0x0000);
+  ASSERT_EQ(half(1.0f + std::ldexp(1.0f, -11)).bits, 0x3c00);
+  ASSERT_EQ(half(1.0f + std::ldexp(3.0f, -11)).bits, 0x3c02);
+  ASSERT_EQ(half(std::numeric_limits<float>::infinity()).bits, 0x7c00);
+}
+
+TEST(LAPlusHalf, Widen) {
+  ASSERT_EQ(static_cast<float>(half(1.0)), 1.0);
+  ASSERT_EQ(static_cast<float>(half(-0.5)), -0.5);
+  ASSERT_EQ(static_cast<float>(half(65504.0)), 65504.0);
+  ASSERT_EQ(static_cast<float>(half(std::ldexp(1.0f, -24))),
+            std::ldexp(1.0f, -24));
+  ASSERT_EQ(static_cast<float>(half(std::ldexp(3.0f, -16))),
+            std::ldexp(3.0f, -16));
+  ASSERT_TRUE(std::isnan(static_cast<float>(half(std::nanf("")))));
+}
+
+TEST(LAPlusBfloat16, Narrow) {
+  ASSERT_EQ(bfloat16(1.0).bits, 0x3f80);
+  ASSERT_EQ(bfloat16(-2.0).bits, 0xc000);
+  ASSERT_EQ(bfloat16(1.0f + std::ldexp(1.0f, -8)).bits, 0x3f80);
+  ASSERT_EQ(bfloat16(1.0f + std::ldexp(3.0f, -8)).bits, 0x3f82);
+  ASSERT_EQ(static_cast<float>(bfloat16(3.0)), 3.0);
+  ASSERT_TRUE(std::isnan(static_cast<float>(bfloat16(std::nanf("")))));
+}
+
+TEST(LAPlusHalf, Convert) {
+  std::vector<float> t0(37);
+  for(std::size_t i = 0; i < t0.size(); ++i) {
+    t0[i] = std::sin(static_cast<float>(i)) * 1000.0f;
+  }
+  std::vector<half> h0(t0.size());
+  std::vector<float> t1(t0.size());
+
+  convert(t0.data(), h0.data(), t0.size());
+  convert(h0.data(), t1.data(), t0.size());
+
+  for(std::size_t i = 0; i < t0.size(); ++i) {
+    ASSERT_EQ(h0[i].bits, half(t0[i]).bits);
+    ASSERT_EQ(t1[i], static_cast<float>(half(t0[i])));
+  }
+}
+
+TEST(LAPlusBfloat16, Convert) {
+  std::vector<float> t0(37);
+  for(std::size_t i = 0; i < t0.size(); ++i) {
+    t0[i] = std::sin(static_cast<float>(i)) * 1000.0f;
+  }
+  t0[3] = std::nanf("");
+  std::vector<bfloat16> b0(t0.size());
+  std::vector<float> t1(t0.size());
+
+  convert(t0.data(), b0.data(), t0.size());
+  convert(b0.data(), t1.data(), t0.size());
+
+  for(std::size_t i = 0; i < t0.size(); ++i) {
+    if(i == 3) {
+      ASSERT_TRUE(std::isnan(t1[i]));
+      continue;
+    }
+    ASSERT_EQ(b0[i].bits, bfloat16(t0[i]).bits);
+    ASSERT_EQ(t1[i], static_cast<float>(bfloat16(t0[i])));
+  }
+}
+
+}  // namespace laplus
@@ -0,0 +1,135 @@
+/******************************************************************************
+ *
+ * laplus/half_matrix.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/half_matrix.hpp"
+#include "laplus/matrixf.hpp"
+#include "gtest/gtest.h"
+#include "helpers.hpp"
+
+#include <cmath>
+
+namespace laplus {
+
+TEST(LAPlusHalfMatrix, ConstructorMatrixf) {
+  std::vector<std::vector<float>> t0 = {{1, 2, 3},
+                                        {4, 5, 6}};
+  Matrixf m0(t0);
+  Matrixh h0(m0);
+  Matrixbf b0(m0);
+  Matrixh h1(m0.transpose());
+
+  ASSERT_EQ(h0.rows(), 2);
+  ASSERT_EQ(h0.cols(), 3);
+  ASSERT_EQ(h0(1, 2), 6.0);
+  ASSERT_EQ(b0(1, 0), 4.0);
+  ASSERT_EQ(h0.widen(), t0);
+  ASSERT_EQ(b0.widen(), t0);
+  ASSERT_EQ(h1.rows(), 3);
+  ASSERT_EQ(h1.layout(), CblasColMajor);
+  ASSERT_EQ(h1.widen(), m0.transpose());
+  ASSERT_EQ(h1.transpose().widen(), t0);
+}
+
+TEST(LAPlusHalfMatrix, Clone) {
+  Matrixh h0(Matrixf({{1, 2}, {3, 4}}));
+  Matrixh h1 = h0.clone();
+  h1.set(0, 0, 5.0);
+
+  ASSERT_EQ(h0(0, 0), 1.0);
+  ASSERT_EQ(h1(0, 0), 5.0);
+}
+
+TEST(LAPlusHalfMatrix, Arithmetic) {
+  Matrixf m0 = Matrixf::Uniform(33, 70, 1.0, 2.0);
+  Matrixf m1 = Matrixf::Uniform(33, 70, 1.0, 2.0);
+  Matrixh h0(m0);
+  Matrixh h1(m1);
+  Matrixbf b0(m0);
+  Matrixbf b1(m1);
+
+  ExpectNear((h0 + h1).widen(), m0 + m1, 1e-2);
+  ExpectNear((h0 - h1).widen(), m0 - m1, 1e-2);
+  ExpectNear((h0 * h1).widen(), m0 * m1, 1e-2);
+  ExpectNear((h0 / h1).widen(), m0 / m1, 1e-2);
+  ExpectNear((h0 * 3.0 + 1.0).widen(), m0 * 3.0 + 1.0, 1e-2);
+  ExpectNear((b0 + b1).widen(), m0 + m1, 5e-2);
+  ExpectNear((b0 * b1).widen(), m0 * m1, 5e-2);
+  ExpectNear(h0.apply([](float x) { return std::sqrt(x); }).widen(),
+             m0.apply([](float x) { return std::sqrt(x); }), 1e-2);
+  ExpectNear((h0 + h1.transpose().transpose()).widen(), m0 + m1, 1e-2);
+}
+
+TEST(LAPlusHalfMatrix, GEMM) {
+  Matrixf m0 = Matrixf::Uniform(67, 300, -1.0, 1.0);
+  Matrixf m1 = Matrixf::Uniform(300, 45, -1.0, 1.0);
+  Matrixf m2 = Matrixh(m0).widen().dot(Matrixh(m1).widen());
+  Matrixf m3 = Matrixbf(m0).widen().dot(Matrixbf(m1).widen());
+
+  ExpectNear(dot(Matrixh(m0), Matrixh(m1)), m2, 1e-3);
+  ExpectNear(dot(Matrixbf(m0), Matrixbf(m1)), m3, 1e-3);
+  ExpectNear(dot(m0, Matrixh(m1)), m0.dot(Matrixh(m1).widen()), 1e-3);
+  ExpectNear(dot(Matrixbf(m0), m1), Matrixbf(m0).widen().dot(m1), 1e-3);
+
+  Matrixf m4 = Matrixf::Uniform(67, 45);
+  Matrixf m5 = m2 * 2.0 + m4 * 0.5;
+  gemm(2.0, Matrixh(m0), Matrixh(m1), 0.5, m4);
+  ExpectNear(m4, m5, 1e-3);
+}
+
+TEST(LAPlusHalfMatrix, GEMMBetaZero) {
+  Matrixf m0 = Matrixf::Uniform(67, 300, -1.0, 1.0);
+  Matrixf m1 = Matrixf::Uniform(300, 45, -1.0, 1.0);
+  Matrixh h1(m1);
+
+  Matrixf m2(std::vector<float>(67 * 45, std::nanf("")), 67, 45);
+  gemm(1.0, m0, h1, 0.0, m2);
+  ExpectNear(m2, m0.dot(h1.widen()), 1e-3);
+
+  // An empty inner dimension leaves a zero product.
+  Matrixf m3(std::vector<float>(67 * 45, std::nanf("")), 45, 67);
+  gemm(1.0, Matrixf(67, 0), Matrixh(Matrixf(0, 45)), 0.0, m3.transpose());
+  for(std::size_t i = 0; i < m3.size(); ++i) EXPECT_EQ(0.0f, m3.data()[i]);
+}
+
+TEST(LAPlusHalfMatrix, GEMMTrans) {
+  Matrixf m0 = Matrixf::Uniform(300, 67, -1.0, 1.0);
+  Matrixf m1 = Matrixf::Uniform(45, 300, -1.0, 1.0);
+  Matrixh h0(m0);
+  Matrixh h1(m1);
+  Matrixf m2 = h0.widen().transpose().dot(h1.widen().transpose());
+
+  ExpectNear(dot(h0.transpose(), h1.transpose()), m2, 1e-3);
+  ExpectNear(dot(Matrixh(m0.transpose()), h1.transpose()), m2, 1e-3);
+
+  Matrixf m3(45, 67);
+  gemm(1.0, h0.transpose(), h1.transpose(), 0.0, m3.transpose());
+  ExpectNear(m3.transpose(), m2, 1e-3);
+}
+
+}  // namespace laplus
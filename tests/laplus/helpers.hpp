@@ -0,0 +1,95 @@
+/******************************************************************************
+ *
+ * laplus/helpers.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_TESTS_HELPERS_HPP__
+#define __LAPLUS_TESTS_HELPERS_HPP__
+
+#include "laplus/conv.hpp"
+#include "laplus/matrixf.hpp"
+#include "laplus/vectorf.hpp"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+namespace laplus {
+
+inline void ExpectNear(const Matrixf& a, const Matrixf& b,
+                       const float tolerance)
+{
+  ASSERT_EQ(a.rows(), b.rows());
+  ASSERT_EQ(a.cols(), b.cols());
+  for(std::size_t i = 0; i < a.rows(); ++i) {
+    for(std::size_t j = 0; j < a.cols(); ++j) {
+      EXPECT_NEAR(a(i, j), b(i, j), tolerance);
+    }
+  }
+}
+
+inline void ExpectNear(const Matrixf& a,
+                       const std::vector<std::vector<float>>& b,
+                       const float tolerance)
+{
+  ASSERT_EQ(a.rows(), b.size());
+  for(std::size_t i = 0; i < a.rows(); ++i) {
+    ASSERT_EQ(a.cols(), b[i].size());
+    for(std::size_t j = 0; j < a.cols(); ++j) {
+      EXPECT_NEAR(a(i, j), b[i][j], tolerance);
+    }
+  }
+}
+
+inline void ExpectNear(const Vectorf& a, const std::vector<float>& b,
+                       const float tolerance)
+{
+  ASSERT_EQ(a.size(), b.size());
+  for(std::size_t i = 0; i < a.size(); ++i) {
+    EXPECT_NEAR(a[i], b[i], tolerance);
+  }
+}
+
+// A tensor of the given shape with elements drawn from [-1, 1).
+inline Tensorf Random(const dims_t& dims)
+{
+  std::size_t n = 1;
+  for(std::size_t d: dims) n *= d;
+  return Tensorf(Matrixf::Uniform(1, n, -1.0, 1.0)).reshape(dims);
+}
+
+// Element (n, c, h, w) of an image or (o, c, h, w) of a filter.
+inline float& At(const Tensorf& t, const ConvLayout layout,
+                 const std::size_t n, const std::size_t c,
+                 const std::size_t h, const std::size_t w)
+{
+  if(layout == NCHW) return t({n, c, h, w});
+  return t({n, h, w, c});
+}
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_TESTS_HELPERS_HPP__
@@ -0,0 +1,89 @@
+/******************************************************************************
+ *
+ * laplus/internal/parallel.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/internal/parallel.hpp"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <vector>
+
+namespace laplus {
+namespace internal {
+
+TEST(LAPlusInternalParallel, Concurrency) {
+  ASSERT_GE(concurrency(), 1);
+}
+
+TEST(LAPlusInternalParallel, SetConcurrency) {
+  const std::size_t s0 = concurrency();
+  set_concurrency(3);
+  ASSERT_EQ(concurrency(), 3);
+
+  std::vector<int> v0(100, 0);
+  parallel_run(v0.size(), [&](const std::size_t i) { v0[i] += i; });
+  set_concurrency(s0);
+  ASSERT_EQ(concurrency(), s0);
+
+  for(std::size_t i = 0; i < v0.size(); ++i) {
+    ASSERT_EQ(v0[i], i);
+  }
+}
+
+TEST(LAPlusInternalParallel, ParallelRun) {
+  std::vector<int> v0(100, 0);
+  parallel_run(v0.size(), [&](const std::size_t i) { v0[i] += i; });
+
+  for(std::size_t i = 0; i < v0.size(); ++i) {
+    ASSERT_EQ(v0[i], i);
+  }
+}
+
+TEST(LAPlusInternalParallel, ParallelRunNested) {
+  std::atomic<int> a0(0);
+  parallel_run(4, [&](const std::size_t) {
+    parallel_run(4, [&](const std::size_t) { ++a0; });
+  });
+
+  ASSERT_EQ(a0.load(), 16);
+}
+
+TEST(LAPlusInternalParallel, ParallelFor) {
+  std::vector<int> v0(1000, 0);
+  parallel_for(0, v0.size(), 7, [&](const std::size_t first,
+                                    const std::size_t last) {
+    for(std::size_t i = first; i < last; ++i) v0[i] += 1;
+  });
+
+  for(std::size_t i = 0; i < v0.size(); ++i) {
+    ASSERT_EQ(v0[i], 1);
+  }
+}
+
+}  // namespace internal
+}  // namespace laplus
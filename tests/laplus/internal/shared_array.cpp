@@ -29,6 +29,7 @@
 #include "laplus/internal/shared_array.hpp"
 #include "gtest/gtest.h"
 
+#include <memory>
 #include <vector>
 
 namespace laplus {
@@ -57,6 +58,28 @@ TEST(LAPlusInternalSharedArray, ConstructorVector) {
   ASSERT_EQ(a0[2], v0[2]);
 }
 
+TEST(LAPlusInternalSharedArray, ConstructorShared) {
+  bool released = false;
+  int* buffer = new int[8]();
+  {
+    std::shared_ptr<int> p0(buffer, [&](int* p) {
+      released = true;
+      delete[] p;
+    });
+    SharedArray<int> a0(p0, 3);
+
+    ASSERT_FALSE(a0.empty());
+    ASSERT_EQ(a0.use_count(), 2);
+    ASSERT_EQ(a0.size(), 3);
+    ASSERT_EQ(a0.get(), buffer);
+
+    p0.reset();
+    ASSERT_EQ(a0.use_count(), 1);
+    ASSERT_FALSE(released);
+  }
+  ASSERT_TRUE(released);
+}
+
 TEST(LAPlusInternalSharedArray, ConstructorCopy) {
   std::vector<int> v0 = {0, 1, 2};
   SharedArray<int> a0(v0);
@@ -0,0 +1,135 @@
+/******************************************************************************
+ *
+ * laplus/internal/transpose.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/internal/transpose.hpp"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace laplus {
+namespace internal {
+
+namespace {
+
+template<typename T>
+void check_copy(const std::size_t rows, const std::size_t cols)
+{
+  const std::size_t lds = cols + 3;
+  const std::size_t ldd = rows + 5;
+  std::vector<T> src(rows * lds);
+  std::vector<T> dst(cols * ldd, -1);
+  for(std::size_t k = 0; k < src.size(); ++k) src[k] = T(k);
+
+  transpose(src.data(), lds, dst.data(), ldd, rows, cols);
+
+  for(std::size_t j = 0; j < cols; ++j) {
+    for(std::size_t i = 0; i < ldd; ++i) {
+      const T expected = (i < rows) ? src[i * lds + j] : T(-1);
+      ASSERT_EQ(dst[j * ldd + i], expected);
+    }
+  }
+}
+
+template<typename T>
+void check_square(const std::size_t n)
+{
+  const std::size_t lda = n + 2;
+  std::vector<T> a(n * lda);
+  for(std::size_t k = 0; k < a.size(); ++k) a[k] = T(k);
+  const std::vector<T> b(a);
+
+  transpose(a.data(), lda, n);
+
+  for(std::size_t i = 0; i < n; ++i) {
+    for(std::size_t j = 0; j < lda; ++j) {
+      const T expected = (j < n) ? b[j * lda + i] : b[i * lda + j];
+      ASSERT_EQ(a[i * lda + j], expected);
+    }
+  }
+}
+
+template<typename T>
+void check_combine(const std::size_t rows, const std::size_t cols)
+{
+  const std::size_t lda = cols + 1;
+  const std::size_t ldb = rows + 2;
+  std::vector<T> a(rows * lda);
+  std::vector<T> b(cols * ldb);
+  for(std::size_t k = 0; k < a.size(); ++k) a[k] = T(k % 7 + 1);
+  for(std::size_t k = 0; k < b.size(); ++k) b[k] = T(k % 5 + 1);
+  std::vector<T> c0(a), c1(a), c2(a), c3(a);
+
+  transpose_axpy(T(2), b.data(), ldb, c0.data(), lda, rows, cols);
+  transpose_mul(b.data(), ldb, c1.data(), lda, rows, cols);
+  transpose_div(b.data(), ldb, c2.data(), lda, rows, cols);
+  transpose_pow(b.data(), ldb, c3.data(), lda, rows, cols);
+
+  for(std::size_t i = 0; i < rows; ++i) {
+    for(std::size_t j = 0; j < cols; ++j) {
+      const T x = a[i * lda + j];
+      const T y = b[j * ldb + i];
+      ASSERT_EQ(c0[i * lda + j], x + T(2) * y);
+      ASSERT_EQ(c1[i * lda + j], x * y);
+      ASSERT_EQ(c2[i * lda + j], x / y);
+      ASSERT_EQ(c3[i * lda + j], std::pow(x, y));
+    }
+  }
+}
+
+}  // unnamed namespace
+
+TEST(LAPlusInternalTranspose, Copy) {
+  for(std::size_t rows: {1, 4, 8, 13, 64, 150}) {
+    for(std::size_t cols: {1, 5, 8, 67, 129}) {
+      check_copy<float>(rows, cols);
+      check_copy<double>(rows, cols);
+    }
+  }
+}
+
+TEST(LAPlusInternalTranspose, Square) {
+  for(std::size_t n: {1, 3, 4, 8, 9, 64, 65, 200}) {
+    check_square<float>(n);
+    check_square<double>(n);
+  }
+}
+
+TEST(LAPlusInternalTranspose, Combine) {
+  for(std::size_t rows: {1, 8, 13, 100}) {
+    for(std::size_t cols: {1, 9, 64, 70}) {
+      check_combine<float>(rows, cols);
+      check_combine<double>(rows, cols);
+    }
+  }
+}
+
+}  // namespace internal
+}  // namespace laplus
@@ -0,0 +1,157 @@
+/******************************************************************************
+ *
+ * laplus/jit.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/jit.hpp"
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+namespace laplus {
+
+namespace {
+
+const std::vector<float> ramp(const std::size_t n, const float scale,
+                              const float offset)
+{
+  std::vector<float> x(n);
+  for(std::size_t i = 0; i < n; ++i)
+    x[i] = scale * std::sin(0.37f * i) + offset;
+  return x;
+}
+
+}  // unnamed namespace
+
+TEST(LAPlusJit, Parse) {
+  Expr e(0.0f);
+  ASSERT_TRUE(Expr::Parse("max(x0, 0) * x1 + 0.5", e));
+  EXPECT_EQ(2u, e.arity());
+  ASSERT_TRUE(Expr::Parse("-(x2 - 1) / abs(x0) + relu(x1)", e));
+  EXPECT_EQ(3u, e.arity());
+  EXPECT_FALSE(Expr::Parse("x0 +", e));
+  EXPECT_FALSE(Expr::Parse("foo(x0)", e));
+  EXPECT_FALSE(Expr::Parse("min(x0)", e));
+  EXPECT_FALSE(Expr::Parse("(x0", e));
+}
+
+TEST(LAPlusJit, Arithmetic) {
+  const std::size_t n = 1003;
+  const std::vector<float> a = ramp(n, 2.0f, 0.0f);
+  const std::vector<float> b = ramp(n, 1.0f, 3.0f);
+  Expr e(0.0f);
+  ASSERT_TRUE(Expr::Parse(
+      "min(max(x0, 0) * x1 + 0.5, 2) - sqrt(x1) / -abs(x0 - 4)", e));
+  const JitKernel kernel(e);
+  const float* inputs[] = {a.data(), b.data()};
+  std::vector<float> y(n);
+  kernel(inputs, y.data(), n);
+  for(std::size_t i = 0; i < n; ++i) {
+    const float expect = std::min(std::max(a[i], 0.0f) * b[i] + 0.5f, 2.0f)
+      - std::sqrt(b[i]) / -std::fabs(a[i] - 4.0f);
+    EXPECT_NEAR(expect, y[i], 1e-5);
+  }
+}
+
+TEST(LAPlusJit, Transcendental) {
+  const std::size_t n = 517;
+  const std::vector<float> a = ramp(n, 20.0f, 0.0f);
+  const Expr x = Expr::Input(0);
+  const JitKernel exp(x.exp());
+  const JitKernel sigmoid(x.sigmoid());
+  const JitKernel tanh(x.tanh());
+  const float* inputs[] = {a.data()};
+  std::vector<float> y0(n), y1(n), y2(n);
+  exp(inputs, y0.data(), n);
+  sigmoid(inputs, y1.data(), n);
+  tanh(inputs, y2.data(), n);
+  for(std::size_t i = 0; i < n; ++i) {
+    EXPECT_NEAR(1.0f, y0[i] / std::exp(a[i]), 1e-6);
+    EXPECT_NEAR(1.0f / (1.0f + std::exp(-a[i])), y1[i], 1e-6);
+    EXPECT_NEAR(std::tanh(a[i]), y2[i], 1e-6);
+  }
+}
+
+TEST(LAPlusJit, Cache) {
+  const Expr x = Expr::Input(0);
+  const Expr y = Expr::Input(1);
+  const JitKernel k0(x * 2.0f + y);
+  const JitKernel k1(x * 3.0f + y);
+  const JitKernel k2(x * y + 3.0f);
+  EXPECT_EQ(k0.native(), k1.native());
+  if(k0.native()) {
+    EXPECT_EQ(k0.entry(), k1.entry());
+    EXPECT_NE(k0.entry(), k2.entry());
+  }
+
+  const Vectorf a = Vectorf(std::vector<float>(21, 1.0f));
+  const Vectorf b = Vectorf(std::vector<float>(21, 1.0f));
+  const Vectorf r0 = k0({a, b});
+  const Vectorf r1 = k1({a, b});
+  for(std::size_t i = 0; i < 21; ++i) {
+    EXPECT_FLOAT_EQ(3.0f, r0[i]);
+    EXPECT_FLOAT_EQ(4.0f, r1[i]);
+  }
+}
+
+TEST(LAPlusJit, Matrix) {
+  const Matrixf a = Matrixf::Uniform(13, 7);
+  const Matrixf b = Matrixf::Uniform(7, 13).transpose();
+  const Expr x = Expr::Input(0);
+  const Expr y = Expr::Input(1);
+  const std::vector<Matrixf> inputs = {a, b};
+  const Matrixf c = JitKernel(x - y * 2.0f)(inputs);
+  for(std::size_t i = 0; i < 13; ++i)
+    for(std::size_t j = 0; j < 7; ++j)
+      EXPECT_NEAR(a(i, j) - b(i, j) * 2.0f, c(i, j), 1e-6);
+}
+
+TEST(LAPlusJit, Wide) {
+  Expr e(0.0f);
+  ASSERT_TRUE(Expr::Parse("x40 + x3 * 2 + 1", e));
+  EXPECT_EQ(41u, e.arity());
+  const JitKernel kernel(e);
+  EXPECT_FALSE(kernel.native());
+
+  std::vector<Vectorf> inputs;
+  for(std::size_t k = 0; k < 41; ++k)
+    inputs.push_back(Vectorf(std::vector<float>(100, float(k))));
+  const Vectorf y = kernel(inputs);
+  ASSERT_EQ(100u, y.size());
+  for(std::size_t i = 0; i < 100; ++i) EXPECT_FLOAT_EQ(47.0f, y[i]);
+
+  std::vector<Matrixf> matrices;
+  for(std::size_t k = 0; k < 41; ++k)
+    matrices.push_back(Matrixf::Uniform(9, 5));
+  const Matrixf z = kernel(matrices);
+  for(std::size_t i = 0; i < 9; ++i)
+    for(std::size_t j = 0; j < 5; ++j)
+      EXPECT_NEAR(matrices[40](i, j) + matrices[3](i, j) * 2.0f + 1.0f,
+                  z(i, j), 1e-6);
+}
+
+}  // namespace laplus
@@ -0,0 +1,253 @@
+/******************************************************************************
+ *
+ * laplus/linalg.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#include "laplus/linalg.hpp"
+#include "laplus/matrixf.hpp"
+#include "laplus/vectorf.hpp"
+#include "gtest/gtest.h"
+#include "helpers.hpp"
+
+namespace laplus {
+
+namespace {
+
+Matrixf Diagonal(const Vectorf& v)
+{
+  Matrixf result(v.size(), v.size());
+  for(std::size_t i = 0; i < v.size(); ++i) {
+    result(i, i) = v[i];
+  }
+  return result;
+}
+
+}  // unnamed namespace
+
+TEST(LAPlusLinalg, LU) {
+  std::vector<std::vector<float>> t0 = {{4, 3},
+                                        {6, 3}};
+  std::vector<std::vector<float>> t1 = {{10, 7},
+                                        {12, 9}};
+  std::vector<std::vector<float>> t2 = {{1, 1},
+                                        {2, 1}};
+  std::vector<float> t3 = {10, 12};
+  std::vector<float> t4 = {1, 2};
+
+  Matrixf m0(t0);
+  Matrixf m1(t1);
+  Vectorf v0(t3);
+
+  LU f0 = lu(m0.clone());
+
+  ASSERT_EQ(f0.info(), 0);
+  ASSERT_EQ(m0, t0);
+  ASSERT_EQ(f0.pivots().size(), 2);
+
+  ExpectNear(f0.L().dot(f0.U()), {{6, 3}, {4, 3}}, 1e-4);
+  ExpectNear(f0.solve(m1), t2, 1e-4);
+  ExpectNear(f0.solve(v0), t4, 1e-4);
+
+  EXPECT_EQ(0, f0.solve_inplace(m1));
+
+  ExpectNear(m1, t2, 1e-4);
+}
+
+TEST(LAPlusLinalg, LUTrans) {
+  std::vector<std::vector<float>> t0 = {{4, 6},
+                                        {3, 3}};
+  std::vector<std::vector<float>> t1 = {{10, 7},
+                                        {12, 9}};
+  std::vector<std::vector<float>> t2 = {{1, 1},
+                                        {2, 1}};
+
+  Matrixf m0 = Matrixf(t0).transpose();
+  Matrixf m1 = Matrixf(t1);
+
+  LU f0 = lu(m0);
+
+  ASSERT_EQ(f0.info(), 0);
+  ExpectNear(f0.solve(m1), t2, 1e-4);
+
+  EXPECT_EQ(0, f0.solve_inplace(m1));
+
+  ExpectNear(m1, t2, 1e-4);
+}
+
+TEST(LAPlusLinalg, LUSingular) {
+  std::vector<std::vector<float>> t0 = {{1, 2},
+                                        {2, 4}};
+
+  LU f0 = lu(Matrixf(t0));
+
+  ASSERT_GT(f0.info(), 0);
+}
+
+TEST(LAPlusLinalg, Cholesky) {
+  std::vector<std::vector<float>> t0 = {{4, 2},
+                                        {2, 3}};
+  std::vector<float> t1 = {2, 1};
+  std::vector<float> t2 = {0.5, 0};
+  std::vector<std::vector<float>> t3 = {{2, 0},
+                                        {1, std::sqrt(2.0f)}};
+
+  Matrixf m0(t0);
+
+  Cholesky f0 = cholesky(m0.clone(), CblasLower);
+  Cholesky f1 = cholesky(m0.clone(), CblasUpper);
+
+  ASSERT_EQ(f0.info(), 0);
+  ASSERT_EQ(f1.info(), 0);
+
+  ExpectNear(f0.L(), t3, 1e-4);
+  ExpectNear(f1.L(), t3, 1e-4);
+  ExpectNear(f0.solve(Vectorf(t1)), t2, 1e-4);
+  ExpectNear(f1.solve(Vectorf(t1)), t2, 1e-4);
+}
+
+TEST(LAPlusLinalg, CholeskyIndefinite) {
+  std::vector<std::vector<float>> t0 = {{1, 2},
+                                        {2, 1}};
+
+  Cholesky f0 = cholesky(Matrixf(t0), CblasLower);
+
+  ASSERT_GT(f0.info(), 0);
+}
+
+TEST(LAPlusLinalg, QR) {
+  std::vector<std::vector<float>> t0 = {{1, 0},
+                                        {0, 1},
+                                        {1, 1}};
+  std::vector<std::vector<float>> t1 = {{1, 0},
+                                        {0, 1}};
+  std::vector<float> t2 = {1, 1, 2};
+  std::vector<float> t3 = {1, 1};
+
+  Matrixf m0(t0);
+
+  QR f0 = qr(m0.clone());
+
+  ASSERT_EQ(f0.info(), 0);
+  ASSERT_EQ(f0.Q().rows(), 3);
+  ASSERT_EQ(f0.Q().cols(), 2);
+  ASSERT_EQ(f0.R().rows(), 2);
+  ASSERT_EQ(f0.R().cols(), 2);
+
+  ExpectNear(f0.Q().dot(f0.R()), t0, 1e-4);
+  ExpectNear(f0.Q().transpose().dot(f0.Q()), t1, 1e-4);
+  ExpectNear(f0.solve(Vectorf(t2)), t3, 1e-4);
+}
+
+TEST(LAPlusLinalg, SVD) {
+  std::vector<std::vector<float>> t0 = {{3, 0},
+                                        {0, 4},
+                                        {0, 0}};
+  std::vector<float> t1 = {4, 3};
+
+  SVD f0 = svd(Matrixf(t0));
+
+  ASSERT_EQ(f0.info(), 0);
+  ASSERT_EQ(f0.U().rows(), 3);
+  ASSERT_EQ(f0.U().cols(), 2);
+  ASSERT_EQ(f0.Vt().rows(), 2);
+  ASSERT_EQ(f0.Vt().cols(), 2);
+
+  ExpectNear(f0.S(), t1, 1e-4);
+  ExpectNear(f0.U().dot(Diagonal(f0.S())).dot(f0.Vt()), t0, 1e-4);
+}
+
+TEST(LAPlusLinalg, SVDTrans) {
+  std::vector<std::vector<float>> t0 = {{1, 2, 3},
+                                        {4, 5, 6}};
+
+  SVD f0 = svd(Matrixf(t0).transpose());
+
+  ASSERT_EQ(f0.info(), 0);
+  ASSERT_EQ(f0.U().rows(), 3);
+  ASSERT_EQ(f0.Vt().cols(), 2);
+
+  ExpectNear(f0.U().dot(Diagonal(f0.S())).dot(f0.Vt()),
+             {{1, 4}, {2, 5}, {3, 6}}, 1e-4);
+}
+
+TEST(LAPlusLinalg, Eigh) {
+  std::vector<std::vector<float>> t0 = {{2, 1},
+                                        {1, 2}};
+  std::vector<float> t1 = {1, 3};
+
+  Matrixf m0(t0);
+
+  Eigh f0 = eigh(m0.clone(), CblasUpper);
+  Eigh f1 = eigh(m0.clone(), CblasLower);
+
+  ASSERT_EQ(f0.info(), 0);
+  ASSERT_EQ(f1.info(), 0);
+
+  ExpectNear(f0.values(), t1, 1e-4);
+  ExpectNear(f1.values(), t1, 1e-4);
+
+  for(std::size_t j = 0; j < 2; ++j) {
+    Vectorf v = f0.vectors().col(j);
+    Vectorf w = m0.dot(v);
+    for(std::size_t i = 0; i < 2; ++i) {
+      EXPECT_NEAR(w[i], f0.values()[j] * v[i], 1e-4);
+    }
+  }
+}
+
+TEST(LAPlusLinalg, Solve) {
+  std::vector<std::vector<float>> t0 = {{4, 3},
+                                        {6, 3}};
+  std::vector<std::vector<float>> t1 = {{10},
+                                        {12}};
+  std::vector<std::vector<float>> t2 = {{1},
+                                        {2}};
+
+  Matrixf m0(t0);
+
+  ExpectNear(solve(m0, Matrixf(t1)), t2, 1e-4);
+  ASSERT_EQ(m0, t0);
+}
+
+TEST(LAPlusLinalg, Lstsq) {
+  std::vector<std::vector<float>> t0 = {{1, 1},
+                                        {1, 2},
+                                        {1, 3}};
+  std::vector<std::vector<float>> t1 = {{1, 2},
+                                        {2, 4},
+                                        {2, 6}};
+  std::vector<std::vector<float>> t2 = {{ 2.0f / 3.0f, 0},
+                                        {0.5, 2}};
+
+  Matrixf m0(t0);
+
+  for(std::size_t k = 0; k < 2; ++k) {
+    ExpectNear(lstsq(m0, Matrixf(t1)), t2, 1e-4);
+    ASSERT_EQ(m0, t0);
+  }
+}
+
+}  // namespace laplus
@@ -30,6 +30,8 @@
 #include "laplus/vectorf.hpp"
 #include "gtest/gtest.h"
 
+#include <cmath>
+
 namespace laplus {
 
 TEST(LAPlusMatrixf, ConstructorSize) {
@@ -62,6 +64,45 @@ TEST(LAPlusMatrixf, ConstructorVector) {
   ASSERT_EQ(m0, t0);
 }
 
+TEST(LAPlusMatrixf, ConstructorVectorMove) {
+  std::size_t r0 = 2;
+  std::size_t c0 = 3;
+  std::vector<float> t0 = {1, 2, 3, 4, 5, 6};
+  std::vector<float> t1 = t0;
+  const float* p0 = t1.data();
+
+  Matrixf m0(std::move(t1), r0, c0);
+
+  ASSERT_EQ(m0.use_count(), 1);
+  ASSERT_EQ(m0.rows(), r0);
+  ASSERT_EQ(m0.cols(), c0);
+  ASSERT_EQ(m0.data(), p0);
+  ASSERT_EQ(m0, t0);
+}
+
+TEST(LAPlusMatrixf, ConstructorAdopt) {
+  std::size_t r0 = 2;
+  std::size_t c0 = 3;
+  std::vector<float> t0 = {1, 2, 3, 4, 5, 6};
+  bool released = false;
+  float* p0 = new float[6]{1, 2, 3, 4, 5, 6};
+
+  {
+    Matrixf m0(p0, r0, c0, [&](float* p) {
+      released = true;
+      delete[] p;
+    });
+
+    ASSERT_EQ(m0.rows(), r0);
+    ASSERT_EQ(m0.cols(), c0);
+    ASSERT_EQ(m0.data(), p0);
+    ASSERT_EQ(m0, t0);
+    ASSERT_EQ(m0.transpose()(2, 1), 6);
+  }
+
+  ASSERT_TRUE(released);
+}
+
 TEST(LAPlusMatrixf, ConstructorVector2D) {
   std::size_t r0 = 2;
   std::size_t c0 = 3;
@@ -817,6 +858,139 @@ TEST(LAPlusMatrixf, Transpose) {
   ASSERT_EQ(m1, t1);
 }
 
+TEST(LAPlusMatrixf, CloneTranspose) {
+  std::vector<std::vector<float>> t0 = {{1, 2, 3},
+                                        {2, 3, 4}};
+  std::vector<std::vector<float>> t1 = {{1, 2},
+                                        {2, 3},
+                                        {3, 4}};
+
+  Matrixf m0 = Matrixf(t0).transpose();
+  Matrixf m1 = m0.clone();
+
+  ASSERT_EQ(m1.use_count(), 1);
+  ASSERT_EQ(m1.rows(), 3);
+  ASSERT_EQ(m1.cols(), 2);
+  ASSERT_EQ(m1.layout(), m0.layout());
+  ASSERT_EQ(m1, t1);
+}
+
+TEST(LAPlusMatrixf, TransposeCopy) {
+  std::size_t r0 = 131;
+  std::size_t c0 = 77;
+
+  Matrixf m0 = Matrixf::Uniform(r0, c0);
+  Matrixf m1 = m0.transpose_copy();
+
+  ASSERT_EQ(m1.use_count(), 1);
+  ASSERT_EQ(m1.rows(), c0);
+  ASSERT_EQ(m1.cols(), r0);
+  ASSERT_EQ(m1.layout(), CblasRowMajor);
+  for(std::size_t i = 0; i < r0; ++i) {
+    for(std::size_t j = 0; j < c0; ++j) ASSERT_EQ(m1(j, i), m0(i, j));
+  }
+
+  Matrixf m2 = m1.transpose_copy();
+
+  ASSERT_EQ(m2.rows(), r0);
+  ASSERT_EQ(m2.cols(), c0);
+  ASSERT_EQ(m2, m0);
+}
+
+TEST(LAPlusMatrixf, Materialize) {
+  std::size_t r0 = 70;
+  std::size_t c0 = 135;
+
+  Matrixf m0 = Matrixf::Uniform(c0, r0).transpose();
+  Matrixf m1 = m0.materialize();
+
+  ASSERT_EQ(m0.layout(), CblasColMajor);
+  ASSERT_EQ(m1.use_count(), 1);
+  ASSERT_EQ(m1.rows(), r0);
+  ASSERT_EQ(m1.cols(), c0);
+  ASSERT_EQ(m1.layout(), CblasRowMajor);
+  ASSERT_EQ(m1.ldim(), c0);
+  ASSERT_EQ(m1, m0);
+
+  Matrixf m2 = m1.materialize();
+
+  ASSERT_EQ(m2.use_count(), 1);
+  ASSERT_EQ(m2, m0);
+}
+
+TEST(LAPlusMatrixf, RowMajor) {
+  std::size_t r0 = 70;
+  std::size_t c0 = 135;
+
+  Matrixf m0 = Matrixf::Uniform(c0, r0).transpose();
+  Matrixf m1 = m0.row_major();
+
+  ASSERT_EQ(m1.use_count(), 1);
+  ASSERT_EQ(m1.layout(), CblasRowMajor);
+  ASSERT_EQ(m1.ldim(), c0);
+  ASSERT_EQ(m1, m0);
+
+  Matrixf m2 = m1.row_major();
+
+  ASSERT_EQ(m2.get(), m1.get());
+  ASSERT_EQ(m2, m0);
+}
+
+TEST(LAPlusMatrixf, TransposeInplace) {
+  for(std::size_t n: {1, 7, 8, 64, 133}) {
+    Matrixf m0 = Matrixf::Uniform(n, n);
+    Matrixf m1 = m0.clone();
+    m1.transpose_inplace();
+
+    for(std::size_t i = 0; i < n; ++i) {
+      for(std::size_t j = 0; j < n; ++j) ASSERT_EQ(m1(j, i), m0(i, j));
+    }
+
+    Matrixf m2 = m0.clone().transpose();
+    m2.transpose_inplace();
+
+    ASSERT_EQ(m2.layout(), CblasColMajor);
+    ASSERT_EQ(m2, m0);
+  }
+}
+
+TEST(LAPlusMatrixf, OperatorArithmeticMixedLayout) {
+  std::size_t r0 = 70;
+  std::size_t c0 = 45;
+
+  Matrixf m0 = Matrixf::Uniform(r0, c0) + 1.0f;
+  Matrixf m1 = (Matrixf::Uniform(c0, r0) + 1.0f).transpose();
+
+  Matrixf m2 = m0 + m1;
+  Matrixf m3 = m0 - m1;
+  Matrixf m4 = m0 * m1;
+  Matrixf m5 = m0 / m1;
+  Matrixf m6 = m0 ^ m1;
+  Matrixf m7 = m1 * m0;
+
+  ASSERT_EQ(m2.layout(), CblasRowMajor);
+  ASSERT_EQ(m7.layout(), CblasColMajor);
+  for(std::size_t i = 0; i < r0; ++i) {
+    for(std::size_t j = 0; j < c0; ++j) {
+      ASSERT_FLOAT_EQ(m2(i, j), m0(i, j) + m1(i, j));
+      ASSERT_FLOAT_EQ(m3(i, j), m0(i, j) - m1(i, j));
+      ASSERT_FLOAT_EQ(m4(i, j), m0(i, j) * m1(i, j));
+      ASSERT_FLOAT_EQ(m5(i, j), m0(i, j) / m1(i, j));
+      ASSERT_FLOAT_EQ(m6(i, j), std::pow(m0(i, j), m1(i, j)));
+      ASSERT_FLOAT_EQ(m7(i, j), m0(i, j) * m1(i, j));
+    }
+  }
+
+  Matrixf m8 = m0.clone();
+  m8.axpy(2.0f, m1);
+
+  for(std::size_t i = 0; i < r0; ++i) {
+    for(std::size_t j = 0; j < c0; ++j) {
+      ASSERT_FLOAT_EQ(m8(i, j), m0(i, j) + 2.0f * m1(i, j));
+    }
+  }
+}
+
 TEST(LAPlusMatrixf, Reshape) {
   std::size_t r0 = 2;
   std::size_t c0 = 3;
@@ -988,6 +1162,20 @@ TEST(LAPlusMatrixf, ColTrans) {
   ASSERT_EQ(v1, t3);
 }
 
+TEST(LAPlusMatrixf, ColMul) {
+  Matrixf m0 = Matrixf::Uniform(8, 2);
+  Matrixf m1 = m0.clone();
+  Vectorf v0 = Vectorf::Uniform(8);
+
+  Vectorf v1 = m0.col(1);
+  v1 *= v0;
+
+  for(std::size_t i = 0; i < 8; ++i) {
+    ASSERT_EQ(m0(i, 0), m1(i, 0));
+    ASSERT_EQ(m0(i, 1), m1(i, 1) * v0[i]);
+  }
+}
+
 TEST(LAPlusMatrixf, SetRow) {
   std::size_t r0 = 2;
   std::size_t c0 = 3;
@@ -1153,6 +1341,101 @@ TEST(LAPlusMatrixf, Level2BLAS_GEMV) {
   ASSERT_EQ(v1, t3);
 }
 
+TEST(LAPlusMatrixf, Level2BLAS_GEMVTrans) {
+  std::size_t r0 = 2;
+  std::size_t c0 = 3;
+  std::vector<std::vector<float>> t0 = {{1, 2, 3},
+                                        {2, 3, 4}};
+  std::vector<float> t1 = {1, 2};
+  std::vector<float> t2 = {5, 8, 11};
+
+  Matrixf m0(t0);
+  Vectorf v0(t1);
+  Vectorf v1(c0);
+
+  ASSERT_EQ(m0.transpose().rows(), c0);
+  ASSERT_EQ(m0.transpose().cols(), r0);
+
+  v1.gemv(1.0, m0.transpose(), v0, 0.0);
+
+  ASSERT_EQ(m0, t0);
+  ASSERT_EQ(v0, t1);
+  ASSERT_EQ(v1.size(), c0);
+  ASSERT_EQ(v1, t2);
+}
+
+TEST(LAPlusMatrixf, Level2BLAS_SYMV) {
+  std::size_t r0 = 3;
+  std::vector<std::vector<float>> t0 = {{2, 1, 0},
+                                        {9, 3, 1},
+                                        {9, 9, 4}};
+  std::vector<float> t1 = {1, 2, 3};
+  std::vector<float> t2 = {4, 10, 14};
+
+  Matrixf m0(t0);
+  Vectorf v0(t1);
+  Vectorf v1(r0);
+  Vectorf v2(r0);
+
+  v1.symv(CblasUpper, 1.0, m0, v0, 0.0);
+
+  ASSERT_EQ(m0, t0);
+  ASSERT_EQ(v0, t1);
+  ASSERT_EQ(v1, t2);
+
+  v2.symv(CblasLower, 1.0, m0.transpose(), v0, 0.0);
+
+  ASSERT_EQ(m0, t0);
+  ASSERT_EQ(v0, t1);
+  ASSERT_EQ(v2, t2);
+}
+
+TEST(LAPlusMatrixf, Level2BLAS_TRMV) {
+  std::vector<std::vector<float>> t0 = {{1, 0, 0},
+                                        {2, 3, 0},
+                                        {4, 5, 6}};
+  std::vector<float> t1 = {1, 1, 1};
+  std::vector<float> t2 = {1, 5, 15};
+  std::vector<float> t3 = {7, 8, 6};
+
+  Matrixf m0(t0);
+  Vectorf v0(t1);
+  Vectorf v1(t1);
+
+  v0.trmv(CblasLower, CblasNonUnit, m0);
+
+  ASSERT_EQ(m0, t0);
+  ASSERT_EQ(v0, t2);
+
+  v1.trmv(CblasUpper, CblasNonUnit, m0.transpose());
+
+  ASSERT_EQ(m0, t0);
+  ASSERT_EQ(v1, t3);
+}
+
+TEST(LAPlusMatrixf, Level2BLAS_TRSV) {
+  std::vector<std::vector<float>> t0 = {{1, 0, 0},
+                                        {2, 3, 0},
+                                        {4, 5, 6}};
+  std::vector<float> t1 = {1, 5, 15};
+  std::vector<float> t2 = {7, 8, 6};
+  std::vector<float> t3 = {1, 1, 1};
+
+  Matrixf m0(t0);
+  Vectorf v0(t1);
+  Vectorf v1(t2);
+
+  v0.trsv(CblasLower, CblasNonUnit, m0);
+
+  ASSERT_EQ(m0, t0);
+  ASSERT_EQ(v0, t3);
+
+  v1.trsv(CblasUpper, CblasNonUnit, m0.transpose());
+
+  ASSERT_EQ(m0, t0);
+  ASSERT_EQ(v1, t3);
+}
+
 TEST(LAPlusMatrixf, Level2BLAS_GER) {
   std::size_t r0 = 2;
   std::size_t c0 = 3;
@@ -1205,6 +1488,52 @@ TEST(LAPlusMatrixf, Level2BLAS_GER) {
   ASSERT_EQ(m0, t3);
 }
 
+TEST(LAPlusMatrixf, Level2BLAS_GERTrans) {
+  std::size_t r0 = 2;
+  std::size_t c0 = 3;
+  std::vector<float> t0 = {1, 2};
+  std::vector<float> t1 = {1, 2, 3};
+  std::vector<std::vector<float>> t2 = {{1, 2, 3},
+                                        {2, 4, 6}};
+
+  Vectorf v0(t0);
+  Vectorf v1(t1);
+  Matrixf m0 = Matrixf(c0, r0).transpose();
+
+  ASSERT_EQ(m0.rows(), r0);
+  ASSERT_EQ(m0.cols(), c0);
+
+  m0.ger(1.0, v0, v1);
+
+  ASSERT_EQ(v0, t0);
+  ASSERT_EQ(v1, t1);
+  ASSERT_EQ(m0, t2);
+}
+
+TEST(LAPlusMatrixf, Level2BLAS_SYR) {
+  std::size_t r0 = 3;
+  std::vector<float> t0 = {1, 2, 3};
+  std::vector<std::vector<float>> t1 = {{1, 2, 3},
+                                        {0, 4, 6},
+                                        {0, 0, 9}};
+  std::vector<std::vector<float>> t2 = {{2, 4, 6},
+                                        {0, 8, 12},
+                                        {0, 0, 18}};
+
+  Vectorf v0(t0);
+  Matrixf m0(r0, r0);
+
+  m0.syr(CblasUpper, 1.0, v0);
+
+  ASSERT_EQ(v0, t0);
+  ASSERT_EQ(m0, t1);
+
+  m0.syr2(CblasUpper, 0.5, v0, v0);
+
+  ASSERT_EQ(v0, t0);
+  ASSERT_EQ(m0, t2);
+}
+
 TEST(LAPlusMatrixf, Level3BLAS_GEMM) {
   std::size_t r0 = 2;
   std::size_t r1 = 3;
@@ -1349,6 +1678,169 @@ TEST(LAPlusMatrixf, Level3BLAS_GEMM) {
   ASSERT_EQ(m5, m2.transpose());
 }
 
+TEST(LAPlusMatrixf, Level3BLAS_GEMMTrans) {
+  std::size_t r0 = 4;
+  std::size_t c0 = 2;
+  std::vector<std::vector<float>> t0 = {{1, 2, 3},
+                                        {2, 3, 4}};
+  std::vector<std::vector<float>> t1 = {{1, 2, 3, 4},
+                                        {2, 3, 4, 5},
+                                        {3, 4, 5, 6}};
+  std::vector<std::vector<float>> t2 = {{14, 20},
+                                        {20, 29},
+                                        {26, 38},
+                                        {32, 47}};
+
+  Matrixf m0(t0);
+  Matrixf m1(t1);
+  Matrixf m2 = Matrixf(c0, r0).transpose();
+  Matrixf m3 = Matrixf(c0, r0).transpose();
+
+  ASSERT_EQ(m2.rows(), r0);
+  ASSERT_EQ(m2.cols(), c0);
+
+  m2.gemm(1.0, m1.transpose(), m0.transpose(), 0.0);
+
+  ASSERT_EQ(m0, t0);
+  ASSERT_EQ(m1, t1);
+  ASSERT_EQ(m2, t2);
+
+  m3.gemm(1.0, m1.transpose(), m0.transpose(), 0.0);
+  m3.gemm(1.0, m1.transpose(), m0.transpose(), -1.0);
+
+  ASSERT_EQ(m3, Matrixf(r0, c0));
+}
+
+TEST(LAPlusMatrixf, Level3BLAS_SYMM) {
+  std::vector<std::vector<float>> t0 = {{2, 1},
+                                        {9, 3}};
+  std::vector<std::vector<float>> t1 = {{1, 2, 3},
+                                        {4, 5, 6}};
+  std::vector<std::vector<float>> t2 = {{6, 9, 12},
+                                        {13, 17, 21}};
+  std::vector<std::vector<float>> t3 = {{6, 13},
+                                        {9, 17},
+                                        {12, 21}};
+
+  Matrixf m0(t0);
+  Matrixf m1(t1);
+  Matrixf m2(2, 3);
+  Matrixf m3(3, 2);
+
+  m2.symm(CblasLeft, CblasUpper, 1.0, m0, m1, 0.0);
+
+  ASSERT_EQ(m0, t0);
+  ASSERT_EQ(m1, t1);
+  ASSERT_EQ(m2, t2);
+
+  m3.symm(CblasRight, CblasUpper, 1.0, m0, m1.transpose(), 0.0);
+
+  ASSERT_EQ(m0, t0);
+  ASSERT_EQ(m1, t1);
+  ASSERT_EQ(m3, t3);
+}
+
+TEST(LAPlusMatrixf, Level3BLAS_SYRK) {
+  std::vector<std::vector<float>> t0 = {{1, 2},
+                                        {3, 4},
+                                        {5, 6}};
+  std::vector<std::vector<float>> t1 = {{35, 44},
+                                        { 0, 56}};
+  std::vector<std::vector<float>> t2 = {{ 5,  0,  0},
+                                        {11, 25,  0},
+                                        {17, 39, 61}};
+
+  Matrixf m0(t0);
+  Matrixf m1(2, 2);
+  Matrixf m2(3, 3);
+
+  m1.syrk(CblasUpper, 1.0, m0.transpose(), 0.0);
+
+  ASSERT_EQ(m0, t0);
+  ASSERT_EQ(m1, t1);
+
+  m2.syrk(CblasLower, 1.0, m0, 0.0);
+
+  ASSERT_EQ(m0, t0);
+  ASSERT_EQ(m2, t2);
+}
+
+TEST(LAPlusMatrixf, Level3BLAS_SYR2K) {
+  std::vector<std::vector<float>> t0 = {{1, 0},
+                                        {0, 1}};
+  std::vector<std::vector<float>> t1 = {{1, 2},
+                                        {3, 4}};
+  std::vector<std::vector<float>> t2 = {{2, 5},
+                                        {0, 8}};
+
+  Matrixf m0(t0);
+  Matrixf m1(t1);
+  Matrixf m2(2, 2);
+  Matrixf m3(2, 2);
+
+  m2.syr2k(CblasUpper, 1.0, m0, m1, 0.0);
+
+  ASSERT_EQ(m0, t0);
+  ASSERT_EQ(m1, t1);
+  ASSERT_EQ(m2, t2);
+
+  m3.syr2k(CblasUpper, 1.0, m0.transpose(), m1, 0.0);
+
+  ASSERT_EQ(m3, t2);
+}
+
+TEST(LAPlusMatrixf, Level3BLAS_TRMM) {
+  std::vector<std::vector<float>> t0 = {{1, 0},
+                                        {2, 3}};
+  std::vector<std::vector<float>> t1 = {{1, 1},
+                                        {1, 1}};
+  std::vector<std::vector<float>> t2 = {{1, 1},
+                                        {5, 5}};
+  std::vector<std::vector<float>> t3 = {{1, 5},
+                                        {1, 5}};
+
+  Matrixf m0(t0);
+  Matrixf m1(t1);
+  Matrixf m2(t1);
+
+  m1.trmm(CblasLeft, CblasLower, CblasNonUnit, 1.0, m0);
+
+  ASSERT_EQ(m0, t0);
+  ASSERT_EQ(m1, t2);
+
+  m2.trmm(CblasRight, CblasUpper, CblasNonUnit, 1.0, m0.transpose());
+
+  ASSERT_EQ(m0, t0);
+  ASSERT_EQ(m2, t3);
+}
+
+TEST(LAPlusMatrixf, Level3BLAS_TRSM) {
+  std::vector<std::vector<float>> t0 = {{1, 0},
+                                        {2, 3}};
+  std::vector<std::vector<float>> t1 = {{1, 1},
+                                        {5, 5}};
+  std::vector<std::vector<float>> t2 = {{1, 5},
+                                        {1, 5}};
+  std::vector<std::vector<float>> t3 = {{1, 1},
+                                        {1, 1}};
+
+  Matrixf m0(t0);
+  Matrixf m1(t1);
+  Matrixf m2 = Matrixf(t2).transpose();
+
+  ASSERT_EQ(m2, t1);
+
+  m1.trsm(CblasLeft, CblasLower, CblasNonUnit, 1.0, m0);
+
+  ASSERT_EQ(m0, t0);
+  ASSERT_EQ(m1, t3);
+
+  m2.trsm(CblasLeft, CblasLower, CblasNonUnit, 1.0, m0);
+
+  ASSERT_EQ(m0, t0);
+  ASSERT_EQ(m2, t3);
+}
+
 TEST(LAPlusMatrixf, MaxCoeff) {
   std::size_t r0 = 5;
   std::size_t c0 = 5;
@@ -1726,6 +2218,44 @@ TEST(LAPlusMatrixf, GeneratorIdentity) {
   ASSERT_EQ(v0, t0);
 }
 
-}  // namespace laplus
+TEST(LAPlusMatrixd, Level2BLAS_GEMV) {
+  Matrixd m0({{1, 2, 3},
+              {2, 3, 4}});
+  Vectord v0({1, 2, 3});
+  Vectord v1({1, 2});
+  std::vector<double> t0 = {15, 22};
 
+  v1.gemv(1.0, m0, v0, 1.0);
 
+  ASSERT_EQ(v1, t0);
+}
+
+TEST(LAPlusMatrixd, Level3BLAS_GEMMTrans) {
+  Matrixd m0({{1, 2},
+              {2, 3},
+              {3, 4}});
+  Matrixd m1({{1, 2, 3, 4},
+              {2, 3, 4, 5},
+              {3, 4, 5, 6}});
+  Matrixd m2(2, 4);
+  std::vector<std::vector<double>> t0 = {{14, 20, 26, 32},
+                                         {20, 29, 38, 47}};
+
+  m2.gemm(1.0, m0.transpose(), m1, 0.0);
+
+  ASSERT_EQ(m2, t0);
+  ASSERT_EQ(m0.transpose().dot(m1), t0);
+  ASSERT_EQ(m1.transpose().dot(m0).transpose(), t0);
+}
+
+TEST(LAPlusMatrixd, OperatorArithmeticFloatL) {
+  Matrixd m0({{1, 2},
+              {4, 8}});
+  std::vector<std::vector<double>> t0 = {{8, 4},
+                                         {2, 1}};
+
+  ASSERT_EQ(8.0 / m0, t0);
+  ASSERT_EQ(2 * m0 - m0, m0);
+}
+
+}  // namespace laplus
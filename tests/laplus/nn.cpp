@@ -0,0 +1,225 @@
+/******************************************************************************
+ *
+ * laplus/nn.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/nn.hpp"
+#include "gtest/gtest.h"
+#include "helpers.hpp"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace laplus {
+
+namespace {
+
+void CheckPool(const dims_t& dims, const PoolParams& p)
+{
+  const ConvLayout l = p.layout;
+  const bool planar = (l == NCHW);
+  const Tensorf x = Random(dims);
+  const Tensorf y0 = max_pool2d(x, p);
+  const Tensorf y1 = avg_pool2d(x, p);
+  const Tensorf dy = Random(y0.dims());
+  const Tensorf dx0 = max_pool2d_backward(x, dy, p);
+  const Tensorf dx1 = avg_pool2d_backward(dy, dims, p);
+
+  const std::size_t N = dims[0], C = planar ? dims[1] : dims[3];
+  const std::size_t H = planar ? dims[2] : dims[1];
+  const std::size_t W = planar ? dims[3] : dims[2];
+  const std::size_t OH = (H + 2 * p.pad_h - p.kernel_h) / p.stride_h + 1;
+  const std::size_t OW = (W + 2 * p.pad_w - p.kernel_w) / p.stride_w + 1;
+  Tensorf dx2(dims);
+  Tensorf dx3(dims);
+  for(std::size_t n = 0; n < N; ++n)
+  for(std::size_t c = 0; c < C; ++c)
+  for(std::size_t r = 0; r < OH; ++r)
+  for(std::size_t q = 0; q < OW; ++q) {
+    float best = -std::numeric_limits<float>::infinity();
+    float sum = 0.0;
+    std::size_t bh = 0, bw = 0, count = 0;
+    for(std::size_t i = 0; i < p.kernel_h; ++i)
+    for(std::size_t j = 0; j < p.kernel_w; ++j) {
+      const long h = long(r * p.stride_h + i) - long(p.pad_h);
+      const long w = long(q * p.stride_w + j) - long(p.pad_w);
+      if(h < 0 || w < 0 || h >= long(H) || w >= long(W)) continue;
+      const float v = At(x, l, n, c, h, w);
+      if(v > best) {
+        best = v;
+        bh = h;
+        bw = w;
+      }
+      sum += v;
+      ++count;
+    }
+    ASSERT_EQ(At(y0, l, n, c, r, q), best);
+    ASSERT_NEAR(At(y1, l, n, c, r, q), sum / count, 1e-5);
+    At(dx2, l, n, c, bh, bw) += At(dy, l, n, c, r, q);
+    for(std::size_t i = 0; i < p.kernel_h; ++i)
+    for(std::size_t j = 0; j < p.kernel_w; ++j) {
+      const long h = long(r * p.stride_h + i) - long(p.pad_h);
+      const long w = long(q * p.stride_w + j) - long(p.pad_w);
+      if(h < 0 || w < 0 || h >= long(H) || w >= long(W)) continue;
+      At(dx3, l, n, c, h, w) += At(dy, l, n, c, r, q) / count;
+    }
+  }
+  for(std::size_t k = 0; k < x.size(); ++k) {
+    ASSERT_NEAR(dx0.data()[k], dx2.data()[k], 1e-5);
+    ASSERT_NEAR(dx1.data()[k], dx3.data()[k], 1e-5);
+  }
+}
+
+// Normalizes x over rows (axis 0) or columns (axis 1) in double precision
+// and returns y together with the gradients for dy.
+void Reference(const Matrixf& x, const Matrixf& dy, const Vectorf& gamma,
+               const Vectorf& beta, const float eps, const int axis,
+               Matrixf& y, Matrixf& dx, Vectorf& dgamma, Vectorf& dbeta)
+{
+  const std::size_t groups = axis ? x.rows() : x.cols();
+  const std::size_t n = axis ? x.cols() : x.rows();
+  for(std::size_t j = 0; j < x.cols(); ++j) {
+    dgamma[j] = 0.0;
+    dbeta[j] = 0.0;
+  }
+  for(std::size_t g = 0; g < groups; ++g) {
+    auto at = [&](const Matrixf& m, std::size_t k) -> float& {
+      return axis ? m(g, k) : m(k, g);
+    };
+    auto col = [&](std::size_t k) { return axis ? k : g; };
+    double mean = 0.0, var = 0.0;
+    for(std::size_t k = 0; k < n; ++k) mean += at(x, k);
+    mean /= n;
+    for(std::size_t k = 0; k < n; ++k) {
+      var += (at(x, k) - mean) * (at(x, k) - mean);
+    }
+    var /= n;
+    const double rstd = 1.0 / std::sqrt(var + eps);
+    double s0 = 0.0, s1 = 0.0;
+    for(std::size_t k = 0; k < n; ++k) {
+      const double h = (at(x, k) - mean) * rstd;
+      const double e = at(dy, k) * gamma[col(k)];
+      at(y, k) = h * gamma[col(k)] + beta[col(k)];
+      s0 += e;
+      s1 += e * h;
+      dgamma[col(k)] += at(dy, k) * h;
+      dbeta[col(k)] += at(dy, k);
+    }
+    for(std::size_t k = 0; k < n; ++k) {
+      const double h = (at(x, k) - mean) * rstd;
+      const double e = at(dy, k) * gamma[col(k)];
+      at(dx, k) = rstd * (e - s0 / n - h * s1 / n);
+    }
+  }
+}
+
+}  // unnamed namespace
+
+TEST(LAPlusNN, Pool) {
+  CheckPool({2, 3, 7, 9}, {NCHW, 2, 2, 2, 2, 0, 0});
+  CheckPool({2, 3, 7, 9}, {NCHW, 3, 3, 2, 1, 1, 1});
+  CheckPool({2, 7, 9, 11}, {NHWC, 2, 2, 2, 2, 0, 0});
+  CheckPool({1, 6, 6, 19}, {NHWC, 3, 2, 1, 2, 2, 1});
+}
+
+TEST(LAPlusNN, BatchNorm) {
+  Matrixf x = Matrixf::Uniform(300, 19, 10.0, 12.0);
+  Matrixf dy = Matrixf::Uniform(300, 19, -1.0, 1.0);
+  Vectorf gamma = Vectorf::Uniform(19, 0.5, 1.5);
+  Vectorf beta = Vectorf::Uniform(19, -1.0, 1.0);
+  Matrixf y0(300, 19), dx0(300, 19);
+  Vectorf dgamma(19), dbeta(19);
+  Reference(x, dy, gamma, beta, 1e-5, 0, y0, dx0, dgamma, dbeta);
+
+  NormStats stats;
+  Matrixf y1 = batch_norm(x, gamma, beta, 1e-5, stats);
+  NormGrads grads = batch_norm_backward(dy, x, gamma, stats);
+  ExpectNear(y1, y0, 1e-3);
+  ExpectNear(grads.dx, dx0, 1e-3);
+  ExpectNear(Matrixf(grads.dgamma), Matrixf(dgamma), 1e-2);
+  ExpectNear(Matrixf(grads.dbeta), Matrixf(dbeta), 1e-3);
+
+  Matrixf x1(19, 300);
+  for(std::size_t i = 0; i < 300; ++i) {
+    for(std::size_t j = 0; j < 19; ++j) x1(j, i) = x(i, j);
+  }
+  Matrixf y2 = batch_norm(x1.transpose(), gamma, beta, stats);
+  ExpectNear(y2, y0, 1e-3);
+}
+
+TEST(LAPlusNN, LayerNorm) {
+  Matrixf x = Matrixf::Uniform(70, 37, -3.0, 5.0);
+  Matrixf dy = Matrixf::Uniform(70, 37, -1.0, 1.0);
+  Vectorf gamma = Vectorf::Uniform(37, 0.5, 1.5);
+  Vectorf beta = Vectorf::Uniform(37, -1.0, 1.0);
+  Matrixf y0(70, 37), dx0(70, 37);
+  Vectorf dgamma(37), dbeta(37);
+  Reference(x, dy, gamma, beta, 1e-5, 1, y0, dx0, dgamma, dbeta);
+
+  NormStats stats;
+  Matrixf y1 = layer_norm(x, gamma, beta, 1e-5, stats);
+  NormGrads grads = layer_norm_backward(dy, x, gamma, stats);
+  ASSERT_EQ(stats.mean.size(), 70);
+  ExpectNear(y1, y0, 1e-4);
+  ExpectNear(grads.dx, dx0, 1e-4);
+  ExpectNear(Matrixf(grads.dgamma), Matrixf(dgamma), 1e-3);
+  ExpectNear(Matrixf(grads.dbeta), Matrixf(dbeta), 1e-3);
+}
+
+TEST(LAPlusNN, Dropout) {
+  Matrixf x = Matrixf::Uniform(200, 301, 1.0, 2.0);
+  Matrixf y0 = dropout(x, 0.3, 42);
+  Matrixf y1 = dropout(x, 0.3, 42);
+  Matrixf y2 = dropout(x, 0.3, 43);
+  Matrixf y3 = dropout_backward(Matrixf(200, 301) + 1.0, 0.3, 42);
+
+  std::size_t dropped = 0, differ = 0;
+  for(std::size_t i = 0; i < x.rows(); ++i) {
+    for(std::size_t j = 0; j < x.cols(); ++j) {
+      if(y0(i, j) == 0.0) {
+        ++dropped;
+        ASSERT_EQ(y3(i, j), 0.0);
+      } else {
+        ASSERT_FLOAT_EQ(y0(i, j), x(i, j) / 0.7);
+        ASSERT_FLOAT_EQ(y3(i, j), 1.0 / 0.7);
+      }
+      if((y0(i, j) == 0.0) != (y2(i, j) == 0.0)) ++differ;
+    }
+  }
+  ASSERT_EQ(y0, y1);
+  ASSERT_NEAR(double(dropped) / x.size(), 0.3, 0.01);
+  ASSERT_GT(differ, x.size() / 4);
+
+  Matrixf x1(301, 200);
+  for(std::size_t i = 0; i < 200; ++i) {
+    for(std::size_t j = 0; j < 301; ++j) x1(j, i) = x(i, j);
+  }
+  ASSERT_EQ(dropout(x1.transpose(), 0.3, 42), y0);
+}
+
+}  // namespace laplus
@@ -0,0 +1,187 @@
+/******************************************************************************
+ *
+ * laplus/npy.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/npy.hpp"
+#include "laplus/vectorf.hpp"
+#include "laplus/matrixf.hpp"
+#include "laplus/typedef.hpp"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+
+namespace laplus {
+
+namespace {
+
+const std::string path = "laplus_npy_test.npy";
+
+void WriteNpy(const std::string& dict, const std::string& data)
+{
+  std::string header = dict;
+  header.resize(117, ' ');
+  header += '\n';
+  std::ofstream stream(path, std::ios::binary);
+  stream.write("\x93NUMPY\x01\x00\x76\x00", 10);
+  stream.write(header.data(), header.size());
+  stream.write(data.data(), data.size());
+}
+
+}  // unnamed namespace
+
+TEST(LAPlusNpy, RoundTrip)
+{
+  const Matrixf A = Matrixf::Uniform(5, 7);
+  const Matrixf B = Matrixf::Uniform(3, 4).transpose();
+  const Matrix<double> C = Matrix<double>::Normal(2, 9);
+  Matrixf A0(1, 1);
+  Matrix<double> C0(1, 1);
+
+  ASSERT_TRUE(save_npy(path, A));
+  ASSERT_TRUE(load_npy(path, A0));
+  ASSERT_EQ(A, A0);
+  ASSERT_EQ(0, reinterpret_cast<std::uintptr_t>(A0.data()) % 64);
+
+  ASSERT_TRUE(save_npy(path, B));
+  ASSERT_TRUE(load_npy(path, A0));
+  ASSERT_EQ(B, A0);
+  ASSERT_EQ(CblasColMajor, A0.layout());
+
+  ASSERT_TRUE(save_npy(path, C));
+  ASSERT_TRUE(load_npy(path, C0));
+  ASSERT_EQ(C, C0);
+  ASSERT_TRUE(load_npy(path, A0));
+  for(std::size_t i = 0; i < C.rows(); ++i) {
+    for(std::size_t j = 0; j < C.cols(); ++j) {
+      ASSERT_FLOAT_EQ(float(C(i, j)), A0(i, j));
+    }
+  }
+
+  ASSERT_TRUE(save_npy(path, A.col(3)));
+  ASSERT_TRUE(load_npy(path, A0));
+  ASSERT_EQ(shape_t(1, 5), shape_t(A0.rows(), A0.cols()));
+  ASSERT_EQ(A.col(3), A0.row(0));
+
+  std::remove(path.c_str());
+}
+
+TEST(LAPlusNpy, Convert)
+{
+  Matrixf A(1, 1);
+
+  // Big-endian int16 in Fortran order.
+  WriteNpy("{'descr': '>i2', 'fortran_order': True, 'shape': (2, 3), }",
+           std::string("\x00\x01\xff\xfe\x00\x03\x00\x04\x01\x00\x80\x00",
+                       12));
+  ASSERT_TRUE(load_npy(path, A));
+  ASSERT_EQ(Matrixf(vector2d<float>({{1, 3, 256}, {-2, 4, -32768}})), A);
+
+  WriteNpy("{'descr': '|b1', 'fortran_order': False, 'shape': (4,), }",
+           std::string("\x01\x00\x00\x01", 4));
+  ASSERT_TRUE(load_npy(path, A));
+  ASSERT_EQ(Matrixf(vector2d<float>({{1, 0, 0, 1}})), A);
+
+  WriteNpy("{'descr': '<u8', 'fortran_order': False, 'shape': (1L, 1L), }",
+           std::string("\x00\x00\x00\x00\x01\x00\x00\x00", 8));
+  ASSERT_TRUE(load_npy(path, A));
+  ASSERT_FLOAT_EQ(4294967296.0f, A(0, 0));
+
+  WriteNpy("{'descr': '<f2', 'fortran_order': False, 'shape': (2,), }",
+           std::string("\x00\x3c\x00\xc1", 4));
+  ASSERT_TRUE(load_npy(path, A));
+  ASSERT_EQ(Matrixf(vector2d<float>({{1.0, -2.5}})), A);
+
+  WriteNpy("{'descr': '<f4', 'fortran_order': False, 'shape': (), }",
+           std::string("\x00\x00\x80\x3f", 4));
+  ASSERT_TRUE(load_npy(path, A));
+  ASSERT_EQ(Matrixf(vector2d<float>({{1.0}})), A);
+
+  std::remove(path.c_str());
+}
+
+TEST(LAPlusNpy, Invalid)
+{
+  Matrixf A = Matrixf::Uniform(2, 2);
+  const Matrixf A0 = A.clone();
+  ASSERT_FALSE(load_npy("laplus_npy_missing.npy", A));
+
+  WriteNpy("{'descr': '<c8', 'fortran_order': False, 'shape': (1,), }",
+           std::string(8, '\0'));
+  ASSERT_FALSE(load_npy(path, A));
+
+  WriteNpy("{'descr': '<f4', 'fortran_order': False, 'shape': (2, 2, 2), }",
+           std::string(32, '\0'));
+  ASSERT_FALSE(load_npy(path, A));
+
+  WriteNpy("{'descr': '<f4', 'fortran_order': False, 'shape': (4, 4), }",
+           std::string(32, '\0'));
+  ASSERT_FALSE(load_npy(path, A));
+
+  // The element count wraps around to the eight floats in the file.
+  WriteNpy("{'descr': '<f4', 'fortran_order': False, "
+           "'shape': (4611686018427387906, 4), }",
+           std::string(32, '\0'));
+  ASSERT_FALSE(load_npy(path, A));
+  ASSERT_EQ(A0, A);
+
+  std::map<std::string, Matrixf> arrays;
+  ASSERT_FALSE(load_npz(path, arrays));
+
+  std::remove(path.c_str());
+}
+
+TEST(LAPlusNpy, Archive)
+{
+  const std::string archive = "laplus_npy_test.npz";
+  std::map<std::string, Matrixf> arrays;
+  arrays.insert(std::make_pair("weight", Matrixf::Uniform(6, 3)));
+  arrays.insert(std::make_pair("bias", Matrixf::Uniform(1, 3)));
+  arrays.insert(std::make_pair("embedding",
+                               Matrixf::Uniform(4, 5).transpose()));
+  ASSERT_TRUE(save_npz(archive, arrays));
+
+  std::map<std::string, Matrixf> loaded;
+  ASSERT_TRUE(load_npz(archive, loaded));
+  ASSERT_EQ(3, loaded.size());
+  for(const auto& item: arrays) {
+    ASSERT_EQ(1, loaded.count(item.first));
+    ASSERT_EQ(item.second, loaded.at(item.first));
+    ASSERT_EQ(item.second.layout(), loaded.at(item.first).layout());
+  }
+
+  std::map<std::string, Matrix<double>> doubles;
+  ASSERT_TRUE(load_npz(archive, doubles));
+  ASSERT_FLOAT_EQ(arrays.at("weight")(5, 2), doubles.at("weight")(5, 2));
+
+  std::remove(archive.c_str());
+}
+
+}  // namespace laplus
@@ -0,0 +1,182 @@
+/******************************************************************************
+ *
+ * laplus/optimizer.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/optimizer.hpp"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <vector>
+
+namespace laplus {
+
+namespace {
+
+// Straightforward per-element reference of each algorithm.
+struct Reference {
+  OptimizerParams p;
+  std::vector<double> w, m, v;
+  std::size_t t;
+
+  Reference(const OptimizerParams& params, const Vectorf& x)
+    : p(params), w(x.size()), m(x.size(), 0.0), v(x.size(), 0.0), t(0)
+  { for(std::size_t i = 0; i < x.size(); ++i) w[i] = x[i]; }
+
+  void step(const Vectorf& g)
+  {
+    ++t;
+    for(std::size_t i = 0; i < w.size(); ++i) {
+      double d = g[i];
+      if(p.algorithm != OptimizerAdamW) d += p.weight_decay * w[i];
+      switch(p.algorithm) {
+      case OptimizerSGD:
+        if(p.momentum != 0.0f) {
+          v[i] = p.momentum * v[i] + d;
+          d = p.nesterov ? d + p.momentum * v[i] : v[i];
+        }
+        w[i] -= p.lr * d;
+        break;
+      case OptimizerAdam:
+      case OptimizerAdamW: {
+        if(p.algorithm == OptimizerAdamW) {
+          w[i] -= p.lr * p.weight_decay * w[i];
+        }
+        m[i] = p.beta1 * m[i] + (1.0 - p.beta1) * d;
+        v[i] = p.beta2 * v[i] + (1.0 - p.beta2) * d * d;
+        const double mh = m[i] / (1.0 - std::pow(p.beta1, t));
+        const double vh = v[i] / (1.0 - std::pow(p.beta2, t));
+        w[i] -= p.lr * mh / (std::sqrt(vh) + p.eps);
+        break;
+      }
+      case OptimizerRMSProp:
+        v[i] = p.beta2 * v[i] + (1.0 - p.beta2) * d * d;
+        d /= std::sqrt(v[i]) + p.eps;
+        if(p.momentum != 0.0f) d = m[i] = p.momentum * m[i] + d;
+        w[i] -= p.lr * d;
+        break;
+      }
+    }
+  }
+};
+
+void Check(const OptimizerParams& p)
+{
+  Matrixf w = Matrixf::Uniform(17, 61, -1.0, 1.0);
+  Reference r(p, w);
+  Optimizer optimizer(p);
+  const std::size_t slot = optimizer.add(w);
+
+  for(std::size_t k = 0; k < 5; ++k) {
+    const Matrixf g = Matrixf::Uniform(17, 61, -1.0, 1.0);
+    optimizer.step(slot, w, g);
+    r.step(g);
+  }
+
+  ASSERT_EQ(optimizer.steps(slot), 5);
+  for(std::size_t i = 0; i < w.size(); ++i) {
+    ASSERT_NEAR(w.data()[i], r.w[i], 1e-5);
+  }
+}
+
+void CheckGemm(const OptimizerParams& p)
+{
+  const Matrixf a = Matrixf::Uniform(33, 19, -1.0, 1.0);
+  const Matrixf b = Matrixf::Uniform(33, 21, -1.0, 1.0);
+  Matrixf w0 = Matrixf::Uniform(19, 21, -1.0, 1.0);
+  Matrixf w1 = w0.clone();
+  Optimizer o0(p);
+  Optimizer o1(p);
+  const std::size_t s0 = o0.add(w0);
+  const std::size_t s1 = o1.add(w1);
+
+  for(std::size_t k = 0; k < 3; ++k) {
+    o0.step(s0, w0, a.transpose(), b);
+    o1.step(s1, w1, a.transpose().dot(b));
+  }
+
+  ASSERT_EQ(o0.steps(s0), 3);
+  for(std::size_t i = 0; i < w0.rows(); ++i) {
+    for(std::size_t j = 0; j < w0.cols(); ++j) {
+      ASSERT_NEAR(w0(i, j), w1(i, j), 1e-4);
+    }
+  }
+}
+
+}  // unnamed namespace
+
+TEST(LAPlusOptimizer, SGD) {
+  Check({OptimizerSGD, 0.1f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, false});
+  Check({OptimizerSGD, 0.1f, 0.0f, 0.0f, 0.0f, 0.0f, 0.01f, false});
+}
+
+TEST(LAPlusOptimizer, SGDMomentum) {
+  Check({OptimizerSGD, 0.1f, 0.9f, 0.0f, 0.0f, 0.0f, 0.0f, false});
+  Check({OptimizerSGD, 0.1f, 0.9f, 0.0f, 0.0f, 0.0f, 0.01f, true});
+}
+
+TEST(LAPlusOptimizer, Adam) {
+  Check({OptimizerAdam, 0.01f, 0.0f, 0.9f, 0.999f, 1e-8f, 0.0f, false});
+  Check({OptimizerAdam, 0.01f, 0.0f, 0.9f, 0.999f, 1e-8f, 0.1f, false});
+}
+
+TEST(LAPlusOptimizer, AdamW) {
+  Check({OptimizerAdamW, 0.01f, 0.0f, 0.9f, 0.999f, 1e-8f, 0.1f, false});
+}
+
+TEST(LAPlusOptimizer, RMSProp) {
+  Check({OptimizerRMSProp, 0.01f, 0.0f, 0.0f, 0.99f, 1e-8f, 0.0f, false});
+  Check({OptimizerRMSProp, 0.01f, 0.9f, 0.0f, 0.99f, 1e-8f, 0.01f, false});
+}
+
+TEST(LAPlusOptimizer, StepTransposed) {
+  const OptimizerParams p = {OptimizerSGD, 0.5f, 0.0f, 0.0f, 0.0f, 0.0f,
+                             0.0f, false};
+  Matrixf w = Matrixf::Uniform(9, 13);
+  const Matrixf w0 = w.clone();
+  const Matrixf g = Matrixf::Uniform(13, 9).transpose();
+  Optimizer optimizer(p);
+  const std::size_t slot = optimizer.add(w);
+  optimizer.step(slot, w, g);
+
+  for(std::size_t i = 0; i < w.rows(); ++i) {
+    for(std::size_t j = 0; j < w.cols(); ++j) {
+      ASSERT_FLOAT_EQ(w(i, j), w0(i, j) - 0.5f * g(i, j));
+    }
+  }
+}
+
+TEST(LAPlusOptimizer, StepGemm) {
+  CheckGemm({OptimizerSGD, 0.1f, 0.0f, 0.0f, 0.0f, 0.0f, 0.01f, false});
+  CheckGemm({OptimizerSGD, 0.1f, 0.9f, 0.0f, 0.0f, 0.0f, 0.0f, false});
+  CheckGemm({OptimizerSGD, 0.1f, 0.9f, 0.0f, 0.0f, 0.0f, 0.0f, true});
+  CheckGemm({OptimizerAdam, 0.01f, 0.0f, 0.9f, 0.999f, 1e-8f, 0.0f, false});
+  CheckGemm({OptimizerRMSProp, 0.01f, 0.9f, 0.0f, 0.99f, 1e-8f, 0.0f,
+             false});
+}
+
+}  // namespace laplus
@@ -0,0 +1,71 @@
+/******************************************************************************
+ *
+ * laplus/process.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#ifndef __LAPLUS_TESTS_PROCESS_HPP__
+#define __LAPLUS_TESTS_PROCESS_HPP__
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace laplus {
+
+// Runs body(rank) for ranks 1 to size - 1 in forked children and for rank
+// 0 in this process, and returns whether every rank succeeded. Children
+// must stay off the worker pool, which does not survive the fork.
+inline const bool spawn(const std::size_t size,
+                        const std::function<bool(const std::size_t)>& body)
+{
+  std::vector<pid_t> children;
+  for(std::size_t rank = 1; rank < size; ++rank) {
+    const pid_t pid = ::fork();
+    if(pid == 0) ::_exit(body(rank) ? 0 : 1);
+    children.push_back(pid);
+  }
+  bool ok = body(0);
+  for(const pid_t pid: children) {
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  }
+  return ok;
+}
+
+// A name for shared memory segments and sockets that does not clash with
+// concurrent runs of the tests.
+inline const std::string unique(const std::string& name)
+{ return "laplus-" + name + "-" + std::to_string(::getpid()); }
+
+}  // namespace laplus
+
+#endif  // __LAPLUS_TESTS_PROCESS_HPP__
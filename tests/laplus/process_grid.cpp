@@ -0,0 +1,126 @@
+/******************************************************************************
+ *
+ * laplus/process_grid.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/process_grid.hpp"
+#include "gtest/gtest.h"
+#include "process.hpp"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace laplus {
+
+namespace {
+
+Matrixf pattern(const std::size_t rows, const std::size_t cols,
+                const float seed)
+{
+  std::vector<float> values(rows * cols);
+  for(std::size_t i = 0; i < values.size(); ++i)
+    values[i] = std::sin(seed * (i + 1));
+  return Matrixf(values, rows, cols);
+}
+
+// Multiplies distributed blocks of fixed matrices on the given grid and
+// checks the gathered result against a serial product.
+const bool summa(const ProcessGrid& grid, const std::size_t width)
+{
+  const std::size_t m = 13, n = 11, k = 17;
+  const Matrixf a = pattern(m, k, 0.3f);
+  const Matrixf b = pattern(k, n, 0.7f);
+  const Matrixf c = pattern(m, n, 1.1f);
+
+  Matrixf local = grid.block(c);
+  grid.gemm(2.0f, grid.block(a), grid.block(b), 0.5f, local, k, width);
+  const Matrixf result = grid.gather(local, m, n);
+
+  bool ok = grid.transport().is_open();
+  for(std::size_t i = 0; i < m; ++i) {
+    for(std::size_t j = 0; j < n; ++j) {
+      float expect = 0.5f * c.data()[i * n + j];
+      for(std::size_t p = 0; p < k; ++p)
+        expect += 2.0f * a.data()[i * k + p] * b.data()[p * n + j];
+      ok = ok && std::fabs(expect - result.data()[i * n + j]) < 1e-4f;
+    }
+  }
+  return ok;
+}
+
+}  // unnamed namespace
+
+TEST(LAPlusProcessGrid, Split) {
+  EXPECT_EQ(0u, ProcessGrid::split(10, 3, 0));
+  EXPECT_EQ(3u, ProcessGrid::split(10, 3, 1));
+  EXPECT_EQ(6u, ProcessGrid::split(10, 3, 2));
+  EXPECT_EQ(10u, ProcessGrid::split(10, 3, 3));
+}
+
+TEST(LAPlusProcessGrid, Single) {
+  SharedTransport t(unique("single"), 0, 1);
+  const ProcessGrid grid(t, 1, 1);
+  EXPECT_TRUE(summa(grid, 4));
+}
+
+TEST(LAPlusProcessGrid, BetaZero) {
+  SharedTransport t(unique("beta"), 0, 1);
+  const ProcessGrid grid(t, 1, 1);
+  const Matrixf a = pattern(5, 3, 0.3f);
+  const Matrixf b = pattern(3, 4, 0.7f);
+  Matrixf c(std::vector<float>(20, std::nanf("")), 5, 4);
+  grid.gemm(1.0f, a, b, 0.0f, c, 3);
+
+  const Matrixf expect = a.dot(b);
+  for(std::size_t i = 0; i < 5; ++i) {
+    for(std::size_t j = 0; j < 4; ++j) {
+      EXPECT_NEAR(expect(i, j), c(i, j), 1e-5);
+    }
+  }
+}
+
+TEST(LAPlusProcessGrid, Shared) {
+  const std::string name = unique("grid");
+  EXPECT_TRUE(spawn(4, [&](const std::size_t rank) {
+    SharedTransport t(name, rank, 4, 256);
+    const ProcessGrid grid(t, 2, 2);
+    return grid.row() == rank / 2 && grid.col() == rank % 2
+      && summa(grid, 3);
+  }));
+}
+
+TEST(LAPlusProcessGrid, Unix) {
+  const std::string path = "/tmp/" + unique("grid");
+  EXPECT_TRUE(spawn(6, [&](const std::size_t rank) {
+    SocketTransport t(SocketUnix, path, rank, 6);
+    const ProcessGrid grid(t, 2, 3);
+    return summa(grid, 256);
+  }));
+}
+
+}  // namespace laplus
@@ -0,0 +1,139 @@
+/******************************************************************************
+ *
+ * laplus/quantized_matrix.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/quantized_matrix.hpp"
+#include "laplus/matrixf.hpp"
+#include "gtest/gtest.h"
+#include "helpers.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace laplus {
+
+TEST(LAPlusQuantizedMatrix, Quantize) {
+  QuantParams p0 = {UInt8, PerTensor, {0.5}, {10}};
+  QuantParams p1 = {Int8, PerCol, {1.0, 2.0}, {0, -1}};
+  Matrixf m0({{1, -1}, {200, -200}});
+
+  QuantizedMatrix q0(m0, p0);
+  QuantizedMatrix q1(m0, p1);
+
+  ASSERT_EQ(q0.value(0, 0), 12);
+  ASSERT_EQ(q0.value(0, 1), 8);
+  ASSERT_EQ(q0.value(1, 0), 255);
+  ASSERT_EQ(q0.value(1, 1), 0);
+  ASSERT_EQ(q1.value(0, 0), 1);
+  ASSERT_EQ(q1.value(0, 1), -1);
+  ASSERT_EQ(q1.value(1, 0), 127);
+  ASSERT_EQ(q1.value(1, 1), -101);
+  ASSERT_EQ(q1(0, 1), 0.0);
+  ASSERT_EQ(q1(1, 1), -200.0);
+}
+
+TEST(LAPlusQuantizedMatrix, Calibrator) {
+  Calibrator c0(PerRow);
+  c0.observe(Matrixf({{0, 255}, {-1, 1}}));
+  c0.observe(Matrixf({{1, 2}, {-2, 0}}));
+  QuantParams p0 = c0.params(UInt8);
+  QuantParams p1 = c0.params(Int8, true);
+
+  ASSERT_EQ(p0.axis, PerRow);
+  ASSERT_EQ(p0.scales.size(), 2);
+  ASSERT_FLOAT_EQ(p0.scales[0], 1.0);
+  ASSERT_EQ(p0.zero_points[0], 0);
+  ASSERT_FLOAT_EQ(p0.scales[1], 3.0 / 255.0);
+  ASSERT_EQ(p0.zero_points[1], 170);
+  ASSERT_FLOAT_EQ(p1.scales[1], 2.0 / 127.0);
+  ASSERT_EQ(p1.zero_points[1], 0);
+}
+
+TEST(LAPlusQuantizedMatrix, Dequantize) {
+  Matrixf m0 = Matrixf::Uniform(19, 37, -3.0, 5.0);
+
+  for(QuantAxis axis: {PerTensor, PerRow, PerCol}) {
+    for(QuantType type: {Int8, UInt8}) {
+      QuantizedMatrix q0(m0, axis, type);
+      QuantizedMatrix q1(m0.transpose(), axis, type);
+      const float tolerance = 8.0 / 255.0 * 0.5 + 1e-5;
+
+      ExpectNear(q0.dequantize(), m0, tolerance);
+      ExpectNear(q1.dequantize(), m0.transpose(), tolerance);
+      ExpectNear(q1.transpose().dequantize(), m0, tolerance);
+      ExpectNear(q0.pack(CblasColMajor).dequantize(), q0.dequantize(), 0.0);
+    }
+  }
+}
+
+TEST(LAPlusQuantizedMatrix, GEMM) {
+  Matrixf m0 = Matrixf::Uniform(13, 150, -1.0, 3.0);
+  Matrixf m1 = Matrixf::Uniform(150, 23, -2.0, 1.0);
+  QuantizedMatrix q0(m0, PerRow, UInt8);
+  QuantizedMatrix q1(m1, PerCol, Int8);
+  std::vector<std::int32_t> c0(13 * 23);
+
+  gemm(q0, q1, c0.data());
+
+  for(std::size_t i = 0; i < 13; ++i) {
+    for(std::size_t j = 0; j < 23; ++j) {
+      std::int32_t sum = 0;
+      for(std::size_t k = 0; k < 150; ++k) {
+        sum += (q0.value(i, k) - q0.params().zero_points[i])
+             * (q1.value(k, j) - q1.params().zero_points[j]);
+      }
+      ASSERT_EQ(c0[i * 23 + j], sum);
+    }
+  }
+
+  Matrixf m2 = q0.dequantize().dot(q1.dequantize());
+  ExpectNear(dot(q0, q1), m2, 1e-3);
+  ExpectNear(dot(q0, QuantizedMatrix(m1, PerTensor, Int8)), m0.dot(m1), 0.5);
+}
+
+TEST(LAPlusQuantizedMatrix, Requantize) {
+  Matrixf m0 = Matrixf::Uniform(7, 70, 0.0, 1.0);
+  Matrixf m1 = Matrixf::Uniform(70, 9, -1.0, 1.0);
+  QuantizedMatrix q0(m0, PerTensor, UInt8);
+  QuantizedMatrix q1(m1.transpose(), PerRow, Int8);
+  Matrixf m2 = dot(q0, q1.transpose());
+
+  Calibrator c0(PerCol);
+  c0.observe(m2);
+  QuantParams p0 = c0.params(Int8);
+  QuantizedMatrix q2 = dot(q0, q1.transpose(), p0);
+  QuantizedMatrix q3(m2, p0);
+
+  for(std::size_t i = 0; i < 7; ++i) {
+    for(std::size_t j = 0; j < 9; ++j) {
+      ASSERT_NEAR(q2.value(i, j), q3.value(i, j), 1);
+    }
+  }
+}
+
+}  // namespace laplus
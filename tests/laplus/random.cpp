@@ -0,0 +1,195 @@
+/******************************************************************************
+ *
+ * laplus/random.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/random.hpp"
+#include "laplus/vectorf.hpp"
+#include "laplus/matrixf.hpp"
+#include "laplus/internal/parallel.hpp"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace laplus {
+
+namespace {
+
+template<typename T>
+void CheckMoments(const std::vector<T>& values, const T mean, const T var)
+{
+  double m = 0.0;
+  for(T v: values) m += v;
+  m /= values.size();
+  double s = 0.0;
+  for(T v: values) s += (v - m) * (v - m);
+  s /= values.size();
+  EXPECT_NEAR(m, mean, 0.01);
+  EXPECT_NEAR(s, var, 0.02);
+}
+
+}  // unnamed namespace
+
+TEST(LAPlusRandom, KnownAnswer)
+{
+  std::uint32_t out[4];
+
+  Philox(0, 0).block(0, out);
+  EXPECT_EQ(0x6627e8d5u, out[0]);
+  EXPECT_EQ(0xe169c58du, out[1]);
+  EXPECT_EQ(0xbc57ac4cu, out[2]);
+  EXPECT_EQ(0x9b00dbd8u, out[3]);
+
+  Philox(~0ull, ~0ull).block(~0ull, out);
+  EXPECT_EQ(0x408f276du, out[0]);
+  EXPECT_EQ(0x41c83b0eu, out[1]);
+  EXPECT_EQ(0xa20bc7c6u, out[2]);
+  EXPECT_EQ(0x6d5451fdu, out[3]);
+
+  Philox(0x299f31d0a4093822ull, 0x0370734413198a2eull)
+      .block(0x85a308d3243f6a88ull, out);
+  EXPECT_EQ(0xd16cfe09u, out[0]);
+  EXPECT_EQ(0x94fdccebu, out[1]);
+  EXPECT_EQ(0x5001e420u, out[2]);
+  EXPECT_EQ(0x24126ea1u, out[3]);
+}
+
+TEST(LAPlusRandom, Uniform)
+{
+  const Philox philox(42, 7);
+  const std::size_t n = 100003;
+  std::vector<float> values(n);
+  philox.uniform(values.data(), n, -1.0f, 3.0f);
+
+  for(std::size_t i = 0; i < n; ++i) {
+    ASSERT_LE(-1.0f, values[i]);
+    ASSERT_GT(3.0f, values[i]);
+  }
+  CheckMoments<float>(values, 1.0f, 16.0f / 12.0f);
+
+  // Element i is drawn from word i % 4 of block i / 4.
+  for(std::size_t i: {0ul, 5ul, 31ul, 32ul, 4097ul, n - 1}) {
+    std::uint32_t out[4];
+    philox.block(i / 4, out);
+    EXPECT_FLOAT_EQ(-1.0f + (out[i % 4] >> 8) * 4.0f / 16777216.0f,
+                    values[i]);
+  }
+
+  // A shorter fill is a prefix of a longer one.
+  std::vector<float> prefix(37);
+  philox.uniform(prefix.data(), prefix.size(), -1.0f, 3.0f);
+  for(std::size_t i = 0; i < prefix.size(); ++i) {
+    EXPECT_EQ(values[i], prefix[i]);
+  }
+
+  std::vector<double> doubles(n);
+  philox.uniform(doubles.data(), n, 0.0, 1.0);
+  for(double v: doubles) {
+    ASSERT_LE(0.0, v);
+    ASSERT_GT(1.0, v);
+  }
+  CheckMoments<double>(doubles, 0.5, 1.0 / 12.0);
+}
+
+TEST(LAPlusRandom, Normal)
+{
+  const Philox philox(3, 1);
+  const std::size_t n = 200001;
+
+  std::vector<float> values(n);
+  philox.normal(values.data(), n, 0.0f, 1.0f);
+  CheckMoments<float>(values, 0.0f, 1.0f);
+
+  std::vector<float> shifted(n);
+  philox.normal(shifted.data(), n, 2.0f, 0.5f);
+  for(std::size_t i = 0; i < n; ++i) {
+    ASSERT_NEAR(2.0f + 0.5f * values[i], shifted[i], 1e-5);
+  }
+
+  // The vectorized and scalar paths agree on a tail shorter than a group.
+  std::vector<float> prefix(45);
+  philox.normal(prefix.data(), prefix.size(), 0.0f, 1.0f);
+  for(std::size_t i = 0; i < 32; ++i) {
+    EXPECT_NEAR(values[i], prefix[i], 1e-5);
+  }
+  for(std::size_t i = 32; i < prefix.size(); ++i) {
+    EXPECT_EQ(values[i], prefix[i]);
+  }
+
+  std::size_t tail = 0;
+  for(float v: values) tail += (std::fabs(v) > 3.0f);
+  EXPECT_NEAR(0.0027, double(tail) / n, 0.0005);
+
+  std::vector<double> doubles(n);
+  philox.normal(doubles.data(), n, 0.0, 1.0);
+  CheckMoments<double>(doubles, 0.0, 1.0);
+}
+
+TEST(LAPlusRandom, Seed)
+{
+  seed(1);
+  const Matrixf A = Matrixf::Normal(16, 16);
+  const Matrixf B = Matrixf::Normal(16, 16);
+  const Vectorf u = Vectorf::Uniform(100);
+  EXPECT_NE(A, B);
+
+  seed(1);
+  EXPECT_EQ(A, Matrixf::Normal(16, 16));
+  EXPECT_EQ(B, Matrixf::Normal(16, 16));
+  EXPECT_EQ(u, Vectorf::Uniform(100));
+
+  seed(2);
+  EXPECT_NE(A, Matrixf::Normal(16, 16));
+}
+
+TEST(LAPlusRandom, ThreadCount)
+{
+  const std::size_t threads = internal::concurrency();
+  const Philox g(7, 3);
+  const std::size_t n = 100003;
+  std::vector<float> f[2] = {std::vector<float>(n), std::vector<float>(n)};
+  std::vector<float> h[2] = {std::vector<float>(n), std::vector<float>(n)};
+  std::vector<double> d[2] = {std::vector<double>(n), std::vector<double>(n)};
+  std::vector<double> e[2] = {std::vector<double>(n), std::vector<double>(n)};
+  for(std::size_t k = 0; k < 2; ++k) {
+    internal::set_concurrency(k == 0 ? 1 : 4);
+    g.uniform(f[k].data(), n, -1.0f, 1.0f);
+    g.normal(h[k].data(), n, 0.0f, 1.0f);
+    g.uniform(d[k].data(), n, -1.0, 1.0);
+    g.normal(e[k].data(), n, 0.0, 1.0);
+  }
+  internal::set_concurrency(threads);
+
+  EXPECT_EQ(f[0], f[1]);
+  EXPECT_EQ(h[0], h[1]);
+  EXPECT_EQ(d[0], d[1]);
+  EXPECT_EQ(e[0], e[1]);
+}
+
+}  // namespace laplus
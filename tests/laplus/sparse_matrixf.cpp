@@ -0,0 +1,203 @@
+/******************************************************************************
+ *
+ * laplus/sparse_matrixf.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/sparse_matrixf.hpp"
+#include "laplus/matrixf.hpp"
+#include "laplus/vectorf.hpp"
+#include "laplus/internal/parallel.hpp"
+#include "gtest/gtest.h"
+#include "helpers.hpp"
+
+namespace laplus {
+
+namespace {
+
+Matrixf Sparsify(const Matrixf& m, const float threshold)
+{
+  Matrixf result(m.rows(), m.cols());
+  for(std::size_t i = 0; i < m.rows(); ++i) {
+    for(std::size_t j = 0; j < m.cols(); ++j) {
+      if(m(i, j) > threshold) result(i, j) = m(i, j);
+    }
+  }
+  return result;
+}
+
+}  // unnamed namespace
+
+TEST(LAPlusSparseMatrixf, ConstructorTriplets) {
+  std::vector<Triplet> t0 = {
+    {1, 2, 3.0}, {0, 0, 1.0}, {1, 0, 2.0}, {0, 0, 4.0}
+  };
+  SparseMatrixf s0(2, 3, t0, CSR);
+  SparseMatrixf s1(2, 3, t0, CSC);
+
+  ASSERT_EQ(s0.nnz(), 3);
+  ASSERT_EQ(s0.format(), CSR);
+  ASSERT_EQ(std::vector<std::size_t>(s0.indptr(), s0.indptr() + 3),
+            std::vector<std::size_t>({0, 1, 3}));
+  ASSERT_EQ(std::vector<std::int32_t>(s0.indices(), s0.indices() + 3),
+            std::vector<std::int32_t>({0, 0, 2}));
+  ASSERT_EQ(std::vector<float>(s0.values(), s0.values() + 3),
+            std::vector<float>({5.0, 2.0, 3.0}));
+
+  ASSERT_EQ(s1.nnz(), 3);
+  ASSERT_EQ(s1.format(), CSC);
+  ASSERT_EQ(std::vector<std::size_t>(s1.indptr(), s1.indptr() + 4),
+            std::vector<std::size_t>({0, 2, 2, 3}));
+  ASSERT_EQ(std::vector<std::int32_t>(s1.indices(), s1.indices() + 3),
+            std::vector<std::int32_t>({0, 1, 1}));
+
+  ASSERT_EQ(s0(0, 0), 5.0);
+  ASSERT_EQ(s0(0, 1), 0.0);
+  ASSERT_EQ(s1(1, 2), 3.0);
+  ASSERT_EQ(s1(1, 1), 0.0);
+}
+
+TEST(LAPlusSparseMatrixf, ConstructorDense) {
+  Matrixf m0({{1, 0, 2}, {0, 0, 3}});
+  SparseMatrixf s0(m0, CSR);
+  SparseMatrixf s1(m0.transpose(), CSC);
+
+  ASSERT_EQ(s0.nnz(), 3);
+  ASSERT_EQ(s1.nnz(), 3);
+  ASSERT_EQ(s1.rows(), 3);
+  ASSERT_EQ(s1.cols(), 2);
+  ExpectNear(s0.dense(), m0, 1e-3);
+  ExpectNear(s1.dense(), m0.transpose(), 1e-3);
+}
+
+TEST(LAPlusSparseMatrixf, TransposeConvert) {
+  Matrixf m0({{1, 0, 2}, {0, 0, 3}});
+  SparseMatrixf s0(m0, CSR);
+  SparseMatrixf s1 = s0.transpose();
+  SparseMatrixf s2 = s0.convert(CSC);
+
+  ASSERT_EQ(s1.format(), CSC);
+  ASSERT_EQ(s1.values(), s0.values());
+  ExpectNear(s1.dense(), m0.transpose(), 1e-3);
+  ASSERT_EQ(s2.format(), CSC);
+  ExpectNear(s2.dense(), m0, 1e-3);
+  ExpectNear(s2.convert(CSR).dense(), m0, 1e-3);
+}
+
+TEST(LAPlusSparseMatrixf, Clone) {
+  Matrixf m0({{1, 0, 2}, {0, 0, 3}});
+  SparseMatrixf s0(m0, CSR);
+  SparseMatrixf s1 = s0.clone();
+  s1.values()[0] = 9.0;
+
+  ASSERT_EQ(s0(0, 0), 1.0);
+  ASSERT_EQ(s1(0, 0), 9.0);
+}
+
+TEST(LAPlusSparseMatrixf, SPMV) {
+  Matrixf m0({{1, 0, 2}, {0, 0, 3}});
+  Vectorf v0({1, 2, 3});
+  Vectorf v1({1, 1});
+
+  SparseMatrixf(m0, CSR).spmv(2.0, v0, 1.0, v1);
+  ASSERT_EQ(v1, std::vector<float>({15, 19}));
+
+  Vectorf v2({1, 1});
+  SparseMatrixf(m0, CSC).spmv(2.0, v0, 1.0, v2);
+  ASSERT_EQ(v2, std::vector<float>({15, 19}));
+
+  ASSERT_EQ(SparseMatrixf(m0, CSR).transpose().dot(Vectorf({1, 2})),
+            std::vector<float>({1, 0, 8}));
+}
+
+TEST(LAPlusSparseMatrixf, SPMVLarge) {
+  Matrixf m0 = Sparsify(Matrixf::Uniform(67, 45), 0.8);
+  Vectorf v0 = Vectorf::Uniform(45);
+  Matrixf m1(v0);
+  Matrixf m2 = m0.dot(m1.reshape(45, 1));
+
+  for(SparseFormat format: {CSR, CSC}) {
+    Matrixf m3(SparseMatrixf(m0, format).dot(v0));
+    ExpectNear(m3.reshape(67, 1), m2, 1e-3);
+  }
+}
+
+TEST(LAPlusSparseMatrixf, SPMM) {
+  Matrixf m0 = Sparsify(Matrixf::Uniform(37, 29), 0.7);
+  Matrixf m1 = Matrixf::Uniform(29, 19);
+  Matrixf m2 = Matrixf::Uniform(19, 37);
+  Matrixf m3 = m0.dot(m1);
+  Matrixf m4 = m2.dot(m0);
+
+  for(SparseFormat format: {CSR, CSC}) {
+    SparseMatrixf s0(m0, format);
+    ExpectNear(s0.dot(m1), m3, 1e-3);
+    ExpectNear(dot(m2, s0), m4, 1e-3);
+
+    Matrixf m5 = Matrixf::Uniform(37, 19);
+    Matrixf m6 = m3 * 2.0 + m5 * 0.5;
+    s0.spmm(CblasLeft, 2.0, m1, 0.5, m5);
+    ExpectNear(m5, m6, 1e-3);
+  }
+}
+
+TEST(LAPlusSparseMatrixf, SPMMTrans) {
+  Matrixf m0 = Sparsify(Matrixf::Uniform(37, 29), 0.7);
+  Matrixf m1 = Matrixf::Uniform(19, 29);
+  Matrixf m2 = Matrixf::Uniform(37, 23);
+
+  for(SparseFormat format: {CSR, CSC}) {
+    SparseMatrixf s0(m0, format);
+    ExpectNear(s0.dot(m1.transpose()), m0.dot(m1.transpose()), 1e-3);
+    ExpectNear(dot(m1, s0.transpose()), m1.dot(m0.transpose()), 1e-3);
+    ExpectNear(s0.transpose().dot(m2), m0.transpose().dot(m2), 1e-3);
+  }
+}
+
+// Large enough to split the work across threads, including the reduction
+// of per-thread buffers for CSC products.
+TEST(LAPlusSparseMatrixf, Threaded) {
+  const std::size_t s0 = internal::concurrency();
+  internal::set_concurrency(4);
+
+  Matrixf m0 = Sparsify(Matrixf::Uniform(300, 200), 0.6);
+  Vectorf v0 = Vectorf::Uniform(200);
+  Matrixf m1 = Matrixf::Uniform(200, 3);
+  Matrixf m2 = Matrixf::Uniform(200, 300);
+  Matrixf m3 = m0.dot(Matrixf(v0).reshape(200, 1));
+
+  for(SparseFormat format: {CSR, CSC}) {
+    SparseMatrixf s1(m0, format);
+    EXPECT_GE(s1.nnz(), 16384);
+    ExpectNear(Matrixf(s1.dot(v0)).reshape(300, 1), m3, 1e-3);
+    ExpectNear(s1.dot(m1), m0.dot(m1), 1e-3);
+    ExpectNear(s1.dot(m2), m0.dot(m2), 1e-3);
+  }
+
+  internal::set_concurrency(s0);
+}
+
+}  // namespace laplus
@@ -0,0 +1,133 @@
+/******************************************************************************
+ *
+ * laplus/strassen.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/strassen.hpp"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace laplus {
+
+namespace {
+
+const float peak(const Matrixf& m)
+{
+  float result = 0.0f;
+  for(std::size_t i = 0; i < m.size(); ++i)
+    result = std::max(result, std::fabs(m.data()[i]));
+  return result;
+}
+
+// Largest deviation from a.dot(b), relative to max|A| max|B| k.
+const float deviation(const Matrixf& a, const Matrixf& b,
+                      const Matrixf& c)
+{
+  const Matrixf r = a.dot(b);
+  float error = 0.0f;
+  for(std::size_t i = 0; i < r.size(); ++i)
+    error = std::max(error, std::fabs(r.data()[i] - c.data()[i]));
+  return error / (peak(a) * peak(b) * a.cols());
+}
+
+}  // unnamed namespace
+
+TEST(LAPlusStrassen, Square) {
+  const Matrixf a = Matrixf::Uniform(256, 256, -1.0f, 1.0f);
+  const Matrixf b = Matrixf::Uniform(256, 256, -1.0f, 1.0f);
+  Strassen strassen(32, false);
+  EXPECT_LT(deviation(a, b, strassen.dot(a, b)), 1e-6);
+  EXPECT_GT(strassen.workspace(), 0u);
+}
+
+TEST(LAPlusStrassen, Odd) {
+  // Peeling at every level of a 3-level recursion.
+  const Matrixf a = Matrixf::Uniform(77, 91, -1.0f, 1.0f);
+  const Matrixf b = Matrixf::Uniform(91, 69, -1.0f, 1.0f);
+  Strassen strassen(8, false);
+  EXPECT_LT(deviation(a, b, strassen.dot(a, b)), 1e-6);
+}
+
+TEST(LAPlusStrassen, Parallel) {
+  const Matrixf a = Matrixf::Uniform(101, 130, -1.0f, 1.0f);
+  const Matrixf b = Matrixf::Uniform(130, 99, -1.0f, 1.0f);
+  Strassen strassen(16, true);
+  EXPECT_LT(deviation(a, b, strassen.dot(a, b)), 1e-6);
+}
+
+TEST(LAPlusStrassen, Gemm) {
+  const Matrixf a = Matrixf::Uniform(70, 64, -1.0f, 1.0f);
+  const Matrixf b = Matrixf::Uniform(80, 64, -1.0f, 1.0f);
+  const Matrixf c = Matrixf::Uniform(70, 80, -1.0f, 1.0f);
+  Matrixf r = c.clone();
+  r.gemm(0.5f, a, b.transpose(), 2.0f);
+
+  Strassen strassen(10, true);
+  Matrixf s = c.clone();
+  strassen.gemm(0.5f, a, b.transpose(), 2.0f, s);
+  for(std::size_t i = 0; i < r.size(); ++i)
+    EXPECT_NEAR(r.data()[i], s.data()[i], 1e-4);
+
+  // The pool is reused by a smaller product.
+  const std::size_t pooled = strassen.workspace();
+  strassen.dot(a, a.transpose());
+  EXPECT_EQ(pooled, strassen.workspace());
+  strassen.release();
+  EXPECT_EQ(0u, strassen.workspace());
+}
+
+TEST(LAPlusStrassen, BetaZero) {
+  const Matrixf a = Matrixf::Uniform(40, 30, -1.0f, 1.0f);
+  const Matrixf b = Matrixf::Uniform(30, 20, -1.0f, 1.0f);
+  const Matrixf r = a.dot(b);
+
+  Strassen strassen(8, false);
+  Matrixf s(std::vector<float>(800, std::nanf("")), 40, 20);
+  strassen.gemm(0.5f, a, b, 0.0f, s);
+  for(std::size_t i = 0; i < r.size(); ++i)
+    EXPECT_NEAR(0.5f * r.data()[i], s.data()[i], 1e-4);
+
+  // An empty inner dimension leaves a zero product.
+  Matrixf e(std::vector<float>(800, std::nanf("")), 40, 20);
+  strassen.gemm(1.0f, Matrixf(40, 0), Matrixf(0, 20), 0.0f, e);
+  for(std::size_t i = 0; i < e.size(); ++i)
+    EXPECT_EQ(0.0f, e.data()[i]);
+}
+
+TEST(LAPlusStrassen, Leaf) {
+  const Matrixf a = Matrixf::Uniform(20, 30);
+  const Matrixf b = Matrixf::Uniform(30, 40);
+  Strassen strassen;
+  EXPECT_EQ(1024u, strassen.cutoff());
+  const Matrixf c = strassen.dot(a, b);
+  EXPECT_EQ(0u, strassen.workspace());
+  EXPECT_LT(deviation(a, b, c), 1e-7);
+}
+
+}  // namespace laplus
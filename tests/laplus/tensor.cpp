@@ -0,0 +1,184 @@
+/******************************************************************************
+ *
+ * laplus/tensor.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/tensor.hpp"
+#include "laplus/matrixf.hpp"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+namespace laplus {
+
+TEST(LAPlusTensor, Constructor) {
+  Tensorf t0({2, 3, 4});
+  Tensorf t1({0, 1, 2, 3, 4, 5}, {2, 3});
+
+  ASSERT_EQ(t0.rank(), 3);
+  ASSERT_EQ(t0.size(), 24);
+  ASSERT_EQ(t0.dims(), dims_t({2, 3, 4}));
+  ASSERT_EQ(t0.strides(), dims_t({12, 4, 1}));
+  ASSERT_TRUE(t0.contiguous());
+  ASSERT_EQ(t0, std::vector<float>(24, 0.0));
+  ASSERT_EQ(t1({1, 2}), 5.0);
+  ASSERT_EQ(t1[1], std::vector<float>({3, 4, 5}));
+}
+
+TEST(LAPlusTensor, Views) {
+  std::vector<float> values(24);
+  for(std::size_t i = 0; i < values.size(); ++i) values[i] = i;
+  Tensorf t0(values, {2, 3, 4});
+
+  Tensorf t1 = t0.permute({2, 0, 1});
+  ASSERT_EQ(t1.dims(), dims_t({4, 2, 3}));
+  ASSERT_EQ(t1.strides(), dims_t({1, 12, 4}));
+  ASSERT_FALSE(t1.contiguous());
+  ASSERT_EQ(t1({3, 1, 2}), t0({1, 2, 3}));
+
+  Tensorf t2 = t0.slice(2, 1, 4, 2);
+  ASSERT_EQ(t2.dims(), dims_t({2, 3, 2}));
+  ASSERT_EQ(t2[1][0], std::vector<float>({13, 15}));
+
+  Tensorf t3 = t0.select(1, 2);
+  ASSERT_EQ(t3, std::vector<float>({8, 9, 10, 11, 20, 21, 22, 23}));
+
+  Tensorf t4 = t0.transpose();
+  ASSERT_EQ(t4.dims(), dims_t({4, 3, 2}));
+  ASSERT_EQ(t4({3, 2, 1}), 23.0);
+
+  ASSERT_EQ(t0.unsqueeze(1).dims(), dims_t({2, 1, 3, 4}));
+  ASSERT_EQ(t0.unsqueeze(1).squeeze(1), t0);
+
+  t2 += 100.0;
+  ASSERT_EQ(t0[0][0], std::vector<float>({0, 101, 2, 103}));
+  ASSERT_EQ(t0.use_count(), 5);
+}
+
+TEST(LAPlusTensor, Reshape) {
+  std::vector<float> values(24);
+  for(std::size_t i = 0; i < values.size(); ++i) values[i] = i;
+  Tensorf t0(values, {2, 3, 4});
+
+  Tensorf t1 = t0.reshape({6, 1, 4});
+  ASSERT_EQ(t1.get(), t0.get());
+  ASSERT_EQ(t1[5], std::vector<float>({20, 21, 22, 23}));
+
+  Tensorf t2 = t0.permute({1, 0, 2}).reshape({3, 2, 2, 2});
+  ASSERT_EQ(t2.get(), t0.get());
+  ASSERT_EQ(t2.strides(), dims_t({4, 12, 2, 1}));
+  ASSERT_EQ(t2[1][1], std::vector<float>({16, 17, 18, 19}));
+
+  Tensorf t3 = t0.permute({2, 1, 0}).reshape({24});
+  ASSERT_NE(t3.get(), t0.get());
+  ASSERT_TRUE(t3.contiguous());
+  ASSERT_EQ(t3({1}), 12.0);
+
+  Tensorf t4 = t0.slice(1, 0, 3, 2).reshape({4, 4});
+  ASSERT_NE(t4.get(), t0.get());
+  ASSERT_EQ(t4[1], std::vector<float>({8, 9, 10, 11}));
+
+  ASSERT_EQ(t0.materialize().get(), t0.get());
+  ASSERT_NE(t0.transpose().materialize().get(), t0.get());
+}
+
+TEST(LAPlusTensor, Broadcast) {
+  Tensorf t0({1, 2, 3, 4, 5, 6}, {2, 3});
+  Tensorf t1({10, 20, 30}, {3});
+  Tensorf t2({100, 200}, {2, 1});
+
+  ASSERT_EQ(broadcast({2, 1, 3}, {4, 1}), dims_t({2, 4, 3}));
+  ASSERT_EQ(t0 + t1, std::vector<float>({11, 22, 33, 14, 25, 36}));
+  ASSERT_EQ(t0 * t2, std::vector<float>({100, 200, 300, 800, 1000, 1200}));
+  ASSERT_EQ((t1 - t2).dims(), dims_t({2, 3}));
+  ASSERT_EQ(t1 - t2, std::vector<float>({-90, -80, -70, -190, -180, -170}));
+  ASSERT_EQ(t0 / 2.0, std::vector<float>({0.5, 1, 1.5, 2, 2.5, 3}));
+  ASSERT_EQ(-t0.transpose(), std::vector<float>({-1, -4, -2, -5, -3, -6}));
+
+  Tensorf t3 = t1.broadcast_to({4, 3});
+  ASSERT_EQ(t3.strides(), dims_t({0, 1}));
+  ASSERT_EQ(t3[3], std::vector<float>({10, 20, 30}));
+
+  t0.transpose() -= t2.transpose();
+  ASSERT_EQ(t0, std::vector<float>({-99, -98, -97, -196, -195, -194}));
+  ASSERT_EQ(t1.apply([](float x) { return x / 10; }),
+            std::vector<float>({1, 2, 3}));
+}
+
+TEST(LAPlusTensor, Parallel) {
+  Tensorf t0({64, 33, 65});
+  Tensorf t1(dims_t({64, 1}));
+  t0 += 1.0;
+  t1 += 2.0;
+
+  Tensorf t2 = t0.permute({2, 0, 1}) * t1;
+  ASSERT_EQ(t2.dims(), dims_t({65, 64, 33}));
+  ASSERT_EQ(t2, std::vector<float>(65 * 64 * 33, 2.0));
+}
+
+TEST(LAPlusTensor, Matrix) {
+  Matrixf m0({{1, 2, 3}, {4, 5, 6}});
+  Tensorf t0(m0);
+  Tensorf t1(m0.transpose());
+
+  ASSERT_EQ(t0.get(), m0.get());
+  ASSERT_EQ(t0.strides(), dims_t({3, 1}));
+  ASSERT_EQ(t1.strides(), dims_t({1, 3}));
+  ASSERT_EQ(t1, std::vector<float>({1, 4, 2, 5, 3, 6}));
+
+  Matrixf m1 = t1.matrix();
+  ASSERT_EQ(m1.get(), m0.get());
+  ASSERT_EQ(m1, m0.transpose());
+
+  std::vector<float> values(24);
+  for(std::size_t i = 0; i < values.size(); ++i) values[i] = i;
+  Tensorf t2(values, {2, 3, 4});
+  Matrixf m2 = t2.matrix();
+  Matrixf m3 = t2[1].matrix();
+  Matrixf m4 = t2.matrix(1);
+  ASSERT_EQ(m2.rows(), 6);
+  ASSERT_EQ(m2.cols(), 4);
+  ASSERT_EQ(m3.get(), t2.get());
+  ASSERT_EQ(m3.row(0), std::vector<float>({12, 13, 14, 15}));
+  ASSERT_EQ(m4.cols(), 12);
+
+  Matrixf m5 = t2.permute({0, 2, 1}).matrix();
+  ASSERT_NE(m5.get(), t2.get());
+  ASSERT_EQ(m5.row(1), std::vector<float>({1, 5, 9}));
+
+  Matrixf m6 = Matrixf::Identity(4);
+  t2[1].matrix().gemm(2.0, m3.clone(), m6, 0.0);
+  ASSERT_EQ(t2[1][2], std::vector<float>({40, 42, 44, 46}));
+}
+
+TEST(LAPlusTensord, Broadcast) {
+  Tensord t0({1, 2, 3, 4}, {2, 2});
+  Tensord t1({1, 10}, {2});
+  ASSERT_EQ(t0 * t1 + 1.0, std::vector<double>({2, 21, 4, 41}));
+}
+
+}  // namespace laplus
@@ -0,0 +1,144 @@
+/******************************************************************************
+ *
+ * laplus/trainer.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/trainer.hpp"
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+namespace laplus {
+
+namespace {
+
+// Least squares on y = xW, with loss 0.5 |xW - t|^2.
+const float least_squares(const std::size_t, const Matrixf& x,
+                          const Matrixf& t,
+                          const std::vector<Matrixf>& w,
+                          std::vector<Matrixf>& g)
+{
+  const Matrixf e = x.dot(w[0]) - t;
+  g[0].gemm(1.0f, x.transpose(), e, 0.0f);
+  return 0.5f * (e * e).sum();
+}
+
+OptimizerParams sgd(const float lr)
+{ return {OptimizerSGD, lr, 0.0f, 0.9f, 0.999f, 1e-8f, 0.0f, false}; }
+
+}  // unnamed namespace
+
+TEST(LAPlusTrainer, Synchronous) {
+  const Matrixf x = Matrixf::Uniform(37, 5);
+  const Matrixf t = Matrixf::Uniform(37, 3);
+  Matrixf w = Matrixf::Uniform(5, 3);
+  Matrixf r = w.clone();
+
+  Trainer trainer({w}, least_squares, sgd(0.01f),
+                  {TrainerSynchronous, 4});
+  for(std::size_t n = 0; n < 3; ++n) {
+    const Matrixf e = x.dot(r) - t;
+    const float loss = trainer.step(x, t);
+    EXPECT_NEAR(0.5f * (e * e).sum(), loss, 1e-4);
+    r.gemm(-0.01f, x.transpose(), e, 1.0f);
+  }
+  for(std::size_t i = 0; i < w.size(); ++i)
+    EXPECT_NEAR(r.data()[i], w.data()[i], 1e-5);
+}
+
+TEST(LAPlusTrainer, Adam) {
+  const Matrixf x = Matrixf::Uniform(20, 4);
+  const Matrixf t = Matrixf::Uniform(20, 2);
+  Matrixf w = Matrixf::Uniform(4, 2);
+  Matrixf r = w.clone();
+  const OptimizerParams params = {OptimizerAdam, 0.01f, 0.0f, 0.9f,
+                                      0.999f, 1e-8f, 0.0f, false};
+
+  Optimizer reference(params);
+  reference.add(r);
+  Trainer trainer({w}, least_squares, params,
+                  {TrainerSynchronous, 3});
+  for(std::size_t n = 0; n < 4; ++n) {
+    reference.step(0, r, x.transpose(), x.dot(r) - t);
+    trainer.step(x, t);
+  }
+  for(std::size_t i = 0; i < w.size(); ++i)
+    EXPECT_NEAR(r.data()[i], w.data()[i], 1e-5);
+}
+
+TEST(LAPlusTrainer, SmallBatch) {
+  const Matrixf x = Matrixf::Uniform(2, 3);
+  const Matrixf t = Matrixf::Uniform(2, 1);
+  Matrixf w(3, 1);
+
+  Trainer trainer({w}, least_squares, sgd(0.1f),
+                  {TrainerSynchronous, 8});
+  EXPECT_NEAR(0.5f * (t * t).sum(), trainer.step(x, t), 1e-6);
+  Matrixf r(3, 1);
+  r.gemm(0.1f, x.transpose(), t, 0.0f);
+  for(std::size_t i = 0; i < w.size(); ++i)
+    EXPECT_NEAR(r.data()[i], w.data()[i], 1e-6);
+}
+
+TEST(LAPlusTrainer, Hogwild) {
+  const Matrixf x = Matrixf::Uniform(256, 8, -1.0f, 1.0f);
+  const Matrixf t = x.dot(Matrixf::Uniform(8, 2, -1.0f, 1.0f));
+  Matrixf w(8, 2);
+
+  Trainer trainer({w}, least_squares, sgd(0.02f), {TrainerHogwild, 4});
+  EXPECT_EQ(4u, trainer.workers());
+  const float first = trainer.epoch(x, t, 16);
+  float last = first;
+  for(std::size_t n = 0; n < 50; ++n) last = trainer.epoch(x, t, 16);
+  EXPECT_LT(last, first * 1e-3);
+}
+
+TEST(LAPlusTrainer, Epoch) {
+  const Matrixf x = Matrixf::Uniform(30, 4);
+  const Matrixf t = Matrixf::Uniform(30, 2);
+  Matrixf w0 = Matrixf::Uniform(4, 2);
+  Matrixf w1 = w0.clone();
+
+  Trainer t0({w0}, least_squares, sgd(0.05f),
+             {TrainerSynchronous, 0});
+  Trainer t1({w1}, least_squares, sgd(0.05f),
+             {TrainerSynchronous, 1});
+  t0.epoch(x, t, 7);
+  for(std::size_t first = 0; first < 30; first += 7) {
+    const std::size_t n = std::min<std::size_t>(7, 30 - first);
+    Matrixf xs(n, 4), ts(n, 2);
+    for(std::size_t i = 0; i < n; ++i) {
+      xs.set_row(i, x.row(first + i));
+      ts.set_row(i, t.row(first + i));
+    }
+    t1.step(xs, ts);
+  }
+  for(std::size_t i = 0; i < w0.size(); ++i)
+    EXPECT_NEAR(w1.data()[i], w0.data()[i], 1e-5);
+}
+
+}  // namespace laplus
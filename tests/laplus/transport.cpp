@@ -0,0 +1,95 @@
+/******************************************************************************
+ *
+ * laplus/transport.cpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2016 Kotone Itaya
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#include "laplus/transport.hpp"
+#include "gtest/gtest.h"
+#include "process.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace laplus {
+
+namespace {
+
+// Every rank streams a message larger than the transport buffers to every
+// other rank from a second thread while receiving theirs.
+const bool exchange(Transport& t)
+{
+  if(!t.is_open()) return false;
+  const std::size_t n = 100003;
+  const std::size_t me = t.rank();
+  std::vector<std::uint32_t> message(n);
+  for(std::size_t i = 0; i < n; ++i) message[i] = me * n + i;
+
+  std::thread sender([&] {
+    for(std::size_t peer = 0; peer < t.size(); ++peer)
+      if(peer != me) t.send(peer, message.data(), n * 4);
+  });
+  bool ok = true;
+  std::vector<std::uint32_t> received(n);
+  for(std::size_t peer = 0; peer < t.size(); ++peer) {
+    if(peer == me) continue;
+    t.recv(peer, received.data(), n * 4);
+    for(std::size_t i = 0; i < n; ++i)
+      ok = ok && received[i] == peer * n + i;
+  }
+  sender.join();
+  return ok && t.is_open();
+}
+
+}  // unnamed namespace
+
+TEST(LAPlusTransport, Shared) {
+  const std::string name = unique("shared");
+  EXPECT_TRUE(spawn(3, [&](const std::size_t rank) {
+    SharedTransport t(name, rank, 3, 1000);
+    return t.capacity() == 1024 && exchange(t);
+  }));
+}
+
+TEST(LAPlusTransport, Unix) {
+  const std::string path = "/tmp/" + unique("unix");
+  EXPECT_TRUE(spawn(3, [&](const std::size_t rank) {
+    SocketTransport t(SocketUnix, path, rank, 3);
+    return exchange(t);
+  }));
+}
+
+TEST(LAPlusTransport, TCP) {
+  const std::string address = "127.0.0.1:"
+    + std::to_string(20000 + ::getpid() % 20000);
+  EXPECT_TRUE(spawn(2, [&](const std::size_t rank) {
+    SocketTransport t(SocketTCP, address, rank, 2);
+    return exchange(t);
+  }));
+}
+
+}  // namespace laplus
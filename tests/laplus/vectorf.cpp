@@ -52,6 +52,43 @@ TEST(LAPlusVectorf, ConstructorVector) {
   ASSERT_EQ(v0, t0);
 }
 
+TEST(LAPlusVectorf, ConstructorVectorMove) {
+  std::vector<float> t0 = {0, 1, 2};
+  std::vector<float> t1 = t0;
+  const float* p0 = t1.data();
+  Vectorf v0(std::move(t1));
+
+  ASSERT_FALSE(v0.empty());
+  ASSERT_EQ(v0.use_count(), 1);
+  ASSERT_EQ(v0.size(), t0.size());
+  ASSERT_EQ(v0.data(), p0);
+  ASSERT_EQ(v0, t0);
+}
+
+TEST(LAPlusVectorf, ConstructorAdopt) {
+  std::vector<float> t0 = {0, 1, 2};
+  std::size_t released = 0;
+  float* p0 = new float[3]{0, 1, 2};
+
+  {
+    Vectorf v0(p0, 3, [&](float* p) {
+      ++released;
+      delete[] p;
+    });
+
+    ASSERT_FALSE(v0.empty());
+    ASSERT_EQ(v0.use_count(), 1);
+    ASSERT_EQ(v0.size(), t0.size());
+    ASSERT_EQ(v0.data(), p0);
+    ASSERT_EQ(v0, t0);
+
+    Vectorf v1(v0);
+    ASSERT_EQ(v0.use_count(), 2);
+  }
+
+  ASSERT_EQ(released, 1);
+}
+
 TEST(LAPlusVectorf, ConstructorCopy) {
   std::size_t s0 = 3;
   Vectorf v0(s0);
@@ -1640,4 +1677,59 @@ TEST(LAPlusVectorf, GeneratorUniform) {
   }
 }
 
+TEST(LAPlusVectord, ConstructorVector) {
+  std::vector<double> t0 = {1, 2, 3};
+  Vectord v0(t0);
+
+  ASSERT_FALSE(v0.empty());
+  ASSERT_EQ(v0.use_count(), 1);
+  ASSERT_EQ(v0.size(), t0.size());
+  ASSERT_EQ(v0, t0);
+}
+
+TEST(LAPlusVectord, Level1BLAS_AXPY) {
+  Vectord v0({1, 2, 3});
+  Vectord v1({1, 2, 3});
+  std::vector<double> t0({3, 6, 9});
+
+  v1.axpy(2.0, v0);
+
+  ASSERT_EQ(v1, t0);
+}
+
+TEST(LAPlusVectord, Level1BLAS_DOT) {
+  Vectord v0({1e8, 1, -1e8});
+  Vectord v1({1, 1, 1});
+
+  ASSERT_EQ(v0.dot(v1), 1.0);
+}
+
+TEST(LAPlusVectord, MulInplace) {
+  Vectord v0({1, 2, 3, 4, 5, 6, 7, 8});
+  Vectord v1({1, 2, 3, 4, 5, 6, 7, 8});
+  std::vector<double> t0({1, 4, 9, 16, 25, 36, 49, 64});
+
+  v1.mul_inplace(v0);
+
+  ASSERT_EQ(v1, t0);
+}
+
+TEST(LAPlusVectord, DivInplace) {
+  Vectord v0({1, 2, 3, 4, 5, 6, 7, 8});
+  Vectord v1({1, 4, 9, 16, 25, 36, 49, 64});
+  std::vector<double> t0({1, 2, 3, 4, 5, 6, 7, 8});
+
+  v1.div_inplace(v0);
+
+  ASSERT_EQ(v1, t0);
+}
+
+TEST(LAPlusVectord, OperatorArithmeticFloatL) {
+  Vectord v0({1, 2, 4});
+
+  ASSERT_EQ(2 * v0, std::vector<double>({2, 4, 8}));
+  ASSERT_EQ(1.0 - v0, std::vector<double>({0, -1, -3}));
+  ASSERT_EQ(4.0 / v0, std::vector<double>({4, 2, 1}));
+}
+
 }  // namespace laplus